@@ -103,6 +103,7 @@ void ActionManager::pauseTarget(Node* target)
     {
         it->second.paused = true;
     }
+    _tweenSystem.pauseTarget(target);
 }
 
 void ActionManager::resumeTarget(Node* target)
@@ -112,6 +113,7 @@ void ActionManager::resumeTarget(Node* target)
     {
         it->second.paused = false;
     }
+    _tweenSystem.resumeTarget(target);
 }
 
 Vector<Node*> ActionManager::pauseAllRunningActions()
@@ -123,6 +125,11 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         element.paused = true;
         idsWithActions.pushBack(const_cast<Node*>(target));
     }
+    for (auto target : _tweenSystem.pauseAllTargets())
+    {
+        if (!idsWithActions.contains(target))
+            idsWithActions.pushBack(target);
+    }
 
     return idsWithActions;
 }
@@ -167,6 +174,7 @@ void ActionManager::removeAllActions()
 {
     for (auto actionIt = _targets.begin(); actionIt != _targets.end();)
         removeTargetActionHandle(actionIt);
+    _tweenSystem.stopAll();
 }
 
 void ActionManager::removeAllActionsFromTarget(Node* target)
@@ -180,6 +188,7 @@ void ActionManager::removeAllActionsFromTarget(Node* target)
     auto actionIt = _targets.find(target);
     if (actionIt != _targets.end())
         removeTargetActionHandle(actionIt);
+    _tweenSystem.stopAllForTarget(target);
 }
 
 void ActionManager::removeTargetActionHandle(std::unordered_map<Node*, ActionHandle>::iterator& actionIt)
@@ -452,6 +461,8 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    _tweenSystem.update(dt);
 }
 
 }
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #define __ACTION_CCACTION_MANAGER_H__
 
 #include "2d/Action.h"
+#include "2d/TweenSystem.h"
 #include "base/Vector.h"
 #include "base/Object.h"
 
@@ -200,6 +201,11 @@ public:
      */
     virtual void update(float dt);
 
+    /** Gets the TweenSystem updated with the actions, the tweens of a target pause, resume and stop with its
+     * actions.
+     */
+    TweenSystem* getTweenSystem() { return &_tweenSystem; }
+
 protected:
     // declared in ActionManager.m
     void removeTargetActionHandle(std::unordered_map<Node*, ActionHandle>::iterator& actionIt);
@@ -216,6 +222,7 @@ protected:
     std::unordered_map<Node*, ActionHandle> _targets;
     ActionHandle* _currentTarget;
     bool _currentTargetSalvaged;
+    TweenSystem _tweenSystem;
 };
 
 // end of actions group
@@ -32,7 +32,10 @@ THE SOFTWARE.
 #include "base/Director.h"
 #include "base/axstd.h"
 #include "renderer/TextureCache.h"
+#include "base/JobSystem.h"
+#include "platform/FileUtils.h"
 #include "clipper2/clipper.h"
+#include "xxhash/xxhash.h"
 #include <algorithm>
 #include <math.h>
 
@@ -185,9 +188,21 @@ AutoPolygon::AutoPolygon(std::string_view filename)
     _scaleFactor = Director::getInstance()->getContentScaleFactor();
 }
 
+AutoPolygon::AutoPolygon(Image* image, std::string_view filename)
+    : _image(image), _data(nullptr), _filename(filename), _width(0), _height(0), _scaleFactor(0)
+{
+    AXASSERT(_image->getPixelFormat() == backend::PixelFormat::RGBA8,
+             "unsupported format, currently only supports rgba8888");
+    _image->retain();
+    _data        = _image->getData();
+    _width       = _image->getWidth();
+    _height      = _image->getHeight();
+    _scaleFactor = Director::getInstance()->getContentScaleFactor();
+}
+
 AutoPolygon::~AutoPolygon()
 {
-    AX_SAFE_DELETE(_image);
+    AX_SAFE_RELEASE(_image);
 }
 
 std::vector<Vec2> AutoPolygon::trace(const Rect& rect, float threshold)
@@ -723,10 +738,252 @@ PolygonInfo AutoPolygon::generateTriangles(const Rect& rect, float epsilon, floa
     return ret;
 }
 
+namespace
+{
+std::string s_cacheDirectory;
+
+constexpr uint32_t POLYGON_CACHE_MAGIC   = 0x4c4f5041;  // "APOL"
+constexpr uint32_t POLYGON_CACHE_VERSION = 1;
+
+// Everything the generated triangles depend on, the file name is the hash of it
+struct PolygonCacheKey
+{
+    uint64_t fileHash;
+    float rect[4];
+    float epsilon;
+    float threshold;
+    float scaleFactor;
+    uint32_t padding;
+};
+
+struct PolygonCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    PolygonCacheKey key;
+    float rect[4];
+    uint32_t vertCount;
+    uint32_t indexCount;
+};
+
+// Vertices are stored without color and z, which are always white and 0
+struct PolygonCacheVertex
+{
+    float x, y, u, v;
+};
+
+PolygonCacheKey makeCacheKey(uint64_t fileHash, const Rect& rect, float epsilon, float threshold, float scaleFactor)
+{
+    PolygonCacheKey key{};
+    key.fileHash    = fileHash;
+    key.rect[0]     = rect.origin.x;
+    key.rect[1]     = rect.origin.y;
+    key.rect[2]     = rect.size.width;
+    key.rect[3]     = rect.size.height;
+    key.epsilon     = epsilon;
+    key.threshold   = threshold;
+    key.scaleFactor = scaleFactor;
+    return key;
+}
+
+std::string getCacheFilePath(const PolygonCacheKey& key)
+{
+    return fmt::format("{}{:016x}.axpoly", s_cacheDirectory, XXH64(&key, sizeof(key), 0));
+}
+
+bool loadCachedPolygon(const PolygonCacheKey& key, PolygonInfo& info)
+{
+    auto data = FileUtils::getInstance()->getDataFromFile(getCacheFilePath(key));
+    if (data.getSize() < static_cast<ssize_t>(sizeof(PolygonCacheHeader)))
+        return false;
+
+    PolygonCacheHeader header;
+    memcpy(&header, data.getBytes(), sizeof(header));
+    size_t size = sizeof(header) + header.vertCount * sizeof(PolygonCacheVertex) +
+                  header.indexCount * sizeof(unsigned short);
+    if (header.magic != POLYGON_CACHE_MAGIC || header.version != POLYGON_CACHE_VERSION ||
+        memcmp(&header.key, &key, sizeof(key)) != 0 || static_cast<size_t>(data.getSize()) != size)
+        return false;
+
+    auto vertices = reinterpret_cast<const PolygonCacheVertex*>(data.getBytes() + sizeof(header));
+    auto verts    = new V3F_C4B_T2F[header.vertCount];
+    for (uint32_t i = 0; i < header.vertCount; ++i)
+    {
+        verts[i].vertices  = Vec3(vertices[i].x, vertices[i].y, 0);
+        verts[i].colors    = Color4B::WHITE;
+        verts[i].texCoords = Tex2F(vertices[i].u, vertices[i].v);
+    }
+    auto indices = new unsigned short[header.indexCount];
+    memcpy(indices, vertices + header.vertCount, header.indexCount * sizeof(unsigned short));
+
+    info.triangles = {verts, indices, header.vertCount, header.indexCount};
+    info.setRect(Rect(header.rect[0], header.rect[1], header.rect[2], header.rect[3]));
+    return true;
+}
+
+void saveCachedPolygon(const PolygonCacheKey& key, const PolygonInfo& info)
+{
+    auto& triangles = info.triangles;
+    auto& rect      = info.getRect();
+
+    PolygonCacheHeader header{POLYGON_CACHE_MAGIC,
+                              POLYGON_CACHE_VERSION,
+                              key,
+                              {rect.origin.x, rect.origin.y, rect.size.width, rect.size.height},
+                              triangles.vertCount,
+                              triangles.indexCount};
+
+    Data data;
+    auto size  = sizeof(header) + triangles.vertCount * sizeof(PolygonCacheVertex) +
+                triangles.indexCount * sizeof(unsigned short);
+    auto bytes = static_cast<uint8_t*>(malloc(size));
+    memcpy(bytes, &header, sizeof(header));
+    auto vertices = reinterpret_cast<PolygonCacheVertex*>(bytes + sizeof(header));
+    for (unsigned int i = 0; i < triangles.vertCount; ++i)
+    {
+        auto& v     = triangles.verts[i];
+        vertices[i] = {v.vertices.x, v.vertices.y, v.texCoords.u, v.texCoords.v};
+    }
+    memcpy(vertices + triangles.vertCount, triangles.indices, triangles.indexCount * sizeof(unsigned short));
+    data.fastSet(bytes, size);
+
+    if (!FileUtils::getInstance()->writeDataToFile(data, getCacheFilePath(key)))
+        AXLOGW("AUTOPOLYGON: failed to write the polygon cache of {}", info.getFilename());
+}
+
+uint64_t hashFile(const Data& data)
+{
+    return XXH64(data.getBytes(), data.getSize(), 0);
+}
+}  // namespace
+
 PolygonInfo AutoPolygon::generatePolygon(std::string_view filename, const Rect& rect, float epsilon, float threshold)
 {
-    AutoPolygon ap(filename);
-    return ap.generateTriangles(rect, epsilon, threshold);
+    if (s_cacheDirectory.empty())
+    {
+        AutoPolygon ap(filename);
+        return ap.generateTriangles(rect, epsilon, threshold);
+    }
+
+    // A cache hit only costs reading the file, it isn't decoded
+    auto data        = FileUtils::getInstance()->getDataFromFile(filename);
+    auto scaleFactor = Director::getInstance()->getContentScaleFactor();
+    auto key         = makeCacheKey(hashFile(data), rect, epsilon, threshold, scaleFactor);
+
+    PolygonInfo info;
+    if (loadCachedPolygon(key, info))
+    {
+        info.setFilename(filename);
+        return info;
+    }
+
+    auto image = new Image();
+    image->initWithImageData(data.getBytes(), data.getSize());
+    AutoPolygon ap(image, filename);
+    image->release();
+    info = ap.generateTriangles(rect, epsilon, threshold);
+    if (info.triangles.indexCount > 0)
+        saveCachedPolygon(key, info);
+    return info;
+}
+
+void AutoPolygon::generatePolygonsAsync(std::string_view filename,
+                                        std::vector<Rect> rects,
+                                        float epsilon,
+                                        float threshold,
+                                        std::function<void(std::vector<PolygonInfo>&)> callback)
+{
+    struct Batch
+    {
+        std::string filename;
+        std::string fullPath;
+        std::vector<Rect> rects;
+        std::function<void(std::vector<PolygonInfo>&)> callback;
+        Image* image      = nullptr;
+        std::unique_ptr<AutoPolygon> polygon;  // generation doesn't modify it, the jobs share it
+        uint64_t fileHash = 0;
+        float scaleFactor = 1.0f;
+        std::vector<PolygonInfo> results;
+        size_t pending    = 0;
+    };
+
+    // Full paths and the scale factor are resolved here, workers don't touch the FileUtils path cache or Director
+    auto batch         = std::make_shared<Batch>();
+    batch->filename    = filename;
+    batch->fullPath    = FileUtils::getInstance()->fullPathForFilename(filename);
+    batch->rects       = std::move(rects);
+    batch->callback    = std::move(callback);
+    batch->scaleFactor = Director::getInstance()->getContentScaleFactor();
+    batch->results.resize(batch->rects.size());
+
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    jobSystem->enqueue(
+        [batch]() {
+            auto data       = FileUtils::getInstance()->getDataFromFile(batch->fullPath);
+            batch->fileHash = hashFile(data);
+            batch->image    = new Image();
+            if (!batch->image->initWithImageData(data.getBytes(), data.getSize()) ||
+                batch->image->getPixelFormat() != backend::PixelFormat::RGBA8)
+                AX_SAFE_RELEASE_NULL(batch->image);
+        },
+        [batch, jobSystem, epsilon, threshold]() {
+            if (!batch->image || batch->rects.empty())
+            {
+                if (!batch->image)
+                    AXLOGE("AUTOPOLYGON: can't load {} as a rgba8888 image", batch->filename);
+                batch->results.clear();
+                batch->callback(batch->results);
+                return;
+            }
+
+            batch->polygon = std::make_unique<AutoPolygon>(batch->image, batch->filename);
+            AX_SAFE_RELEASE_NULL(batch->image);
+            batch->pending = batch->rects.size();
+            for (size_t i = 0; i < batch->rects.size(); ++i)
+            {
+                jobSystem->enqueue(
+                    [batch, i, epsilon, threshold]() {
+                        auto& rect = batch->rects[i];
+                        auto key   = makeCacheKey(batch->fileHash, rect, epsilon, threshold, batch->scaleFactor);
+                        auto& info = batch->results[i];
+                        if (!s_cacheDirectory.empty() && loadCachedPolygon(key, info))
+                        {
+                            info.setFilename(batch->filename);
+                            return;
+                        }
+
+                        info = batch->polygon->generateTriangles(rect, epsilon, threshold);
+                        if (!s_cacheDirectory.empty() && info.triangles.indexCount > 0)
+                            saveCachedPolygon(key, info);
+                    },
+                    [batch]() {
+                        if (--batch->pending > 0)
+                            return;
+                        batch->polygon.reset();
+                        batch->callback(batch->results);
+                    });
+            }
+        });
+}
+
+void AutoPolygon::setCacheDirectory(std::string_view directory)
+{
+    s_cacheDirectory = directory;
+    if (s_cacheDirectory.empty())
+        return;
+
+    // Workers read and write the cache, relative paths would go through the FileUtils lookup which isn't thread safe
+    if (!FileUtils::getInstance()->isAbsolutePath(s_cacheDirectory))
+        s_cacheDirectory.insert(0, FileUtils::getInstance()->getWritablePath());
+
+    if (s_cacheDirectory.back() != '/')
+        s_cacheDirectory.push_back('/');
+    FileUtils::getInstance()->createDirectories(s_cacheDirectory);
+}
+
+std::string_view AutoPolygon::getCacheDirectory()
+{
+    return s_cacheDirectory;
 }
 
 }
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #ifndef COCOS_2D_CCAUTOPOLYGON_H__
 #define COCOS_2D_CCAUTOPOLYGON_H__
 
+#include <functional>
 #include <string>
 #include <vector>
 #include "platform/Image.h"
@@ -152,6 +153,13 @@ public:
      */
     AutoPolygon(std::string_view filename);
 
+    /**
+     * create an AutoPolygon sharing an already decoded RGBA8 image, the image is retained
+     * @param   image       the image to trace.
+     * @param   filename    the file the image was loaded from, used to name the generated PolygonInfo.
+     */
+    AutoPolygon(Image* image, std::string_view filename);
+
     /**
      * Destructor of AutoPolygon.
      */
@@ -262,6 +270,33 @@ public:
                                        float epsilon = 2.0f,
                                        float threshold = 0.05f);
 
+    /**
+     * Generates the polygons of several rects of one image on the JobSystem, e.g. all the frames of a sprite sheet.
+     * The image is decoded once and each rect is traced by its own job.
+     * @param   filename    A path to image file.
+     * @param   rects       texture rects in points, like SpriteFrame::getRect, Rect::ZERO for the whole texture
+     * @param   callback    called on the axmol thread with the polygons in the order of rects, empty if the image
+     * can't be loaded
+     */
+    static void generatePolygonsAsync(std::string_view filename,
+                                      std::vector<Rect> rects,
+                                      float epsilon,
+                                      float threshold,
+                                      std::function<void(std::vector<PolygonInfo>&)> callback);
+
+    /**
+     * Enables the persistent polygon cache, disabled by default or when the directory is empty.
+     * generatePolygon and generatePolygonsAsync then store their results in the directory, keyed by the content
+     * hash of the image file, the rect, epsilon, threshold and the content scale factor, and load them on later
+     * runs instead of tracing the image again. The directory is created if needed, a relative directory is
+     * relative to the writable path.
+     * @code
+     * AutoPolygon::setCacheDirectory(FileUtils::getInstance()->getWritablePath() + "polygons/");
+     * @endcode
+     */
+    static void setCacheDirectory(std::string_view directory);
+    static std::string_view getCacheDirectory();
+
 protected:
     Vec2 findFirstNoneTransparentPixel(const Rect& rect, float threshold);
     std::vector<ax::Vec2> marchSquare(const Rect& rect, const Vec2& first, float threshold);
@@ -382,6 +382,18 @@ bool Camera::isVisibleInFrustum(const AABB* aabb) const
     }
     return !_frustum.isOutOfFrustum(*aabb);
 }
+
+const Frustum& Camera::getFrustum() const
+{
+    // flags the frustum dirty if the camera moved
+    getViewMatrix();
+    if (_frustumDirty)
+    {
+        _frustum.initFrustum(this);
+        _frustumDirty = false;
+    }
+    return _frustum;
+}
 #endif
 
 float Camera::getDepthInView(const Mat4& transform) const
@@ -72,6 +72,9 @@ class AX_DLL Camera : public Node
     friend class Scene;
     friend class Director;
     friend class EventDispatcher;
+#if defined(AX_ENABLE_3D)
+    friend class MeshCuller;
+#endif
 
 public:
     /**
@@ -199,6 +202,22 @@ public:
      * Is this aabb visible in frustum
      */
     bool isVisibleInFrustum(const AABB* aabb) const;
+
+    /**
+     * Get the camera frustum, updated from the view projection matrix when needed.
+     */
+    const Frustum& getFrustum() const;
+
+    /**
+     * Get the number of mesh renderers found in the frustum by the last culling pass of this camera.
+     * @see MeshCuller
+     */
+    unsigned int getVisibleMeshCount() const { return _visibleMeshCount; }
+
+    /**
+     * Get the number of mesh renderers skipped by the last culling pass of this camera.
+     */
+    unsigned int getCulledMeshCount() const { return _culledMeshCount; }
 #endif
 
     /**
@@ -365,7 +384,9 @@ protected:
     CameraFlag _cameraFlag      = CameraFlag::DEFAULT;  // camera flag
 #if defined(AX_ENABLE_3D)
     mutable Frustum _frustum;                           // camera frustum
-    mutable bool _frustumDirty = true;
+    mutable bool _frustumDirty     = true;
+    unsigned int _visibleMeshCount = 0;  // meshes in the frustum found by the last culling pass
+    unsigned int _culledMeshCount  = 0;  // meshes out of the frustum skipped by the last culling pass
 #endif
     int8_t _depth = -1;  // camera depth, the depth of camera with CameraFlag::DEFAULT flag is 0 by default, a camera
                          // with larger depth is drawn on top of camera with smaller depth
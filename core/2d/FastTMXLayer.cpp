@@ -276,7 +276,7 @@ void FastTMXLayer::updateVertexBuffer()
     {
         _vertexBuffer = backend::DriverBase::getInstance()->newBuffer(vertexBufferSize, backend::BufferType::VERTEX, backend::BufferUsage::STATIC);
     }
-    _vertexBuffer->updateData(&_totalQuads[0], vertexBufferSize);
+    _director->getRenderer()->updateBufferData(_vertexBuffer, &_totalQuads[0], vertexBufferSize);
 }
 
 void FastTMXLayer::updateIndexBuffer()
@@ -286,7 +286,7 @@ void FastTMXLayer::updateIndexBuffer()
     {
         _indexBuffer = backend::DriverBase::getInstance()->newBuffer(indexBufferSize, backend::BufferType::INDEX, backend::BufferUsage::DYNAMIC);
     }
-    _indexBuffer->updateData(&_indices[0], indexBufferSize);
+    _director->getRenderer()->updateBufferData(_indexBuffer, &_indices[0], indexBufferSize);
 }
 
 // FastTMXLayer - setup Tiles
@@ -52,6 +52,7 @@ const int FontAtlas::CacheTextureWidth     = 512;
 const int FontAtlas::CacheTextureHeight    = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__ax_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__ax_RESET_FONTATLAS";
+const char* FontAtlas::CMD_EVICT_GLYPHS    = "__ax_EVICT_GLYPHS";
 
 void FontAtlas::loadFontAtlas(std::string_view fontatlasFile, hlookup::string_map<FontAtlas*>& outAtlasMap)
 {
@@ -174,8 +175,7 @@ FontAtlas::FontAtlas(Font* theFont, int atlasWidth, int atlasHeight, float scale
 
 void FontAtlas::reinit()
 {
-    if (!_currentPageData)
-        _currentPageData = new uint8_t[_currentPageDataSize];
+    releasePages();
     _currentPage = -1;
 
     addNewPage();
@@ -194,14 +194,12 @@ FontAtlas::~FontAtlas()
 
     _font->release();
     releaseTextures();
-
-    AX_SAFE_DELETE_ARRAY(_currentPageData);
+    releasePages();
 }
 
 void FontAtlas::initWithSettings(void* opaque /*simdjson::ondemand::document*/)
 {
-    if (!_currentPageData)
-        _currentPageData = new uint8_t[_currentPageDataSize];
+    releasePages();
     _currentPage = -1;
 
     simdjson::ondemand::document& settings = *(simdjson::ondemand::document*)opaque;
@@ -217,6 +215,15 @@ void FontAtlas::initWithSettings(void* opaque /*simdjson::ondemand::document*/)
     _currentPageOrigX = static_cast<float>(settings["pageX"].get_double());
     _currentPageOrigY = static_cast<float>(settings["pageY"].get_double());
 
+    // the last page keeps growing, the row at pageY is filled up to pageX
+    if (!_pages.empty())
+    {
+        auto& packer = _pages.back().packer;
+        packer.reserve(_width, static_cast<int>(_currentPageOrigY));
+        packer.reserve(static_cast<int>(_currentPageOrigX),
+                       static_cast<int>(_currentPageOrigY + _lineHeight) + _letterPadding + _letterEdgeExtend);
+    }
+
     // letters
     FontLetterDefinition tempDef;
     tempDef.rotated         = false;
@@ -250,7 +257,6 @@ void FontAtlas::reset()
 {
     releaseTextures();
 
-    _currLineHeight   = 0;
     _currentPageOrigX = 0;
     _currentPageOrigY = 0;
     _letterDefinitions.clear();
@@ -258,6 +264,15 @@ void FontAtlas::reset()
     reinit();
 }
 
+void FontAtlas::releasePages()
+{
+    for (auto&& page : _pages)
+        delete[] page.data;
+    _pages.clear();
+    _glyphSlots.clear();
+    _currentPageData = nullptr;
+}
+
 void FontAtlas::releaseTextures()
 {
     for (auto&& item : _atlasTextures)
@@ -340,6 +355,17 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
     if (!_currentPageData)
         reinit();
 
+    const auto frame = Director::getInstance()->getTotalFrames();
+    if (_pageBudget > 0)
+    {
+        for (auto&& charCode : utf32Text)
+        {
+            auto it = _glyphSlots.find(charCode);
+            if (it != _glyphSlots.end())
+                it->second.lastUse = frame;
+        }
+    }
+
     std::unordered_set<char32_t> charCodeSet;
     findNewCharacters(utf32Text, charCodeSet);
     if (charCodeSet.empty())
@@ -351,13 +377,14 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
     int adjustForExtend      = _letterEdgeExtend / 2;
     int bitmapWidth          = 0;
     int bitmapHeight         = 0;
-    int glyphHeight;
+    int page                 = 0;
+    int glyphX               = 0;
+    int glyphY               = 0;
     Rect tempRect;
     FontLetterDefinition tempDef;
 
-    auto pixelFormat = _pixelFormat;
-
-    int startY = (int)_currentPageOrigY;
+    _evictionQueue.clear();
+    _glyphsEvicted = false;
 
     for (auto&& charCode : charCodeSet)
     {
@@ -406,33 +433,26 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX         = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
             tempDef.offsetY         = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > _width)
+            // keep a one pixel gap to the neighbours
+            int slotWidth  = static_cast<int>(std::ceil(tempDef.width)) + 1;
+            int slotHeight = bitmapHeight + _letterPadding + _letterEdgeExtend + 1;
+            if (!allocateGlyph(slotWidth, slotHeight, frame, page, glyphX, glyphY))
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight   = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= _height)
-                {
-                    updateTextureContent(pixelFormat, startY);
+                AXLOGW("FontAtlas: glyph {} doesn't fit in a {}x{} page", (uint32_t)charCode, _width, _height);
+                if (charRenderer->getOutlineSize() > 0)
+                    delete[] bitmap;
+                continue;
+            }
 
-                    startY = 0;
+            charRenderer->renderCharAt(_pages[page].data, glyphX + adjustForExtend, glyphY + adjustForExtend, bitmap,
+                                       bitmapWidth, bitmapHeight, _width, _height);
+            markPageDirty(page, glyphX, glyphY, slotWidth, slotHeight);
+            if (_pageBudget > 0)
+                _glyphSlots[charCode] = GlyphSlot{page, glyphX, glyphY, slotWidth, slotHeight, frame, 0};
 
-                    addNewPage();
-                }
-            }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
-            {
-                _currLineHeight = glyphHeight;
-            }
-            charRenderer->renderCharAt(_currentPageData, (int)_currentPageOrigX + adjustForExtend,
-                                       (int)_currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight,
-                                        _width, _height);
-
-            tempDef.U         = _currentPageOrigX;
-            tempDef.V         = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
+            tempDef.U         = static_cast<float>(glyphX);
+            tempDef.V         = static_cast<float>(glyphY);
+            tempDef.textureID = page;
             // take from pixels to points
             tempDef.width   = tempDef.width / _scaleFactor;
             tempDef.height  = tempDef.height / _scaleFactor;
@@ -454,29 +474,198 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetY         = 0;
             tempDef.textureID       = 0;
             tempDef.rotated         = false;
-            _currentPageOrigX += 1;
         }
 
         _letterDefinitions[charCode] = tempDef;
     }
 
-    updateTextureContent(pixelFormat, startY);
+    for (int index = 0; index < static_cast<int>(_pages.size()); ++index)
+        updateTextureContent(index);
+
+    // the resume point saved with prebuilt atlases
+    _currentPageOrigX = 0;
+    _currentPageOrigY = static_cast<float>(_pages[_currentPage].packer.getUsedHeight());
+
+    if (_glyphsEvicted)
+    {
+        _glyphsEvicted = false;
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_EVICT_GLYPHS, this);
+    }
 
     return true;
 }
 
-void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
+bool FontAtlas::allocateGlyph(int width, int height, unsigned int frame, int& page, int& x, int& y)
 {
-    auto data = _currentPageData + (_width * (int)startY << _strideShift);
-    _atlasTextures[_currentPage]->updateWithSubData(data, 0, startY, _width,
-                                                    (std::min)((int)_currentPageOrigY - startY + _currLineHeight, _height));
+    if (_pageBudget == 0)
+    {
+        // a growing atlas only fills its current page
+        if (!_pages[_currentPage].packer.insert(width, height, x, y))
+        {
+            updateTextureContent(_currentPage);
+            addNewPage();
+            if (!_pages[_currentPage].packer.insert(width, height, x, y))
+                return false;
+        }
+        page = _currentPage;
+        return true;
+    }
+
+    for (page = 0; page < static_cast<int>(_pages.size()); ++page)
+    {
+        if (_pages[page].packer.insert(width, height, x, y))
+            return true;
+    }
+
+    if (static_cast<int>(_pages.size()) < _pageBudget)
+    {
+        addNewPage();
+        page = _currentPage;
+        return _pages[page].packer.insert(width, height, x, y);
+    }
+
+    // evict the least recently used glyphs until the room of one of them takes the new glyph
+    if (_evictionQueue.empty())
+    {
+        for (auto&& item : _glyphSlots)
+        {
+            if (item.second.lastUse < frame && item.second.pins == 0)
+                _evictionQueue.emplace_back(item.second.lastUse, item.first);
+        }
+        std::sort(_evictionQueue.begin(), _evictionQueue.end(), std::greater<>{});
+    }
+
+    while (!_evictionQueue.empty())
+    {
+        auto charCode = _evictionQueue.back().second;
+        _evictionQueue.pop_back();
+
+        auto it = _glyphSlots.find(charCode);
+        if (it == _glyphSlots.end() || it->second.lastUse >= frame || it->second.pins > 0)
+            continue;
+
+        page = it->second.page;
+        evictGlyph(charCode);
+        if (_pages[page].packer.insert(width, height, x, y))
+            return true;
+    }
+
+    // the glyphs left are all shown in this frame or pinned, exceed the budget rather than corrupt them
+    AXLOGW("FontAtlas: the text shown needs more than {} pages, adding one", _pageBudget);
+    addNewPage();
+    page = _currentPage;
+    return _pages[page].packer.insert(width, height, x, y);
+}
+
+void FontAtlas::pinGlyphs(const std::u32string& utf32Text)
+{
+    if (_pageBudget == 0)
+        return;
+
+    for (auto&& charCode : utf32Text)
+    {
+        auto it = _glyphSlots.find(charCode);
+        if (it != _glyphSlots.end())
+            ++it->second.pins;
+    }
+}
+
+void FontAtlas::unpinGlyphs(const std::u32string& utf32Text)
+{
+    if (_pageBudget == 0)
+        return;
+
+    // a purge in between dropped the pins with the slots, the glyphs may have been added again since
+    for (auto&& charCode : utf32Text)
+    {
+        auto it = _glyphSlots.find(charCode);
+        if (it != _glyphSlots.end() && it->second.pins > 0)
+            --it->second.pins;
+    }
+}
+
+void FontAtlas::evictGlyph(char32_t charCode)
+{
+    auto it    = _glyphSlots.find(charCode);
+    auto& slot = it->second;
+    auto& page = _pages[slot.page];
+
+    for (int row = slot.y; row < slot.y + slot.height; ++row)
+        memset(page.data + ((row * _width + slot.x) << _strideShift), 0, slot.width << _strideShift);
+    markPageDirty(slot.page, slot.x, slot.y, slot.width, slot.height);
+    page.packer.release(slot.x, slot.y, slot.width, slot.height);
+
+    _glyphSlots.erase(it);
+    _letterDefinitions.erase(charCode);
+    _glyphsEvicted = true;
+}
+
+void FontAtlas::markPageDirty(int page, int x, int y, int width, int height)
+{
+    auto& glyphPage = _pages[page];
+    if (glyphPage.dirtyRight <= glyphPage.dirtyLeft)
+    {
+        glyphPage.dirtyLeft   = x;
+        glyphPage.dirtyTop    = y;
+        glyphPage.dirtyRight  = x + width;
+        glyphPage.dirtyBottom = y + height;
+    }
+    else
+    {
+        glyphPage.dirtyLeft   = std::min(glyphPage.dirtyLeft, x);
+        glyphPage.dirtyTop    = std::min(glyphPage.dirtyTop, y);
+        glyphPage.dirtyRight  = std::max(glyphPage.dirtyRight, x + width);
+        glyphPage.dirtyBottom = std::max(glyphPage.dirtyBottom, y + height);
+    }
+}
+
+void FontAtlas::updateTextureContent(int page)
+{
+    auto& glyphPage = _pages[page];
+    if (glyphPage.dirtyRight <= glyphPage.dirtyLeft || !glyphPage.data)
+        return;
+
+    // 8 pixel aligned columns keep the rows a multiple of any GL_UNPACK_ALIGNMENT left by earlier uploads
+    int left   = glyphPage.dirtyLeft & ~7;
+    int right  = std::min((glyphPage.dirtyRight + 7) & ~7, _width);
+    int top    = std::max(glyphPage.dirtyTop, 0);
+    int bottom = std::min(glyphPage.dirtyBottom, _height);
+    glyphPage.dirtyLeft = glyphPage.dirtyRight = 0;
+    if (bottom <= top)
+        return;
+
+    int width     = right - left;
+    int height    = bottom - top;
+    uint8_t* data = glyphPage.data + ((top * _width + left) << _strideShift);
+    if (width != _width)
+    {
+        const int rowBytes = width << _strideShift;
+        _uploadBuffer.resize(rowBytes * height);
+        for (int row = 0; row < height; ++row)
+            memcpy(_uploadBuffer.data() + row * rowBytes, data + ((row * _width) << _strideShift), rowBytes);
+        data = _uploadBuffer.data();
+    }
+    _atlasTextures[page]->updateWithSubData(data, left, top, width, height);
+}
+
+uint8_t* FontAtlas::takePageBuffer()
+{
+    uint8_t* data = nullptr;
+    // a growing atlas never writes to a full page again, so its buffer goes to the next one
+    if (_pageBudget == 0 && !_pages.empty())
+        std::swap(data, _pages.back().data);
+    if (!data)
+        data = new uint8_t[_currentPageDataSize];
+    return data;
 }
 
 void FontAtlas::addNewPage()
 {
-    memset(_currentPageData, 0, _currentPageDataSize);
-    addNewPageWithData(_currentPageData, _currentPageDataSize);
+    auto data = takePageBuffer();
+    memset(data, 0, _currentPageDataSize);
+    addPage(data);
 
+    _currentPageOrigX = 0;
     _currentPageOrigY = 0;
 }
 
@@ -484,6 +673,13 @@ void FontAtlas::addNewPageWithData(const uint8_t* data, size_t size)
 {
     assert(_currentPageDataSize == size);
 
+    auto pageData = takePageBuffer();
+    memcpy(pageData, data, _currentPageDataSize);
+    addPage(pageData);
+}
+
+void FontAtlas::addPage(uint8_t* data)
+{
     auto texture = new Texture2D();
     texture->initWithData(data, _currentPageDataSize, _pixelFormat, _width, _height);
 
@@ -494,6 +690,22 @@ void FontAtlas::addNewPageWithData(const uint8_t* data, size_t size)
 
     setTexture(++_currentPage, texture);
     texture->release();
+
+    auto& page = _pages.emplace_back();
+    page.packer.reset(_width, _height);
+    page.data        = data;
+    _currentPageData = data;
+}
+
+void FontAtlas::setPageBudget(int maxPages)
+{
+    maxPages = std::max(maxPages, 0);
+    if (_pageBudget != maxPages)
+    {
+        _pageBudget = maxPages;
+        if (!_pages.empty())
+            purgeTexturesAtlas();
+    }
 }
 
 void FontAtlas::setTexture(unsigned int slot, Texture2D* texture)
@@ -32,6 +32,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/PlatformMacros.h"
 #include "base/Object.h"
@@ -40,6 +41,7 @@
 
 #include "base/Map.h"
 #include "2d/FontFreeType.h"
+#include "2d/SkylinePacker.h"
 
 namespace ax
 {
@@ -70,6 +72,7 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    static const char* CMD_EVICT_GLYPHS;
     static void loadFontAtlas(std::string_view fontatlasFile, hlookup::string_map<FontAtlas*>& outAtlasMap);
     /**
      * @js ctor
@@ -127,6 +130,20 @@ public:
     */
     void setAliasTexParameters();
 
+    /** Caps the atlas to maxPages textures. Once they are full, the least recently used glyphs are evicted and
+     * their room is reused for new ones, the Labels of this atlas are laid out again to drop the evicted glyphs.
+     * Glyphs used in the current frame or pinned by a Label are never evicted, the atlas exceeds the budget instead.
+     * 0, the default, lets the atlas add pages as needed. Changing it purges the atlas.
+     */
+    void setPageBudget(int maxPages);
+    int getPageBudget() const { return _pageBudget; }
+
+    /** Keeps the glyphs of the text from being evicted until unpinGlyphs is called with the same text, used by
+     * Labels for the text they show. Does nothing without a page budget.
+     */
+    void pinGlyphs(const std::u32string& utf32Text);
+    void unpinGlyphs(const std::u32string& utf32Text);
+
 protected:
     void initWithSettings(void* opaque /*simdjson::ondemand::document*/);
 
@@ -145,7 +162,38 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
 
-    void updateTextureContent(backend::PixelFormat format, int startY);
+    /** Uploads the dirty part of a page. */
+    void updateTextureContent(int page);
+
+    void addPage(uint8_t* data);
+    uint8_t* takePageBuffer();
+    void releasePages();
+    void markPageDirty(int page, int x, int y, int width, int height);
+    bool allocateGlyph(int width, int height, unsigned int frame, int& page, int& x, int& y);
+    void evictGlyph(char32_t charCode);
+
+    struct GlyphPage
+    {
+        SkylinePacker packer;
+        // copy of the texture, a growing atlas only keeps the one of its current page
+        uint8_t* data   = nullptr;
+        int dirtyLeft   = 0;
+        int dirtyTop    = 0;
+        int dirtyRight  = 0;
+        int dirtyBottom = 0;
+    };
+
+    struct GlyphSlot
+    {
+        int page;
+        int x;
+        int y;
+        int width;
+        int height;
+        unsigned int lastUse;
+        // number of Labels showing the glyph
+        int pins;
+    };
 
     std::unordered_map<unsigned int, Texture2D*> _atlasTextures;
     std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
@@ -174,10 +222,17 @@ protected:
     int _letterPadding      = 0;
     int _letterEdgeExtend   = 0;
 
+    std::vector<GlyphPage> _pages;
+    int _pageBudget = 0;
+    // LRU glyph cache, only used with a page budget
+    std::unordered_map<char32_t, GlyphSlot> _glyphSlots;
+    std::vector<std::pair<unsigned int, char32_t>> _evictionQueue;
+    bool _glyphsEvicted = false;
+    std::vector<uint8_t> _uploadBuffer;
+
     int _fontAscender                               = 0;
     EventListenerCustom* _rendererRecreatedListener = nullptr;
     bool _antialiasEnabled                          = true;
-    int _currLineHeight                             = 0;
 
     friend class Label;
 };
@@ -140,6 +140,7 @@ public:
             _quad.br.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(bx), SPRITE_RENDER_IN_SUBPIXEL(by), _positionZ);
             _quad.tl.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(dx), SPRITE_RENDER_IN_SUBPIXEL(dy), _positionZ);
             _quad.tr.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(cx), SPRITE_RENDER_IN_SUBPIXEL(cy), _positionZ);
+            markQuadDirty();
 
             if (_textureAtlas)
             {
@@ -177,6 +178,7 @@ public:
         _quad.br.colors = color4;
         _quad.tl.colors = color4;
         _quad.tr.colors = color4;
+        markQuadDirty();
 
         _textureAtlas->updateQuad(_quad, _atlasIndex);
     }
@@ -526,6 +528,8 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
             }
             _batchNodes.clear();
             _batchCommands.clear();
+            // the purge dropped the pins with the glyphs
+            _pinnedText.clear();
 
             if (_fontAtlas)
             {
@@ -539,6 +543,7 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
         {
             _fontAtlas      = nullptr;
+            _pinnedText.clear();
             auto lineHeight = _lineHeight;
             this->setTTFConfig(_fontConfig);
             if (_currentLabelType != LabelType::STRING_TEXTURE)
@@ -552,6 +557,15 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    // the atlas reused the room of glyphs this label may show, lay it out again
+    _evictGlyphsListener = EventListenerCustom::create(FontAtlas::CMD_EVICT_GLYPHS, [this](EventCustom* event) {
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_evictGlyphsListener, 3);
 }
 
 Label::~Label()
@@ -560,6 +574,7 @@ Label::~Label()
 
     if (_fontAtlas)
     {
+        unpinGlyphs();
         Node::removeAllChildrenWithCleanup(true);
         AX_SAFE_RELEASE_NULL(_reusedLetter);
         _batchNodes.clear();
@@ -568,6 +583,7 @@ Label::~Label()
     _batchCommands.clear();
     _eventDispatcher->removeEventListener(_purgeTextureListener);
     _eventDispatcher->removeEventListener(_resetTextureListener);
+    _eventDispatcher->removeEventListener(_evictGlyphsListener);
 
     AX_SAFE_RELEASE_NULL(_textSprite);
     AX_SAFE_RELEASE_NULL(_shadowNode);
@@ -589,6 +605,7 @@ void Label::reset()
     _lettersInfo.clear();
     if (_fontAtlas)
     {
+        unpinGlyphs();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
@@ -791,6 +808,7 @@ void Label::setFontAtlas(FontAtlas* atlas, bool distanceFieldEnabled /* = false
     AX_SAFE_RETAIN(atlas);
     if (_fontAtlas)
     {
+        unpinGlyphs();
         _batchNodes.clear();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
@@ -1086,6 +1104,8 @@ bool Label::alignText()
 {
     if (_fontAtlas == nullptr || _utf32Text.empty())
     {
+        if (_fontAtlas)
+            unpinGlyphs();
         setContentSize(Vec2::ZERO);
         return true;
     }
@@ -1094,6 +1114,13 @@ bool Label::alignText()
     do
     {
         _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        if (_fontAtlas->getPageBudget() > 0)
+        {
+            // keep the glyphs shown until the next layout, whether or not the label is drawn every frame
+            _fontAtlas->pinGlyphs(_utf32Text);
+            unpinGlyphs();
+            _pinnedText = _utf32Text;
+        }
         auto& textures = _fontAtlas->getTextures();
         auto size      = textures.size();
         if (size > static_cast<size_t>(_batchNodes.size()))
@@ -1704,12 +1731,22 @@ void Label::setCameraMask(unsigned short mask, bool applyChildren)
     }
 }
 
+void Label::unpinGlyphs()
+{
+    if (!_pinnedText.empty())
+    {
+        _fontAtlas->unpinGlyphs(_pinnedText);
+        _pinnedText.clear();
+    }
+}
+
 void Label::updateContent()
 {
     if (_systemFontDirty)
     {
         if (_fontAtlas)
         {
+            unpinGlyphs();
             _batchNodes.clear();
             _batchCommands.clear();
             AX_SAFE_RELEASE_NULL(_reusedLetter);
@@ -782,6 +782,8 @@ protected:
 
     void updateLabelLetters();
     virtual bool alignText();
+    // drops the pins of the glyphs shown, before the atlas changes
+    void unpinGlyphs();
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
 
@@ -908,6 +910,8 @@ protected:
     Mat4 _shadowTransform;
 
     std::u32string _utf32Text;
+    // text whose glyphs are pinned in a budgeted _fontAtlas
+    std::u32string _pinnedText;
     std::string _utf8Text;
 
     std::string _bmFontPath;
@@ -930,6 +934,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _evictGlyphsListener;
 
 #if AX_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -43,7 +43,9 @@ THE SOFTWARE.
 #include "2d/ActionManager.h"
 #include "2d/Scene.h"
 #include "2d/Component.h"
+#include "2d/TransformSystem.h"
 #include "renderer/Material.h"
+#include "renderer/Renderer.h"
 #include "math/TransformUtils.h"
 #include "renderer/backend/ProgramManager.h"
 #include "renderer/backend/ProgramStateRegistry.h"
@@ -120,7 +122,13 @@ Node::Node()
     , _cascadeColorEnabled(false)
     , _cascadeOpacityEnabled(false)
     , _childFollowCameraMask(false)
+    , _parallelVisitSafe(false)
     , _cameraMask(1)
+    , _transformSystem(nullptr)
+    , _transformIndex(-1)
+    , _transformVersion(0)
+    , _volatileTransform(false)
+    , _modelViewFromWorld(false)
     , _onEnterCallback(nullptr)
     , _onExitCallback(nullptr)
     , _onEnterTransitionDidFinishCallback(nullptr)
@@ -256,8 +264,8 @@ void Node::setSkewX(float skewX)
     if (_skewX == skewX)
         return;
 
-    _skewX            = skewX;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _skewX = skewX;
+    markTransformDirty();
 }
 
 float Node::getSkewY() const
@@ -270,8 +278,8 @@ void Node::setSkewY(float skewY)
     if (_skewY == skewY)
         return;
 
-    _skewY            = skewY;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _skewY = skewY;
+    markTransformDirty();
 }
 
 void Node::setLocalZOrder(int z)
@@ -323,7 +331,7 @@ void Node::setRotation(float rotation)
         return;
 
     _rotationZ_X = _rotationZ_Y = rotation;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 
     updateRotationQuat();
 }
@@ -338,7 +346,7 @@ void Node::setRotation3D(const Vec3& rotation)
     if (_rotationX == rotation.x && _rotationY == rotation.y && _rotationZ_X == rotation.z)
         return;
 
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -391,7 +399,7 @@ void Node::setRotationQuat(const Quaternion& quat)
 {
     _rotationQuat = quat;
     updateRotation3D();
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -404,8 +412,8 @@ void Node::setRotationSkewX(float rotationX)
     if (_rotationZ_X == rotationX)
         return;
 
-    _rotationZ_X      = rotationX;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _rotationZ_X = rotationX;
+    markTransformDirty();
 
     updateRotationQuat();
 }
@@ -420,8 +428,8 @@ void Node::setRotationSkewY(float rotationY)
     if (_rotationZ_Y == rotationY)
         return;
 
-    _rotationZ_Y      = rotationY;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _rotationZ_Y = rotationY;
+    markTransformDirty();
 
     updateRotationQuat();
 }
@@ -440,7 +448,7 @@ void Node::setScale(float scale)
         return;
 
     _scaleX = _scaleY = _scaleZ = scale;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 }
 
 /// scaleX getter
@@ -455,9 +463,9 @@ void Node::setScale(float scaleX, float scaleY)
     if (_scaleX == scaleX && _scaleY == scaleY)
         return;
 
-    _scaleX           = scaleX;
-    _scaleY           = scaleY;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _scaleX = scaleX;
+    _scaleY = scaleY;
+    markTransformDirty();
 }
 
 /// scaleX setter
@@ -466,8 +474,8 @@ void Node::setScaleX(float scaleX)
     if (_scaleX == scaleX)
         return;
 
-    _scaleX           = scaleX;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _scaleX = scaleX;
+    markTransformDirty();
 }
 
 /// scaleY getter
@@ -482,8 +490,8 @@ void Node::setScaleZ(float scaleZ)
     if (_scaleZ == scaleZ)
         return;
 
-    _scaleZ           = scaleZ;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _scaleZ = scaleZ;
+    markTransformDirty();
 }
 
 /// scaleY getter
@@ -498,8 +506,8 @@ void Node::setScaleY(float scaleY)
     if (_scaleY == scaleY)
         return;
 
-    _scaleY           = scaleY;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    _scaleY = scaleY;
+    markTransformDirty();
 }
 
 /// position getter
@@ -528,7 +536,7 @@ void Node::setPosition(float x, float y)
     _position.x = x;
     _position.y = y;
 
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
     _usingNormalizedPosition                            = false;
 }
 
@@ -573,7 +581,7 @@ void Node::setPositionZ(float positionZ)
     if (_positionZ == positionZ)
         return;
 
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 
     _positionZ = positionZ;
 }
@@ -593,7 +601,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _normalizedPosition      = position;
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
-    _transformUpdated = _transformDirty = _inverseDirty = true;
+    markTransformDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -614,7 +622,7 @@ void Node::setVisible(bool visible)
     {
         _visible = visible;
         if (_visible)
-            _transformUpdated = _transformDirty = _inverseDirty = true;
+            markTransformDirty();
     }
 }
 
@@ -635,7 +643,7 @@ void Node::setAnchorPoint(const Vec2& point)
     {
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
-        _transformUpdated = _transformDirty = _inverseDirty = true;
+        markTransformDirty();
     }
 }
 
@@ -652,7 +660,8 @@ void Node::setContentSize(const Vec2& size)
         _contentSize = size;
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
-        _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        _contentSizeDirty = true;
+        markTransformDirty();
     }
 }
 
@@ -672,9 +681,33 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node* parent)
 {
-    _parent           = parent;
+    // the subtree moves to the transform system of its new scene
+    if (_transformSystem)
+        _transformSystem->unregisterNode(this);
+    if (parent && parent->_transformSystem)
+        parent->_transformSystem->registerNode(this, parent);
+
+    _parent                  = parent;
     _normalizedPositionDirty = true;
+    markTransformDirty();
+}
+
+void Node::markTransformDirty()
+{
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    ++_transformVersion;
+    if (_transformSystem)
+        _transformSystem->markDirty(_transformIndex);
+}
+
+void Node::setVolatileTransform(bool isVolatile)
+{
+    if (_volatileTransform == isVolatile)
+        return;
+
+    _volatileTransform = isVolatile;
+    if (_transformSystem)
+        _transformSystem->setVolatile(_transformIndex, isVolatile);
 }
 
 /// isRelativeAnchorPoint getter
@@ -689,7 +722,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     if (newValue != _ignoreAnchorPointForPosition)
     {
         _ignoreAnchorPointForPosition = newValue;
-        _transformUpdated = _transformDirty = _inverseDirty = true;
+        markTransformDirty();
     }
 }
 
@@ -1236,11 +1269,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
         AXASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
         if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
         {
-            auto& s           = _parent->getContentSize();
-            _position.x       = _normalizedPosition.x * s.width;
-            _position.y       = _normalizedPosition.y * s.height;
-            _transformUpdated = _transformDirty = _inverseDirty = true;
-            _normalizedPositionDirty                            = false;
+            auto& s     = _parent->getContentSize();
+            _position.x = _normalizedPosition.x * s.width;
+            _position.y = _normalizedPosition.y * s.height;
+            markTransformDirty();
+            _normalizedPositionDirty = false;
         }
     }
 
@@ -1254,7 +1287,25 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
 
     if (flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
+    {
+        // the transform system has concatenated the transforms already, valid when visited from the parent, i.e.
+        // parentTransform is the world transform of the parent, and not e.g. by a render texture
+        _modelViewFromWorld = false;
+        if (_transformSystem && _transformSystem->isVisitTransformValid())
+        {
+            if (_parent)
+                _modelViewFromWorld =
+                    _parent->_modelViewFromWorld &&
+                    memcmp(parentTransform.m, _parent->_modelViewTransform.m, sizeof(parentTransform.m)) == 0;
+            else
+                _modelViewFromWorld = parentTransform.isIdentity();
+        }
+
+        if (_modelViewFromWorld)
+            _modelViewTransform = _transformSystem->getWorldTransform(_transformIndex);
+        else
+            _modelViewTransform = this->transform(parentTransform);
+    }
 
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1298,7 +1349,10 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
             auto node = _children.at(i);
 
             if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
+            {
+                if (!node->_parallelVisitSafe || !renderer->deferVisit(node, _modelViewTransform, flags))
+                    node->visit(renderer, _modelViewTransform, flags);
+            }
             else
                 break;
         }
@@ -1307,7 +1361,11 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
             this->draw(renderer, _modelViewTransform, flags);
 
         for (auto it = _children.cbegin() + i, itCend = _children.cend(); it != itCend; ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+        {
+            auto node = *it;
+            if (!node->_parallelVisitSafe || !renderer->deferVisit(node, _modelViewTransform, flags))
+                node->visit(renderer, _modelViewTransform, flags);
+        }
     }
     else if (visibleByCamera)
     {
@@ -1803,6 +1861,9 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform        = transform;
     _transformDirty   = false;
     _transformUpdated = true;
+    ++_transformVersion;
+    if (_transformSystem)
+        _transformSystem->markDirty(_transformIndex);
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1838,6 +1899,9 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    ++_transformVersion;
+    if (_transformSystem)
+        _transformSystem->markDirty(_transformIndex);
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -1871,6 +1935,9 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
 
 Mat4 Node::getNodeToWorldTransform() const
 {
+    if (_transformSystem && _transformSystem->isClean())
+        return _transformSystem->getWorldTransform(_transformIndex);
+
     return this->getNodeToParentTransform(nullptr);
 }
 
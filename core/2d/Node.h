@@ -58,6 +58,7 @@ class Component;
 class ComponentContainer;
 class EventDispatcher;
 class Scene;
+class TransformSystem;
 class Renderer;
 class Director;
 class Material;
@@ -1142,6 +1143,23 @@ public:
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit();
 
+    /**
+     * Sets whether the node and its whole subtree can be visited by a JobSystem worker,
+     * @see `Renderer::setParallelVisitEnabled(bool)`.
+     * Only flag the subtrees whose visit and draw update nothing but the state of their own nodes and add commands to
+     * the renderer, e.g. plain sprites: no group or callback commands, no changes to the scene graph or shared caches.
+     *
+     * @param safe true if the subtree can be visited in parallel, false otherwise. Default is false.
+     */
+    void setParallelVisitSafe(bool safe) { _parallelVisitSafe = safe; }
+
+    /**
+     * Whether the node and its whole subtree can be visited by a JobSystem worker.
+     *
+     * @return true if the subtree can be visited in parallel.
+     */
+    bool isParallelVisitSafe() const { return _parallelVisitSafe; }
+
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
      This function recursively calls parent->getScene() until parent is a Scene object. The results are not cached. It
@@ -1879,6 +1897,13 @@ protected:
     Mat4 transform(const Mat4& parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    // set the transform dirty flags, and report the change to the transform system
+    void markTransformDirty();
+
+    // for the nodes whose getNodeToParentTransform changes without the dirty flags: the transform system reads
+    // their transform on every update, and only serves their subtree's world transforms during the visit
+    void setVolatileTransform(bool isVolatile);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -2001,9 +2026,16 @@ protected:
     bool _normalizedPositionDirty;
 
     bool _childFollowCameraMask;
+    bool _parallelVisitSafe;  ///< whether the subtree can be visited by a JobSystem worker
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
 
+    TransformSystem* _transformSystem;  ///< the transform system the node is registered into, if any
+    int _transformIndex;                ///< index of the node in the transform system
+    uint32_t _transformVersion;         ///< incremented on every local transform change
+    bool _volatileTransform;            ///< the transform changes without the dirty flags, e.g. it follows a bone
+    bool _modelViewFromWorld;           ///< _modelViewTransform is the world transform of the transform system
+
 #if AX_ENABLE_SCRIPT_BINDING
     int _scriptHandler;        ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
     int _updateScriptHandler;  ///< script handler for update() callback per frame, which is invoked from lua &
@@ -2042,11 +2074,14 @@ public:
     PhysicsBody* getPhysicsBody() const { return _physicsBody; }
 
     friend class PhysicsBody;
+    friend class PhysicsWorld;
 #endif
 
     static int __attachedNodeCount;
 
 private:
+    friend class TransformSystem;
+
     AX_DISALLOW_COPY_AND_ASSIGN(Node);
 };
 
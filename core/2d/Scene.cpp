@@ -30,11 +30,16 @@ THE SOFTWARE.
 #include "2d/Scene.h"
 #include "base/Director.h"
 #include "2d/Camera.h"
+#include "2d/TransformSystem.h"
 #include "base/EventDispatcher.h"
 #include "base/EventListenerCustom.h"
 #include "base/UTF8.h"
 #include "renderer/Renderer.h"
 
+#if defined(AX_ENABLE_3D)
+#    include "3d/MeshCuller.h"
+#endif
+
 #if defined(AX_ENABLE_PHYSICS)
 #    include "physics/PhysicsWorld.h"
 #endif
@@ -62,6 +67,10 @@ Scene::Scene()
     setAnchorPoint(Vec2(0.5f, 0.5f));
 
     Camera::_visitingCamera = nullptr;
+
+#if defined(AX_ENABLE_3D) && AX_USE_CULLING
+    _meshCuller = new MeshCuller();
+#endif
 }
 
 Scene::~Scene()
@@ -76,6 +85,12 @@ Scene::~Scene()
     _director->getEventDispatcher()->removeEventListener(_event);
     AX_SAFE_RELEASE(_event);
 
+    delete _transformSystem;
+
+#if defined(AX_ENABLE_3D)
+    delete _meshCuller;
+#endif
+
 #if defined(AX_ENABLE_PHYSICS)
     delete _physicsWorld;
 #endif
@@ -186,6 +201,16 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+#if defined(AX_ENABLE_3D)
+    if (_meshCuller)
+    {
+        // the culler compares world transforms, refresh them first so it reads them from the transform system
+        if (_transformSystem)
+            _transformSystem->update();
+        _meshCuller->update();
+    }
+#endif
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -215,8 +240,19 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
         camera->apply();
         // clear background with max depth
         camera->clearBackground();
-        // visit the scene
+        // visit the scene, the cameras changed above are updated by the transform system as well
+        if (_transformSystem)
+        {
+            _transformSystem->update();
+            _transformSystem->setVisiting(true);
+        }
+#if defined(AX_ENABLE_3D)
+        if (_meshCuller)
+            _meshCuller->cull(camera);
+#endif
         visit(renderer, transform, 0);
+        if (_transformSystem)
+            _transformSystem->setVisiting(false);
 #if defined(AX_ENABLE_NAVMESH)
         if (_navMesh && _navMeshDebugCamera == camera)
         {
@@ -260,6 +296,17 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera::_visitingCamera = nullptr;
 }
 
+void Scene::setTransformSystemEnabled(bool enabled)
+{
+    if (enabled == (_transformSystem != nullptr))
+        return;
+
+    if (enabled)
+        _transformSystem = new TransformSystem(this);
+    else
+        AX_SAFE_DELETE(_transformSystem);
+}
+
 void Scene::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
     Node::visit(renderer, parentTransform, parentFlags);
@@ -41,6 +41,10 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class TransformSystem;
+#if defined(AX_ENABLE_3D)
+class MeshCuller;
+#endif
 #if defined(AX_ENABLE_PHYSICS)
 class PhysicsWorld;
 #endif
@@ -130,6 +134,26 @@ public:
 
     void setCameraOrderDirty() { _cameraOrderDirty = true; }
 
+    /** Enable/disable the transform system of the scene.
+     * When enabled, the transforms of the scene graph are kept in flat arrays sorted by depth, and updated in one
+     * linear pass before the visit, @see TransformSystem.
+     * @param enabled Whether the transform system is enabled. Default is false.
+     */
+    void setTransformSystemEnabled(bool enabled);
+
+    /** Get the transform system of the scene.
+     * @return The transform system, nullptr if disabled.
+     */
+    TransformSystem* getTransformSystem() const { return _transformSystem; }
+
+#if defined(AX_ENABLE_3D)
+    /** Get the frustum culler of the mesh renderers of the scene.
+     * The hierarchy is refitted once per render, then queried by each camera before its visit.
+     * @see Camera::getVisibleMeshCount, Camera::getCulledMeshCount
+     */
+    MeshCuller* getMeshCuller() const { return _meshCuller; }
+#endif
+
     void onProjectionChanged(EventCustom* event);
 
 private:
@@ -154,6 +178,12 @@ protected:
 
     std::vector<BaseLight*> _lights;
 
+    TransformSystem* _transformSystem = nullptr;
+
+#if defined(AX_ENABLE_3D)
+    MeshCuller* _meshCuller = nullptr;
+#endif
+
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(Scene);
 
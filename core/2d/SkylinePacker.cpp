@@ -0,0 +1,266 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/SkylinePacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ax
+{
+
+void SkylinePacker::reset(int width, int height)
+{
+    _width    = width;
+    _height   = height;
+    _usedArea = 0;
+    _skyline.clear();
+    _skyline.emplace_back(Segment{0, 0, width});
+    _freeRects.clear();
+}
+
+bool SkylinePacker::insert(int width, int height, int& x, int& y)
+{
+    if (width <= 0 || height <= 0 || width > _width || height > _height)
+        return false;
+
+    if (insertFree(width, height, x, y))
+    {
+        _usedArea += width * height;
+        return true;
+    }
+
+    // bottom-left: lowest top edge first, then the narrowest segment to keep wide gaps for wide rectangles
+    size_t bestIndex = _skyline.size();
+    int bestTop      = std::numeric_limits<int>::max();
+    int bestWidth    = std::numeric_limits<int>::max();
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int restY = fitSegment(i, width, height);
+        if (restY < 0)
+            continue;
+
+        int top = restY + height;
+        if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop   = top;
+            bestWidth = _skyline[i].width;
+            x         = _skyline[i].x;
+            y         = restY;
+        }
+    }
+
+    if (bestIndex == _skyline.size())
+        return false;
+
+    addSegment(bestIndex, x, y, width, height);
+    _usedArea += width * height;
+    return true;
+}
+
+bool SkylinePacker::insertFree(int width, int height, int& x, int& y)
+{
+    // best area fit
+    auto best     = _freeRects.end();
+    int bestWaste = std::numeric_limits<int>::max();
+    for (auto it = _freeRects.begin(); it != _freeRects.end(); ++it)
+    {
+        if (it->width >= width && it->height >= height)
+        {
+            int waste = it->width * it->height - width * height;
+            if (waste < bestWaste)
+            {
+                best      = it;
+                bestWaste = waste;
+            }
+        }
+    }
+
+    if (best == _freeRects.end())
+        return false;
+
+    auto rect = *best;
+    _freeRects.erase(best);
+    x = rect.x;
+    y = rect.y;
+
+    // guillotine split along the shorter leftover axis, so the bigger remainder stays in one piece
+    int rightWidth  = rect.width - width;
+    int belowHeight = rect.height - height;
+    if (rightWidth < belowHeight)
+    {
+        if (rightWidth > 0)
+            _freeRects.emplace_back(FreeRect{rect.x + width, rect.y, rightWidth, height});
+        if (belowHeight > 0)
+            _freeRects.emplace_back(FreeRect{rect.x, rect.y + height, rect.width, belowHeight});
+    }
+    else
+    {
+        if (rightWidth > 0)
+            _freeRects.emplace_back(FreeRect{rect.x + width, rect.y, rightWidth, rect.height});
+        if (belowHeight > 0)
+            _freeRects.emplace_back(FreeRect{rect.x, rect.y + height, width, belowHeight});
+    }
+    return true;
+}
+
+int SkylinePacker::fitSegment(size_t index, int width, int height) const
+{
+    int x = _skyline[index].x;
+    if (x + width > _width)
+        return -1;
+
+    int y         = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        if (i == _skyline.size())
+            return -1;
+
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height)
+            return -1;
+        remaining -= _skyline[i].width;
+    }
+    return y;
+}
+
+void SkylinePacker::addSegment(size_t index, int x, int y, int width, int height)
+{
+    _skyline.insert(_skyline.begin() + index, Segment{x, y + height, width});
+
+    // shrink or drop the segments now covered by the new one
+    const int right = x + width;
+    for (size_t i = index + 1; i < _skyline.size();)
+    {
+        auto& segment = _skyline[i];
+        if (segment.x >= right)
+            break;
+
+        int overlap = right - segment.x;
+        if (overlap >= segment.width)
+        {
+            _skyline.erase(_skyline.begin() + i);
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+
+    mergeSegments();
+}
+
+void SkylinePacker::mergeSegments()
+{
+    // neighbours of equal height become one segment
+    for (size_t i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+            ++i;
+    }
+}
+
+void SkylinePacker::release(int x, int y, int width, int height)
+{
+    _usedArea -= width * height;
+
+    // merge with free neighbours sharing a whole edge, so glyphs released side by side make room for a
+    // bigger one again; each merge may line the result up with another neighbour, hence the rescan
+    FreeRect rect{x, y, width, height};
+    for (auto it = _freeRects.begin(); it != _freeRects.end();)
+    {
+        bool merged = false;
+        if (it->y == rect.y && it->height == rect.height)
+        {
+            if (it->x + it->width == rect.x || rect.x + rect.width == it->x)
+            {
+                rect.x = std::min(rect.x, it->x);
+                rect.width += it->width;
+                merged = true;
+            }
+        }
+        else if (it->x == rect.x && it->width == rect.width)
+        {
+            if (it->y + it->height == rect.y || rect.y + rect.height == it->y)
+            {
+                rect.y = std::min(rect.y, it->y);
+                rect.height += it->height;
+                merged = true;
+            }
+        }
+
+        if (merged)
+        {
+            _freeRects.erase(it);
+            it = _freeRects.begin();
+        }
+        else
+            ++it;
+    }
+    _freeRects.emplace_back(rect);
+}
+
+void SkylinePacker::reserve(int width, int height)
+{
+    width  = std::min(width, _width);
+    height = std::min(height, _height);
+    if (width <= 0 || height <= 0)
+        return;
+
+    // raise the skyline under [0, width) to at least height
+    std::vector<Segment> skyline;
+    skyline.reserve(_skyline.size() + 2);
+    for (auto&& segment : _skyline)
+    {
+        int right = segment.x + segment.width;
+        if (right <= width)
+            skyline.emplace_back(Segment{segment.x, std::max(segment.y, height), segment.width});
+        else if (segment.x >= width)
+            skyline.emplace_back(segment);
+        else
+        {
+            skyline.emplace_back(Segment{segment.x, std::max(segment.y, height), width - segment.x});
+            skyline.emplace_back(Segment{width, segment.y, right - width});
+        }
+    }
+    _skyline.swap(skyline);
+    mergeSegments();
+}
+
+int SkylinePacker::getUsedHeight() const
+{
+    int height = 0;
+    for (auto&& segment : _skyline)
+        height = std::max(height, segment.y);
+    return height;
+}
+
+}  // namespace ax
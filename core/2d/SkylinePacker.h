@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "platform/PlatformMacros.h"
+
+/// @cond DO_NOT_SHOW
+
+namespace ax
+{
+
+/**
+ * Packs rectangles into a fixed size page with the skyline bottom-left heuristic: the page keeps the top
+ * outline of the placed rectangles, and each new rectangle goes where it ends up lowest, filling the gaps
+ * the row by row placement used to leave under short glyphs.
+ * Released rectangles, e.g. of evicted glyphs, are kept in a free list, merged with free neighbours sharing an
+ * edge, and reused guillotine style.
+ */
+class AX_DLL SkylinePacker
+{
+public:
+    SkylinePacker() = default;
+    SkylinePacker(int width, int height) { reset(width, height); }
+
+    /** Empties the page. */
+    void reset(int width, int height);
+
+    /**
+     * Finds room for a rectangle.
+     *
+     * @return false if the page has no room left for it.
+     */
+    bool insert(int width, int height, int& x, int& y);
+
+    /** Gives a rectangle back to the page, later inserts may reuse it. */
+    void release(int x, int y, int width, int height);
+
+    /** Marks the area left of width and below height as used, e.g. for a page restored from a prebuilt atlas. */
+    void reserve(int width, int height);
+
+    /** The highest point of the skyline. */
+    int getUsedHeight() const;
+
+    /** The area taken by the inserted rectangles, in pixels. */
+    int getUsedArea() const { return _usedArea; }
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+private:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct FreeRect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    bool insertFree(int width, int height, int& x, int& y);
+    // returns the y a rectangle would rest at on segment index, or -1 if it doesn't fit there
+    int fitSegment(size_t index, int width, int height) const;
+    void addSegment(size_t index, int x, int y, int width, int height);
+    void mergeSegments();
+
+    std::vector<Segment> _skyline;
+    std::vector<FreeRect> _freeRects;
+    int _width    = 0;
+    int _height   = 0;
+    int _usedArea = 0;
+};
+
+}  // namespace ax
+
+/// @endcond
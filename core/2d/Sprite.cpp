@@ -266,6 +266,7 @@ bool Sprite::initWithPolygon(const ax::PolygonInfo& info)
     {
         _polyInfo   = info;
         _renderMode = RenderMode::POLYGON;
+        markQuadDirty();
         Node::setContentSize(_polyInfo.getRect().size / _director->getContentScaleFactor());
         ret = true;
     }
@@ -300,6 +301,7 @@ bool Sprite::initWithTexture(Texture2D* texture, const Rect& rect, bool rotated)
         _quad.br.colors = Color4B::WHITE;
         _quad.tl.colors = Color4B::WHITE;
         _quad.tr.colors = Color4B::WHITE;
+        markQuadDirty();
 
         // update texture (calls updateBlendFunc)
         setTexture(texture);
@@ -701,6 +703,7 @@ void Sprite::updatePoly()
         // to avoid memcpy'ing stuff
         _polyInfo.setTriangles(triangles);
     }
+    markQuadDirty();
 }
 
 void Sprite::setCenterRectNormalized(const ax::Rect& rectTopLeft)
@@ -876,6 +879,7 @@ void Sprite::setTextureCoords(const Rect& rectInPoints, V3F_C4B_T2F_Quad* outQua
         outQuad->tr.texCoords.u = right;
         outQuad->tr.texCoords.v = top;
     }
+    markQuadDirty();
 }
 
 void Sprite::setVertexCoords(const Rect& rect, V3F_C4B_T2F_Quad* outQuad)
@@ -921,6 +925,7 @@ void Sprite::setVertexCoords(const Rect& rect, V3F_C4B_T2F_Quad* outQuad)
         outQuad->br.vertices.set(x2, y1, 0.0f);
         outQuad->tl.vertices.set(x1, y2, 0.0f);
         outQuad->tr.vertices.set(x2, y2, 0.0f);
+        markQuadDirty();
     }
 }
 
@@ -1089,6 +1094,7 @@ void Sprite::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 #endif
     {
         _trianglesCommand.init(_globalZOrder, _texture, _blendFunc, _polyInfo.triangles, transform, flags);
+        _trianglesCommand.setDataVersion(_quadVersion);
         renderer->addCommand(&_trianglesCommand);
 
 #if AX_SPRITE_DEBUG_DRAW
@@ -1470,6 +1476,7 @@ void Sprite::flipX()
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.x     = _contentSize.width - v.x;
         }
+        markQuadDirty();
     }
     else
         // RenderMode:: Quad or Slice9
@@ -1487,6 +1494,7 @@ void Sprite::flipY()
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.y     = _contentSize.height - v.y;
         }
+        markQuadDirty();
     }
     else
         // RenderMode:: Quad or Slice9
@@ -1516,6 +1524,7 @@ void Sprite::updateColor()
     // when switching from Quad to Slice9, the color will be obtained from _quad
     // so it is important to update _quad colors as well.
     _quad.bl.colors = _quad.tl.colors = _quad.br.colors = _quad.tr.colors = color4;
+    markQuadDirty();
 
     // renders using batch node
     if (_renderMode == RenderMode::QUAD_BATCHNODE)
@@ -1587,6 +1596,7 @@ void Sprite::setSpriteFrame(SpriteFrame* spriteFrame)
     {
         _polyInfo   = spriteFrame->getPolygonInfo();
         _renderMode = RenderMode::POLYGON;
+        markQuadDirty();
         if (_flippedX)
             flipX();
         if (_flippedY)
@@ -1662,6 +1672,7 @@ void Sprite::setBatchNode(SpriteBatchNode* spriteBatchNode)
         _quad.br.vertices.set(x2, y1, 0);
         _quad.tl.vertices.set(x1, y2, 0);
         _quad.tr.vertices.set(x2, y2, 0);
+        markQuadDirty();
     }
     else
     {
@@ -1716,6 +1727,12 @@ void Sprite::setPolygonInfo(const PolygonInfo& info)
 {
     _polyInfo   = info;
     _renderMode = RenderMode::POLYGON;
+    markQuadDirty();
+}
+
+void Sprite::markQuadDirty()
+{
+    _quadVersion = TrianglesCommand::nextDataVersion();
 }
 
 void Sprite::setMVPMatrixUniform()
@@ -672,6 +672,8 @@ protected:
     void updateStretchFactor();
     void populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad);
     void setMVPMatrixUniform();
+    /** Subclasses writing _quad or _polyInfo directly must call it, the renderer may keep the old data otherwise. */
+    void markQuadDirty();
     //
     // Data used when the sprite is rendered using a SpriteSheet
     //
@@ -719,6 +721,7 @@ protected:
     V3F_C4B_T2F* _trianglesVertex   = nullptr;
     unsigned short* _trianglesIndex = nullptr;
     PolygonInfo _polyInfo;
+    uint32_t _quadVersion = 0;  /// data version of _quad and _polyInfo given to _trianglesCommand
 
     // opacity and RGB protocol
     bool _opacityModifyRGB = false;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "2d/SpriteBatchNode.h"
 #include <stddef.h>  // offsetof
+#include <cmath>
 #include "base/Types.h"
 #include "2d/Sprite.h"
 #include "base/Director.h"
@@ -40,10 +41,61 @@ THE SOFTWARE.
 #include "renderer/Shaders.h"
 #include "renderer/backend/ProgramState.h"
 #include "renderer/backend/DriverBase.h"
+#include "renderer/backend/Buffer.h"
 
 namespace ax
 {
 
+static bool s_defaultInstancingEnabled = false;
+
+static bool isReconstructed(float value, float expected)
+{
+    return std::abs(value - expected) <= 1e-5f * (std::max)(1.0f, std::abs(expected));
+}
+
+// Describes a flat, single colored quad as origin + edges, with an axis aligned (optionally rotated) texture rect.
+static bool makeSpriteInstance(const V3F_C4B_T2F_Quad& quad, Vec3& origin, Vec2& xEdge, Vec2& yEdge, Vec2& texSize)
+{
+    const auto& bl = quad.bl;
+    const auto& br = quad.br;
+    const auto& tl = quad.tl;
+    if (br.vertices.z != bl.vertices.z || tl.vertices.z != bl.vertices.z)
+        return false;
+    if (br.colors != bl.colors || tl.colors != bl.colors || quad.tr.colors != bl.colors)
+        return false;
+
+    Vec2 toBr(br.vertices.x - bl.vertices.x, br.vertices.y - bl.vertices.y);
+    Vec2 toTl(tl.vertices.x - bl.vertices.x, tl.vertices.y - bl.vertices.y);
+    Vec2 texToBr(br.texCoords.u - bl.texCoords.u, br.texCoords.v - bl.texCoords.v);
+    Vec2 texToTl(tl.texCoords.u - bl.texCoords.u, tl.texCoords.v - bl.texCoords.v);
+    if (texToBr.y == 0 && texToTl.x == 0)
+    {
+        xEdge   = toBr;
+        yEdge   = toTl;
+        texSize = Vec2(texToBr.x, texToTl.y);
+    }
+    else if (texToBr.x == 0 && texToTl.y == 0)
+    {
+        // rotated sprite frame: u runs along the left edge
+        xEdge   = toTl;
+        yEdge   = toBr;
+        texSize = Vec2(texToTl.x, texToBr.y);
+    }
+    else
+        return false;
+
+    // the instance is a parallelogram, the tr corner must be the one it rebuilds from the other three
+    const auto& tr = quad.tr;
+    if (tr.vertices.z != bl.vertices.z || !isReconstructed(tr.vertices.x, bl.vertices.x + toBr.x + toTl.x) ||
+        !isReconstructed(tr.vertices.y, bl.vertices.y + toBr.y + toTl.y) ||
+        !isReconstructed(tr.texCoords.u, bl.texCoords.u + texToBr.x + texToTl.x) ||
+        !isReconstructed(tr.texCoords.v, bl.texCoords.v + texToBr.y + texToTl.y))
+        return false;
+
+    origin = bl.vertices;
+    return true;
+}
+
 /*
  * creation with Texture2D
  */
@@ -160,11 +212,23 @@ bool SpriteBatchNode::initWithFile(std::string_view fileImage, ssize_t capacity
     return initWithTexture(texture2D, capacity);
 }
 
-SpriteBatchNode::SpriteBatchNode() {}
+SpriteBatchNode::SpriteBatchNode() : _instancingEnabled(s_defaultInstancingEnabled) {}
 
 SpriteBatchNode::~SpriteBatchNode()
 {
     AX_SAFE_RELEASE(_textureAtlas);
+    AX_SAFE_RELEASE(_instanceBuffer);
+    AX_SAFE_RELEASE(_instanceProgramState);
+}
+
+void SpriteBatchNode::setDefaultInstancingEnabled(bool enabled)
+{
+    s_defaultInstancingEnabled = enabled;
+}
+
+bool SpriteBatchNode::isDefaultInstancingEnabled()
+{
+    return s_defaultInstancingEnabled;
 }
 
 // override visit
@@ -429,6 +493,9 @@ void SpriteBatchNode::draw(Renderer* renderer, const Mat4& transform, uint32_t f
         child->updateTransform();
     }
 
+    if (_instancingEnabled && drawInstanced(renderer, transform, flags))
+        return;
+
     const auto& matrixProjection = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     auto programState            = _quadCommand.getPipelineDescriptor().programState;
     programState->setUniform(_mvpMatrixLocaiton, matrixProjection.m, sizeof(matrixProjection.m));
@@ -437,6 +504,69 @@ void SpriteBatchNode::draw(Renderer* renderer, const Mat4& transform, uint32_t f
     renderer->addCommand(&_quadCommand);
 }
 
+bool SpriteBatchNode::drawInstanced(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    // the driver can be replaced, e.g. by the null driver of the tests, don't keep its answer
+    auto supported    = backend::DriverBase::getInstance()->checkForFeatureSupported(backend::FeatureType::INSTANCING);
+    auto programState = _quadCommand.getPipelineDescriptor().programState;
+    if (!supported || !programState ||
+        programState->getProgram()->getProgramType() != backend::ProgramType::POSITION_TEXTURE_COLOR)
+        return false;
+
+    const auto quads = _textureAtlas->getQuads();
+    const auto count = static_cast<size_t>(_textureAtlas->getTotalQuads());
+    _instances.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& instance = _instances[i];
+        if (!makeSpriteInstance(quads[i], instance.origin, instance.xEdge, instance.yEdge, instance.texSize))
+            return false;
+        instance.reserved  = 0;
+        instance.texOrigin = Vec2(quads[i].bl.texCoords.u, quads[i].bl.texCoords.v);
+        instance.color     = Color4F(quads[i].bl.colors);
+    }
+
+    if (!_instanceProgramState)
+    {
+        static const Vec2 corners[]         = {Vec2(0, 0), Vec2(1, 0), Vec2(0, 1), Vec2(1, 1)};
+        static const unsigned short indices[] = {0, 1, 2, 2, 1, 3};
+
+        auto program          = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR_INSTANCE);
+        _instanceProgramState = new backend::ProgramState(program);
+        _instanceMvpLocation     = _instanceProgramState->getUniformLocation("u_MVPMatrix");
+        _instanceTextureLocation = _instanceProgramState->getUniformLocation("u_tex0");
+
+        _instanceCommand.getPipelineDescriptor().programState = _instanceProgramState;
+        _instanceCommand.setDrawType(CustomCommand::DrawType::ELEMENT_INSTANCE);
+        _instanceCommand.createVertexBuffer(sizeof(Vec2), 4, CustomCommand::BufferUsage::STATIC);
+        _instanceCommand.updateVertexBuffer(corners, sizeof(corners));
+        _instanceCommand.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, 6, CustomCommand::BufferUsage::STATIC);
+        _instanceCommand.updateIndexBuffer(indices, sizeof(indices));
+        _instanceCommand.setIndexDrawInfo(0, 6);
+    }
+
+    if (!_instanceBuffer || _instanceCapacity < count)
+    {
+        AX_SAFE_RELEASE(_instanceBuffer);
+        _instanceCapacity = std::max(count, static_cast<size_t>(_textureAtlas->getCapacity()));
+        _instanceBuffer   = backend::DriverBase::getInstance()->newBuffer(
+            _instanceCapacity * sizeof(SpriteInstance), backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
+    }
+    renderer->updateBufferData(_instanceBuffer, _instances.data(), count * sizeof(SpriteInstance));
+
+    // the instances are in batch node space, like the quads
+    const auto& matrixProjection = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 mvp                     = matrixProjection * transform;
+    _instanceProgramState->setUniform(_instanceMvpLocation, mvp.m, sizeof(mvp.m));
+    _instanceProgramState->setTexture(_instanceTextureLocation, 0, _textureAtlas->getTexture()->getBackendTexture());
+
+    _instanceCommand.init(_globalZOrder, transform, flags);
+    _instanceCommand.init(_globalZOrder, _blendFunc);
+    _instanceCommand.setInstanceBuffer(_instanceBuffer, static_cast<int>(count));
+    renderer->addCommand(&_instanceCommand);
+    return true;
+}
+
 void SpriteBatchNode::increaseAtlasCapacity()
 {
     // if we're going beyond the current TextureAtlas's capacity,
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "base/Protocols.h"
 #include "renderer/TextureAtlas.h"
 #include "renderer/QuadCommand.h"
+#include "renderer/CustomCommand.h"
 
 namespace ax
 {
@@ -255,6 +256,18 @@ public:
     bool initWithFile(std::string_view fileImage, ssize_t capacity = DEFAULT_CAPACITY);
     bool init() override;
 
+    /** Enables drawing the sprites instanced: one unit quad drawn once per sprite, with the sprite's corner, edges,
+     * texture rect and color uploaded as a single 64 byte instance, instead of four transformed vertices per sprite.
+     * The batch falls back to the regular quad path when the device doesn't support instancing, when a custom
+     * program state is set, or when a quad can't be described by an instance (3D rotated or per-vertex colored).
+     */
+    void setInstancingEnabled(bool enabled) { _instancingEnabled = enabled; }
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
+    /** Sets whether SpriteBatchNodes created from now on draw instanced, false by default. */
+    static void setDefaultInstancingEnabled(bool enabled);
+    static bool isDefaultInstancingEnabled();
+
 protected:
     /** Updates a quad at a certain index into the texture atlas. The Sprite won't be added into the children array.
      This method should be called only when you are dealing with very big AtlasSprite and when most of the Sprite won't
@@ -268,6 +281,9 @@ protected:
     void setVertexLayout();
     void setUniformLocation();
 
+    /** Issues the batch as an instanced draw, returns false if the regular quad command has to be used instead. */
+    bool drawInstanced(Renderer* renderer, const Mat4& transform, uint32_t flags);
+
     TextureAtlas* _textureAtlas = nullptr;
     BlendFunc _blendFunc;
     QuadCommand _quadCommand;
@@ -279,6 +295,27 @@ protected:
     // There is not need to retain/release these objects, since they are already retained by _children
     // So, using std::vector<Sprite*> is slightly faster than using ax::Array for this particular case
     std::vector<Sprite*> _descendants;
+
+    /** Per sprite instance data, read as a mat4 by positionTextureColorInstance.vert */
+    struct SpriteInstance
+    {
+        Vec3 origin;
+        float reserved;
+        Vec2 xEdge;
+        Vec2 yEdge;
+        Vec2 texOrigin;
+        Vec2 texSize;
+        Color4F color;
+    };
+
+    bool _instancingEnabled = false;
+    CustomCommand _instanceCommand;
+    backend::ProgramState* _instanceProgramState = nullptr;
+    backend::Buffer* _instanceBuffer             = nullptr;
+    size_t _instanceCapacity                     = 0;
+    std::vector<SpriteInstance> _instances;
+    backend::UniformLocation _instanceMvpLocation;
+    backend::UniformLocation _instanceTextureLocation;
 };
 
 // end of sprite_nodes group
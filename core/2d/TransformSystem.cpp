@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/TransformSystem.h"
+#include "2d/Node.h"
+
+namespace ax
+{
+
+TransformSystem::TransformSystem(Node* root) : _root(root) {}
+
+TransformSystem::~TransformSystem()
+{
+    for (auto node : _nodes)
+    {
+        if (node)
+            node->_transformSystem = nullptr;
+    }
+}
+
+void TransformSystem::update()
+{
+    if (_structureDirty)
+        rebuild();
+    if (_clean && !_volatileCount)
+        return;
+
+    auto nodes   = _nodes.data();
+    auto parents = _parents.data();
+    auto locals  = _locals.data();
+    auto worlds  = _worlds.data();
+    for (size_t i = 0, count = _nodes.size(); i < count; ++i)
+    {
+        // an unregistered slot, its descendants are unregistered too
+        if (!nodes[i])
+            continue;
+
+        auto parent = parents[i];
+        bool local  = _localDirty[i] || _volatile[i];
+        bool dirty  = local || (parent >= 0 && _worldDirty[parent]);
+
+        // only the nodes which changed are read
+        if (local)
+        {
+            locals[i]      = nodes[i]->getNodeToParentTransform();
+            _localDirty[i] = 0;
+        }
+
+        if (dirty)
+        {
+            if (parent >= 0)
+                Mat4::multiply(worlds[parent], locals[i], &worlds[i]);
+            else
+                worlds[i] = locals[i];
+        }
+        _worldDirty[i] = dirty;
+    }
+
+    // the model-view transforms of the visit start from the transform of the root
+    _rootIdentity = !_nodes.empty() && _worlds[0].isIdentity() && !_root->getParent();
+    _clean        = true;
+}
+
+void TransformSystem::registerNode(Node* node, Node* parent)
+{
+    // the rebuild registers the whole scene graph
+    if (_structureDirty || parent->_transformSystem != this)
+        return;
+
+    // breadth first from the end of the arrays, the parents stay before their children
+    auto first = _nodes.size();
+    append(node, parent->_transformIndex);
+    for (size_t i = first; i < _nodes.size(); ++i)
+    {
+        for (auto child : _nodes[i]->getChildren())
+            append(child, static_cast<int>(i));
+    }
+    _clean = false;
+}
+
+void TransformSystem::unregisterNode(Node* node)
+{
+    if (node->_transformSystem != this)
+        return;
+
+    auto index         = node->_transformIndex;
+    _nodes[index]      = nullptr;
+    _worldDirty[index] = 0;
+    setVolatile(index, false);
+    node->_transformSystem = nullptr;
+    node->_transformIndex  = -1;
+
+    // compact the arrays once they're mostly unregistered slots
+    if (++_removedCount > _nodes.size() / 2)
+        markStructureDirty();
+
+    for (auto child : node->getChildren())
+        unregisterNode(child);
+}
+
+void TransformSystem::setVolatile(int index, bool isVolatile)
+{
+    if (_volatile[index] == isVolatile)
+        return;
+
+    _volatile[index] = isVolatile;
+    if (isVolatile)
+    {
+        ++_volatileCount;
+        _clean = false;
+    }
+    else
+        --_volatileCount;
+}
+
+void TransformSystem::append(Node* node, int parent)
+{
+    auto index = static_cast<int>(_nodes.size());
+    _nodes.emplace_back(node);
+    _parents.emplace_back(parent);
+    _locals.emplace_back();
+    _worlds.emplace_back();
+    _localDirty.emplace_back(1);
+    _worldDirty.emplace_back(1);
+    _volatile.emplace_back(0);
+
+    node->_transformSystem = this;
+    node->_transformIndex  = index;
+    setVolatile(index, node->_volatileTransform);
+}
+
+void TransformSystem::rebuild()
+{
+    for (auto node : _nodes)
+    {
+        if (node)
+            node->_transformSystem = nullptr;
+    }
+
+    _nodes.clear();
+    _parents.clear();
+    _locals.clear();
+    _worlds.clear();
+    _localDirty.clear();
+    _worldDirty.clear();
+    _volatile.clear();
+    _volatileCount = 0;
+    _removedCount  = 0;
+
+    // breadth first, so the nodes are sorted by depth
+    append(_root, -1);
+    for (size_t i = 0; i < _nodes.size(); ++i)
+    {
+        for (auto child : _nodes[i]->getChildren())
+            append(child, static_cast<int>(i));
+    }
+
+    _structureDirty = false;
+    _clean          = false;
+}
+
+}  // namespace ax
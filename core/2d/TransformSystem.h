@@ -0,0 +1,141 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "platform/PlatformMacros.h"
+#include "math/Mat4.h"
+
+namespace ax
+{
+
+class Node;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TransformSystem
+ * @brief Keeps the transforms of a scene graph in flat arrays, and updates them in one linear pass.
+ *
+ * The nodes are laid out breadth first, and a reparented subtree is appended at the end, so a parent always comes
+ * before its children: for every node the arrays hold the parent index, the node to parent matrix and the node to
+ * world matrix. The nodes report their transform changes, the update pass only reads the dirty nodes, the world
+ * matrices are concatenated with Mat4::multiply which uses the SSE/NEON paths of MathUtil.
+ *
+ * While it's up to date, Node::getNodeToWorldTransform and the model-view transforms of the visit read the
+ * world matrices instead of walking up the parents. Enabled by Scene::setTransformSystemEnabled.
+ * @note A node class overriding getNodeToParentTransform() must report its changes with the usual dirty flags, or
+ * be marked with Node::setVolatileTransform, e.g. AttachNode which follows a bone.
+ */
+class AX_DLL TransformSystem
+{
+public:
+    /** Creates the system for the scene graph of root, the nodes are registered by the first update. */
+    explicit TransformSystem(Node* root);
+    ~TransformSystem();
+
+    /** Registers the nodes again if the scene graph changed, then updates the dirty world transforms. */
+    void update();
+
+    /** Marks the node to parent transform of the node at index as changed, also called by the parallel visits. */
+    void markDirty(int index)
+    {
+        _localDirty[index] = 1;
+        _clean.store(false, std::memory_order_relaxed);
+    }
+
+    /** Marks the scene graph as changed, the nodes are registered again by the next update. */
+    void markStructureDirty()
+    {
+        _structureDirty = true;
+        _clean          = false;
+    }
+
+    /** Registers the node and its descendants under parent, which is registered, e.g. when it's added to parent. */
+    void registerNode(Node* node, Node* parent);
+
+    /** Unregisters the node and its descendants, e.g. when it's removed from its parent. */
+    void unregisterNode(Node* node);
+
+    /** Whether the node to parent transform of the node at index is read by every update. */
+    void setVolatile(int index, bool isVolatile);
+
+    /** Whether nothing changed since the last update, i.e. the world transforms can be read. */
+    bool isClean() const { return _clean.load(std::memory_order_relaxed); }
+
+    /** Gets the node to world transform of the node at index, only valid while isClean() */
+    const Mat4& getWorldTransform(int index) const { return _worlds[index]; }
+
+    /**
+     * Set by the scene while it's visited: the model-view transforms can come from the world transforms. The world
+     * transforms below volatile nodes are only valid until the end of the visit.
+     */
+    void setVisiting(bool visiting)
+    {
+        _visiting = visiting;
+        if (!visiting && _volatileCount)
+            _clean = false;
+    }
+
+    /** Whether the model-view transforms of the current visit are the world transforms. */
+    bool isVisitTransformValid() const { return _visiting && _rootIdentity && _clean.load(std::memory_order_relaxed); }
+
+    /** Gets the number of registered nodes. */
+    size_t getNodeCount() const { return _nodes.size() - _removedCount; }
+
+protected:
+    void rebuild();
+    void append(Node* node, int parent);
+
+    Node* _root = nullptr;
+
+    // the nodes sorted by depth, and their transforms
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<Mat4> _locals;
+    std::vector<Mat4> _worlds;
+    std::vector<uint8_t> _localDirty;
+    std::vector<uint8_t> _worldDirty;
+    std::vector<uint8_t> _volatile;
+
+    size_t _volatileCount = 0;
+    size_t _removedCount  = 0;  ///< the unregistered slots, the arrays are compacted by a rebuild
+
+    bool _structureDirty = true;
+    std::atomic<bool> _clean{false};  ///< cleared by the nodes of the parallel visits too
+    bool _visiting     = false;
+    bool _rootIdentity = false;
+};
+
+// end of _2d group
+/// @}
+
+}  // namespace ax
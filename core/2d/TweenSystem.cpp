@@ -0,0 +1,474 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/TweenSystem.h"
+#include "2d/Node.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace ax
+{
+
+// Eases a lane in place, the common curves get their own loop so they vectorize
+static void ease(tweenfunc::TweenType easing, float* time, size_t count)
+{
+    switch (easing)
+    {
+    case tweenfunc::Linear:
+        break;
+    case tweenfunc::Quad_EaseIn:
+        for (size_t i = 0; i < count; ++i)
+            time[i] = time[i] * time[i];
+        break;
+    case tweenfunc::Quad_EaseOut:
+        for (size_t i = 0; i < count; ++i)
+            time[i] = time[i] * (2 - time[i]);
+        break;
+    case tweenfunc::Cubic_EaseIn:
+        for (size_t i = 0; i < count; ++i)
+            time[i] = time[i] * time[i] * time[i];
+        break;
+    case tweenfunc::Cubic_EaseOut:
+        for (size_t i = 0; i < count; ++i)
+        {
+            float t = time[i] - 1;
+            time[i] = t * t * t + 1;
+        }
+        break;
+    default:
+        for (size_t i = 0; i < count; ++i)
+            time[i] = tweenfunc::tweenTo(time[i], easing, nullptr);
+        break;
+    }
+}
+
+TweenSystem::TweenSystem() {}
+
+TweenSystem::~TweenSystem()
+{
+    stopAll();
+}
+
+unsigned int TweenSystem::moveTo(Node* target, float duration, const Vec2& position, tweenfunc::TweenType easing)
+{
+    const auto& from = target->getPosition();
+    const float start[] = {from.x, from.y};
+    const float end[]   = {position.x, position.y};
+    return add(target, Property::Position, easing, duration, start, end);
+}
+
+unsigned int TweenSystem::moveBy(Node* target, float duration, const Vec2& deltaPosition, tweenfunc::TweenType easing)
+{
+    return moveTo(target, duration, target->getPosition() + deltaPosition, easing);
+}
+
+unsigned int TweenSystem::scaleTo(Node* target, float duration, float scale, tweenfunc::TweenType easing)
+{
+    return scaleTo(target, duration, scale, scale, easing);
+}
+
+unsigned int TweenSystem::scaleTo(Node* target,
+                                  float duration,
+                                  float scaleX,
+                                  float scaleY,
+                                  tweenfunc::TweenType easing)
+{
+    const float start[] = {target->getScaleX(), target->getScaleY()};
+    const float end[]   = {scaleX, scaleY};
+    return add(target, Property::Scale, easing, duration, start, end);
+}
+
+unsigned int TweenSystem::scaleBy(Node* target, float duration, float scale, tweenfunc::TweenType easing)
+{
+    return scaleTo(target, duration, target->getScaleX() * scale, target->getScaleY() * scale, easing);
+}
+
+unsigned int TweenSystem::rotateTo(Node* target, float duration, float angle, tweenfunc::TweenType easing)
+{
+    auto diff = std::fmod(angle - target->getRotation(), 360.0f);
+    if (diff > 180)
+        diff -= 360;
+    else if (diff < -180)
+        diff += 360;
+    return rotateBy(target, duration, diff, easing);
+}
+
+unsigned int TweenSystem::rotateBy(Node* target, float duration, float deltaAngle, tweenfunc::TweenType easing)
+{
+    const float start[] = {target->getRotation()};
+    const float end[]   = {start[0] + deltaAngle};
+    return add(target, Property::Rotation, easing, duration, start, end);
+}
+
+unsigned int TweenSystem::fadeTo(Node* target, float duration, uint8_t opacity, tweenfunc::TweenType easing)
+{
+    const float start[] = {static_cast<float>(target->getOpacity())};
+    const float end[]   = {static_cast<float>(opacity)};
+    return add(target, Property::Opacity, easing, duration, start, end);
+}
+
+unsigned int TweenSystem::fadeIn(Node* target, float duration, tweenfunc::TweenType easing)
+{
+    return fadeTo(target, duration, 255, easing);
+}
+
+unsigned int TweenSystem::fadeOut(Node* target, float duration, tweenfunc::TweenType easing)
+{
+    return fadeTo(target, duration, 0, easing);
+}
+
+unsigned int TweenSystem::tintTo(Node* target, float duration, const Color3B& color, tweenfunc::TweenType easing)
+{
+    const auto& from    = target->getColor();
+    const float start[] = {static_cast<float>(from.r), static_cast<float>(from.g), static_cast<float>(from.b)};
+    const float end[]   = {static_cast<float>(color.r), static_cast<float>(color.g), static_cast<float>(color.b)};
+    return add(target, Property::Color, easing, duration, start, end);
+}
+
+unsigned int TweenSystem::add(Node* target,
+                              Property property,
+                              tweenfunc::TweenType easing,
+                              float duration,
+                              const float* from,
+                              const float* to)
+{
+    AXASSERT(target, "Argument target must be non-nullptr");
+    AXASSERT(!_updating, "Tweens can't be added while the TweenSystem writes the nodes");
+    AXASSERT(easing != tweenfunc::CUSTOM_EASING, "Custom easing needs parameters, use ActionTween instead");
+
+    auto laneIt = std::find_if(_lanes.begin(), _lanes.end(), [property, easing](const Lane& lane) {
+        return lane.property == property && lane.easing == easing;
+    });
+    if (laneIt == _lanes.end())
+    {
+        laneIt             = _lanes.emplace(_lanes.end());
+        laneIt->property   = property;
+        laneIt->easing     = easing;
+        switch (property)
+        {
+        case Property::Position:
+        case Property::Scale:
+            laneIt->components = 2;
+            break;
+        case Property::Color:
+            laneIt->components = 3;
+            break;
+        default:
+            laneIt->components = 1;
+            break;
+        }
+    }
+    auto& lane = *laneIt;
+
+    // a target starts paused while it isn't running, like its actions
+    auto targetIt = _targets.find(target);
+    if (targetIt == _targets.end())
+    {
+        target->retain();
+        targetIt = _targets.emplace(target, TargetState{{}, !target->isRunning()}).first;
+    }
+
+    auto id = _nextId++;
+    if (_nextId == 0)
+        _nextId = 1;
+    targetIt->second.tweens.emplace_back(id);
+    _slots.emplace(id, Slot{static_cast<uint32_t>(laneIt - _lanes.begin()), static_cast<uint32_t>(lane.ids.size())});
+
+    lane.targets.emplace_back(target);
+    lane.ids.emplace_back(id);
+    lane.elapsed.emplace_back(0.0f);
+    // prevent division by 0, like ActionInterval
+    lane.invDurations.emplace_back(1.0f / (std::max)(duration, FLT_EPSILON));
+    lane.running.emplace_back(targetIt->second.paused ? 0.0f : 1.0f);
+    for (int c = 0; c < lane.components; ++c)
+    {
+        lane.from[c].emplace_back(from[c]);
+        lane.delta[c].emplace_back(to[c] - from[c]);
+    }
+    return id;
+}
+
+void TweenSystem::setCompletionCallback(unsigned int tween, std::function<void()> callback)
+{
+    if (isRunning(tween))
+        _completionCallbacks[tween] = std::move(callback);
+}
+
+void TweenSystem::stop(unsigned int tween)
+{
+    auto slotIt = _slots.find(tween);
+    if (slotIt == _slots.end())
+        return;
+
+    if (_updating)
+    {
+        // removed once the lanes are written
+        _lanes[slotIt->second.lane].running[slotIt->second.index] = 0;
+        _finished.emplace_back(FinishedTween{tween, false});
+        return;
+    }
+    _completionCallbacks.erase(tween);
+    remove(tween);
+}
+
+void TweenSystem::remove(unsigned int tween)
+{
+    auto slotIt = _slots.find(tween);
+    if (slotIt == _slots.end())
+        return;
+
+    auto& lane        = _lanes[slotIt->second.lane];
+    const auto index  = slotIt->second.index;
+    const auto last   = lane.ids.size() - 1;
+    const auto target = lane.targets[index];
+    _slots.erase(slotIt);
+
+    // move the last tween of the lane into the hole
+    auto swapPop = [index, last](auto& values) {
+        values[index] = values[last];
+        values.pop_back();
+    };
+    if (index != last)
+        _slots[lane.ids[last]].index = index;
+    swapPop(lane.targets);
+    swapPop(lane.ids);
+    swapPop(lane.elapsed);
+    swapPop(lane.invDurations);
+    swapPop(lane.running);
+    for (int c = 0; c < lane.components; ++c)
+    {
+        swapPop(lane.from[c]);
+        swapPop(lane.delta[c]);
+    }
+
+    auto targetIt = _targets.find(target);
+    auto& tweens  = targetIt->second.tweens;
+    auto tweenIt  = std::find(tweens.begin(), tweens.end(), tween);
+    *tweenIt      = tweens.back();
+    tweens.pop_back();
+    if (tweens.empty())
+    {
+        _targets.erase(targetIt);
+        target->release();
+    }
+}
+
+void TweenSystem::stopAllForTarget(Node* target)
+{
+    auto targetIt = _targets.find(target);
+    if (targetIt == _targets.end())
+        return;
+
+    // stopping the last tween erases the target state
+    auto tweens = targetIt->second.tweens;
+    for (auto tween : tweens)
+        stop(tween);
+}
+
+void TweenSystem::stopAll()
+{
+    std::vector<unsigned int> tweens;
+    tweens.reserve(_slots.size());
+    for (auto& [tween, slot] : _slots)
+        tweens.emplace_back(tween);
+    for (auto tween : tweens)
+        stop(tween);
+}
+
+void TweenSystem::setTargetRunning(const TargetState& state, float running)
+{
+    for (auto tween : state.tweens)
+    {
+        const auto& slot                      = _slots[tween];
+        _lanes[slot.lane].running[slot.index] = running;
+    }
+}
+
+void TweenSystem::pauseTarget(Node* target)
+{
+    auto targetIt = _targets.find(target);
+    if (targetIt != _targets.end() && !targetIt->second.paused)
+    {
+        targetIt->second.paused = true;
+        setTargetRunning(targetIt->second, 0);
+    }
+}
+
+void TweenSystem::resumeTarget(Node* target)
+{
+    auto targetIt = _targets.find(target);
+    if (targetIt != _targets.end() && targetIt->second.paused)
+    {
+        targetIt->second.paused = false;
+        setTargetRunning(targetIt->second, 1);
+    }
+}
+
+std::vector<Node*> TweenSystem::pauseAllTargets()
+{
+    std::vector<Node*> paused;
+    for (auto& [target, state] : _targets)
+    {
+        if (!state.paused)
+        {
+            state.paused = true;
+            paused.emplace_back(target);
+        }
+    }
+    for (auto& lane : _lanes)
+        std::fill(lane.running.begin(), lane.running.end(), 0.0f);
+    return paused;
+}
+
+size_t TweenSystem::getTweenCountForTarget(const Node* target) const
+{
+    auto targetIt = _targets.find(const_cast<Node*>(target));
+    return targetIt != _targets.end() ? targetIt->second.tweens.size() : 0;
+}
+
+void TweenSystem::update(float dt)
+{
+    if (_slots.empty())
+        return;
+
+    _updating = true;
+    for (auto& lane : _lanes)
+    {
+        if (!lane.ids.empty())
+            updateLane(lane, dt);
+    }
+    _updating = false;
+
+    // the callbacks may add or stop tweens, so they are called once all lanes were written
+    for (size_t i = 0; i < _finished.size(); ++i)
+    {
+        auto finished = _finished[i];
+        if (!isRunning(finished.id))
+            continue;
+
+        std::function<void()> callback;
+        auto callbackIt = _completionCallbacks.find(finished.id);
+        if (callbackIt != _completionCallbacks.end())
+        {
+            if (finished.completed)
+                callback = std::move(callbackIt->second);
+            _completionCallbacks.erase(callbackIt);
+        }
+        remove(finished.id);
+        if (callback)
+            callback();
+    }
+    _finished.clear();
+}
+
+void TweenSystem::updateLane(Lane& lane, float dt)
+{
+    const size_t count = lane.ids.size();
+    lane.progress.resize(count);
+    for (int c = 0; c < lane.components; ++c)
+        lane.values[c].resize(count);
+
+    float* elapsed            = lane.elapsed.data();
+    float* progress           = lane.progress.data();
+    const float* invDurations = lane.invDurations.data();
+    const float* running      = lane.running.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        elapsed[i] += dt * running[i];
+        progress[i] = (std::min)(elapsed[i] * invDurations[i], 1.0f);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (progress[i] >= 1.0f && running[i] != 0)
+            _finished.emplace_back(FinishedTween{lane.ids[i], true});
+    }
+
+    ease(lane.easing, progress, count);
+
+    // opacities and colors are clamped, as easings like Back and Elastic overshoot
+    const bool clamped = lane.property == Property::Opacity || lane.property == Property::Color;
+    for (int c = 0; c < lane.components; ++c)
+    {
+        float* values      = lane.values[c].data();
+        const float* from  = lane.from[c].data();
+        const float* delta = lane.delta[c].data();
+        for (size_t i = 0; i < count; ++i)
+            values[i] = from[i] + delta[i] * progress[i];
+        if (clamped)
+        {
+            for (size_t i = 0; i < count; ++i)
+                values[i] = std::clamp(values[i], 0.0f, 255.0f);
+        }
+    }
+
+    // write back, the paused tweens leave their nodes untouched
+    auto targets   = lane.targets.data();
+    const float* x = lane.values[0].data();
+    const float* y = lane.values[1].data();
+    const float* z = lane.values[2].data();
+    switch (lane.property)
+    {
+    case Property::Position:
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (running[i] != 0)
+                targets[i]->setPosition(x[i], y[i]);
+        }
+        break;
+    case Property::Scale:
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (running[i] != 0)
+                targets[i]->setScale(x[i], y[i]);
+        }
+        break;
+    case Property::Rotation:
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (running[i] != 0)
+                targets[i]->setRotation(x[i]);
+        }
+        break;
+    case Property::Opacity:
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (running[i] != 0)
+                targets[i]->setOpacity(static_cast<uint8_t>(x[i]));
+        }
+        break;
+    case Property::Color:
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (running[i] != 0)
+                targets[i]->setColor(
+                    Color3B(static_cast<uint8_t>(x[i]), static_cast<uint8_t>(y[i]), static_cast<uint8_t>(z[i])));
+        }
+        break;
+    }
+}
+
+}  // namespace ax
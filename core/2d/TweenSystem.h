@@ -0,0 +1,182 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <stdint.h>
+
+#include "platform/PlatformMacros.h"
+#include "2d/TweenFunction.h"
+#include "math/Vec2.h"
+#include "base/Types.h"
+
+namespace ax
+{
+
+class Node;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TweenSystem
+ * @brief Runs simple property tweens in batches, for animating thousands of nodes.
+ *
+ * The tweens are grouped in lanes by property and easing. Every lane keeps its tweens in flat arrays, so an update
+ * advances the times, eases and interpolates a whole lane in tight loops and then writes the values back to the
+ * nodes in one pass. The functions mirror MoveTo, MoveBy, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn,
+ * FadeOut and TintTo, the start values are read when the tween is added.
+ *
+ * The ActionManager owns one and updates it after the actions: the tweens of a node pause, resume and stop with its
+ * actions. A tween returns an id which can be stopped or given a completion callback.
+ */
+class AX_DLL TweenSystem
+{
+public:
+    TweenSystem();
+    ~TweenSystem();
+
+    unsigned int moveTo(Node* target,
+                        float duration,
+                        const Vec2& position,
+                        tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int moveBy(Node* target,
+                        float duration,
+                        const Vec2& deltaPosition,
+                        tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int scaleTo(Node* target, float duration, float scale, tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int scaleTo(Node* target,
+                         float duration,
+                         float scaleX,
+                         float scaleY,
+                         tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int scaleBy(Node* target, float duration, float scale, tweenfunc::TweenType easing = tweenfunc::Linear);
+    /** Rotates to angle the shorter way round, like RotateTo. */
+    unsigned int rotateTo(Node* target, float duration, float angle, tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int rotateBy(Node* target,
+                          float duration,
+                          float deltaAngle,
+                          tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int fadeTo(Node* target, float duration, uint8_t opacity, tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int fadeIn(Node* target, float duration, tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int fadeOut(Node* target, float duration, tweenfunc::TweenType easing = tweenfunc::Linear);
+    unsigned int tintTo(Node* target,
+                        float duration,
+                        const Color3B& color,
+                        tweenfunc::TweenType easing = tweenfunc::Linear);
+
+    /** Sets a function called once the tween finished, it isn't called when the tween is stopped. */
+    void setCompletionCallback(unsigned int tween, std::function<void()> callback);
+
+    /** Whether the tween is still running, or paused. */
+    bool isRunning(unsigned int tween) const { return _slots.find(tween) != _slots.end(); }
+
+    void stop(unsigned int tween);
+    void stopAllForTarget(Node* target);
+    void stopAll();
+
+    /** Pauses the tweens of target, including the ones added while it's paused. */
+    void pauseTarget(Node* target);
+    void resumeTarget(Node* target);
+    /** Pauses the tweens of all targets, returns the targets which weren't paused. */
+    std::vector<Node*> pauseAllTargets();
+
+    size_t getTweenCount() const { return _slots.size(); }
+    size_t getTweenCountForTarget(const Node* target) const;
+
+    void update(float dt);
+
+protected:
+    enum class Property
+    {
+        Position,
+        Scale,
+        Rotation,
+        Opacity,
+        Color,
+    };
+
+    // The tweens of a property and easing, one array per field
+    struct Lane
+    {
+        Property property;
+        tweenfunc::TweenType easing;
+        int components;
+        std::vector<Node*> targets;
+        std::vector<unsigned int> ids;
+        std::vector<float> elapsed;
+        std::vector<float> invDurations;
+        std::vector<float> running;  // 1 while running, 0 while paused so the time loop doesn't branch
+        std::vector<float> from[3];
+        std::vector<float> delta[3];
+        std::vector<float> progress;  // scratch arrays of the update
+        std::vector<float> values[3];
+    };
+
+    struct Slot
+    {
+        uint32_t lane;
+        uint32_t index;
+    };
+
+    struct TargetState
+    {
+        std::vector<unsigned int> tweens;  // so stopping or pausing a target doesn't scan the lanes
+        bool paused;
+    };
+
+    struct FinishedTween
+    {
+        unsigned int id;
+        bool completed;  // false if stopped while updating
+    };
+
+    unsigned int add(Node* target,
+                     Property property,
+                     tweenfunc::TweenType easing,
+                     float duration,
+                     const float* from,
+                     const float* to);
+    void remove(unsigned int tween);
+    void setTargetRunning(const TargetState& state, float running);
+    void updateLane(Lane& lane, float dt);
+
+    std::vector<Lane> _lanes;
+    std::unordered_map<unsigned int, Slot> _slots;
+    std::unordered_map<Node*, TargetState> _targets;  // the targets are retained while they have tweens
+    std::unordered_map<unsigned int, std::function<void()>> _completionCallbacks;
+    std::vector<FinishedTween> _finished;
+    unsigned int _nextId = 1;
+    bool _updating       = false;
+};
+
+// end of _2d group
+/// @}
+
+}  // namespace ax
@@ -32,6 +32,7 @@
 #include "base/EventCustom.h"
 #include "base/Director.h"
 #include "base/EventDispatcher.h"
+#include "base/JobSystem.h"
 
 namespace ax
 {
@@ -39,7 +40,9 @@ namespace ax
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeInAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeOutAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_runningAnimates;
-float Animate3D::_transTime = 0.1f;
+std::vector<Animate3D::PendingSample> Animate3D::s_pendingSamples;
+bool Animate3D::s_parallelSampling = false;
+float Animate3D::_transTime        = 0.1f;
 
 // create Animate3D using Animation.
 Animate3D* Animate3D::create(Animation3D* animation)
@@ -228,6 +231,19 @@ void Animate3D::startWithTarget(Node* target)
         {
             AXLOGW("warning: no animation found for the skeleton");
         }
+
+        _sampledBones.clear();
+        _translateTracks.clear();
+        _rotTracks.clear();
+        _scaleTracks.clear();
+        for (const auto& it : _boneCurves)
+        {
+            _sampledBones.emplace_back(it.first);
+            _translateTracks.emplace_back(it.second->translateTrack);
+            _rotTracks.emplace_back(it.second->rotTrack);
+            _scaleTracks.emplace_back(it.second->scaleTrack);
+        }
+        _trackCursors.assign(_animation ? _animation->getTracks().keyCounts.size() : 0, 0);
     }
 
     auto runningAction = s_runningAnimates.find(target);
@@ -274,6 +290,12 @@ void Animate3D::startWithTarget(Node* target)
 
 void Animate3D::stop()
 {
+    if (_samplePending)
+    {  // the last update of a finished action must still reach the bones
+        _samplePending = false;
+        sampleBones(_pendingSampleTime);
+    }
+
     removeFromMap();
 
     ActionInterval::stop();
@@ -336,7 +358,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float *trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse)
                 {
                     t        = 1 - t;
@@ -346,26 +367,23 @@ void Animate3D::update(float t)
                 t        = _start + t * _last;
                 lastTime = _start + lastTime * _last;
 
-                for (const auto& it : _boneCurves)
+                if (!_sampledBones.empty())
                 {
-                    auto bone  = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
+                    if (s_parallelSampling)
                     {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
+                        if (!_samplePending)
+                        {
+                            _samplePending = true;
+                            retain();
+                            _target->retain();
+                            s_pendingSamples.emplace_back(PendingSample{this, _target});
+                        }
+                        _pendingSampleTime = t;
                     }
-                    if (curve->scaleCurve)
+                    else
                     {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
+                        sampleBones(t);
                     }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
                 }
 
                 for (const auto& it : _nodeCurves)
@@ -423,6 +441,89 @@ void Animate3D::update(float t)
     }
 }
 
+void Animate3D::sampleBones(float t)
+{
+    thread_local std::vector<float> translations, rotations, scales;
+    auto count = _sampledBones.size();
+    translations.resize(count * 4);
+    rotations.resize(count * 4);
+    scales.resize(count * 4);
+
+    auto cursors = _trackCursors.data();
+    _animation->sampleTracks(t, _translateTracks.data(), count, cursors, _translateEvaluate, translations.data());
+    _animation->sampleTracks(t, _rotTracks.data(), count, cursors, _roteEvaluate, rotations.data());
+    _animation->sampleTracks(t, _scaleTracks.data(), count, cursors, _scaleEvaluate, scales.data());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        _sampledBones[i]->setAnimationValue(_translateTracks[i] >= 0 ? &translations[i * 4] : nullptr,
+                                            _rotTracks[i] >= 0 ? &rotations[i * 4] : nullptr,
+                                            _scaleTracks[i] >= 0 ? &scales[i * 4] : nullptr, this, _weight);
+    }
+}
+
+void Animate3D::flushPendingSamples()
+{
+    if (s_pendingSamples.empty())
+        return;
+
+    // The animates of a target blend into the same bones, so a target is sampled by one thread only
+    std::stable_sort(s_pendingSamples.begin(), s_pendingSamples.end(),
+                     [](const PendingSample& lhs, const PendingSample& rhs) { return lhs.target < rhs.target; });
+    static std::vector<size_t> targetEnds;
+    targetEnds.clear();
+    for (size_t i = 0, count = s_pendingSamples.size(); i < count; ++i)
+    {
+        if (i + 1 == count || s_pendingSamples[i + 1].target != s_pendingSamples[i].target)
+            targetEnds.emplace_back(i + 1);
+    }
+
+    auto sampleTarget = [](size_t target) {
+        size_t first = target > 0 ? targetEnds[target - 1] : 0;
+        for (size_t i = first; i < targetEnds[target]; ++i)
+        {
+            auto animate = s_pendingSamples[i].animate;
+            if (animate->_samplePending)
+            {
+                animate->_samplePending = false;
+                animate->sampleBones(animate->_pendingSampleTime);
+            }
+        }
+
+        // Blend the sampled poses into the bone matrices while they are hot in cache, only bones of MeshRenderer
+        // targets are sampled.
+        auto skeleton = static_cast<MeshRenderer*>(s_pendingSamples[first].target)->getSkeleton();
+        if (skeleton)
+            skeleton->updateBoneMatrix();
+    };
+
+    auto targetCount = targetEnds.size();
+    auto jobSystem   = Director::getInstance()->getJobSystem();
+    if (!jobSystem || targetCount < PARALLEL_SAMPLING_MIN_TARGETS)
+    {
+        for (size_t target = 0; target < targetCount; ++target)
+            sampleTarget(target);
+    }
+    else
+    {
+        // The main thread samples targets as well, so a busy JobSystem never stalls the frame.
+        jobSystem->parallelFor(
+            0, targetCount, 1,
+            [&sampleTarget](size_t begin, size_t end) {
+                for (auto target = begin; target < end; ++target)
+                    sampleTarget(target);
+            },
+            JobPriority::High, PARALLEL_SAMPLING_MAX_HELPERS);
+    }
+
+    for (auto&& sample : s_pendingSamples)
+    {
+        sample.animate->release();
+        sample.target->release();
+    }
+    s_pendingSamples.clear();
+}
+
 float Animate3D::getSpeed() const
 {
     return _playReverse ? -_absSpeed : _absSpeed;
@@ -502,6 +603,8 @@ Animate3D::Animate3D()
     , _lastTime(0.0f)
     , _originInterval(0.0f)
     , _frameRate(30.0f)
+    , _pendingSampleTime(0.0f)
+    , _samplePending(false)
 {
     setQuality(Animate3DQuality::QUALITY_HIGH);
 }
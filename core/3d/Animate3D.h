@@ -29,6 +29,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "3d/Animation3D.h"
 #include "base/Macros.h"
@@ -116,6 +117,25 @@ public:
             _transTime = transTime;
     }
 
+    /**The min number of animated skeletons to sample them across the JobSystem.*/
+    static const int PARALLEL_SAMPLING_MIN_TARGETS = 4;
+    /**The max number of JobSystem workers helping the main thread to sample skeletons.*/
+    static const int PARALLEL_SAMPLING_MAX_HELPERS = 7;
+
+    /**
+     * Enable/disable sampling the skeletons of all running Animate3D together, disabled by default.
+     * When enabled, update only records the time to sample and Director samples every animated skeleton
+     * after the scheduler update, the skeletons are spread across the JobSystem workers which also blend
+     * the bone matrices.
+     */
+    static void setParallelSamplingEnabled(bool enabled) { s_parallelSampling = enabled; }
+
+    /** Whether the skeletons of all running Animate3D are sampled together. */
+    static bool isParallelSamplingEnabled() { return s_parallelSampling; }
+
+    /** Sample the skeletons recorded by update since the last call, called by Director after the scheduler update. */
+    static void flushPendingSamples();
+
     /**set animate quality*/
     void setQuality(Animate3DQuality quality);
 
@@ -143,6 +163,9 @@ public:
     bool initWithFrames(Animation3D* animation, int startFrame, int endFrame, float frameRate);
 
 protected:
+    /** sample the bone tracks at time t (0 - 1) and pass the pose to the bones */
+    void sampleBones(float t);
+
     enum class Animate3DState
     {
         FadeIn,
@@ -170,6 +193,15 @@ protected:
     Animate3DQuality _quality;
 
     std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves;  // weak ref
+
+    // the bones of _boneCurves and the indices of their curves in Animation3D::getTracks()
+    std::vector<Bone3D*> _sampledBones;
+    std::vector<int> _translateTracks;
+    std::vector<int> _rotTracks;
+    std::vector<int> _scaleTracks;
+    std::vector<uint32_t> _trackCursors;  // last sampled key of every track of _animation
+    float _pendingSampleTime;
+    bool _samplePending;
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
 
     std::unordered_map<int, ValueMap> _keyFrameUserInfos;
@@ -180,6 +212,15 @@ protected:
     static std::unordered_map<Node*, Animate3D*> s_fadeInAnimates;
     static std::unordered_map<Node*, Animate3D*> s_fadeOutAnimates;
     static std::unordered_map<Node*, Animate3D*> s_runningAnimates;
+
+    // animates waiting for flushPendingSamples, both the animate and its target are retained
+    struct PendingSample
+    {
+        Animate3D* animate;
+        Node* target;
+    };
+    static std::vector<PendingSample> s_pendingSamples;
+    static bool s_parallelSampling;
 };
 
 // end of 3d group
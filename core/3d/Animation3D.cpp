@@ -28,6 +28,7 @@
 #include "3d/Bundle3D.h"
 #include "platform/FileUtils.h"
 #include "base/axstd.h"
+#include "math/MathUtil.h"
 
 namespace ax
 {
@@ -93,7 +94,14 @@ Animation3D::~Animation3D()
     }
 }
 
-Animation3D::Curve::Curve() : translateCurve(nullptr), rotCurve(nullptr), scaleCurve(nullptr) {}
+Animation3D::Curve::Curve()
+    : translateCurve(nullptr)
+    , rotCurve(nullptr)
+    , scaleCurve(nullptr)
+    , translateTrack(-1)
+    , rotTrack(-1)
+    , scaleTrack(-1)
+{}
 Animation3D::Curve::~Curve()
 {
     AX_SAFE_RELEASE_NULL(translateCurve);
@@ -106,6 +114,7 @@ Animation3D::Curve::~Curve()
 bool Animation3D::init(const Animation3DData& data)
 {
     _duration = data._totalTime;
+    _tracks   = Tracks{};
 
     {
         axstd::pod_vector<float> keys;
@@ -131,6 +140,7 @@ bool Animation3D::init(const Animation3DData& data)
             curve->translateCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->translateCurve)
                 curve->translateCurve->retain();
+            curve->translateTrack = addTrack(&keys[0], &values[0].x, 3, (int)keys.size());
         }
     }
 
@@ -157,6 +167,7 @@ bool Animation3D::init(const Animation3DData& data)
             curve->rotCurve = Curve::AnimationCurveQuat::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->rotCurve)
                 curve->rotCurve->retain();
+            curve->rotTrack = addTrack(&keys[0], &values[0].x, 4, (int)keys.size());
         }
     }
 
@@ -183,12 +194,102 @@ bool Animation3D::init(const Animation3DData& data)
             curve->scaleCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0].x, (int)keys.size());
             if (curve->scaleCurve)
                 curve->scaleCurve->retain();
+            curve->scaleTrack = addTrack(&keys[0], &values[0].x, 3, (int)keys.size());
         }
     }
 
     return true;
 }
 
+int Animation3D::addTrack(const float* keyTimes, const float* keyValues, int componentSize, int count)
+{
+    auto track = static_cast<int>(_tracks.firstKeys.size());
+    _tracks.firstKeys.emplace_back(static_cast<uint32_t>(_tracks.keyTimes.size()));
+    _tracks.keyCounts.emplace_back(static_cast<uint32_t>(count));
+    _tracks.keyTimes.insert(_tracks.keyTimes.end(), keyTimes, keyTimes + count);
+    for (int i = 0; i < count; ++i, keyValues += componentSize)
+    {
+        _tracks.keyValues.insert(_tracks.keyValues.end(), keyValues, keyValues + componentSize);
+        if (componentSize == 3)
+            _tracks.keyValues.emplace_back(0.0f);
+    }
+    return track;
+}
+
+void Animation3D::sampleTracks(float time,
+                               const int* tracks,
+                               size_t count,
+                               uint32_t* cursors,
+                               EvaluateType type,
+                               float* dst) const
+{
+    // The key pairs to interpolate are gathered first, so that they are blended in one SIMD pass
+    thread_local std::vector<float> fromValues, toValues, alphas, blended;
+    thread_local std::vector<float*> outputs;
+    fromValues.clear();
+    toValues.clear();
+    alphas.clear();
+    outputs.clear();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        int track = tracks[i];
+        if (track < 0)
+            continue;
+
+        auto keyCount  = _tracks.keyCounts[track];
+        auto keyTimes  = &_tracks.keyTimes[_tracks.firstKeys[track]];
+        auto keyValues = &_tracks.keyValues[_tracks.firstKeys[track] * 4];
+        auto output    = dst + i * 4;
+        if (keyCount == 1 || time <= keyTimes[0])
+        {
+            memcpy(output, keyValues, 4 * sizeof(float));
+            continue;
+        }
+        if (time >= keyTimes[keyCount - 1])
+        {
+            memcpy(output, &keyValues[(keyCount - 1) * 4], 4 * sizeof(float));
+            continue;
+        }
+
+        // Playback mostly stays on the cached key or moves to the next one, search only when it jumps
+        auto& key = cursors[track];
+        if (key + 1 >= keyCount || time < keyTimes[key] || time > keyTimes[key + 1])
+        {
+            if (key + 2 < keyCount && time >= keyTimes[key + 1] && time <= keyTimes[key + 2])
+                ++key;
+            else
+                key = static_cast<uint32_t>(std::upper_bound(keyTimes, keyTimes + keyCount, time) - keyTimes - 1);
+        }
+
+        float span  = keyTimes[key + 1] - keyTimes[key];
+        float alpha = span > 0.0f ? (time - keyTimes[key]) / span : 0.0f;
+        auto from   = &keyValues[key * 4];
+        if (type == EvaluateType::INT_NEAR)
+        {
+            memcpy(output, alpha > 0.5f ? from + 4 : from, 4 * sizeof(float));
+            continue;
+        }
+
+        fromValues.insert(fromValues.end(), from, from + 4);
+        toValues.insert(toValues.end(), from + 4, from + 8);
+        alphas.emplace_back(alpha);
+        outputs.emplace_back(output);
+    }
+
+    if (alphas.empty())
+        return;
+
+    blended.resize(fromValues.size());
+    if (type == EvaluateType::INT_QUAT_SLERP)
+        MathUtil::slerpQuaternions(fromValues.data(), toValues.data(), alphas.data(), blended.data(), alphas.size());
+    else
+        MathUtil::lerpVec4(fromValues.data(), toValues.data(), alphas.data(), blended.data(), alphas.size());
+
+    for (size_t i = 0, size = outputs.size(); i < size; ++i)
+        memcpy(outputs[i], &blended[i * 4], 4 * sizeof(float));
+}
+
 ////////////////////////////////////////////////////////////////
 Animation3DCache* Animation3DCache::_cacheInstance = nullptr;
 
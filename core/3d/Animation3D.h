@@ -63,6 +63,10 @@ public:
         AnimationCurveQuat* rotCurve;
         /**scaling curve*/
         AnimationCurveVec3* scaleCurve;
+        /**index of the translation, rotation and scaling curves in Animation3D::getTracks(), -1 if none*/
+        int translateTrack;
+        int rotTrack;
+        int scaleTrack;
         /**constructor */
         Curve();
         /**constructor */
@@ -85,6 +89,38 @@ public:
     /**get the bone Curves set*/
     const hlookup::string_map<Curve*>& getBoneCurves() const { return _boneCurves; }
 
+    /**
+     * The keyframes of all bone curves packed into contiguous arrays, so that a whole skeleton is sampled
+     * without chasing one AnimationCurve per bone. Every key value takes 4 floats, vec3 keys are padded with 0.
+     */
+    struct Tracks
+    {
+        std::vector<float> keyTimes;      // key times of all tracks, the keys of a track are adjacent
+        std::vector<float> keyValues;     // 4 floats per key, in the order of keyTimes
+        std::vector<uint32_t> firstKeys;  // index of the first key of each track
+        std::vector<uint32_t> keyCounts;  // number of keys of each track
+    };
+
+    /**get the packed keyframes of all bone curves*/
+    const Tracks& getTracks() const { return _tracks; }
+
+    /**
+     * Sample count tracks at the given time, 4 floats per track are written to dst.
+     *
+     * @param time the time (0 - 1) to sample
+     * @param tracks the track indices, the output of a track index -1 is left untouched
+     * @param count the number of tracks to sample
+     * @param cursors the last key of every track of this animation, which makes sampling successive times O(1)
+     * @param type INT_NEAR, INT_LINEAR, or INT_QUAT_SLERP for rotation tracks
+     * @param dst the sampled values
+     */
+    void sampleTracks(float time,
+                      const int* tracks,
+                      size_t count,
+                      uint32_t* cursors,
+                      EvaluateType type,
+                      float* dst) const;
+
     Animation3D();
     virtual ~Animation3D();
     /**init Animation3D from bundle data*/
@@ -94,7 +130,10 @@ public:
     bool initWithFile(std::string_view filename, std::string_view animationName);
 
 protected:
+    int addTrack(const float* keyTimes, const float* keyValues, int componentSize, int count);
+
     hlookup::string_map<Curve*> _boneCurves;  // bone curves map, key bone name, value AnimationCurve
+    Tracks _tracks;                            // packed keyframes of _boneCurves
 
     float _duration;  // animation duration
 };
@@ -38,7 +38,11 @@ AttachNode* AttachNode::create(Bone3D* attachBone)
     return attachnode;
 }
 
-AttachNode::AttachNode() : _attachBone(nullptr) {}
+AttachNode::AttachNode() : _attachBone(nullptr)
+{
+    // the transform follows the bone, which doesn't mark the node dirty
+    setVolatileTransform(true);
+}
 AttachNode::~AttachNode() {}
 
 Mat4 AttachNode::getWorldToNodeTransform() const
@@ -0,0 +1,388 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+
+namespace ax
+{
+
+static AABB mergeAABB(const AABB& a, const AABB& b)
+{
+    AABB result(a);
+    result.merge(b);
+    return result;
+}
+
+static float surfaceArea(const AABB& aabb)
+{
+    Vec3 size = aabb._max - aabb._min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static bool containsAABB(const AABB& outer, const AABB& inner)
+{
+    return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z &&
+           outer._max.x >= inner._max.x && outer._max.y >= inner._max.y && outer._max.z >= inner._max.z;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin) : _margin(margin) {}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy() {}
+
+int BoundingVolumeHierarchy::createProxy(const AABB& aabb, void* userData)
+{
+    int proxyId = allocateNode();
+
+    Vec3 margin = (aabb._max - aabb._min) * _margin;
+
+    auto& node    = _nodes[proxyId];
+    node.aabb     = AABB(aabb._min - margin, aabb._max + margin);
+    node.bounds   = aabb;
+    node.userData = userData;
+    node.height   = 0;
+
+    insertLeaf(proxyId);
+    ++_proxyCount;
+    return proxyId;
+}
+
+void BoundingVolumeHierarchy::destroyProxy(int proxyId)
+{
+    AXASSERT(proxyId >= 0 && proxyId < static_cast<int>(_nodes.size()) && _nodes[proxyId].isLeaf(),
+             "invalid proxy id");
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --_proxyCount;
+}
+
+bool BoundingVolumeHierarchy::moveProxy(int proxyId, const AABB& aabb)
+{
+    AXASSERT(proxyId >= 0 && proxyId < static_cast<int>(_nodes.size()) && _nodes[proxyId].isLeaf(),
+             "invalid proxy id");
+
+    auto& node  = _nodes[proxyId];
+    node.bounds = aabb;
+    if (containsAABB(node.aabb, aabb))
+        return false;
+
+    removeLeaf(proxyId);
+
+    Vec3 margin = (aabb._max - aabb._min) * _margin;
+    _nodes[proxyId].aabb = AABB(aabb._min - margin, aabb._max + margin);
+
+    insertLeaf(proxyId);
+    return true;
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+    _nodes.clear();
+    _root       = NULL_NODE;
+    _freeList   = NULL_NODE;
+    _proxyCount = 0;
+}
+
+int BoundingVolumeHierarchy::allocateNode()
+{
+    int nodeId;
+    if (_freeList != NULL_NODE)
+    {
+        nodeId    = _freeList;
+        _freeList = _nodes[nodeId].parent;
+    }
+    else
+    {
+        nodeId = static_cast<int>(_nodes.size());
+        _nodes.emplace_back();
+    }
+
+    auto& node    = _nodes[nodeId];
+    node.userData = nullptr;
+    node.parent   = NULL_NODE;
+    node.child1   = NULL_NODE;
+    node.child2   = NULL_NODE;
+    node.height   = 0;
+    return nodeId;
+}
+
+void BoundingVolumeHierarchy::freeNode(int nodeId)
+{
+    auto& node    = _nodes[nodeId];
+    node.userData = nullptr;
+    node.parent   = _freeList;
+    node.height   = -1;
+    _freeList     = nodeId;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(int leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root               = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the cheapest sibling, the cost of a subtree is the area it would add to the tree
+    const AABB leafAABB = _nodes[leaf].aabb;
+    int index           = _root;
+    while (!_nodes[index].isLeaf())
+    {
+        const auto& node = _nodes[index];
+
+        float area         = surfaceArea(node.aabb);
+        float combinedArea = surfaceArea(mergeAABB(node.aabb, leafAABB));
+
+        // cost of making a new parent for this node and the leaf, and the minimum cost of pushing the leaf down
+        float cost        = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int child) {
+            const auto& childNode = _nodes[child];
+            float mergedArea      = surfaceArea(mergeAABB(childNode.aabb, leafAABB));
+            return (childNode.isLeaf() ? mergedArea : mergedArea - surfaceArea(childNode.aabb)) + inheritance;
+        };
+        float cost1 = childCost(node.child1);
+        float cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int sibling   = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+
+    auto& parentNode  = _nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.aabb   = mergeAABB(leafAABB, _nodes[sibling].aabb);
+    parentNode.height = _nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent    = newParent;
+
+    refitAncestors(_nodes[leaf].parent);
+}
+
+void BoundingVolumeHierarchy::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    int parent      = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling     = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_NODE)
+    {
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refitAncestors(grandParent);
+    }
+    else
+    {
+        _root                  = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void BoundingVolumeHierarchy::refitAncestors(int nodeId)
+{
+    while (nodeId != NULL_NODE)
+    {
+        nodeId = balance(nodeId);
+
+        auto& node     = _nodes[nodeId];
+        const auto& c1 = _nodes[node.child1];
+        const auto& c2 = _nodes[node.child2];
+        node.height    = 1 + std::max(c1.height, c2.height);
+        node.aabb      = mergeAABB(c1.aabb, c2.aabb);
+
+        nodeId = node.parent;
+    }
+}
+
+int BoundingVolumeHierarchy::balance(int iA)
+{
+    auto& A = _nodes[iA];
+    if (A.isLeaf() || A.height < 2)
+        return iA;
+
+    int iB  = A.child1;
+    int iC  = A.child2;
+    auto& B = _nodes[iB];
+    auto& C = _nodes[iC];
+
+    int heightDiff = C.height - B.height;
+
+    // rotate the heavier child up, the grandchild with the larger height stays under it
+    if (heightDiff > 1)
+    {
+        int iF  = C.child1;
+        int iG  = C.child2;
+        auto& F = _nodes[iF];
+        auto& G = _nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NULL_NODE)
+        {
+            if (_nodes[C.parent].child1 == iA)
+                _nodes[C.parent].child1 = iC;
+            else
+                _nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            _root = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.aabb   = mergeAABB(B.aabb, G.aabb);
+            C.aabb   = mergeAABB(A.aabb, F.aabb);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.aabb   = mergeAABB(B.aabb, F.aabb);
+            C.aabb   = mergeAABB(A.aabb, G.aabb);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    if (heightDiff < -1)
+    {
+        int iD  = B.child1;
+        int iE  = B.child2;
+        auto& D = _nodes[iD];
+        auto& E = _nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NULL_NODE)
+        {
+            if (_nodes[B.parent].child1 == iA)
+                _nodes[B.parent].child1 = iB;
+            else
+                _nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            _root = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.aabb   = mergeAABB(C.aabb, E.aabb);
+            B.aabb   = mergeAABB(A.aabb, D.aabb);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.aabb   = mergeAABB(C.aabb, D.aabb);
+            B.aabb   = mergeAABB(A.aabb, E.aabb);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+bool BoundingVolumeHierarchy::validate() const
+{
+    if (_root == NULL_NODE)
+        return _proxyCount == 0;
+    if (_nodes[_root].parent != NULL_NODE)
+        return false;
+    return validateNode(_root) == _proxyCount;
+}
+
+int BoundingVolumeHierarchy::validateNode(int nodeId) const
+{
+    const auto& node = _nodes[nodeId];
+    if (node.isLeaf())
+        return node.height == 0 && node.child2 == NULL_NODE && containsAABB(node.aabb, node.bounds) ? 1 : -1;
+
+    const auto& c1 = _nodes[node.child1];
+    const auto& c2 = _nodes[node.child2];
+    if (c1.parent != nodeId || c2.parent != nodeId || node.height != 1 + std::max(c1.height, c2.height) ||
+        !containsAABB(node.aabb, c1.aabb) || !containsAABB(node.aabb, c2.aabb))
+        return -1;
+
+    int leaves1 = validateNode(node.child1);
+    int leaves2 = validateNode(node.child2);
+    return leaves1 < 0 || leaves2 < 0 ? -1 : leaves1 + leaves2;
+}
+
+}
@@ -0,0 +1,193 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "3d/AABB.h"
+#include "3d/Frustum.h"
+
+namespace ax
+{
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * Dynamic bounding volume hierarchy of AABBs.
+ * Every proxy is a leaf of a binary tree whose inner nodes bound their two children. Leaves are kept with a fat
+ * AABB, enlarged by a margin, so small moves only refit the leaf and don't change the tree. Leaves are inserted
+ * next to the sibling that minimizes the surface area of the tree, and the tree is rebalanced with rotations
+ * on the way up, which keeps queries O(log n) for scenes where most of the proxies are out of the query volume.
+ */
+class AX_DLL BoundingVolumeHierarchy
+{
+public:
+    static const int NULL_NODE = -1;
+
+    /**
+     * Constructor.
+     * @param margin The fat AABB margin of the leaves, relative to their size.
+     */
+    explicit BoundingVolumeHierarchy(float margin = 0.1f);
+    ~BoundingVolumeHierarchy();
+
+    /**
+     * Add a proxy.
+     * @return The proxy id, stable until the proxy is destroyed.
+     */
+    int createProxy(const AABB& aabb, void* userData);
+
+    /** Remove a proxy. */
+    void destroyProxy(int proxyId);
+
+    /**
+     * Update the bounds of a proxy.
+     * @return true if the proxy left its fat AABB and was reinserted in the tree.
+     */
+    bool moveProxy(int proxyId, const AABB& aabb);
+
+    void* getUserData(int proxyId) const { return _nodes[proxyId].userData; }
+    const AABB& getBounds(int proxyId) const { return _nodes[proxyId].bounds; }
+    const AABB& getFatAABB(int proxyId) const { return _nodes[proxyId].aabb; }
+
+    /** Remove all the proxies. */
+    void clear();
+
+    int getProxyCount() const { return _proxyCount; }
+
+    /** Get the height of the tree, 0 for a single leaf. */
+    int getHeight() const { return _root == NULL_NODE ? 0 : _nodes[_root].height; }
+
+    /** Check the tree invariants, for debugging. */
+    bool validate() const;
+
+    /**
+     * Call callback(userData) for each proxy whose bounds intersect the aabb.
+     */
+    template <typename F>
+    void query(const AABB& aabb, F&& callback) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        _stack.clear();
+        _stack.push_back({_root, 0});
+        while (!_stack.empty())
+        {
+            int nodeId = _stack.back().node;
+            _stack.pop_back();
+
+            const TreeNode& node = _nodes[nodeId];
+            if (!node.aabb.intersects(aabb))
+                continue;
+
+            if (node.isLeaf())
+            {
+                if (node.bounds.intersects(aabb))
+                    callback(node.userData);
+            }
+            else
+            {
+                _stack.push_back({node.child1, 0});
+                _stack.push_back({node.child2, 0});
+            }
+        }
+    }
+
+    /**
+     * Call callback(userData) for each proxy whose bounds intersect the frustum. A subtree fully inside a clip
+     * plane isn't tested against it again, and a subtree fully inside the frustum is reported without any test.
+     */
+    template <typename F>
+    void query(const Frustum& frustum, F&& callback) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        _stack.clear();
+        _stack.push_back({_root, ALL_PLANES});
+        while (!_stack.empty())
+        {
+            auto entry = _stack.back();
+            _stack.pop_back();
+
+            const TreeNode& node = _nodes[entry.node];
+            if (entry.planeMask && !frustum.intersectAABB(node.isLeaf() ? node.bounds : node.aabb, entry.planeMask))
+                continue;
+
+            if (node.isLeaf())
+                callback(node.userData);
+            else
+            {
+                _stack.push_back({node.child1, entry.planeMask});
+                _stack.push_back({node.child2, entry.planeMask});
+            }
+        }
+    }
+
+protected:
+    static const unsigned int ALL_PLANES = 0x3f;
+
+    struct TreeNode
+    {
+        AABB aabb;    // fat aabb for leaves, union of the children for inner nodes
+        AABB bounds;  // exact aabb of the proxy, leaves only
+        void* userData;
+        int parent;   // next free node when in the free list
+        int child1;
+        int child2;
+        int height;   // 0 for leaves, -1 for free nodes
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    struct StackEntry
+    {
+        int node;
+        unsigned int planeMask;
+    };
+
+    int allocateNode();
+    void freeNode(int nodeId);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int nodeId);
+    void refitAncestors(int nodeId);
+    int validateNode(int nodeId) const;
+
+    std::vector<TreeNode> _nodes;
+    mutable std::vector<StackEntry> _stack;
+    int _root       = NULL_NODE;
+    int _freeList   = NULL_NODE;
+    int _proxyCount = 0;
+    float _margin;
+};
+
+// end of 3d group
+/// @}
+
+}
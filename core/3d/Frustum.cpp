@@ -56,6 +56,34 @@ bool Frustum::isOutOfFrustum(const AABB& aabb) const
     return false;
 }
 
+bool Frustum::intersectAABB(const AABB& aabb, unsigned int& planeMask) const
+{
+    if (!_initialized)
+    {
+        planeMask = 0;
+        return true;
+    }
+
+    int plane = _clipZ ? 6 : 4;
+    for (int i = 0; i < plane; i++)
+    {
+        if (!(planeMask & (1u << i)))
+            continue;
+
+        const Vec3& normal = _plane[i].getNormal();
+        Vec3 nearPoint(normal.x < 0 ? aabb._max.x : aabb._min.x, normal.y < 0 ? aabb._max.y : aabb._min.y,
+                       normal.z < 0 ? aabb._max.z : aabb._min.z);
+        if (_plane[i].dist2Plane(nearPoint) > 0)
+            return false;
+
+        Vec3 farPoint(normal.x < 0 ? aabb._min.x : aabb._max.x, normal.y < 0 ? aabb._min.y : aabb._max.y,
+                      normal.z < 0 ? aabb._min.z : aabb._max.z);
+        if (_plane[i].dist2Plane(farPoint) <= 0)
+            planeMask &= ~(1u << i);
+    }
+    return true;
+}
+
 bool Frustum::isOutOfFrustum(const OBB& obb) const
 {
     if (_initialized)
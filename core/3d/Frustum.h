@@ -68,6 +68,13 @@ public:
      */
     bool isOutOfFrustum(const OBB& obb) const;
 
+    /**
+     * is aabb intersecting the frustum, only the clip planes whose bit is set in planeMask are tested.
+     * The bits of the planes the aabb is fully inside of are cleared, so the children of a bounding volume
+     * only need to be tested against the remaining planes, a mask of 0 means fully inside.
+     */
+    bool intersectAABB(const AABB& aabb, unsigned int& planeMask) const;
+
     /**
      * get & set z clip. if bclipZ == true use near and far plane
      */
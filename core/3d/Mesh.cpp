@@ -475,7 +475,7 @@ void Mesh::draw(Renderer* renderer,
             }
 
             // Fill the buffer with identity matrix.
-            _instanceTransformBuffer->updateData(_instanceMatrixCache, _instanceCount * 64);
+            renderer->updateBufferData(_instanceTransformBuffer, _instanceMatrixCache, _instanceCount * 64);
 
             _instanceTransformBufferDirty = false;
         }
@@ -490,7 +490,7 @@ void Mesh::draw(Renderer* renderer,
                 auto& mat = _->getNodeToParentTransform();
                 std::copy(mat.m, mat.m + 16, _instanceMatrixCache + 16 * memOffset++);
             }
-            _instanceTransformBuffer->updateSubData(_instanceMatrixCache, 0, _instanceCount * 64);
+            renderer->updateBufferSubData(_instanceTransformBuffer, _instanceMatrixCache, 0, _instanceCount * 64);
         }
     }
 
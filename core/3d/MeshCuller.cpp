@@ -0,0 +1,136 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/MeshCuller.h"
+#include "3d/MeshRenderer.h"
+#include "2d/Camera.h"
+#include "base/Director.h"
+
+#include <string.h>
+
+namespace ax
+{
+
+MeshCuller::MeshCuller() {}
+
+MeshCuller::~MeshCuller()
+{
+    for (auto&& entry : _entries)
+    {
+        entry.renderer->_meshCuller   = nullptr;
+        entry.renderer->_cullingIndex = -1;
+    }
+}
+
+void MeshCuller::addMeshRenderer(MeshRenderer* renderer)
+{
+    AXASSERT(renderer->_meshCuller == nullptr, "the renderer is already registered");
+
+    renderer->_meshCuller   = this;
+    renderer->_cullingIndex = static_cast<int>(_entries.size());
+    // the proxy is created by the next update
+    _entries.push_back({renderer, BoundingVolumeHierarchy::NULL_NODE, Mat4::IDENTITY, true});
+}
+
+void MeshCuller::removeMeshRenderer(MeshRenderer* renderer)
+{
+    AXASSERT(renderer->_meshCuller == this, "the renderer isn't registered into this culler");
+
+    int index = renderer->_cullingIndex;
+    if (_entries[index].proxy != BoundingVolumeHierarchy::NULL_NODE)
+        _hierarchy.destroyProxy(_entries[index].proxy);
+
+    if (index != static_cast<int>(_entries.size()) - 1)
+    {
+        _entries[index]                         = _entries.back();
+        _entries[index].renderer->_cullingIndex = index;
+    }
+    _entries.pop_back();
+
+    renderer->_meshCuller   = nullptr;
+    renderer->_cullingIndex = -1;
+
+    // the renderer may be released before the next cull
+    _visible.clear();
+    _cullingCamera = nullptr;
+}
+
+void MeshCuller::update()
+{
+    for (auto&& entry : _entries)
+    {
+        // read from the transform system once it's up to date, see Scene::render
+        Mat4 worldTransform(entry.renderer->getNodeToWorldTransform());
+        if (!entry.dirty && !entry.renderer->_aabbDirty &&
+            memcmp(entry.worldTransform.m, worldTransform.m, sizeof(Mat4)) == 0)
+            continue;
+
+        entry.worldTransform = worldTransform;
+        entry.dirty          = false;
+
+        const AABB& aabb = entry.renderer->getAABB();
+        if (aabb.isEmpty())
+        {
+            if (entry.proxy != BoundingVolumeHierarchy::NULL_NODE)
+            {
+                _hierarchy.destroyProxy(entry.proxy);
+                entry.proxy = BoundingVolumeHierarchy::NULL_NODE;
+            }
+        }
+        else if (entry.proxy == BoundingVolumeHierarchy::NULL_NODE)
+            entry.proxy = _hierarchy.createProxy(aabb, entry.renderer);
+        else
+            _hierarchy.moveProxy(entry.proxy, aabb);
+    }
+}
+
+void MeshCuller::cull(Camera* camera)
+{
+    _cullingCamera = camera;
+    _cullingFrame  = Director::getInstance()->getTotalFrames();
+    ++_cullingStamp;
+
+    _visible.clear();
+    _hierarchy.query(camera->getFrustum(), [this](void* userData) {
+        auto renderer           = static_cast<MeshRenderer*>(userData);
+        renderer->_cullingStamp = _cullingStamp;
+        _visible.emplace_back(renderer);
+    });
+
+    camera->_visibleMeshCount = static_cast<unsigned int>(_visible.size());
+    camera->_culledMeshCount  = static_cast<unsigned int>(_hierarchy.getProxyCount() - _visible.size());
+}
+
+bool MeshCuller::hasCulled(const Camera* camera) const
+{
+    return camera == _cullingCamera && _cullingFrame == Director::getInstance()->getTotalFrames();
+}
+
+bool MeshCuller::isVisible(const MeshRenderer* renderer) const
+{
+    return renderer->_cullingStamp == _cullingStamp ||
+           _entries[renderer->_cullingIndex].proxy == BoundingVolumeHierarchy::NULL_NODE;
+}
+
+}
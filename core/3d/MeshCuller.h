@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "3d/BoundingVolumeHierarchy.h"
+#include "math/Mat4.h"
+
+namespace ax
+{
+
+class Camera;
+class MeshRenderer;
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/** @class MeshCuller
+ * @brief Frustum culling of the mesh renderers of a scene.
+ *
+ * The mesh renderers register into the culler of their scene on enter. Their world AABBs are kept in a
+ * BoundingVolumeHierarchy, refitted once per frame for the renderers whose world transform or meshes changed. Each camera
+ * then queries the hierarchy once before the visit, and MeshRenderer::draw skips the renderers out of its frustum.
+ * Owned by Scene, @see Scene::getMeshCuller.
+ */
+class AX_DLL MeshCuller
+{
+public:
+    MeshCuller();
+    ~MeshCuller();
+
+    void addMeshRenderer(MeshRenderer* renderer);
+    void removeMeshRenderer(MeshRenderer* renderer);
+
+    /**
+     * Refits the hierarchy to the renderers whose world transform or meshes changed since the last update.
+     * The world transforms are compared with the ones of the last update rather than tracked by version, so
+     * renderers moved by a bone through an AttachNode are refitted as well.
+     */
+    void update();
+
+    /** Queries the hierarchy with the frustum of camera, the result is valid until the next cull or update. */
+    void cull(Camera* camera);
+
+    /** Whether the last cull was done for camera in the current frame, so isVisible can be used for its visit. */
+    bool hasCulled(const Camera* camera) const;
+
+    /** Whether the renderer was found in the frustum by the last cull. */
+    bool isVisible(const MeshRenderer* renderer) const;
+
+    /** Get the renderers found in the frustum by the last cull. */
+    const std::vector<MeshRenderer*>& getVisibleMeshRenderers() const { return _visible; }
+
+    size_t getMeshRendererCount() const { return _entries.size(); }
+
+    const BoundingVolumeHierarchy& getHierarchy() const { return _hierarchy; }
+
+private:
+    struct Entry
+    {
+        MeshRenderer* renderer;
+        int proxy;            // NULL_NODE while the renderer has no mesh, it's never culled then
+        Mat4 worldTransform;  // world transform the proxy was fitted with
+        bool dirty;           // set until the first update
+    };
+
+    std::vector<Entry> _entries;
+    std::vector<MeshRenderer*> _visible;
+    BoundingVolumeHierarchy _hierarchy;
+
+    const Camera* _cullingCamera = nullptr;
+    unsigned int _cullingFrame   = 0;
+    uint32_t _cullingStamp       = 0;
+};
+
+// end of 3d group
+/// @}
+
+}
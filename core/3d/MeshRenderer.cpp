@@ -31,6 +31,7 @@
 #include "3d/MeshMaterial.h"
 #include "3d/AttachNode.h"
 #include "3d/Mesh.h"
+#include "3d/MeshCuller.h"
 
 #include "base/Director.h"
 #include "base/UTF8.h"
@@ -275,6 +276,10 @@ MeshRenderer::MeshRenderer()
     , _usingAutogeneratedGLProgram(true)
     , _transparentMaterialHint(false)
     , _meshTextureHint(0)
+    , _instancing(false)
+    , _meshCuller(nullptr)
+    , _cullingIndex(-1)
+    , _cullingStamp(0)
 {}
 
 MeshRenderer::~MeshRenderer()
@@ -718,12 +723,14 @@ void MeshRenderer::enableInstancing(MeshMaterial* instanceMat, int count)
         mesh->enableInstancing(true, MAX(1, count));
         mesh->setMaterial(instanceMat);
     }
+    _instancing = true;
 }
 
 void MeshRenderer::disableInstancing()
 {
     for (auto&& mesh : _meshes)
         mesh->enableInstancing(false, 0);
+    _instancing = false;
 }
 
 void MeshRenderer::setDynamicInstancing(bool dynamic)
@@ -859,11 +866,18 @@ void MeshRenderer::visit(ax::Renderer* renderer, const ax::Mat4& parentTransform
 void MeshRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 {
 #if AX_USE_CULLING
-    // TODO new-renderer: interface isVisibleInFrustum removal
-    //  camera clipping
-//    if(_children.empty() && Camera::getVisitingCamera() &&
-//    !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
-//        return;
+    // camera clipping, with the visible set of the scene culler when it was queried for this camera
+    auto camera = Camera::getVisitingCamera();
+    if (camera && !_instancing)
+    {
+        if (_meshCuller && _meshCuller->hasCulled(camera))
+        {
+            if (!_meshCuller->isVisible(this))
+                return;
+        }
+        else if (!camera->isVisibleInFrustum(&getAABB()))
+            return;
+    }
 #endif
 
     if (_skeleton)
@@ -899,6 +913,23 @@ void MeshRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flag
     }
 }
 
+void MeshRenderer::onEnter()
+{
+    Node::onEnter();
+
+    auto scene = getScene();
+    if (scene && scene->getMeshCuller())
+        scene->getMeshCuller()->addMeshRenderer(this);
+}
+
+void MeshRenderer::onExit()
+{
+    if (_meshCuller)
+        _meshCuller->removeMeshRenderer(this);
+
+    Node::onExit();
+}
+
 bool MeshRenderer::setProgramState(backend::ProgramState* programState, bool ownPS /* = false*/)
 {
     if (Node::setProgramState(programState, ownPS))
@@ -52,12 +52,15 @@ class Mesh;
 class Texture2D;
 class MeshSkin;
 class AttachNode;
+class MeshCuller;
 struct NodeData;
 /** @brief MeshRenderer: A mesh can be loaded from model files, .obj, .c3t, .c3b
  *and a mesh renderer renders a list of these loaded meshes with specified materials
  */
 class AX_DLL MeshRenderer : public Node, public BlendProtocol
 {
+    friend class MeshCuller;
+
 public:
     /**
      * Creates an empty MeshRenderer without a mesh or a texture.
@@ -234,6 +237,10 @@ public:
      */
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
 
+    /** Registers into the MeshCuller of the scene. */
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
     /** generate default material. */
     void genMaterial(bool useLight = false);
 
@@ -327,6 +334,11 @@ protected:
     bool _usingAutogeneratedGLProgram;
     bool _transparentMaterialHint; // Generate transparent materials when building from files
     unsigned short _meshTextureHint; // Whether model file has texture config
+    bool _instancing;                // the instances aren't bounded by the aabb, so they are never culled
+
+    MeshCuller* _meshCuller;  // the culler of the scene, while running
+    int _cullingIndex;        // index in the culler
+    uint32_t _cullingStamp;   // culling pass that found the renderer in the frustum
 
     struct AsyncLoadParam
     {
@@ -59,6 +59,9 @@ AudioCache::AudioCache()
     , _id(++__idIndex)
     , _isLoadingFinished(false)
     , _isSkipReadDataTask(false)
+    , _pcmBytes(0)
+    , _lastUse(0)
+    , _pinned(false)
 {
     AXLOGV("AudioCache() {}, id={}", fmt::ptr(this), _id);
     for (int i = 0; i < QUEUEBUFFER_NUM; ++i)
@@ -285,7 +288,8 @@ void AudioCache::readDataTask(unsigned int selfId)
                 break;
             }
 
-            _state = State::READY;
+            _pcmBytes = dataSize;
+            _state    = State::READY;
         }
         else
         {
@@ -302,7 +306,8 @@ void AudioCache::readDataTask(unsigned int selfId)
                 decoder->readFixedFrames(_queBufferFrames, _queBuffers[index]);
             }
 
-            _state = State::READY;
+            _pcmBytes = queBufferBytes * QUEUEBUFFER_NUM;
+            _state    = State::READY;
         }
 
     } while (false);
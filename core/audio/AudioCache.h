@@ -104,6 +104,11 @@ protected:
     bool _isLoadingFinished;
     bool _isSkipReadDataTask;
 
+    // PCM memory budget related stuff, see AudioEngine::setPcmCacheBudget
+    uint32_t _pcmBytes;  // decoded data held, the queue buffers only for streamed files
+    uint64_t _lastUse;   // engine use tick, for LRU eviction
+    bool _pinned;
+
     friend class AudioEngineImpl;
     friend class AudioPlayer;
 };
@@ -51,6 +51,7 @@ hlookup::string_map<std::list<AUDIO_ID>> AudioEngine::_audioPathIDMap;
 // profileName,ProfileHelper
 hlookup::string_map<AudioEngine::ProfileHelper> AudioEngine::_audioPathProfileHelperMap;
 unsigned int AudioEngine::_maxInstances                        = MAX_AUDIOINSTANCES;
+size_t AudioEngine::_pcmCacheBudget                            = 0;
 AudioEngine::ProfileHelper* AudioEngine::_defaultProfileHelper = nullptr;
 std::unordered_map<AUDIO_ID, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
@@ -373,6 +374,41 @@ void AudioEngine::uncacheAll()
     _audioEngineImpl->uncacheAll();
 }
 
+void AudioEngine::setPcmCacheBudget(size_t bytes)
+{
+    _pcmCacheBudget = bytes;
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->trimCaches();
+    }
+}
+
+void AudioEngine::setCachePinned(std::string_view filePath, bool pinned)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    lazyInit();
+
+    if (_audioEngineImpl && FileUtils::getInstance()->isFileExist(filePath))
+    {
+        _audioEngineImpl->setCachePinned(filePath, pinned);
+    }
+}
+
+AudioCacheStats AudioEngine::getCacheStats()
+{
+    AudioCacheStats stats;
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->getCacheStats(stats);
+    }
+    stats.budget = _pcmCacheBudget;
+    return stats;
+}
+
 float AudioEngine::getDuration(AUDIO_ID audioID)
 {
     auto it = _audioIDInfoMap.find(audioID);
@@ -388,6 +424,16 @@ float AudioEngine::getDuration(AUDIO_ID audioID)
     return TIME_UNKNOWN;
 }
 
+bool AudioEngine::getStreamStats(AUDIO_ID audioID, AudioStreamStats& stats)
+{
+    auto it = _audioIDInfoMap.find(audioID);
+    if (it != _audioIDInfoMap.end() && it->second.state != AudioState::INITIALIZING)
+    {
+        return _audioEngineImpl->getStreamStats(audioID, stats);
+    }
+    return false;
+}
+
 bool AudioEngine::setCurrentTime(AUDIO_ID audioID, float time)
 {
     auto it = _audioIDInfoMap.find(audioID);
@@ -526,7 +572,7 @@ void AudioEngine::preload(std::string_view filePath, std::function<void(bool isS
 void AudioEngine::addTask(const std::function<void()>& task)
 {
     lazyInit();
-    Director::getInstance()->getJobSystem()->enqueue(task);
+    Director::getInstance()->getJobSystem()->run(task, JobPriority::Low);
 }
 
 int AudioEngine::getPlayingAudioCount()
@@ -31,6 +31,7 @@
 #include "audio/AudioMacros.h"
 #include <functional>
 #include <list>
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -84,6 +85,36 @@ public:
     AudioProfile() : maxInstances(0), minDelay(0.0) {}
 };
 
+/**
+ * @struct AudioStreamStats
+ *
+ * @brief Refill statistics of a streamed audio instance, see AudioEngine::getStreamStats.
+ * @js NA
+ */
+struct AX_DLL AudioStreamStats
+{
+    unsigned int refills    = 0;     // Number of queue buffers decoded and queued again.
+    unsigned int underruns  = 0;     // Number of times the source ran dry and had to be restarted.
+    float lastRefillLatency = 0.0f;  // Seconds from the scheduled refill until the buffers were queued again.
+    float maxRefillLatency  = 0.0f;  // Highest refill latency so far.
+};
+
+/**
+ * @struct AudioCacheStats
+ *
+ * @brief Memory held by the decoded audio caches, see AudioEngine::getCacheStats.
+ * @js NA
+ */
+struct AX_DLL AudioCacheStats
+{
+    size_t budget           = 0;  // The PCM budget in bytes, 0 if unlimited.
+    size_t totalBytes       = 0;  // Decoded PCM held by all caches, streamed files only hold their queue buffers.
+    size_t pinnedBytes      = 0;  // Part of totalBytes held by pinned caches.
+    unsigned int cacheCount = 0;  // Number of cached files, loading ones included.
+    unsigned int evictions  = 0;  // Caches evicted to fit the budget so far.
+    std::map<std::string, size_t> bytesPerFormat;  // totalBytes by sample format, e.g. "stereo16".
+};
+
 class AudioEngineImpl;
 
 /**
@@ -260,6 +291,17 @@ public:
      */
     static float getDuration(AUDIO_ID audioID);
 
+    /**
+     * Gets the refill statistics of a streamed audio instance.
+     * Long audio files are streamed through a few queue buffers which a shared worker thread refills
+     * before the source runs dry, small files are played from memory and have no statistics.
+     *
+     * @param audioID An audioID returned by the play2d function.
+     * @param stats   Receives the statistics.
+     * @return True if the audio instance is streamed, false otherwise.
+     */
+    static bool getStreamStats(AUDIO_ID audioID, AudioStreamStats& stats);
+
     /**
      * Returns the state of an audio instance.
      *
@@ -304,6 +346,30 @@ public:
      */
     static void uncacheAll();
 
+    /**
+     * Sets the memory budget of the decoded PCM data kept by the audio caches.
+     * Once it's exceeded, the least recently used caches which are neither pinned nor played by an audio instance
+     * are uncached. The budget is enforced when audio is preloaded or played and when an audio instance finishes.
+     *
+     * @param bytes The budget in bytes, 0 (the default) means unlimited.
+     */
+    static void setPcmCacheBudget(size_t bytes);
+
+    /** Gets the memory budget of the decoded PCM data, 0 if unlimited. */
+    static size_t getPcmCacheBudget() { return _pcmCacheBudget; }
+
+    /**
+     * Pins an audio file in the cache, so the PCM budget never evicts it; useful for latency critical effects.
+     * Pinning preloads the file if needed, uncache still releases a pinned file.
+     *
+     * @param filePath The path of an audio file.
+     * @param pinned Whether the file is pinned.
+     */
+    static void setCachePinned(std::string_view filePath, bool pinned);
+
+    /** Gets the memory held by the audio caches. */
+    static AudioCacheStats getCacheStats();
+
     /**
      * Gets the audio profile by id of audio instance.
      *
@@ -396,6 +462,8 @@ protected:
 
     static unsigned int _maxInstances;
 
+    static size_t _pcmCacheBudget;
+
     static ProfileHelper* _defaultProfileHelper;
 
     static AudioEngineImpl* _audioEngineImpl;
@@ -40,6 +40,10 @@
 #include "base/Scheduler.h"
 #include "base/Utils.h"
 
+#include "yasio/thread_name.hpp"
+
+#include <algorithm>
+
 #if AX_USE_ALSOFT
 #    include "alc/inprogext.h"
 #endif
@@ -315,7 +319,7 @@ ALvoid ax::AudioEngineImpl::myAlSourceNotificationCallback(ALuint sid, ALuint no
         player = e.second;
         if (player->_alSource == sid && player->_streamingSource)
         {
-            player->wakeupRotateThread();
+            s_instance->_wakeStream(player);
         }
     }
     s_instance->_threadMutex.unlock();
@@ -325,13 +329,31 @@ ALvoid ax::AudioEngineImpl::myAlSourceNotificationCallback(ALuint sid, ALuint no
 namespace ax
 {
 
-AudioEngineImpl::AudioEngineImpl() : _scheduled(false), _currentAudioID(0), _scheduler(nullptr)
+AudioEngineImpl::AudioEngineImpl()
+    : _scheduled(false)
+    , _currentAudioID(0)
+    , _scheduler(nullptr)
+    , _cacheUseTick(0)
+    , _cacheEvictions(0)
+    , _streamingPlayer(nullptr)
+    , _streamThreadExit(false)
 {
     s_instance = this;
 }
 
 AudioEngineImpl::~AudioEngineImpl()
 {
+    if (_streamThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lck(_streamMutex);
+            _streamThreadExit = true;
+            _streamQueue.clear();
+        }
+        _streamCondition.notify_all();
+        _streamThread.join();
+    }
+
     if (_scheduled && _scheduler != nullptr)
     {
         _scheduler->unschedule(AX_SCHEDULE_SELECTOR(AudioEngineImpl::update), this);
@@ -502,6 +524,9 @@ AudioCache* AudioEngineImpl::preload(std::string_view filePath, std::function<vo
     auto it = _audioCaches.find(filePath);
     if (it == _audioCaches.end())
     {
+        // make room before the new file gets decoded
+        trimCaches();
+
         audioCache = new AudioCache();  // hlookup_second(it);
         _audioCaches.emplace(filePath, std::unique_ptr<AudioCache>(audioCache));
         audioCache->_fileFullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
@@ -522,6 +547,8 @@ AudioCache* AudioEngineImpl::preload(std::string_view filePath, std::function<vo
         audioCache = it->second.get();
     }
 
+    audioCache->_lastUse = ++_cacheUseTick;
+
     if (audioCache && callback)
     {
         audioCache->addLoadCallback(callback);
@@ -529,6 +556,130 @@ AudioCache* AudioEngineImpl::preload(std::string_view filePath, std::function<vo
     return audioCache;
 }
 
+void AudioEngineImpl::setCachePinned(std::string_view filePath, bool pinned)
+{
+    auto audioCache = preload(filePath, nullptr);
+    if (audioCache->_pinned != pinned)
+    {
+        audioCache->_pinned = pinned;
+        if (!pinned)
+            trimCaches();
+    }
+}
+
+static const char* alFormatName(ALenum format)
+{
+    switch (format)
+    {
+    case AL_FORMAT_MONO8:
+        return "mono8";
+    case AL_FORMAT_STEREO8:
+        return "stereo8";
+    case AL_FORMAT_MONO16:
+        return "mono16";
+    case AL_FORMAT_STEREO16:
+        return "stereo16";
+#if AX_USE_ALSOFT
+    case AL_FORMAT_MONO_FLOAT32:
+        return "monoFloat32";
+    case AL_FORMAT_STEREO_FLOAT32:
+        return "stereoFloat32";
+    case AL_FORMAT_MONO_DOUBLE_EXT:
+        return "monoDouble";
+    case AL_FORMAT_STEREO_DOUBLE_EXT:
+        return "stereoDouble";
+    case AL_FORMAT_MONO_MULAW:
+        return "monoMulaw";
+    case AL_FORMAT_STEREO_MULAW:
+        return "stereoMulaw";
+    case AL_FORMAT_MONO_ALAW_EXT:
+        return "monoAlaw";
+    case AL_FORMAT_STEREO_ALAW_EXT:
+        return "stereoAlaw";
+    case AL_FORMAT_MONO_MSADPCM_SOFT:
+        return "monoMsAdpcm";
+    case AL_FORMAT_STEREO_MSADPCM_SOFT:
+        return "stereoMsAdpcm";
+    case AL_FORMAT_MONO_IMA4:
+        return "monoIma4";
+    case AL_FORMAT_STEREO_IMA4:
+        return "stereoIma4";
+#endif
+    default:
+        return "unknown";
+    }
+}
+
+void AudioEngineImpl::getCacheStats(AudioCacheStats& stats)
+{
+    stats.cacheCount = static_cast<unsigned int>(_audioCaches.size());
+    stats.evictions  = _cacheEvictions;
+    for (auto&& item : _audioCaches)
+    {
+        auto audioCache = item.second.get();
+        if (audioCache->_state != AudioCache::State::READY)
+            continue;
+
+        stats.totalBytes += audioCache->_pcmBytes;
+        if (audioCache->_pinned)
+            stats.pinnedBytes += audioCache->_pcmBytes;
+        stats.bytesPerFormat[alFormatName(audioCache->_format)] += audioCache->_pcmBytes;
+    }
+}
+
+void AudioEngineImpl::trimCaches()
+{
+    const auto budget = AudioEngine::_pcmCacheBudget;
+    if (budget == 0)
+        return;
+
+    size_t totalBytes = 0;
+    for (auto&& item : _audioCaches)
+    {
+        if (item.second->_state == AudioCache::State::READY)
+            totalBytes += item.second->_pcmBytes;
+    }
+    if (totalBytes <= budget)
+        return;
+
+    std::lock_guard<std::recursive_mutex> lck(_threadMutex);
+
+    // caches still referenced by a player must stay alive
+    std::vector<AudioCache*> playedCaches;
+    for (auto&& item : _audioPlayers)
+    {
+        if (item.second->_audioCache)
+            playedCaches.emplace_back(item.second->_audioCache);
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (auto&& item : _audioCaches)
+    {
+        auto audioCache = item.second.get();
+        if (audioCache->_pinned || !audioCache->_isLoadingFinished || audioCache->_pcmBytes == 0)
+            continue;
+        if (std::find(playedCaches.begin(), playedCaches.end(), audioCache) != playedCaches.end())
+            continue;
+        candidates.emplace_back(audioCache->_lastUse, item.first);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto&& candidate : candidates)
+    {
+        if (totalBytes <= budget)
+            break;
+
+        auto it = _audioCaches.find(candidate.second);
+        totalBytes -= it->second->_pcmBytes;
+        AXLOGV("AudioEngineImpl::trimCaches, evict {}, {} bytes", candidate.second, it->second->_pcmBytes);
+        _audioCaches.erase(it);
+        ++_cacheEvictions;
+    }
+
+    if (totalBytes > budget)
+        AXLOGW("Audio PCM caches hold {} bytes, over the budget of {} bytes", totalBytes, budget);
+}
+
 AUDIO_ID AudioEngineImpl::play2d(std::string_view filePath, bool loop, float volume, float time)
 {
     if (s_ALDevice == nullptr)
@@ -548,6 +699,7 @@ AUDIO_ID AudioEngineImpl::play2d(std::string_view filePath, bool loop, float vol
         return AudioEngine::INVALID_AUDIO_ID;
     }
 
+    player->_engine   = this;
     player->_alSource = alSource;
     player->_loop     = loop;
     player->_volume   = volume;
@@ -894,6 +1046,141 @@ void AudioEngineImpl::setFinishCallback(AUDIO_ID audioID,
     player->_finishCallbak = callback;
 }
 
+bool AudioEngineImpl::getStreamStats(AUDIO_ID audioID, AudioStreamStats& stats)
+{
+    std::unique_lock<std::recursive_mutex> lck(_threadMutex);
+    auto iter = _audioPlayers.find(audioID);
+    if (iter == _audioPlayers.end() || !iter->second->_streamingSource)
+        return false;
+
+    auto player = iter->second;
+    std::lock_guard<std::mutex> streamLock(_streamMutex);
+    stats = player->_streamStats;
+    return true;
+}
+
+void AudioEngineImpl::_addStream(AudioPlayer* player)
+{
+    std::lock_guard<std::mutex> lck(_streamMutex);
+    if (!_streamThread.joinable())
+        _streamThread = std::thread(&AudioEngineImpl::_streamThreadProc, this);
+
+    // the first refill opens the decoder, so do it right away
+    _scheduleStream(player, StreamClock::now());
+}
+
+void AudioEngineImpl::_removeStream(AudioPlayer* player)
+{
+    std::unique_lock<std::mutex> lck(_streamMutex);
+    auto it = std::remove_if(_streamQueue.begin(), _streamQueue.end(),
+                             [player](const StreamEntry& entry) { return entry.player == player; });
+    if (it != _streamQueue.end())
+    {
+        _streamQueue.erase(it, _streamQueue.end());
+        std::make_heap(_streamQueue.begin(), _streamQueue.end());
+    }
+
+    _streamCondition.wait(lck, [this, player] { return _streamingPlayer != player; });
+}
+
+void AudioEngineImpl::_wakeStream(AudioPlayer* player)
+{
+    std::lock_guard<std::mutex> lck(_streamMutex);
+    for (auto&& entry : _streamQueue)
+    {
+        if (entry.player == player)
+        {
+            entry.deadline = StreamClock::now();
+            std::make_heap(_streamQueue.begin(), _streamQueue.end());
+            _streamCondition.notify_all();
+            break;
+        }
+    }
+}
+
+void AudioEngineImpl::_scheduleStream(AudioPlayer* player, StreamClock::time_point deadline)
+{
+    _streamQueue.emplace_back(StreamEntry{deadline, player});
+    std::push_heap(_streamQueue.begin(), _streamQueue.end());
+    _streamCondition.notify_all();
+}
+
+void AudioEngineImpl::_streamThreadProc()
+{
+    yasio::set_thread_name("axmol-audio");
+
+    using namespace std::chrono;
+
+    // a player is due once its first queue buffer has been played, i.e. one buffer before the other ones run out
+    const auto refillLead = duration_cast<StreamClock::duration>(
+        duration<float>((QUEUEBUFFER_NUM - 1) * QUEUEBUFFER_TIME_STEP));
+    const auto minWait  = milliseconds(5);
+    const auto pollWait = duration_cast<StreamClock::duration>(duration<float>(QUEUEBUFFER_TIME_STEP / 2));
+
+    std::unique_lock<std::mutex> lck(_streamMutex);
+    while (!_streamThreadExit)
+    {
+        if (_streamQueue.empty())
+        {
+            _streamCondition.wait(lck);
+            continue;
+        }
+
+        const auto dueTime = _streamQueue.front().deadline - refillLead;
+        if (StreamClock::now() < dueTime)
+        {
+            _streamCondition.wait_until(lck, dueTime);
+            continue;
+        }
+
+        std::pop_heap(_streamQueue.begin(), _streamQueue.end());
+        auto player = _streamQueue.back().player;
+        _streamQueue.pop_back();
+        _streamingPlayer = player;
+        lck.unlock();
+
+        float queuedTime      = 0.0f;
+        unsigned int refilled = 0;
+        bool underrun         = false;
+        bool streaming        = player->rotateBuffers(queuedTime, refilled, underrun);
+        if (!streaming)
+            player->closeStream();
+
+        const auto now = StreamClock::now();
+        lck.lock();
+        _streamingPlayer = nullptr;
+
+        auto& stats = player->_streamStats;
+        if (refilled > 0)
+        {
+            stats.refills += refilled;
+            stats.lastRefillLatency = std::max(duration<float>(now - dueTime).count(), 0.0f);
+            stats.maxRefillLatency  = std::max(stats.maxRefillLatency, stats.lastRefillLatency);
+        }
+        if (underrun)
+        {
+            ++stats.underruns;
+            AXLOGW("audio stream underrun, player id={}, underruns={}", player->_id, stats.underruns);
+        }
+
+        // a destroyed player is waiting in _removeStream, don't queue it again
+        if (streaming && !player->_isDestroyed)
+        {
+            // paused or restarted sources are polled, playing ones are woken when their next buffer is consumed
+            auto wait = queuedTime < 0.0f
+                            ? pollWait
+                            : duration_cast<StreamClock::duration>(duration<float>(queuedTime)) - refillLead;
+            wait = std::clamp<StreamClock::duration>(wait, minWait, pollWait * 2);
+            _scheduleStream(player, now + wait + refillLead);
+        }
+        else if (!streaming)
+            player->_streamFinished = true;
+
+        // wakes up _removeStream
+        _streamCondition.notify_all();
+    }
+}
+
 void AudioEngineImpl::update(float /*dt*/)
 {
     std::unique_lock<std::recursive_mutex> lck(_threadMutex);
@@ -905,6 +1192,7 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
     AUDIO_ID audioID;
     AudioPlayer* player;
     ALuint alSource;
+    bool playersRemoved = false;
 
     //    AXLOGV("AudioPlayer count: {}", (int)_audioPlayers.size());
     for (auto it = _audioPlayers.begin(); it != _audioPlayers.end();)
@@ -920,6 +1208,7 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
             it = _audioPlayers.erase(it);
             delete player;
             _unusedSourcesPool.push(alSource);
+            playersRemoved = true;
         }
         else if (player->_ready && player->isFinished())
         {
@@ -948,6 +1237,7 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
             player->setCache(nullptr);
             delete player;
             _unusedSourcesPool.push(alSource);
+            playersRemoved = true;
         }
         else
         {
@@ -955,6 +1245,10 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
         }
     }
 
+    // the caches of finished players may be evicted now
+    if (playersRemoved)
+        trimCaches();
+
     // don't invoke finish callback when stop/stopAll to avoid stack overflow
     if (AX_LIKELY(!forStop))
     {
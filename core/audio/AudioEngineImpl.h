@@ -31,6 +31,11 @@
 
 #    include <unordered_map>
 #    include <queue>
+#    include <vector>
+#    include <chrono>
+#    include <thread>
+#    include <mutex>
+#    include <condition_variable>
 
 #    include "base/Object.h"
 #    include "audio/AudioMacros.h"
@@ -61,13 +66,40 @@ public:
     float getCurrentTime(AUDIO_ID audioID);
     bool setCurrentTime(AUDIO_ID audioID, float time);
     void setFinishCallback(AUDIO_ID audioID, const std::function<void(AUDIO_ID, std::string_view)>& callback);
+    bool getStreamStats(AUDIO_ID audioID, AudioStreamStats& stats);
 
     void uncache(std::string_view filePath);
     void uncacheAll();
     AudioCache* preload(std::string_view filePath, std::function<void(bool)> callback);
+    void setCachePinned(std::string_view filePath, bool pinned);
+    void getCacheStats(AudioCacheStats& stats);
+    // evicts the least recently used caches which aren't pinned or played until the PCM budget is met
+    void trimCaches();
     void update(float dt);
 
 private:
+    friend class AudioPlayer;
+
+    using StreamClock = std::chrono::steady_clock;
+
+    // a streaming player and the time its queued buffers run dry
+    struct StreamEntry
+    {
+        StreamClock::time_point deadline;
+        AudioPlayer* player;
+
+        // reversed, so the std heap algorithms keep the earliest deadline on top
+        bool operator<(const StreamEntry& other) const { return deadline > other.deadline; }
+    };
+
+    // streaming worker: a single thread refills the queue buffers of all streaming players,
+    // the player closest to an underrun first
+    void _addStream(AudioPlayer* player);
+    void _removeStream(AudioPlayer* player);
+    void _wakeStream(AudioPlayer* player);
+    void _scheduleStream(AudioPlayer* player, StreamClock::time_point deadline);
+    void _streamThreadProc();
+
     // query players state per frame and dispatch finish callback if possible
     void _updatePlayers(bool forStop);
     void _play2d(AudioCache* cache, AUDIO_ID audioID);
@@ -95,6 +127,18 @@ private:
 
     AUDIO_ID _currentAudioID;
     Scheduler* _scheduler;
+
+    uint64_t _cacheUseTick;
+    unsigned int _cacheEvictions;
+
+    std::thread _streamThread;
+    std::mutex _streamMutex;
+    std::condition_variable _streamCondition;
+    // min-heap on deadline
+    std::vector<StreamEntry> _streamQueue;
+    // the player the worker is refilling right now
+    AudioPlayer* _streamingPlayer;
+    bool _streamThreadExit;
 };
 
 }
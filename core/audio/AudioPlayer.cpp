@@ -32,8 +32,7 @@
 #include "platform/FileUtils.h"
 #include "audio/AudioDecoder.h"
 #include "audio/AudioDecoderManager.h"
-
-#include "yasio/thread_name.hpp"
+#include "audio/AudioEngineImpl.h"
 
 namespace ax
 {
@@ -51,12 +50,13 @@ AudioPlayer::AudioPlayer()
     , _ready(false)
     , _currTime(0.0f)
     , _streamingSource(false)
-    , _rotateBufferThread(nullptr)
     , _timeDirty(false)
-    , _isRotateThreadExited(false)
-#if defined(__APPLE__)
-    , _needWakeupRotateThread(false)
-#endif
+    , _streamFinished(false)
+    , _engine(nullptr)
+    , _streamDecoder(nullptr)
+    , _streamBuffer(nullptr)
+    , _streamOffsetFrame(0)
+    , _streamOpened(false)
     , _id(++__playerIdIndex)
 {
     memset(_bufferIds, 0, sizeof(_bufferIds));
@@ -101,22 +101,12 @@ void AudioPlayer::destroy()
 
         if (_streamingSource)
         {
-            if (_rotateBufferThread != nullptr)
+            if (_engine != nullptr)
             {
-                while (!_isRotateThreadExited)
-                {
-                    _sleepCondition.notify_one();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
-                }
-
-                if (_rotateBufferThread->joinable())
-                {
-                    _rotateBufferThread->join();
-                }
-
-                delete _rotateBufferThread;
-                _rotateBufferThread = nullptr;
-                AXLOGV("{}", "rotateBufferThread exited!");
+                // waits until the streaming worker is done with this player
+                _engine->_removeStream(this);
+                closeStream();
+                AXLOGV("{}", "stream removed!");
 
 #if AX_TARGET_PLATFORM == AX_PLATFORM_IOS
                 // some specific OpenAL implement defects existed on iOS platform
@@ -228,8 +218,7 @@ bool AudioPlayer::play2d()
                 // To continuously stream audio from a source without interruption, buffer queuing is required.
                 alSourceQueueBuffers(_alSource, QUEUEBUFFER_NUM, _bufferIds);
                 CHECK_AL_ERROR_DEBUG();
-                _rotateBufferThread = new std::thread(&AudioPlayer::rotateBufferThread, this,
-                                                      _audioCache->_queBufferFrames * QUEUEBUFFER_NUM + 1);
+                _streamOffsetFrame = _audioCache->_queBufferFrames * QUEUEBUFFER_NUM + 1;
             }
             else
             {
@@ -247,6 +236,11 @@ bool AudioPlayer::play2d()
             break;
         }
 
+        if (_streamingSource)
+        {
+            _engine->_addStream(this);
+        }
+
         ALint state;
         alGetSourcei(_alSource, AL_SOURCE_STATE, &state);
         if (state != AL_PLAYING)
@@ -275,159 +269,150 @@ bool AudioPlayer::play2d()
     return ret;
 }
 
-// rotateBufferThread is used to rotate alBufferData for _alSource when playing big audio file
-void AudioPlayer::rotateBufferThread(int offsetFrame)
+// rotateBuffers is used to rotate alBufferData for _alSource when playing big audio file
+bool AudioPlayer::rotateBuffers(float& queuedTime, unsigned int& refilled, bool& underrun)
 {
-    yasio::set_thread_name("axmol-audio");
+    queuedTime = -1.0f;
+    refilled   = 0;
+    underrun   = false;
 
-    char* tmpBuffer           = nullptr;
-    auto& fullPath            = _audioCache->_fileFullPath;
-    AudioDecoder* decoder     = AudioDecoderManager::createDecoder(fullPath);
-    long long rotateSleepTime = static_cast<long long>(QUEUEBUFFER_TIME_STEP * 1000) / 2;
-    do
+    if (!_streamOpened)
     {
-        BREAK_IF(decoder == nullptr || !decoder->open(fullPath));
+        _streamOpened  = true;
+        auto& fullPath = _audioCache->_fileFullPath;
+        _streamDecoder = AudioDecoderManager::createDecoder(fullPath);
+        if (_streamDecoder == nullptr || !_streamDecoder->open(fullPath))
+        {
+            return false;
+        }
 
-        uint32_t framesRead         = 0;
-        const uint32_t framesToRead = _audioCache->_queBufferFrames;
-        const uint32_t bufferSize   = decoder->framesToBytes(framesToRead);
-#if AX_USE_ALSOFT
-        const auto sourceFormat = decoder->getSourceFormat();
-#endif
-        tmpBuffer = (char*)malloc(bufferSize);
-        memset(tmpBuffer, 0, bufferSize);
+        const uint32_t bufferSize = _streamDecoder->framesToBytes(_audioCache->_queBufferFrames);
+        _streamBuffer             = (char*)malloc(bufferSize);
+        memset(_streamBuffer, 0, bufferSize);
 
-        if (offsetFrame != 0)
+        if (_streamOffsetFrame != 0)
         {
-            decoder->seek(offsetFrame);
+            _streamDecoder->seek(_streamOffsetFrame);
         }
+    }
 
-        ALint sourceState;
-        ALint bufferProcessed = 0;
-        bool needToExitThread = false;
+    if (_isDestroyed)
+    {
+        return false;
+    }
 
-        while (!_isDestroyed)
+    auto decoder                = _streamDecoder;
+    uint32_t framesRead         = 0;
+    const uint32_t framesToRead = _audioCache->_queBufferFrames;
+#if AX_USE_ALSOFT
+    const auto sourceFormat = decoder->getSourceFormat();
+#endif
+
+    ALint sourceState;
+    ALint bufferProcessed = 0;
+    alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+    if (sourceState == AL_PLAYING)
+    {
+        alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
+        while (bufferProcessed > 0)
         {
-            alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
-            if (sourceState == AL_PLAYING)
+            bufferProcessed--;
+            if (_timeDirty)
+            {
+                _timeDirty         = false;
+                _streamOffsetFrame = _currTime * decoder->getSampleRate() * decoder->getChannelCount();
+                decoder->seek(_streamOffsetFrame);
+            }
+            else
             {
-                alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
-                while (bufferProcessed > 0)
+                _currTime += QUEUEBUFFER_TIME_STEP;
+                if (_currTime > _audioCache->_duration)
                 {
-                    bufferProcessed--;
-                    if (_timeDirty)
+                    if (_loop)
                     {
-                        _timeDirty  = false;
-                        offsetFrame = _currTime * decoder->getSampleRate() * decoder->getChannelCount();
-                        decoder->seek(offsetFrame);
+                        _currTime = 0.0f;
                     }
                     else
                     {
-                        _currTime += QUEUEBUFFER_TIME_STEP;
-                        if (_currTime > _audioCache->_duration)
-                        {
-                            if (_loop)
-                            {
-                                _currTime = 0.0f;
-                            }
-                            else
-                            {
-                                _currTime = _audioCache->_duration;
-                            }
-                        }
+                        _currTime = _audioCache->_duration;
                     }
-
-                    framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
-
-                    if (framesRead == 0)
-                    {
-                        if (_loop)
-                        {
-                            decoder->seek(0);
-                            framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
-                        }
-                        else
-                        {
-                            needToExitThread = true;
-                            break;
-                        }
-                    }
-                    /*
-                     While the source is playing, alSourceUnqueueBuffers can be called to remove buffers which have
-                     already played. Those buffers can then be filled with new data or discarded. New or refilled
-                     buffers can then be attached to the playing source using alSourceQueueBuffers. As long as there is
-                     always a new buffer to play in the queue, the source will continue to play.
-                     */
-                    ALuint bid;
-                    alSourceUnqueueBuffers(_alSource, 1, &bid);
-#if AX_USE_ALSOFT
-                    if (sourceFormat == AUDIO_SOURCE_FORMAT::ADPCM || sourceFormat == AUDIO_SOURCE_FORMAT::IMA_ADPCM)
-                        alBufferi(bid, AL_UNPACK_BLOCK_ALIGNMENT_SOFT, decoder->getSamplesPerBlock());
-#endif
-                    alBufferData(bid, _audioCache->_format, tmpBuffer, decoder->framesToBytes(framesRead),
-                                 decoder->getSampleRate());
-                    alSourceQueueBuffers(_alSource, 1, &bid);
                 }
             }
-            /* Make sure the source hasn't underrun */
-            else if (sourceState != AL_PAUSED)
-            {
-                ALint queued;
 
-                /* If no buffers are queued, playback is finished */
-                alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
-                if (queued == 0)
+            framesRead = decoder->readFixedFrames(framesToRead, _streamBuffer);
+
+            if (framesRead == 0)
+            {
+                if (_loop)
                 {
-                    needToExitThread = true;
+                    decoder->seek(0);
+                    framesRead = decoder->readFixedFrames(framesToRead, _streamBuffer);
                 }
                 else
                 {
-                    alSourcePlay(_alSource);
-                    if (alGetError() != AL_NO_ERROR)
-                    {
-                        AXLOGE("{}", "Error restarting playback!");
-                        needToExitThread = true;
-                    }
+                    return false;
                 }
             }
+            /*
+             While the source is playing, alSourceUnqueueBuffers can be called to remove buffers which have
+             already played. Those buffers can then be filled with new data or discarded. New or refilled
+             buffers can then be attached to the playing source using alSourceQueueBuffers. As long as there is
+             always a new buffer to play in the queue, the source will continue to play.
+             */
+            ALuint bid;
+            alSourceUnqueueBuffers(_alSource, 1, &bid);
+#if AX_USE_ALSOFT
+            if (sourceFormat == AUDIO_SOURCE_FORMAT::ADPCM || sourceFormat == AUDIO_SOURCE_FORMAT::IMA_ADPCM)
+                alBufferi(bid, AL_UNPACK_BLOCK_ALIGNMENT_SOFT, decoder->getSamplesPerBlock());
+#endif
+            alBufferData(bid, _audioCache->_format, _streamBuffer, decoder->framesToBytes(framesRead),
+                         decoder->getSampleRate());
+            alSourceQueueBuffers(_alSource, 1, &bid);
+            ++refilled;
+        }
 
-            std::unique_lock<std::mutex> lk(_sleepMutex);
-            if (_isDestroyed || needToExitThread)
-            {
-                break;
-            }
-#if defined(__APPLE__)
-            if (!_needWakeupRotateThread)
-            {
-                _sleepCondition.wait_for(lk, std::chrono::milliseconds(rotateSleepTime));
-            }
+        ALint queued;
+        ALfloat offset = 0.0f;
+        alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+        alGetSourcef(_alSource, AL_SEC_OFFSET, &offset);
+        queuedTime = queued * QUEUEBUFFER_TIME_STEP - offset;
+    }
+    /* Make sure the source hasn't underrun */
+    else if (sourceState != AL_PAUSED)
+    {
+        ALint queued;
 
-            _needWakeupRotateThread = false;
-#else
-            _sleepCondition.wait_for(lk, std::chrono::milliseconds(rotateSleepTime));
-#endif
+        /* If no buffers are queued, playback is finished */
+        alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+        if (queued == 0)
+        {
+            return false;
         }
 
-    } while (false);
+        underrun = true;
+        alSourcePlay(_alSource);
+        if (alGetError() != AL_NO_ERROR)
+        {
+            AXLOGE("{}", "Error restarting playback!");
+            return false;
+        }
+    }
 
-    AXLOGV("{}", "Exit rotate buffer thread ...");
-    AudioDecoderManager::destroyDecoder(decoder);
-    free(tmpBuffer);
-    _isRotateThreadExited = true;
+    return true;
 }
 
-#if defined(__APPLE__)
-void AudioPlayer::wakeupRotateThread()
+void AudioPlayer::closeStream()
 {
-    _needWakeupRotateThread = true;
-    _sleepCondition.notify_all();
+    AudioDecoderManager::destroyDecoder(_streamDecoder);
+    _streamDecoder = nullptr;
+    free(_streamBuffer);
+    _streamBuffer = nullptr;
 }
-#endif
 
 bool AudioPlayer::isFinished() const
 {
     if (_streamingSource)
-        return _isRotateThreadExited;
+        return _streamFinished;
     else
     {
         ALint sourceState;
@@ -29,11 +29,11 @@
 #include "platform/PlatformConfig.h"
 
 #include <string>
-#include <condition_variable>
+#include <atomic>
 #include <mutex>
-#include <thread>
 
 #include "audio/AudioMacros.h"
+#include "audio/AudioEngine.h"
 #include "platform/PlatformMacros.h"
 #include "audio/alconfig.h"
 
@@ -41,6 +41,7 @@ namespace ax
 {
 
 class AudioCache;
+class AudioDecoder;
 class AudioEngineImpl;
 
 class AX_DLL AudioPlayer
@@ -62,11 +63,16 @@ public:
 
 protected:
     void setCache(AudioCache* cache);
-    void rotateBufferThread(int offsetFrame);
     bool play2d();
-#if defined(__APPLE__)
-    void wakeupRotateThread();
-#endif
+
+    /** Refills the processed queue buffers of a streaming source, called by the engine's streaming worker.
+     * @param queuedTime Receives the seconds of audio left in the queue, negative if the source isn't playing.
+     * @param refilled Receives the number of buffers queued again.
+     * @param underrun Receives whether the source ran dry and was restarted.
+     * @return False once the stream is finished.
+     */
+    bool rotateBuffers(float& queuedTime, unsigned int& refilled, bool& underrun);
+    void closeStream();
 
     AudioCache* _audioCache;
 
@@ -84,14 +90,19 @@ protected:
     float _currTime;
     bool _streamingSource;
     ALuint _bufferIds[QUEUEBUFFER_NUM];
-    std::thread* _rotateBufferThread;
-    std::condition_variable _sleepCondition;
     std::mutex _sleepMutex;
     bool _timeDirty;
-    bool _isRotateThreadExited;
-#if defined(__APPLE__)
-    std::atomic_bool _needWakeupRotateThread;
-#endif
+    std::atomic_bool _streamFinished;
+
+    // streaming state, only touched by the engine's streaming worker
+    AudioEngineImpl* _engine;
+    AudioDecoder* _streamDecoder;
+    char* _streamBuffer;
+    int _streamOffsetFrame;
+    bool _streamOpened;
+
+    // guarded by the engine's streaming mutex
+    AudioStreamStats _streamStats;
 
     std::mutex _play2dMutex;
 
@@ -139,6 +139,8 @@ THE SOFTWARE.
 #include "2d/Transition.h"
 #include "2d/TransitionPageTurn.h"
 #include "2d/TransitionProgress.h"
+#include "2d/TransformSystem.h"
+#include "2d/TweenSystem.h"
 
 // 2d utils
 #include "2d/Camera.h"
@@ -152,6 +154,7 @@ THE SOFTWARE.
 // renderer
 #include "renderer/CallbackCommand.h"
 #include "renderer/CustomCommand.h"
+#include "renderer/FrameArena.h"
 #include "renderer/GroupCommand.h"
 #include "renderer/Material.h"
 #include "renderer/Pass.h"
@@ -160,6 +163,7 @@ THE SOFTWARE.
 #include "renderer/RenderCommandPool.h"
 #include "renderer/RenderState.h"
 #include "renderer/Renderer.h"
+#include "renderer/RenderThread.h"
 #include "renderer/Technique.h"
 #include "renderer/Texture2D.h"
 #include "renderer/TextureCube.h"
@@ -136,7 +136,7 @@ protected:
 
                     task();
                     Director::getInstance()->getScheduler()->runOnAxmolThread(
-                        std::bind(callback.callback, callback.callbackParam));
+                        std::bind(callback.callback, callback.callbackParam), Scheduler::ActionPriority::Background);
                 }
             });
         }
@@ -247,6 +247,15 @@ THE SOFTWARE.
 #    define AX_ENABLE_PROFILERS 0
 #endif
 
+/** @def AX_ENABLE_RENDER_THREAD
+ * If enabled, the reference count of Object is atomic and Renderer::setPipelined can execute the recorded frames on
+ * a render thread. The atomic reference count makes retain/release more expensive, that's why it's an opt-in.
+ * To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef AX_ENABLE_RENDER_THREAD
+#    define AX_ENABLE_RENDER_THREAD 0
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef AX_LUA_ENGINE_DEBUG
 #    define AX_LUA_ENGINE_DEBUG 0
@@ -362,6 +362,7 @@ Console::Console()
     createCommandExit();
     createCommandFileUtils();
     createCommandFps();
+    createCommandFrameTime();
     createCommandHelp();
     createCommandProjection();
     createCommandResolution();
@@ -904,6 +905,14 @@ void Console::createCommandFps()
                           AX_CALLBACK_2(Console::commandFpsSubCommandOnOff, this)});
 }
 
+void Console::createCommandFrameTime()
+{
+    addCommand({"frametime", "Print the frame time percentiles per phase. Args: [-h | help | reset | ]",
+                AX_CALLBACK_2(Console::commandFrameTime, this)});
+    addSubCommand("frametime", {"reset", "Clear the frame time samples.",
+                                AX_CALLBACK_2(Console::commandFrameTimeSubCommandReset, this)});
+}
+
 void Console::createCommandHelp()
 {
     addCommand({"help", "Print this message. Args: [ ]", AX_CALLBACK_2(Console::commandHelp, this)});
@@ -1057,6 +1066,17 @@ void Console::commandFpsSubCommandOnOff(socket_native_type /*fd*/, std::string_v
     sched->runOnAxmolThread(std::bind(&Director::setStatsDisplay, dir, state));
 }
 
+void Console::commandFrameTime(socket_native_type fd, std::string_view /*args*/)
+{
+    // the histogram is lock-free, no need to wait for the axmol thread
+    Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getFrameTimeHistogram().toString().c_str());
+}
+
+void Console::commandFrameTimeSubCommandReset(socket_native_type /*fd*/, std::string_view /*args*/)
+{
+    Director::getInstance()->getFrameTimeHistogram().reset();
+}
+
 void Console::commandHelp(socket_native_type fd, std::string_view /*args*/)
 {
     sendHelp(fd, _commands, "\nAvailable commands:\n");
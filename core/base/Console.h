@@ -220,6 +220,7 @@ protected:
     void createCommandExit();
     void createCommandFileUtils();
     void createCommandFps();
+    void createCommandFrameTime();
     void createCommandHelp();
     void createCommandProjection();
     void createCommandResolution();
@@ -244,6 +245,8 @@ protected:
     void commandFileUtilsSubCommandFlush(socket_native_type fd, std::string_view args);
     void commandFps(socket_native_type fd, std::string_view args);
     void commandFpsSubCommandOnOff(socket_native_type fd, std::string_view args);
+    void commandFrameTime(socket_native_type fd, std::string_view args);
+    void commandFrameTimeSubCommandReset(socket_native_type fd, std::string_view args);
     void commandHelp(socket_native_type fd, std::string_view args);
     void commandProjection(socket_native_type fd, std::string_view args);
     void commandProjectionSubCommand2d(socket_native_type fd, std::string_view args);
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 // standard includes
 #include <string>
+#include <cmath>
 
 #include "2d/SpriteFrameCache.h"
 #include "platform/FileUtils.h"
@@ -62,6 +63,9 @@ THE SOFTWARE.
 #endif
 #include "base/ObjectFactory.h"
 #include "platform/Application.h"
+#if defined(AX_ENABLE_3D)
+#    include "3d/Animate3D.h"
+#endif
 #if defined(AX_ENABLE_AUDIO)
 #    include "audio/AudioEngine.h"
 #endif
@@ -160,6 +164,7 @@ bool Director::init()
     // listen the event that renderer was recreated on Android/WP8
     _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*) {
         _isStatusLabelUpdated = true;  // Force recreation of textures
+        _renderer->invalidateRetainedBatches();
     });
 
     _eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
@@ -274,6 +279,20 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    using Phase = FrameTimeHistogram::Phase;
+
+    auto phaseBegin = std::chrono::steady_clock::now();
+    if (_frameBegin.time_since_epoch().count() != 0)
+        _frameTimeHistogram.record(Phase::FRAME, phaseBegin - _frameBegin);
+    _frameBegin = phaseBegin;
+
+    // records the time since the previous phase ended
+    auto endPhase = [this, &phaseBegin](Phase phase) {
+        auto now = std::chrono::steady_clock::now();
+        _frameTimeHistogram.record(phase, now - phaseBegin);
+        phaseBegin = now;
+    };
+
     _renderer->beginFrame();
 
     // calculate "global" dt
@@ -288,10 +307,31 @@ void Director::drawScene()
     if (!_paused)
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
-        _scheduler->update(_deltaTime);
+        if (_fixedTimeStep > 0)
+        {
+            _fixedTimeAccumulator += _deltaTime;
+            for (int steps = 0; _fixedTimeAccumulator >= _fixedTimeStep; ++steps)
+            {
+                // drop the time beyond the step budget, or a slow frame makes the next ones slower
+                if (steps == _maxFixedTimeSteps)
+                {
+                    _fixedTimeAccumulator = std::fmod(_fixedTimeAccumulator, _fixedTimeStep);
+                    break;
+                }
+                _scheduler->update(_fixedTimeStep);
+                _fixedTimeAccumulator -= _fixedTimeStep;
+            }
+        }
+        else
+            _scheduler->update(_deltaTime);
+#if defined(AX_ENABLE_3D)
+        Animate3D::flushPendingSamples();
+#endif
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
+    endPhase(Phase::UPDATE);
+
     _renderer->clear(ClearFlag::ALL, _clearColor, 1, 0, -10000.0);
 
     _eventDispatcher->dispatchEvent(_eventBeforeDraw);
@@ -337,22 +377,28 @@ void Director::drawScene()
 #endif
     }
 
+    endPhase(Phase::VISIT);
+
     _renderer->render();
 
+    endPhase(Phase::RENDER);
+
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
     popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
     _totalFrames++;
 
-    // swap buffers
-    if (_glView)
+    // swap buffers, the render thread presents the frame when the renderer is pipelined
+    if (_glView && !_renderer->isPipelined())
     {
         _glView->swapBuffers();
     }
 
     _renderer->endFrame();
 
+    endPhase(Phase::SWAP);
+
     if (_statsDisplay)
     {
 #if !AX_STRIP_FPS
@@ -361,6 +407,13 @@ void Director::drawScene()
     }
 }
 
+void Director::setFixedTimeStep(float step, int maxStepsPerFrame)
+{
+    _fixedTimeStep        = MAX(0, step);
+    _maxFixedTimeSteps    = MAX(1, maxStepsPerFrame);
+    _fixedTimeAccumulator = 0.0f;
+}
+
 void Director::calculateDeltaTime()
 {
     // new delta time. Re-fixed issue #1277
@@ -495,8 +548,13 @@ void Director::resetMatrixStack()
     initMatrixStack();
 }
 
+// The deprecated matrix stacks are only maintained by the render thread, the parallel visits of
+// Renderer::deferVisit leave them untouched.
 void Director::popMatrix(MATRIX_STACK_TYPE type)
 {
+    if (Renderer::isParallelVisitThread())
+        return;
+
     if (MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.pop();
@@ -517,6 +575,9 @@ void Director::popMatrix(MATRIX_STACK_TYPE type)
 
 void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
+    if (Renderer::isParallelVisitThread())
+        return;
+
     if (MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() = Mat4::IDENTITY;
@@ -537,6 +598,9 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 
 void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
+    if (Renderer::isParallelVisitThread())
+        return;
+
     if (MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() = mat;
@@ -557,6 +621,9 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 
 void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
+    if (Renderer::isParallelVisitThread())
+        return;
+
     if (MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() *= mat;
@@ -577,6 +644,9 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 
 void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
+    if (Renderer::isParallelVisitThread())
+        return;
+
     if (type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
         _modelViewMatrixStack.push(_modelViewMatrixStack.top());
@@ -977,6 +1047,10 @@ void Director::restart()
 
 void Director::reset()
 {
+    // the render thread may still execute the last frame, which references the scene
+    if (_renderer)
+        _renderer->waitForRenderThread();
+
 #if AX_ENABLE_GC_FOR_NATIVE_OBJECTS
     auto sEngine = ScriptEngineManager::getInstance()->getScriptEngine();
 #endif  // AX_ENABLE_GC_FOR_NATIVE_OBJECTS
@@ -1127,6 +1201,7 @@ void Director::restartDirector()
     // listen the event that renderer was recreated on Android/WP8
     _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*) {
         _isStatusLabelUpdated = true;  // Force recreation of textures
+        _renderer->invalidateRetainedBatches();
     });
 
     _eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
@@ -46,6 +46,7 @@ THE SOFTWARE.
 #endif
 
 #include "base/JobSystem.h"
+#include "base/FrameTimeHistogram.h"
 
 namespace ax
 {
@@ -459,6 +460,22 @@ public:
      */
     float getFrameRate() const { return _frameRate; }
 
+    /**
+     * Feed Scheduler::update with fixed steps. The frame delta time is accumulated and consumed in steps of
+     * `step` seconds, at most `maxStepsPerFrame` per frame, the time beyond is dropped. 0 disables it, the default.
+     */
+    void setFixedTimeStep(float step, int maxStepsPerFrame = 4);
+    float getFixedTimeStep() const { return _fixedTimeStep; }
+
+    /** The fraction of a step left in the accumulator, to interpolate the rendering between the last two steps. */
+    float getFixedTimeStepAlpha() const { return _fixedTimeStep > 0 ? _fixedTimeAccumulator / _fixedTimeStep : 0; }
+
+    /**
+     * The frame times per phase of drawScene, it can be read from any thread.
+     * @see Console frametime command
+     */
+    FrameTimeHistogram& getFrameTimeHistogram() { return _frameTimeHistogram; }
+
     /**
      * Clones a specified type matrix and put it to the top of specified type of matrix stack.
      * @js NA
@@ -600,6 +617,14 @@ protected:
     float _deltaTime              = 0.0f;
     bool _deltaTimePassedByCaller = false;
 
+    /* the fixed time step mode, disabled when the step is 0 */
+    float _fixedTimeStep        = 0.0f;
+    float _fixedTimeAccumulator = 0.0f;
+    int _maxFixedTimeSteps      = 4;
+
+    FrameTimeHistogram _frameTimeHistogram;
+    std::chrono::steady_clock::time_point _frameBegin;
+
     /* The _glView, where everything is rendered, GLView is a abstract class,cocos2d-x provide GLViewImpl
      which inherit from it as default renderer context,you can have your own by inherit from it*/
     GLView* _glView = nullptr;
@@ -0,0 +1,73 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/FramePacer.h"
+
+#include <thread>
+
+namespace ax
+{
+
+FramePacer::FramePacer(std::chrono::nanoseconds interval) : _interval(interval) {}
+
+void FramePacer::setInterval(std::chrono::nanoseconds interval)
+{
+    if (_deadline != clock::time_point{})
+        _deadline += interval - _interval;
+    _interval = interval;
+}
+
+void FramePacer::waitForNextFrame()
+{
+    auto now = clock::now();
+    if (_deadline == clock::time_point{})
+    {
+        _deadline = now;
+        return;
+    }
+
+    _deadline += _interval;
+    if (now >= _deadline)
+    {
+        if (now - _deadline > _interval)
+            _deadline = now;
+        std::this_thread::yield();
+        return;
+    }
+
+    waitUntil(_deadline, _spinThreshold);
+}
+
+void FramePacer::waitUntil(clock::time_point deadline, std::chrono::nanoseconds spinThreshold)
+{
+    for (auto remaining = deadline - clock::now(); remaining > remaining.zero(); remaining = deadline - clock::now())
+    {
+        if (remaining > spinThreshold)
+            std::this_thread::sleep_for(remaining - spinThreshold);
+        else
+            std::this_thread::yield();
+    }
+}
+
+}  // namespace ax
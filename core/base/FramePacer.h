@@ -0,0 +1,83 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <chrono>
+
+#include "platform/PlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+namespace ax
+{
+
+/**
+ Paces the main loop against absolute frame deadlines. `sleep_for` overshoots by a millisecond or two, so the
+ pacer sleeps until a margin before the deadline, then spins with `yield` for the rest. The deadlines advance by
+ the interval from the previous one instead of from the wake up time, the wake up error doesn't accumulate.
+ */
+class AX_DLL FramePacer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**The default margin before a deadline which is spun instead of slept.*/
+    static constexpr std::chrono::nanoseconds DEFAULT_SPIN_THRESHOLD = std::chrono::milliseconds(2);
+
+    explicit FramePacer(std::chrono::nanoseconds interval = std::chrono::nanoseconds(16666667));
+
+    /** The interval between two frames, the next deadline is moved when it changes. */
+    void setInterval(std::chrono::nanoseconds interval);
+    std::chrono::nanoseconds getInterval() const { return _interval; }
+
+    /** The margin before a deadline which is spun instead of slept, 0 only sleeps. */
+    void setSpinThreshold(std::chrono::nanoseconds threshold) { _spinThreshold = threshold; }
+    std::chrono::nanoseconds getSpinThreshold() const { return _spinThreshold; }
+
+    /**
+     Wait until the deadline of the current frame, called once per frame. The first call starts pacing without
+     waiting. A frame which ends more than one interval late restarts the deadlines from now, rather than running
+     the next frames back to back to catch up.
+     */
+    void waitForNextFrame();
+
+    /** Restart pacing, the next waitForNextFrame doesn't wait. */
+    void reset() { _deadline = clock::time_point{}; }
+
+    /** Sleep then spin until the deadline. */
+    static void waitUntil(clock::time_point deadline, std::chrono::nanoseconds spinThreshold = DEFAULT_SPIN_THRESHOLD);
+
+private:
+    std::chrono::nanoseconds _interval;
+    std::chrono::nanoseconds _spinThreshold = DEFAULT_SPIN_THRESHOLD;
+    clock::time_point _deadline{};
+};
+
+}  // namespace ax
+
+// end of base group
+/// @}
@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/FrameTimeHistogram.h"
+
+#include <algorithm>
+#include "base/format.h"
+
+namespace ax
+{
+
+void FrameTimeHistogram::record(Phase phase, std::chrono::nanoseconds duration)
+{
+    auto& buckets     = _phases[static_cast<int>(phase)];
+    auto microseconds = static_cast<uint32_t>(std::clamp<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0, UINT32_MAX));
+
+    auto index = std::min<uint32_t>(microseconds / BUCKET_WIDTH.count(), BUCKET_COUNT - 1);
+    buckets.counts[index].fetch_add(1, std::memory_order_relaxed);
+
+    // only the main thread records, a plain compare is enough
+    if (microseconds > buckets.maxMicroseconds.load(std::memory_order_relaxed))
+        buckets.maxMicroseconds.store(microseconds, std::memory_order_relaxed);
+}
+
+FrameTimeHistogram::Percentiles FrameTimeHistogram::getPercentiles(Phase phase) const
+{
+    auto& buckets = _phases[static_cast<int>(phase)];
+
+    uint32_t counts[BUCKET_COUNT];
+    uint64_t samples = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        counts[i] = buckets.counts[i].load(std::memory_order_relaxed);
+        samples += counts[i];
+    }
+
+    Percentiles result;
+    result.samples = static_cast<uint32_t>(std::min<uint64_t>(samples, UINT32_MAX));
+    result.max     = buckets.maxMicroseconds.load(std::memory_order_relaxed) / 1000.0f;
+    if (samples == 0)
+        return result;
+
+    // the middle of the bucket, except the last one which is unbounded
+    auto percentile = [&](double fraction) {
+        auto rank        = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * samples + 0.5));
+        uint64_t reached = 0;
+        for (int i = 0; i < BUCKET_COUNT - 1; ++i)
+        {
+            reached += counts[i];
+            if (reached >= rank)
+                return std::min((i + 0.5f) * BUCKET_WIDTH.count() / 1000.0f, result.max);
+        }
+        return result.max;
+    };
+    result.p50 = percentile(0.50);
+    result.p95 = percentile(0.95);
+    result.p99 = percentile(0.99);
+    return result;
+}
+
+void FrameTimeHistogram::reset()
+{
+    for (auto& buckets : _phases)
+    {
+        for (auto& count : buckets.counts)
+            count.store(0, std::memory_order_relaxed);
+        buckets.maxMicroseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string FrameTimeHistogram::toString() const
+{
+    std::string result = fmt::format("{:<8}{:>10}{:>10}{:>10}{:>10}{:>10}\n", "phase", "p50(ms)", "p95(ms)",
+                                     "p99(ms)", "max(ms)", "samples");
+    for (int i = 0; i < static_cast<int>(Phase::COUNT); ++i)
+    {
+        auto percentiles = getPercentiles(static_cast<Phase>(i));
+        result += fmt::format("{:<8}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.2f}{:>10}\n",
+                              getPhaseName(static_cast<Phase>(i)), percentiles.p50, percentiles.p95,
+                              percentiles.p99, percentiles.max, percentiles.samples);
+    }
+    return result;
+}
+
+const char* FrameTimeHistogram::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::UPDATE:
+        return "update";
+    case Phase::VISIT:
+        return "visit";
+    case Phase::RENDER:
+        return "render";
+    case Phase::SWAP:
+        return "swap";
+    case Phase::FRAME:
+        return "frame";
+    default:
+        return "";
+    }
+}
+
+}  // namespace ax
@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+#include "platform/PlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+namespace ax
+{
+
+/**
+ A histogram of the frame times per phase of Director::drawScene. The main thread records with relaxed atomic
+ increments and any thread reads the percentiles without locking, e.g. the Console. The buckets are 0.1 ms wide
+ up to 51.2 ms, longer samples fall in the last bucket which reports the longest one.
+ */
+class AX_DLL FrameTimeHistogram
+{
+public:
+    enum class Phase
+    {
+        UPDATE,  ///< Scheduler::update and the update events
+        VISIT,   ///< the scene visit and the draw events
+        RENDER,  ///< Renderer::render
+        SWAP,    ///< swapping the buffers and ending the frame
+        FRAME,   ///< the interval between the beginning of two frames, including the pacing wait
+        COUNT
+    };
+
+    static constexpr int BUCKET_COUNT = 512;
+    static constexpr std::chrono::microseconds BUCKET_WIDTH{100};
+
+    struct Percentiles
+    {
+        float p50 = 0;  ///< in milliseconds
+        float p95 = 0;
+        float p99 = 0;
+        float max = 0;
+        uint32_t samples = 0;
+    };
+
+    /** Add a sample to the phase. */
+    void record(Phase phase, std::chrono::nanoseconds duration);
+
+    /** The percentiles of the phase samples since the last reset, with the resolution of a bucket. */
+    Percentiles getPercentiles(Phase phase) const;
+
+    /** Clear the samples, the samples recorded meanwhile may be partially kept. */
+    void reset();
+
+    /** A table of the percentiles of every phase. */
+    std::string toString() const;
+
+    static const char* getPhaseName(Phase phase);
+
+private:
+    struct Buckets
+    {
+        std::atomic<uint32_t> counts[BUCKET_COUNT]{};
+        std::atomic<uint32_t> maxMicroseconds{0};
+    };
+    Buckets _phases[static_cast<int>(Phase::COUNT)];
+};
+
+}  // namespace ax
+
+// end of base group
+/// @}
@@ -27,11 +27,12 @@
 #include "base/Director.h"
 #include "yasio/thread_name.hpp"
 
-#include <queue>
+#include <deque>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <future>
+#include <chrono>
 #include <functional>
 #include <stdexcept>
 
@@ -42,95 +43,280 @@
 namespace ax
 {
 
+#pragma region Parking
+// the yields tried before a thread blocked on a JobGroup parks
+static const int LOCK_SPIN_COUNT     = 16;
+static const int WAIT_SPIN_COUNT     = 64;
+static const auto WAIT_PARK_TIMEOUT = std::chrono::milliseconds(1);
+
+// The threads waiting for the lock bit or the job count of a group to clear, shared by all groups
+static std::mutex s_parkMutex;
+static std::condition_variable s_parkCV;
+static std::atomic<int> s_parkedCount{0};
+
+template <class Pred>
+static void park(Pred&& ready, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(s_parkMutex);
+    s_parkedCount.fetch_add(1, std::memory_order_relaxed);
+    // pairs with the fence of unpark, either ready sees the new state or unpark sees this thread parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    s_parkCV.wait_for(lock, timeout, ready);
+    s_parkedCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void unpark()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (s_parkedCount.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(s_parkMutex);
+        s_parkCV.notify_all();
+    }
+}
+#pragma endregion
+
 #pragma region JobExecutor
+struct Job
+{
+    JobFunction task;
+    JobGroup* group{nullptr};
+    bool helpable{false};  // started by run/runAfter, so it may run on a thread helping in JobSystem::wait
+};
+
+/*
+ * Every worker owns one deque per priority lane. A worker pushes and pops at the back of its own deques and steals
+ * from the front of the others, external threads hand their jobs out round robin. The deques are short and each
+ * one is guarded by its own mutex, so workers only contend when stealing.
+ */
 class JobExecutor
 {
 public:
-    explicit JobExecutor(std::span<std::shared_ptr<JobThreadData>> tdds) : stop(false)
+    static constexpr int LANE_COUNT = 3;
+
+    JobExecutor(JobSystem* owner, std::span<std::shared_ptr<JobThreadData>> tdds)
+        : _owner(owner), _queueCount(tdds.size()), _queues(new WorkerQueue[tdds.size()])
     {
-        for (auto thread_data : tdds)
-            workers.emplace_back([this, thread_data] {
+        // keep one worker free of streaming jobs so frame critical work never waits behind blocking IO
+        _maxLowJobs = (std::max)(static_cast<int>(tdds.size()) - 1, 1);
+        for (size_t i = 0; i < tdds.size(); ++i)
+            _workers.emplace_back([this, i, thread_data = tdds[i]] {
                 thread_data->init();
                 yasio::set_thread_name(thread_data->name());
-                for (;;)
-                {
-                    std::function<void(JobThreadData*)> task;
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
-                        if (this->stop && this->tasks.empty())
-                            break;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-
-                    task(thread_data.get());
-                }
+                workerLoop(i, thread_data.get());
                 thread_data->finz();
             });
     }
-    template <class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F(Args...)>::type>
+    ~JobExecutor()
     {
-        using return_type = typename std::invoke_result<F(Args...)>::type;
+        {
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (std::thread& worker : _workers)
+            worker.join();
+    }
 
-        auto task = std::make_shared<std::packaged_task<return_type(size_t)>>(
-            std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...));
+    int getThreadCount() const { return static_cast<int>(_workers.size()); }
 
-        std::future<return_type> res = task->get_future();
+    void push(Job&& job, JobPriority priority)
+    {
+        const auto lane = static_cast<int>(priority);
+        auto index      = (t_worker.executor == this) ? t_worker.index
+                                                      : _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queueCount;
+        auto& queue     = _queues[index];
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+            std::lock_guard<std::mutex> lock(queue.mutex);
 
             // don't allow enqueueing after stopping the pool
-            if (stop)
+            if (_stop.load(std::memory_order_relaxed))
                 throw std::runtime_error("enqueue on stopped executor");
 
-            tasks.emplace([task](JobThreadData* thread_data) { (*task)(thread_data); });
+            queue.lanes[lane].emplace_back(std::move(job));
+            queue.sizes[lane].fetch_add(1, std::memory_order_relaxed);
+        }
+        _queued[lane].fetch_add(1, std::memory_order_release);
+        wakeOne();
+    }
+
+    /** Runs one pending High or Normal job started by run/runAfter, returns false if there was none. */
+    bool help()
+    {
+        Job job;
+        if (tryPop(job, true) < 0)
+            return false;
+        execute(job, (t_worker.executor == this) ? t_worker.threadData : _owner->_mainThreadData);
+        return true;
+    }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> lanes[LANE_COUNT];
+        std::atomic<int> sizes[LANE_COUNT]{};  // lets other threads skip empty deques without locking
+    };
+
+    struct WorkerContext
+    {
+        JobExecutor* executor{nullptr};
+        size_t index{0};
+        JobThreadData* threadData{nullptr};
+    };
+    static thread_local WorkerContext t_worker;
+
+    void workerLoop(size_t index, JobThreadData* threadData)
+    {
+        t_worker = WorkerContext{this, index, threadData};
+        for (;;)
+        {
+            Job job;
+            const auto lane = tryPop(job, false);
+            if (lane >= 0)
+            {
+                execute(job, threadData);
+                if (lane == static_cast<int>(JobPriority::Low))
+                {
+                    _runningLow.fetch_sub(1, std::memory_order_relaxed);
+                    if (_queued[lane].load(std::memory_order_acquire) > 0)
+                        wakeOne();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _condition.wait(lock, [this] { return _stop || hasRunnableJobs(); });
+            if (_stop && !hasQueuedJobs())
+                break;
         }
-        condition.notify_one();
-        return res;
+        t_worker = WorkerContext{};
     }
 
-    template <class F, class... Args>
-    void enqueue_v(F&& f, Args&&... args)
+    void execute(Job& job, JobThreadData* threadData)
     {
-        auto task = std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...);
+        job.task(threadData);
+        job.task.reset();  // release the captures before the group can report done
+        if (job.group)
+            _owner->finishJob(job.group);
+    }
 
+    void wakeOne()
+    {
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _condition.notify_one();
+    }
 
-            // don't allow enqueueing after stopping the pool
-            if (stop)
-                throw std::runtime_error("enqueue on stopped executor");
+    bool hasQueuedJobs() const
+    {
+        for (auto& queued : _queued)
+            if (queued.load(std::memory_order_acquire) > 0)
+                return true;
+        return false;
+    }
+
+    bool hasRunnableJobs() const
+    {
+        return _queued[0].load(std::memory_order_acquire) > 0 || _queued[1].load(std::memory_order_acquire) > 0 ||
+               (_queued[2].load(std::memory_order_acquire) > 0 &&
+                _runningLow.load(std::memory_order_relaxed) < _maxLowJobs);
+    }
 
-            tasks.emplace(std::move(task));
+    /** Takes the next job by priority, own deques first. Returns its lane or -1. */
+    int tryPop(Job& job, bool helping)
+    {
+        const bool isWorker = t_worker.executor == this;
+        const auto self     = isWorker ? t_worker.index : _queueCount;
+        const int laneCount = helping ? LANE_COUNT - 1 : LANE_COUNT;
+        for (int lane = 0; lane < laneCount; ++lane)
+        {
+            if (_queued[lane].load(std::memory_order_acquire) <= 0)
+                continue;
+
+            if (lane == static_cast<int>(JobPriority::Low) && !_stop.load(std::memory_order_relaxed))
+            {
+                if (_runningLow.fetch_add(1, std::memory_order_relaxed) >= _maxLowJobs)
+                {
+                    _runningLow.fetch_sub(1, std::memory_order_relaxed);
+                    continue;
+                }
+                if (takeAny(job, lane, self, helping))
+                    return lane;
+                _runningLow.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (takeAny(job, lane, self, helping))
+            {
+                if (lane == static_cast<int>(JobPriority::Low))
+                    _runningLow.fetch_add(1, std::memory_order_relaxed);
+                return lane;
+            }
         }
-        condition.notify_one();
+        return -1;
     }
-    ~JobExecutor()
+
+    bool takeAny(Job& job, int lane, size_t self, bool helping)
     {
+        if (self < _queueCount && take(job, _queues[self], lane, true, helping))
+            return true;
+        const auto start = (self < _queueCount) ? self + 1 : _nextSteal.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < _queueCount; ++i)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            stop = true;
+            const auto index = (start + i) % _queueCount;
+            if (index != self && take(job, _queues[index], lane, false, helping))
+                return true;
         }
-        condition.notify_all();
-        for (std::thread& worker : workers)
-            worker.join();
+        return false;
     }
 
-private:
+    bool take(Job& job, WorkerQueue& queue, int lane, bool fromBack, bool helpableOnly)
+    {
+        if (queue.sizes[lane].load(std::memory_order_relaxed) <= 0)
+            return false;
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        auto& jobs = queue.lanes[lane];
+        if (jobs.empty())
+            return false;
+
+        auto it = fromBack ? std::prev(jobs.end()) : jobs.begin();
+        if (helpableOnly && !it->helpable)
+        {
+            it = std::find_if(jobs.begin(), jobs.end(), [](const Job& j) { return j.helpable; });
+            if (it == jobs.end())
+                return false;
+        }
+        job = std::move(*it);
+        jobs.erase(it);
+        queue.sizes[lane].fetch_sub(1, std::memory_order_relaxed);
+        _queued[lane].fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    JobSystem* _owner;
+
     // need to keep track of threads so we can join them
-    std::vector<std::thread> workers;
+    std::vector<std::thread> _workers;
 
-    // the task queue
-    std::queue<std::function<void(JobThreadData*)>> tasks;
+    size_t _queueCount;
+    std::unique_ptr<WorkerQueue[]> _queues;
+    std::atomic<size_t> _nextQueue{0};
+    std::atomic<size_t> _nextSteal{0};
+    std::atomic<int> _queued[LANE_COUNT]{};
+    std::atomic<int> _runningLow{0};
+    int _maxLowJobs{1};
 
     // synchronization
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    bool stop;
+    std::mutex _sleepMutex;
+    std::condition_variable _condition;
+    std::atomic<bool> _stop{false};
 };
 
+thread_local JobExecutor::WorkerContext JobExecutor::t_worker;
+
 #pragma endregion
 
 #pragma region JobSystem
@@ -184,7 +370,7 @@ void JobSystem::init(const std::span<std::shared_ptr<JobThreadData>>& tdds)
 {
     _mainThreadData = new MainThreadData();
     if (!tdds.empty())
-        _executor = new JobExecutor(tdds);
+        _executor = new JobExecutor(this, tdds);
 }
 
 JobSystem::~JobSystem()
@@ -197,7 +383,7 @@ JobSystem::~JobSystem()
 void JobSystem::enqueue_v(std::function<void(JobThreadData*)> task)
 {
     if (_executor)
-        _executor->enqueue_v(std::move(task));
+        _executor->push(Job{std::move(task)}, JobPriority::Normal);
     else
         task(_mainThreadData);
 }
@@ -222,7 +408,7 @@ void JobSystem::enqueue(std::shared_ptr<JobThreadTask> task)
         }
     };
     if (_executor)
-        _executor->enqueue_v(std::move(taskw));
+        _executor->push(Job{std::move(taskw)}, JobPriority::Normal);
     else
         taskw(_mainThreadData);
 }
@@ -234,14 +420,158 @@ void JobSystem::enqueue(std::function<void()> task, std::function<void()> done)
     auto taskw = [task_ = std::move(task), done_ = std::move(done)](JobThreadData*) {
         task_();
         if (done_)
-            Director::getInstance()->getScheduler()->runOnAxmolThread(done_);
+            Director::getInstance()->getScheduler()->runOnAxmolThread(done_, Scheduler::ActionPriority::Background);
     };
     if (_executor)
-        _executor->enqueue_v(taskw);
+        _executor->push(Job{std::move(taskw)}, JobPriority::Normal);
     else
         taskw(_mainThreadData);
 }
 
+int JobSystem::getThreadCount() const
+{
+    return _executor ? _executor->getThreadCount() : 0;
+}
+
+void JobSystem::run(JobFunction task, JobPriority priority, JobGroup* group)
+{
+    if (!task)
+        return;
+    if (group)
+        group->addJob();
+    submit(std::move(task), priority, group);
+}
+
+void JobSystem::runAfter(JobGroup& dependency, JobFunction task, JobPriority priority, JobGroup* group)
+{
+    if (!task)
+        return;
+    if (group)
+        group->addJob();
+    JobGroup::Continuation continuation{std::move(task), priority, group};
+    if (!dependency.addContinuation(continuation))
+        submit(std::move(continuation.task), priority, group);
+}
+
+void JobSystem::submit(JobFunction task, JobPriority priority, JobGroup* group)
+{
+    if (_executor)
+        _executor->push(Job{std::move(task), group, true}, priority);
+    else
+    {
+        task(_mainThreadData);
+        task.reset();
+        if (group)
+            finishJob(group);
+    }
+}
+
+void JobSystem::finishJob(JobGroup* group)
+{
+    std::vector<JobGroup::Continuation> ready;
+    group->finishJob(ready);
+    // the group may already be gone here, only the moved out continuations are touched
+    for (auto& continuation : ready)
+        submit(std::move(continuation.task), continuation.priority, continuation.group);
+}
+
+void JobSystem::wait(JobGroup& group)
+{
+    for (int spins = 0; !group.isDone();)
+    {
+        if (_executor && _executor->help())
+            spins = 0;
+        else if (++spins < WAIT_SPIN_COUNT)
+            std::this_thread::yield();
+        else
+            // the remaining jobs run on other threads, the timeout lets this thread help with jobs queued meanwhile
+            park([&group] { return group.isDone(); }, WAIT_PARK_TIMEOUT);
+    }
+}
+
+void JobSystem::parallelForImpl(size_t first,
+                                size_t last,
+                                size_t grainSize,
+                                void (*invoke)(void* context, size_t begin, size_t end),
+                                void* context,
+                                JobPriority priority,
+                                size_t maxHelpers)
+{
+    if (first >= last)
+        return;
+
+    grainSize               = (std::max)(grainSize, size_t{1});
+    const size_t chunkCount = (last - first + grainSize - 1) / grainSize;
+    std::atomic<size_t> nextChunk{0};
+    auto drain = [&] {
+        for (size_t chunk; (chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunkCount;)
+        {
+            const size_t begin = first + chunk * grainSize;
+            invoke(context, begin, (std::min)(begin + grainSize, last));
+        }
+    };
+
+    // helpers that start after all chunks were claimed return at once, waiting on them keeps the stack state alive
+    const size_t helperCount =
+        (std::min)({chunkCount - 1, maxHelpers, static_cast<size_t>(getThreadCount())});
+    JobGroup group;
+    for (size_t i = 0; i < helperCount; ++i)
+        run([&drain] { drain(); }, priority, &group);
+    drain();
+    wait(group);
+}
+
+#pragma endregion
+
+#pragma region JobGroup
+
+uint32_t JobGroup::lock()
+{
+    for (int spins = 0;; ++spins)
+    {
+        auto state = _state.load(std::memory_order_relaxed);
+        if (!(state & LOCKED) &&
+            _state.compare_exchange_weak(state, state | LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+            return state;
+        if (spins < LOCK_SPIN_COUNT)
+            std::this_thread::yield();
+        else
+            park([this] { return !(_state.load(std::memory_order_relaxed) & LOCKED); }, WAIT_PARK_TIMEOUT);
+    }
+}
+
+void JobGroup::unlock(uint32_t state)
+{
+    _state.store(state, std::memory_order_release);
+    // only the shared parking state is touched, a waiter may destroy the group once it sees 0
+    unpark();
+}
+
+void JobGroup::addJob()
+{
+    // a plain fetch_add would be lost when finishJob clears the locked state
+    const auto count = lock();
+    unlock(count + 1);
+}
+
+bool JobGroup::addContinuation(Continuation& continuation)
+{
+    const auto count = lock();
+    if (count != 0)
+        _continuations.emplace_back(std::move(continuation));
+    unlock(count);
+    return count != 0;
+}
+
+void JobGroup::finishJob(std::vector<Continuation>& ready)
+{
+    const auto count = lock();
+    AXASSERT(count > 0, "JobGroup finished more jobs than it started");
+    if (count == 1)
+        ready.swap(_continuations);
+    unlock(count - 1);
+}
+
 #pragma endregion
 
 }  // namespace ax
@@ -39,6 +39,12 @@ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
 #include <memory>
 #include <string>
 #include <span>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <new>
 #include "base/Config.h"
 #include "platform/PlatformDefine.h"
 
@@ -89,8 +95,170 @@ protected:
     JobThreadData* _threadData{nullptr};
 };
 
+/** The lane a job is queued in, workers always drain higher lanes first. */
+enum class JobPriority
+{
+    High,    // frame critical work the current frame waits for: parallel visits, vertex fills, animation sampling
+    Normal,  // default lane, also used by the enqueue API
+    Low,     // streaming work such as file IO and decoding, never runs on a thread helping in JobSystem::wait
+};
+
+/**
+ * A move only job callable, either `void()` or `void(JobThreadData*)`.
+ * Callables up to INLINE_SIZE bytes are stored inline so queueing a job doesn't allocate.
+ */
+class JobFunction
+{
+public:
+    static constexpr size_t INLINE_SIZE = 48;
+
+    JobFunction() = default;
+    JobFunction(std::nullptr_t) {}
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, JobFunction> &&
+                                                !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    JobFunction(F&& f)
+    {
+        using Fn = std::decay_t<F>;
+        if constexpr (isInline<Fn>())
+            new (_storage) Fn(std::forward<F>(f));
+        else
+            *reinterpret_cast<Fn**>(_storage) = new Fn(std::forward<F>(f));
+        _ops = &OPS<Fn>;
+    }
+    JobFunction(JobFunction&& other) noexcept { moveFrom(other); }
+    JobFunction& operator=(JobFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    JobFunction(const JobFunction&)            = delete;
+    JobFunction& operator=(const JobFunction&) = delete;
+    ~JobFunction() { reset(); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+    void operator()(JobThreadData* threadData) { _ops->invoke(_storage, threadData); }
+
+    void reset()
+    {
+        if (_ops)
+        {
+            _ops->destroy(_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* storage, JobThreadData* threadData);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+    };
+
+    template <class Fn>
+    static constexpr bool isInline()
+    {
+        return sizeof(Fn) <= INLINE_SIZE && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+    template <class Fn>
+    static Fn* target(void* storage)
+    {
+        if constexpr (isInline<Fn>())
+            return std::launder(reinterpret_cast<Fn*>(storage));
+        else
+            return *reinterpret_cast<Fn**>(storage);
+    }
+    template <class Fn>
+    static void invokeImpl(void* storage, JobThreadData* threadData)
+    {
+        if constexpr (std::is_invocable_v<Fn&, JobThreadData*>)
+            (*target<Fn>(storage))(threadData);
+        else
+            (*target<Fn>(storage))();
+    }
+    template <class Fn>
+    static void moveImpl(void* dst, void* src)
+    {
+        if constexpr (isInline<Fn>())
+        {
+            new (dst) Fn(std::move(*target<Fn>(src)));
+            target<Fn>(src)->~Fn();
+        }
+        else
+            *reinterpret_cast<Fn**>(dst) = target<Fn>(src);
+    }
+    template <class Fn>
+    static void destroyImpl(void* storage)
+    {
+        if constexpr (isInline<Fn>())
+            target<Fn>(storage)->~Fn();
+        else
+            delete target<Fn>(storage);
+    }
+    template <class Fn>
+    static constexpr Ops OPS{&invokeImpl<Fn>, &moveImpl<Fn>, &destroyImpl<Fn>};
+
+    void moveFrom(JobFunction& other)
+    {
+        if (other._ops)
+        {
+            other._ops->move(_storage, other._storage);
+            _ops       = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char _storage[INLINE_SIZE];
+    const Ops* _ops{nullptr};
+};
+
+/**
+ * Counts the unfinished jobs started with JobSystem::run/runAfter on it.
+ * A group must outlive its jobs and should only be reused once it is done.
+ */
+class AX_API JobGroup
+{
+    friend class JobSystem;
+
+public:
+    JobGroup() = default;
+    JobGroup(const JobGroup&)            = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    bool isDone() const { return _state.load(std::memory_order_acquire) == 0; }
+
+private:
+    struct Continuation
+    {
+        JobFunction task;
+        JobPriority priority;
+        JobGroup* group;
+    };
+
+    static constexpr uint32_t LOCKED = 1u << 31;
+
+    uint32_t lock();
+    void unlock(uint32_t state);
+    void addJob();
+    bool addContinuation(Continuation& continuation);
+    void finishJob(std::vector<Continuation>& ready);
+
+    // The unfinished job count, the top bit guards _continuations. Clearing the whole state in one store is what
+    // lets a waiter destroy the group as soon as it sees 0, so threads blocked on the group park on a condition
+    // variable shared by all groups instead of one owned by the group.
+    std::atomic<uint32_t> _state{0};
+    std::vector<Continuation> _continuations;  // jobs started by runAfter, queued once the count drops to 0
+};
+
 class AX_API JobSystem
 {
+    friend class JobExecutor;
+
 public:
     JobSystem(int nThreads = -1);
     JobSystem(std::span<std::shared_ptr<JobThreadData>> tdds);
@@ -102,9 +270,63 @@ public:
     void enqueue(std::function<void()> task, std::function<void()> done);
     void enqueue(std::shared_ptr<JobThreadTask> task);
 
- protected:
+    /**
+     * Queues task in the given lane, the enqueue functions above use JobPriority::Normal.
+     * Jobs queued from a worker go to that worker's deque and idle workers steal from the others.
+     *
+     * @param group If not null, counts the job until it finished.
+     */
+    void run(JobFunction task, JobPriority priority = JobPriority::Normal, JobGroup* group = nullptr);
+
+    /** Like run, but the task is only queued once all jobs of dependency finished. */
+    void runAfter(JobGroup& dependency,
+                  JobFunction task,
+                  JobPriority priority = JobPriority::Normal,
+                  JobGroup* group      = nullptr);
+
+    /**
+     * Blocks until all jobs of group finished.
+     * While waiting the calling thread runs pending High and Normal jobs started with run/runAfter.
+     */
+    void wait(JobGroup& group);
+
+    /**
+     * Calls func(begin, end) for consecutive chunks of [first, last) holding at most grainSize indices, the
+     * calling thread takes chunks too. Returns once every chunk was processed.
+     *
+     * @param maxHelpers The most workers taking part besides the calling thread.
+     */
+    template <class F>
+    void parallelFor(size_t first,
+                     size_t last,
+                     size_t grainSize,
+                     F&& func,
+                     JobPriority priority = JobPriority::High,
+                     size_t maxHelpers    = SIZE_MAX)
+    {
+        parallelForImpl(
+            first, last, grainSize,
+            [](void* context, size_t begin, size_t end) { (*static_cast<std::decay_t<F>*>(context))(begin, end); },
+            const_cast<void*>(static_cast<const void*>(&func)), priority, maxHelpers);
+    }
+
+    /** The number of worker threads, 0 when jobs run inline on the calling thread. */
+    int getThreadCount() const;
+
+protected:
     void init(const std::span<std::shared_ptr<JobThreadData>>& tdds);
 
+    void submit(JobFunction task, JobPriority priority, JobGroup* group);
+    void finishJob(JobGroup* group);
+
+    void parallelForImpl(size_t first,
+                         size_t last,
+                         size_t grainSize,
+                         void (*invoke)(void* context, size_t begin, size_t end),
+                         void* context,
+                         JobPriority priority,
+                         size_t maxHelpers);
+
 private:
     JobExecutor* _executor{nullptr};
     JobThreadData* _mainThreadData{nullptr};
@@ -87,9 +87,8 @@ void Object::retain()
 void Object::release()
 {
     AXASSERT(_referenceCount > 0, "reference count should be greater than 0");
-    --_referenceCount;
 
-    if (_referenceCount == 0)
+    if (--_referenceCount == 0)
     {
 #if defined(_AX_DEBUG) && (_AX_DEBUG > 0)
         auto poolManager = PoolManager::getInstance();
@@ -31,6 +31,10 @@ THE SOFTWARE.
 #include "platform/PlatformMacros.h"
 #include "base/Config.h"
 
+#if AX_ENABLE_RENDER_THREAD
+#    include <atomic>
+#endif
+
 #define AX_OBJECT_LEAK_DETECTION 0
 
 /**
@@ -135,8 +139,23 @@ public:
     virtual ~Object();
 
 protected:
-    /// count of references
+    /// count of references, the render thread retains and releases the backend objects it executes a frame with
+#if AX_ENABLE_RENDER_THREAD
+    struct ReferenceCount : std::atomic<unsigned int>
+    {
+        using std::atomic<unsigned int>::atomic;
+        // copied like the plain count, subclasses use the implicit copy operations
+        ReferenceCount(const ReferenceCount& other) : std::atomic<unsigned int>(other.load()) {}
+        ReferenceCount& operator=(const ReferenceCount& other)
+        {
+            store(other.load());
+            return *this;
+        }
+    };
+    ReferenceCount _referenceCount;
+#else
     unsigned int _referenceCount;
+#endif
 
     friend class AutoreleasePool;
 
@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include "base/Macros.h"
 #include "base/Director.h"
 #include "base/ScriptSupport.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 namespace ax
 {
@@ -47,6 +50,9 @@ Timer::Timer()
     , _delay(0.0f)
     , _interval(0.0f)
     , _aborted(false)
+    , _lastUpdateClock(0)
+    , _queueVersion(0)
+    , _queued(false)
 {}
 
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
@@ -117,6 +123,22 @@ bool Timer::isExhausted() const
     return !_runForever && _timesExecuted > _repeat;
 }
 
+float Timer::getTimeToNextUpdate() const
+{
+    if (_elapsed == -1 || _aborted)
+        return 0;
+
+    float threshold = _useDelay ? _delay : _interval;
+    if (threshold <= 0)
+        return 0;
+
+    // the least dt for which update sees _elapsed + dt >= threshold in float arithmetic
+    float remaining = (std::max)(threshold - _elapsed, 0.0f);
+    while (_elapsed + remaining < threshold)
+        remaining = std::nextafter(remaining, FLT_MAX);
+    return remaining;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector() : _target(nullptr), _selector(nullptr) {}
@@ -218,12 +240,17 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler()
     : _timeScale(1.0f)
+    , _timerClock(0)
+    , _timerSequence(0)
+    , _staleTimerEntries(0)
+    , _updatingTimers(false)
     , _currentTarget(nullptr)
     , _currentTargetSalvaged(false)
     , _indexMapLocked(false)
 #if AX_ENABLE_SCRIPT_BINDING
     , _scriptHandlerEntries(20)
 #endif
+    , _actionBudget(0.002f)
 {
     // I don't expect to have more than 30 functions to all per frame
     _actionsToPerform.reserve(30);
@@ -260,7 +287,8 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
         timerIt = _timersMap.emplace(target, TimerHandle{}).first;
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        timerIt->second.paused = paused;
+        timerIt->second.paused      = paused;
+        timerIt->second.pausedClock = _timerClock;
     }
     else
     {
@@ -283,6 +311,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
             AXLOGD("Scheduler#schedule. Reiniting timer with interval {:.4f}, repeat {}, delay {:.4f}", interval, repeat,
                   delay);
             (*timerIt)->setupTimerWithInterval(interval, repeat, delay);
+            queueTimer(*timerIt, target, _timerClock);
             return;
         }
     }
@@ -290,6 +319,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
     TimerTargetCallback* timer = new TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     timers.pushBack(timer);
+    queueTimer(timer, target, _timerClock);
     timer->release();
 }
 
@@ -317,6 +347,7 @@ void Scheduler::unschedule(std::string_view key, void* target)
                     timer->setAborted();
                 }
 
+                dequeueTimer(timer);
                 timerHandle.timers.erase(i);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -568,6 +599,8 @@ void Scheduler::unscheduleAllForTarget(std::unordered_map<void*, TimerHandle>::i
         timerHandle.currentTimer->retain();
         timerHandle.currentTimer->setAborted();
     }
+    for (auto timer : timerHandle.timers)
+        dequeueTimer(timer);
     timerHandle.timers.clear();
 
     if (_currentTarget == &timerHandle)
@@ -614,7 +647,7 @@ void Scheduler::resumeTarget(void* target)
     auto timerIt = _timersMap.find(target);
     if (timerIt != _timersMap.end())
     {
-        timerIt->second.paused = false;
+        setTimersPaused(target, timerIt->second, false);
     }
 
     // update selector
@@ -633,7 +666,7 @@ void Scheduler::pauseTarget(void* target)
     auto timerIt = _timersMap.find(target);
     if (timerIt != _timersMap.end())
     {
-        timerIt->second.paused = true;
+        setTimersPaused(target, timerIt->second, true);
     }
 
     // update selector
@@ -677,7 +710,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     // Custom Selectors
     for (auto& [target, timerHandle] : _timersMap)
     {
-        timerHandle.paused = true;
+        setTimersPaused(target, timerHandle, true);
         idsWithSelectors.insert(target);
     }
 
@@ -723,16 +756,71 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
     }
 }
 
-void Scheduler::runOnAxmolThread(std::function<void()> action)
+void Scheduler::runOnAxmolThread(std::function<void()> action, ActionPriority priority)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _actionsToPerform.emplace_back(std::move(action));
+    _actionQueues[static_cast<int>(priority)].enqueue(
+        PendingAction{std::move(action), std::chrono::steady_clock::now()});
 }
 
 void Scheduler::removeAllPendingActions()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _actionsToPerform.clear();
+    PendingAction pending;
+    for (auto& queue : _actionQueues)
+    {
+        while (queue.try_dequeue(pending))
+            ;
+    }
+}
+
+void Scheduler::performActions()
+{
+    using namespace std::chrono;
+
+    auto& frameQueue      = _actionQueues[static_cast<int>(ActionPriority::Frame)];
+    auto& backgroundQueue = _actionQueues[static_cast<int>(ActionPriority::Background)];
+
+    // Testing size is faster than dequeueing.
+    // And almost never there will be functions scheduled to be called.
+    auto frameCount      = frameQueue.size_approx();
+    auto backgroundCount = backgroundQueue.size_approx();
+    if (frameCount == 0 && backgroundCount == 0)
+    {
+        _actionQueueStats = ActionQueueStats{};
+        return;
+    }
+
+    const auto start = steady_clock::now();
+    size_t performed = 0;
+    float maxLatency = 0;
+    auto perform     = [&](PendingAction& pending) {
+        maxLatency = (std::max)(maxLatency, duration<float>(start - pending.queuedAt).count());
+        ++performed;
+        pending.action();
+    };
+
+    // Only the actions queued before this update are performed, so actions queueing actions can't stall the frame.
+    if (frameCount > 0)
+    {
+        _actionsToPerform.resize(frameCount);
+        frameCount = frameQueue.try_dequeue_bulk(_actionsToPerform.begin(), frameCount);
+        for (size_t i = 0; i < frameCount; ++i)
+            perform(_actionsToPerform[i]);
+        _actionsToPerform.clear();
+    }
+
+    // At least one background action per update, so a busy frame still makes progress
+    PendingAction pending;
+    for (; backgroundCount > 0 && backgroundQueue.try_dequeue(pending); --backgroundCount)
+    {
+        perform(pending);
+        pending.action = nullptr;
+        if (_actionBudget > 0 && duration<float>(steady_clock::now() - start).count() >= _actionBudget)
+            break;
+    }
+
+    _actionQueueStats.pendingActions   = frameQueue.size_approx() + backgroundQueue.size_approx();
+    _actionQueueStats.performedActions = performed;
+    _actionQueueStats.maxLatency       = maxLatency;
 }
 
 // main loop
@@ -781,43 +869,8 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (auto it = _timersMap.begin(); it != _timersMap.end();)
-    {
-        auto elt               = &it->second;
-        _currentTarget         = elt;
-        _currentTargetSalvaged = false;
-
-        if (!_currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers.size(); ++(elt->timerIndex))
-            {
-                elt->currentTimer = elt->timers[elt->timerIndex];
-                AXASSERT(!elt->currentTimer->isAborted(), "An aborted timer should not be updated");
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
-        }
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers.empty())
-        {
-            it = _timersMap.erase(it);
-        }
-        else
-            ++it;
-    }
+    // Update the custom selectors which are due
+    updateTimers(dt);
 
     // delete all updates that are removed in update
     for (auto&& sched : _updateDeleteVector)
@@ -829,7 +882,6 @@ void Scheduler::update(float dt)
     _updateDeleteVector.clear();
 
     _indexMapLocked = false;
-    _currentTarget  = nullptr;
 
 #if AX_ENABLE_SCRIPT_BINDING
     //
@@ -856,21 +908,136 @@ void Scheduler::update(float dt)
     //
     // Functions allocated from another thread
     //
+    performActions();
+}
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if (!_actionsToPerform.empty())
+// orders the timer queue as a min-heap
+struct LaterTimerEntry
+{
+    template <typename Entry>
+    bool operator()(const Entry& lhs, const Entry& rhs) const
+    {
+        return lhs.due > rhs.due || (lhs.due == rhs.due && lhs.sequence > rhs.sequence);
+    }
+};
+
+void Scheduler::queueTimer(Timer* timer, void* target, double due)
+{
+    dequeueTimer(timer);
+    timer->_queued = true;
+
+    TimerQueueEntry entry{due, _timerSequence++, timer->_queueVersion, timer, target};
+    if (_updatingTimers)
+    {
+        // due next frame at the earliest, so timers firing every frame can't keep updateTimers busy
+        _deferredTimerEntries.emplace_back(std::move(entry));
+    }
+    else
+    {
+        _timerQueue.emplace_back(std::move(entry));
+        std::push_heap(_timerQueue.begin(), _timerQueue.end(), LaterTimerEntry{});
+    }
+}
+
+void Scheduler::dequeueTimer(Timer* timer)
+{
+    if (timer->_queued)
+    {
+        timer->_queued = false;
+        ++_staleTimerEntries;
+    }
+    ++timer->_queueVersion;
+}
+
+void Scheduler::setTimersPaused(void* target, TimerHandle& timerHandle, bool paused)
+{
+    if (timerHandle.paused == paused)
+        return;
+
+    timerHandle.paused = paused;
+    if (paused)
+    {
+        // the queued entries are dropped once due
+        timerHandle.pausedClock = _timerClock;
+        return;
+    }
+
+    const auto pausedTime = _timerClock - timerHandle.pausedClock;
+    for (auto timer : timerHandle.timers)
+    {
+        timer->_lastUpdateClock += pausedTime;
+        queueTimer(timer, target, timer->_lastUpdateClock + timer->getTimeToNextUpdate());
+    }
+}
+
+void Scheduler::updateTimers(float dt)
+{
+    _timerClock += dt;
+    _updatingTimers = true;
+
+    while (!_timerQueue.empty() && _timerQueue.front().due <= _timerClock)
     {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if
-        // new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_actionsToPerform);
-        _performMutex.unlock();
+        std::pop_heap(_timerQueue.begin(), _timerQueue.end(), LaterTimerEntry{});
+        auto entry = std::move(_timerQueue.back());
+        _timerQueue.pop_back();
+
+        auto timer = entry.timer.get();
+        if (entry.version != timer->_queueVersion)
+        {
+            --_staleTimerEntries;
+            continue;
+        }
+        timer->_queued = false;
+
+        // resuming a paused target queues its timers again
+        auto timerIt = _timersMap.find(entry.target);
+        if (timerIt == _timersMap.end() || timerIt->second.paused)
+            continue;
+
+        auto& timerHandle        = timerIt->second;
+        _currentTarget           = &timerHandle;
+        _currentTargetSalvaged   = false;
+        timerHandle.currentTimer = timer;
+        AXASSERT(!timer->isAborted(), "An aborted timer should not be updated");
 
-        for (const auto& function : temp)
+        timer->update(static_cast<float>(_timerClock - timer->_lastUpdateClock));
+        timer->_lastUpdateClock = _timerClock;
+
+        if (timer->isAborted())
+        {
+            // The timer told the remove itself. To prevent the timer from accidentally deallocating itself before
+            // finishing its step, we retained it. Now that step is done, it's safe to release it.
+            timer->release();
+        }
+        else if (!timer->_queued)
         {
-            function();
+            queueTimer(timer, entry.target, _timerClock + timer->getTimeToNextUpdate());
         }
+        timerHandle.currentTimer = nullptr;
+
+        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+        if (_currentTargetSalvaged && timerHandle.timers.empty())
+            _timersMap.erase(entry.target);
+    }
+
+    _currentTarget  = nullptr;
+    _updatingTimers = false;
+
+    for (auto& entry : _deferredTimerEntries)
+    {
+        _timerQueue.emplace_back(std::move(entry));
+        std::push_heap(_timerQueue.begin(), _timerQueue.end(), LaterTimerEntry{});
+    }
+    _deferredTimerEntries.clear();
+
+    // drop the entries of unscheduled timers once they make up most of the queue
+    if (_staleTimerEntries > 64 && _staleTimerEntries > _timerQueue.size() / 2)
+    {
+        std::erase_if(_timerQueue, [](const TimerQueueEntry& entry) {
+            return entry.version != entry.timer->_queueVersion;
+        });
+        std::make_heap(_timerQueue.begin(), _timerQueue.end(), LaterTimerEntry{});
+        _staleTimerEntries = 0;
     }
 }
 
@@ -890,7 +1057,8 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
         timerIt = _timersMap.emplace(target, TimerHandle{}).first;
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        timerIt->second.paused = paused;
+        timerIt->second.paused      = paused;
+        timerIt->second.pausedClock = _timerClock;
     }
     else
     {
@@ -913,6 +1081,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
             AXLOGD("Scheduler#schedule. Reiniting timer with interval {:.4}, repeat {}, delay {:.4f}", interval, repeat,
                   delay);
             (*timerIt)->setupTimerWithInterval(interval, repeat, delay);
+            queueTimer(*timerIt, target, _timerClock);
             return;
         }
     }
@@ -920,6 +1089,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
     TimerTargetSelector* timer = new TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     timers.pushBack(timer);
+    queueTimer(timer, target, _timerClock);
     timer->release();
 }
 
@@ -974,6 +1144,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Object* target)
                     timer->setAborted();
                 }
 
+                dequeueTimer(timer);
                 timers.erase(i);
 
                 // update timerIndex in case we are in tick:, looping over the actions
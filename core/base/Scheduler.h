@@ -29,12 +29,15 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <set>
+#include "concurrentqueue/concurrentqueue.h"
 #include "base/axstd.h"
 #include "base/Object.h"
 #include "base/Vector.h"
+#include "base/RefPtr.h"
 
 namespace ax
 {
@@ -48,6 +51,8 @@ typedef std::function<void(float)> ccSchedulerFunc;
  */
 class AX_DLL Timer : public Object
 {
+    friend class Scheduler;
+
 protected:
     Timer();
 
@@ -63,6 +68,10 @@ public:
     /** triggers the timer */
     void update(float dt);
 
+    /** The least time update has to accumulate before the timer triggers again, 0 if it should be updated next
+     * frame. */
+    float getTimeToNextUpdate() const;
+
 protected:
     Scheduler* _scheduler;  // weak ref
     float _elapsed;
@@ -73,6 +82,11 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // bookkeeping of the scheduler's timer queue
+    double _lastUpdateClock;     // scheduler clock of the last update call
+    unsigned int _queueVersion;  // queue entries of an older version are stale
+    bool _queued;
 };
 
 class AX_DLL TimerTargetSelector : public Timer
@@ -175,6 +189,7 @@ struct TimerHandle
     int timerIndex;
     Timer* currentTimer;
     bool paused;
+    double pausedClock;  // scheduler clock when the target was paused, the paused time is skipped on resume
 };
 
 #if AX_ENABLE_SCRIPT_BINDING
@@ -196,6 +211,20 @@ selector'.
 class AX_DLL Scheduler : public Object
 {
 public:
+    /** Priority classes of the functions queued with runOnAxmolThread. */
+    enum class ActionPriority
+    {
+        Frame,       // performed in the next update however many are queued
+        Background,  // completions which can wait, performed while the action budget of the update lasts
+    };
+
+    struct ActionQueueStats
+    {
+        size_t pendingActions{0};    // still queued after the last update
+        size_t performedActions{0};  // performed by the last update
+        float maxLatency{0};         // longest time in seconds an action performed by the last update was queued
+    };
+
     /** Priority level reserved for system services.
      * @lua NA
      * @js NA
@@ -465,12 +494,14 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and doesn't lock.
      @param function The function to be run in cocos2d thread.
+     @param priority ActionPriority::Frame runs the function in the next update, ActionPriority::Background when the
+            action budget of an update allows.
      @since v3.0
      @js NA
      */
-    void runOnAxmolThread(std::function<void()> action);
+    void runOnAxmolThread(std::function<void()> action, ActionPriority priority = ActionPriority::Frame);
 #ifndef AX_CORE_PROFILE
     AX_DEPRECATED(2.1) void performFunctionInCocosThread(std::function<void()> action)
     {
@@ -485,6 +516,17 @@ public:
      * @js NA
      */
     void removeAllPendingActions();
+
+    /**
+     * Sets the time in seconds an update may spend on functions queued with ActionPriority::Background, the rest
+     * carries over to the next update. At least one is performed per update, 0 performs all of them.
+     * Defaults to 0.002.
+     */
+    void setActionBudget(float seconds) { _actionBudget = seconds; }
+    float getActionBudget() const { return _actionBudget; }
+
+    /** Depth and latency of the runOnAxmolThread queues as of the last update. */
+    const ActionQueueStats& getActionQueueStats() const { return _actionQueueStats; }
 #ifndef AX_CORE_PROFILE
     AX_DEPRECATED(2.1) void removeAllFunctionsToBePerformedInCocosThread() { removeAllPendingActions(); }
 #endif
@@ -513,6 +555,15 @@ protected:
 
     void unscheduleAllForTarget(std::unordered_map<void*, TimerHandle>::iterator& timerIt);
 
+    // timer queue specific
+
+    void queueTimer(Timer* timer, void* target, double due);
+    void dequeueTimer(Timer* timer);
+    void setTimersPaused(void* target, TimerHandle& timerHandle, bool paused);
+    void updateTimers(float dt);
+
+    void performActions();
+
     float _timeScale;
 
     axstd::pod_vector<SchedHandle*> _waitList; // list wait active
@@ -531,6 +582,24 @@ protected:
 
     // Used for "selectors with interval"
     std::unordered_map<void*, TimerHandle> _timersMap;
+
+    // Min-heap of the interval timers by due time, so a frame only touches the timers which fire. Entries are
+    // invalidated lazily by bumping Timer::_queueVersion.
+    struct TimerQueueEntry
+    {
+        double due;
+        uint64_t sequence;  // breaks ties in scheduling order
+        unsigned int version;
+        RefPtr<Timer> timer;
+        void* target;
+    };
+    std::vector<TimerQueueEntry> _timerQueue;
+    std::vector<TimerQueueEntry> _deferredTimerEntries;  // queued while updating timers, due next frame
+    double _timerClock;  // sum of the scaled frame times
+    uint64_t _timerSequence;
+    size_t _staleTimerEntries;
+    bool _updatingTimers;
+
     struct TimerHandle* _currentTarget;
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
@@ -541,8 +610,15 @@ protected:
 #endif
 
     // Used for "perform action"
-    std::vector<std::function<void()>> _actionsToPerform;
-    std::mutex _performMutex;
+    struct PendingAction
+    {
+        std::function<void()> action;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+    moodycamel::ConcurrentQueue<PendingAction> _actionQueues[2];  // indexed by ActionPriority
+    std::vector<PendingAction> _actionsToPerform;
+    float _actionBudget;
+    ActionQueueStats _actionQueueStats;
 };
 
 // end of base group
@@ -206,7 +206,8 @@ void captureScreen(std::function<void(bool, std::string_view)> afterCap, std::st
             [_afterCap = std::move(_afterCap), image = std::move(image), _outfile = std::move(_outfile)]() mutable {
             bool ok = image->saveToFile(_outfile);
             Director::getInstance()->getScheduler()->runOnAxmolThread(
-                [ok, _afterCap = std::move(_afterCap), _outfile = std::move(_outfile)] { _afterCap(ok, _outfile); });
+                [ok, _afterCap = std::move(_afterCap), _outfile = std::move(_outfile)] { _afterCap(ok, _outfile); },
+                Scheduler::ActionPriority::Background);
         });
     });
 }
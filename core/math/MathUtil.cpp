@@ -306,6 +306,46 @@ void MathUtil::transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_
 #endif
 }
 
+void MathUtil::lerpVec4(const float* from, const float* to, const float* t, float* dst, size_t count)
+{
+#if defined(AX_SSE_INTRINSICS)
+    MathUtilSSE::lerpVec4(from, to, t, dst, count);
+#elif defined(AX_NEON_INTRINSICS)
+#    if AX_64BITS || AX_NEON_INTRINSICS > 1
+    MathUtilNeon::lerpVec4(from, to, t, dst, count);
+#    else
+    if (isNeon32Enabled())
+        MathUtilNeon::lerpVec4(from, to, t, dst, count);
+    else
+        MathUtilC::lerpVec4(from, to, t, dst, count);
+#    endif
+#else
+    MathUtilC::lerpVec4(from, to, t, dst, count);
+#endif
+}
+
+void MathUtil::slerpQuaternions(const float* from, const float* to, const float* t, float* dst, size_t count)
+{
+    // The SIMD versions evaluate 4 quaternions at a time, the remainder goes through MathUtilC
+    size_t simdCount = count & ~static_cast<size_t>(3);
+#if defined(AX_SSE_INTRINSICS)
+    MathUtilSSE::slerpQuaternions(from, to, t, dst, simdCount);
+#elif defined(AX_NEON_INTRINSICS)
+#    if AX_64BITS || AX_NEON_INTRINSICS > 1
+    MathUtilNeon::slerpQuaternions(from, to, t, dst, simdCount);
+#    else
+    if (isNeon32Enabled())
+        MathUtilNeon::slerpQuaternions(from, to, t, dst, simdCount);
+    else
+        simdCount = 0;
+#    endif
+#else
+    simdCount = 0;
+#endif
+    MathUtilC::slerpQuaternions(from + simdCount * 4, to + simdCount * 4, t + simdCount, dst + simdCount * 4,
+                                count - simdCount);
+}
+
 void MathUtil::transformIndices(uint16_t* dst, const uint16_t* src, size_t count, uint16_t offset)
 {
 #if defined(AX_SSE_INTRINSICS)
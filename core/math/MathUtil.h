@@ -94,6 +94,29 @@ public:
      */
     static float lerp(float from, float to, float alpha);
 
+    /**
+     * Linearly interpolates count pairs of vec4, dst[i] = from[i] + (to[i] - from[i]) * t[i].
+     *
+     * @param from the from values, 4 floats each.
+     * @param to the to values, 4 floats each.
+     * @param t the count alpha values between [0,1]
+     * @param dst the interpolated values, 4 floats each.
+     * @param count the number of values.
+     */
+    static void lerpVec4(const float* from, const float* to, const float* t, float* dst, size_t count);
+
+    /**
+     * Spherically interpolates count pairs of quaternions stored as (x, y, z, w), with the same fast
+     * slerp as Quaternion::slerp, evaluated 4 quaternions at a time when SSE or NEON is available.
+     *
+     * @param from the from quaternions.
+     * @param to the to quaternions.
+     * @param t the count alpha values between [0,1]
+     * @param dst the interpolated quaternions.
+     * @param count the number of quaternions.
+     */
+    static void slerpQuaternions(const float* from, const float* to, const float* t, float* dst, size_t count);
+
 private:
     // Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -219,6 +219,69 @@ public:
             ++src;
         }
     }
+
+    inline static void lerpVec4(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i, from += 4, to += 4, dst += 4)
+        {
+            float alpha = t[i];
+            dst[0]      = from[0] + (to[0] - from[0]) * alpha;
+            dst[1]      = from[1] + (to[1] - from[1]) * alpha;
+            dst[2]      = from[2] + (to[2] - from[2]) * alpha;
+            dst[3]      = from[3] + (to[3] - from[3]) * alpha;
+        }
+    }
+
+    inline static float slerpRatio(float sq, float base, float versHalfTheta)
+    {
+        float ratio = -0.00158730159f + (sq - 16.0f) * base;
+        ratio       = 0.0333333333f + ratio * (sq - 9.0f) * versHalfTheta;
+        ratio       = -0.333333333f + ratio * (sq - 4.0f) * versHalfTheta;
+        return 1.0f + ratio * (sq - 1.0f) * versHalfTheta;
+    }
+
+    inline static void slerpQuaternions(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        // The fast slerp of Quaternion::slerp without its early outs, so that every lane of the SIMD versions
+        // runs the same instructions.
+        for (size_t i = 0; i < count; ++i, from += 4, to += 4, dst += 4)
+        {
+            float cosTheta = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+            float alpha    = cosTheta >= 0 ? 1.0f : -1.0f;
+            float halfY    = 1.0f + alpha * cosTheta;
+
+            float f2b = t[i] - 0.5f;
+            float u   = f2b >= 0 ? f2b : -f2b;
+            float f2a = u - f2b;
+            f2b += u;
+            u += u;
+            float f1 = 1.0f - u;
+
+            float halfSecHalfTheta = 1.09f - (0.476537f - 0.0903321f * halfY) * halfY;
+            halfSecHalfTheta *= 1.5f - halfY * halfSecHalfTheta * halfSecHalfTheta;
+            float versHalfTheta = 1.0f - halfY * halfSecHalfTheta;
+
+            float base   = 0.0000440917108f * versHalfTheta;
+            float ratio1 = slerpRatio(f1 * f1, base, versHalfTheta);
+            float ratio2 = slerpRatio(u * u, base, versHalfTheta);
+
+            f1 *= ratio1 * halfSecHalfTheta;
+            f2a *= ratio2;
+            f2b *= ratio2;
+            alpha *= f1 + f2a;
+            float beta = f1 + f2b;
+
+            float x     = alpha * from[0] + beta * to[0];
+            float y     = alpha * from[1] + beta * to[1];
+            float z     = alpha * from[2] + beta * to[2];
+            float w     = alpha * from[3] + beta * to[3];
+            float scale = 1.5f - 0.5f * (x * x + y * y + z * z + w * w);
+            dst[0]      = x * scale;
+            dst[1]      = y * scale;
+            dst[2]      = z * scale;
+            dst[3]      = w * scale;
+        }
+    }
 };
 
 NS_AX_MATH_END
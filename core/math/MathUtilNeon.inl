@@ -146,6 +146,86 @@ struct MathUtilNeon
         vst1_lane_f32(dst + 2, vget_high_f32(prod), 0);  // Store the 3rd element
     }
 
+    inline static void lerpVec4(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float32x4_t a = vld1q_f32(from + i * 4);
+            float32x4_t b = vld1q_f32(to + i * 4);
+            vst1q_f32(dst + i * 4, vmlaq_n_f32(a, vsubq_f32(b, a), t[i]));
+        }
+    }
+
+    inline static float32x4_t slerpRatio(float32x4_t sq, float32x4_t base, float32x4_t versHalfTheta)
+    {
+        float32x4_t ratio = vmlaq_f32(vdupq_n_f32(-0.00158730159f), vsubq_f32(sq, vdupq_n_f32(16.0f)), base);
+        ratio             = vmulq_f32(ratio, vsubq_f32(sq, vdupq_n_f32(9.0f)));
+        ratio             = vmlaq_f32(vdupq_n_f32(0.0333333333f), ratio, versHalfTheta);
+        ratio             = vmulq_f32(ratio, vsubq_f32(sq, vdupq_n_f32(4.0f)));
+        ratio             = vmlaq_f32(vdupq_n_f32(-0.333333333f), ratio, versHalfTheta);
+        return vmlaq_f32(vdupq_n_f32(1.0f), vmulq_f32(ratio, vsubq_f32(sq, vdupq_n_f32(1.0f))), versHalfTheta);
+    }
+
+    // count must be a multiple of 4, vld4q deinterleaves the quaternions so that each lane evaluates one of them
+    inline static void slerpQuaternions(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        const float32x4_t one  = vdupq_n_f32(1.0f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            float32x4x4_t a = vld4q_f32(from + i * 4);
+            float32x4x4_t b = vld4q_f32(to + i * 4);
+
+            float32x4_t cosTheta = vmulq_f32(a.val[0], b.val[0]);
+            cosTheta             = vmlaq_f32(cosTheta, a.val[1], b.val[1]);
+            cosTheta             = vmlaq_f32(cosTheta, a.val[2], b.val[2]);
+            cosTheta             = vmlaq_f32(cosTheta, a.val[3], b.val[3]);
+            float32x4_t alpha    = vbslq_f32(vcgeq_f32(cosTheta, vdupq_n_f32(0.0f)), one, vdupq_n_f32(-1.0f));
+            float32x4_t halfY    = vmlaq_f32(one, alpha, cosTheta);
+
+            float32x4_t f2b = vsubq_f32(vld1q_f32(t + i), half);
+            float32x4_t u   = vabsq_f32(f2b);
+            float32x4_t f2a = vsubq_f32(u, f2b);
+            f2b             = vaddq_f32(f2b, u);
+            u               = vaddq_f32(u, u);
+            float32x4_t f1  = vsubq_f32(one, u);
+
+            float32x4_t halfSecHalfTheta = vmlsq_f32(vdupq_n_f32(0.476537f), vdupq_n_f32(0.0903321f), halfY);
+            halfSecHalfTheta             = vmlsq_f32(vdupq_n_f32(1.09f), halfSecHalfTheta, halfY);
+            halfSecHalfTheta             = vmulq_f32(
+                halfSecHalfTheta, vmlsq_f32(vdupq_n_f32(1.5f), vmulq_f32(halfY, halfSecHalfTheta), halfSecHalfTheta));
+            float32x4_t versHalfTheta = vmlsq_f32(one, halfY, halfSecHalfTheta);
+
+            float32x4_t base   = vmulq_n_f32(versHalfTheta, 0.0000440917108f);
+            float32x4_t ratio1 = slerpRatio(vmulq_f32(f1, f1), base, versHalfTheta);
+            float32x4_t ratio2 = slerpRatio(vmulq_f32(u, u), base, versHalfTheta);
+
+            f1               = vmulq_f32(f1, vmulq_f32(ratio1, halfSecHalfTheta));
+            f2a              = vmulq_f32(f2a, ratio2);
+            f2b              = vmulq_f32(f2b, ratio2);
+            alpha            = vmulq_f32(alpha, vaddq_f32(f1, f2a));
+            float32x4_t beta = vaddq_f32(f1, f2b);
+
+            float32x4x4_t q;
+            q.val[0] = vmlaq_f32(vmulq_f32(alpha, a.val[0]), beta, b.val[0]);
+            q.val[1] = vmlaq_f32(vmulq_f32(alpha, a.val[1]), beta, b.val[1]);
+            q.val[2] = vmlaq_f32(vmulq_f32(alpha, a.val[2]), beta, b.val[2]);
+            q.val[3] = vmlaq_f32(vmulq_f32(alpha, a.val[3]), beta, b.val[3]);
+
+            float32x4_t lengthSq = vmulq_f32(q.val[0], q.val[0]);
+            lengthSq             = vmlaq_f32(lengthSq, q.val[1], q.val[1]);
+            lengthSq             = vmlaq_f32(lengthSq, q.val[2], q.val[2]);
+            lengthSq             = vmlaq_f32(lengthSq, q.val[3], q.val[3]);
+            float32x4_t scale    = vmlsq_f32(vdupq_n_f32(1.5f), half, lengthSq);
+            q.val[0]             = vmulq_f32(q.val[0], scale);
+            q.val[1]             = vmulq_f32(q.val[1], scale);
+            q.val[2]             = vmulq_f32(q.val[2], scale);
+            q.val[3]             = vmulq_f32(q.val[3], scale);
+            vst4q_f32(dst + i * 4, q);
+        }
+    }
+
 #if AX_64BITS
     inline static void transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform)
     {
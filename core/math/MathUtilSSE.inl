@@ -269,6 +269,98 @@ struct MathUtilSSE
             dst[rounded_count + i] = src[rounded_count + i] + offset;
         }
     }
+
+    static void lerpVec4(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            __m128 a = _mm_loadu_ps(from + i * 4);
+            __m128 b = _mm_loadu_ps(to + i * 4);
+            _mm_storeu_ps(dst + i * 4, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t[i]))));
+        }
+    }
+
+    static __m128 slerpRatio(__m128 sq, __m128 base, __m128 versHalfTheta)
+    {
+        __m128 ratio = _mm_add_ps(_mm_set1_ps(-0.00158730159f), _mm_mul_ps(_mm_sub_ps(sq, _mm_set1_ps(16.0f)), base));
+        ratio        = _mm_add_ps(_mm_set1_ps(0.0333333333f),
+                                  _mm_mul_ps(_mm_mul_ps(ratio, _mm_sub_ps(sq, _mm_set1_ps(9.0f))), versHalfTheta));
+        ratio        = _mm_add_ps(_mm_set1_ps(-0.333333333f),
+                                  _mm_mul_ps(_mm_mul_ps(ratio, _mm_sub_ps(sq, _mm_set1_ps(4.0f))), versHalfTheta));
+        return _mm_add_ps(_mm_set1_ps(1.0f),
+                          _mm_mul_ps(_mm_mul_ps(ratio, _mm_sub_ps(sq, _mm_set1_ps(1.0f))), versHalfTheta));
+    }
+
+    // count must be a multiple of 4, the quaternions are transposed so that each lane evaluates one of them
+    static void slerpQuaternions(const float* from, const float* to, const float* t, float* dst, size_t count)
+    {
+        const __m128 one     = _mm_set1_ps(1.0f);
+        const __m128 half    = _mm_set1_ps(0.5f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            __m128 ax = _mm_loadu_ps(from + i * 4);
+            __m128 ay = _mm_loadu_ps(from + i * 4 + 4);
+            __m128 az = _mm_loadu_ps(from + i * 4 + 8);
+            __m128 aw = _mm_loadu_ps(from + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+            __m128 bx = _mm_loadu_ps(to + i * 4);
+            __m128 by = _mm_loadu_ps(to + i * 4 + 4);
+            __m128 bz = _mm_loadu_ps(to + i * 4 + 8);
+            __m128 bw = _mm_loadu_ps(to + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+            __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                                         _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+            __m128 positive = _mm_cmpge_ps(cosTheta, _mm_setzero_ps());
+            __m128 alpha    = _mm_or_ps(_mm_and_ps(positive, one), _mm_andnot_ps(positive, _mm_set1_ps(-1.0f)));
+            __m128 halfY    = _mm_add_ps(one, _mm_mul_ps(alpha, cosTheta));
+
+            __m128 f2b = _mm_sub_ps(_mm_loadu_ps(t + i), half);
+            __m128 u   = _mm_and_ps(f2b, absMask);
+            __m128 f2a = _mm_sub_ps(u, f2b);
+            f2b        = _mm_add_ps(f2b, u);
+            u          = _mm_add_ps(u, u);
+            __m128 f1  = _mm_sub_ps(one, u);
+
+            __m128 halfSecHalfTheta = _mm_sub_ps(
+                _mm_set1_ps(1.09f),
+                _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(0.476537f), _mm_mul_ps(_mm_set1_ps(0.0903321f), halfY)), halfY));
+            halfSecHalfTheta = _mm_mul_ps(
+                halfSecHalfTheta,
+                _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(halfY, halfSecHalfTheta), halfSecHalfTheta)));
+            __m128 versHalfTheta = _mm_sub_ps(one, _mm_mul_ps(halfY, halfSecHalfTheta));
+
+            __m128 base   = _mm_mul_ps(_mm_set1_ps(0.0000440917108f), versHalfTheta);
+            __m128 ratio1 = slerpRatio(_mm_mul_ps(f1, f1), base, versHalfTheta);
+            __m128 ratio2 = slerpRatio(_mm_mul_ps(u, u), base, versHalfTheta);
+
+            f1          = _mm_mul_ps(f1, _mm_mul_ps(ratio1, halfSecHalfTheta));
+            f2a         = _mm_mul_ps(f2a, ratio2);
+            f2b         = _mm_mul_ps(f2b, ratio2);
+            alpha       = _mm_mul_ps(alpha, _mm_add_ps(f1, f2a));
+            __m128 beta = _mm_add_ps(f1, f2b);
+
+            __m128 x     = _mm_add_ps(_mm_mul_ps(alpha, ax), _mm_mul_ps(beta, bx));
+            __m128 y     = _mm_add_ps(_mm_mul_ps(alpha, ay), _mm_mul_ps(beta, by));
+            __m128 z     = _mm_add_ps(_mm_mul_ps(alpha, az), _mm_mul_ps(beta, bz));
+            __m128 w     = _mm_add_ps(_mm_mul_ps(alpha, aw), _mm_mul_ps(beta, bw));
+            __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                         _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+            __m128 scale    = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, lengthSq));
+            x = _mm_mul_ps(x, scale);
+            y = _mm_mul_ps(y, scale);
+            z = _mm_mul_ps(z, scale);
+            w = _mm_mul_ps(w, scale);
+
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(dst + i * 4, x);
+            _mm_storeu_ps(dst + i * 4 + 4, y);
+            _mm_storeu_ps(dst + i * 4 + 8, z);
+            _mm_storeu_ps(dst + i * 4 + 12, w);
+        }
+    }
 };
 
 #endif
@@ -192,7 +192,7 @@ void NavMeshDebugDraw::draw(Renderer* renderer)
 
     if (_dirtyBuffer)
     {
-        _vertexBuffer->updateData(_vertices.data(), sizeof(_vertices[0]) * _vertices.size());
+        renderer->updateBufferData(_vertexBuffer, _vertices.data(), sizeof(_vertices[0]) * _vertices.size());
         _dirtyBuffer = false;
     }
     int idx = 0;
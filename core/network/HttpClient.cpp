@@ -32,6 +32,7 @@
 #include <errno.h>
 #include "base/Utils.h"
 #include "base/Director.h"
+#include "base/ZipUtils.h"
 #include "platform/FileUtils.h"
 #include "yasio/yasio.hpp"
 
@@ -62,6 +63,36 @@ static void __clearQueueUnsafe(_Cont& queue, _Fty pred)
     }
 }
 
+// a request can be sent again only if doing it twice has the same effect as doing it once
+static bool __isIdempotent(HttpRequest* request)
+{
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET:
+        return true;
+    case HttpRequest::Type::PUT:
+    case HttpRequest::Type::DELETE:
+        return request->getRequestDataSize() == 0;
+    default:
+        return false;
+    }
+}
+
+// whether the channel was closed by the server, rather than timed out or failed locally
+static bool __isClosedByPeer(int internalErrorCode)
+{
+    switch (internalErrorCode)
+    {
+    case yasio::errc::eof:
+    case ECONNRESET:
+    case ECONNABORTED:
+    case EPIPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // HttpClient implementation
 HttpClient* HttpClient::getInstance()
 {
@@ -120,6 +151,10 @@ HttpClient::HttpClient()
     , _timeoutForRead(60)
     , _cookie(nullptr)
     , _clearResponsePredicate(nullptr)
+    , _keepAliveEnabled(true)
+    , _keepAliveTimeout(15)
+    , _maxConnectionsPerHost(6)
+    , _responseDecodingEnabled(false)
 {
     AXLOGD("In the constructor of HttpClient!");
     _scheduler = Director::getInstance()->getScheduler();
@@ -201,7 +236,7 @@ void HttpClient::send(HttpRequest* request)
 
     auto response = new HttpResponse(request);
     response->setLocation(request->getUrl(), false);
-    processResponse(response, -1);
+    processResponse(response);
     response->release();
 }
 
@@ -217,40 +252,179 @@ int HttpClient::tryTakeAvailChannel()
     return -1;
 }
 
-void HttpClient::processResponse(HttpResponse* response, int channelIndex)
+int HttpClient::tryTakeIdleConnection(std::string_view host)
+{
+    for (int i = 0; i < HttpClient::MAX_CHANNELS; ++i)
+    {
+        auto& connection = _connections[i];
+        if (connection.idle && connection.host == host)
+        {
+            connection.idle = false;
+            ++connection.generation;
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool HttpClient::tryCloseIdleConnection()
+{
+    for (int i = 0; i < HttpClient::MAX_CHANNELS; ++i)
+    {
+        auto& connection = _connections[i];
+        if (connection.idle)
+        {
+            connection.idle = false;
+            ++connection.generation;
+            _service->close(i);  // the channel is released by YEK_ON_CLOSE
+            return true;
+        }
+    }
+    return false;
+}
+
+void HttpClient::releaseConnection(int channelIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        auto& connection = _connections[channelIndex];
+        auto it          = _hostConnectionCounts.find(connection.host);
+        if (it != _hostConnectionCounts.end() && --it->second <= 0)
+            _hostConnectionCounts.erase(it);
+        connection.host.clear();
+        connection.transport = nullptr;
+        connection.idle      = false;
+        ++connection.generation;
+    }
+
+    // recycle channel
+    _availChannelQueue.push_front(channelIndex);
+}
+
+void HttpClient::processResponse(HttpResponse* response, bool reuseConnection)
 {
     response->retain();
 
-    if (response->validateUri())
+    if (!response->validateUri())
     {
-        if (channelIndex == -1)
-            channelIndex = tryTakeAvailChannel();
+        finishResponse(response);
+        return;
+    }
+
+    auto& requestUri = response->getRequestUri();
+    auto host        = fmt::format("{}://{}:{}", requestUri.getScheme(), requestUri.getHost(), requestUri.getPort());
+
+    int channelIndex        = -1;
+    bool reuseChannel       = false;
+    unsigned int generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        if (reuseConnection && _keepAliveEnabled)
+        {
+            channelIndex = tryTakeIdleConnection(host);
+            reuseChannel = channelIndex != -1;
+        }
+
+        if (!reuseChannel)
+        {
+            auto it = _hostConnectionCounts.find(host);
+            if (it == _hostConnectionCounts.end() || it->second < _maxConnectionsPerHost)
+            {
+                channelIndex = tryTakeAvailChannel();
+                if (channelIndex != -1)
+                {
+                    if (it != _hostConnectionCounts.end())
+                        ++it->second;
+                    else
+                        _hostConnectionCounts.emplace(host, 1);
+                    _connections[channelIndex].host = host;
+                }
+                else
+                {  // all channels are in use, free one kept alive for another host
+                    tryCloseIdleConnection();
+                }
+            }
+        }
 
         if (channelIndex != -1)
         {
-            auto channelHandle = _service->channel_at(channelIndex);
-            auto& requestUri = response->getRequestUri();
-            channelHandle->ud_.ptr = response;
-            _service->set_option(YOPT_C_REMOTE_ENDPOINT, channelIndex, requestUri.getHost().data(),
-                                 (int)requestUri.getPort());
-            if (requestUri.isSecure())
-                _service->open(channelIndex, YCK_SSL_CLIENT);
-            else
-                _service->open(channelIndex, YCK_TCP_CLIENT);
+            response->_reusedConnection                 = reuseChannel;
+            _service->channel_at(channelIndex)->ud_.ptr = response;
+            generation                                  = _connections[channelIndex].generation;
         }
-        else
-            _pendingResponseQueue.emplace_back(response);
     }
+
+    if (channelIndex == -1)
+    {
+        _pendingResponseQueue.emplace_back(response);
+        return;
+    }
+
+    if (reuseChannel)
+    {  // the transport is owned by the io thread, write the request there
+        _service->schedule(std::chrono::microseconds(0), [this, channelIndex, generation](io_service&) {
+            writeRequestOnIdleConnection(channelIndex, generation);
+            return true;
+        });
+        return;
+    }
+
+    _service->set_option(YOPT_C_REMOTE_ENDPOINT, channelIndex, requestUri.getHost().data(), (int)requestUri.getPort());
+    if (requestUri.isSecure())
+        _service->open(channelIndex, YCK_SSL_CLIENT);
     else
-        finishResponse(response);
+        _service->open(channelIndex, YCK_TCP_CLIENT);
+}
+
+void HttpClient::processPendingResponses()
+{
+    std::vector<HttpResponse*> pendingResponses;
+    {
+        auto lck = _pendingResponseQueue.get_lock();
+        while (!_pendingResponseQueue.unsafe_empty())
+        {
+            pendingResponses.emplace_back(_pendingResponseQueue.unsafe_front());
+            _pendingResponseQueue.unsafe_pop_front();
+        }
+    }
+
+    // responses which still can't get a connection are queued again
+    for (auto pendingResponse : pendingResponses)
+    {
+        processResponse(pendingResponse);
+        pendingResponse->release();
+    }
 }
 
 void HttpClient::handleNetworkEvent(yasio::io_event* event)
 {
-    int channelIndex       = event->cindex();
-    auto channel           = _service->channel_at(event->cindex());
-    HttpResponse* response = (HttpResponse*)channel->ud_.ptr;
-    assert(response);
+    int channelIndex = event->cindex();
+    auto channel     = _service->channel_at(channelIndex);
+    HttpResponse* response;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        response = (HttpResponse*)channel->ud_.ptr;
+        if (event->kind() == YEK_ON_CLOSE)
+        {  // an idle connection can't be claimed once it is closing
+            auto& connection     = _connections[channelIndex];
+            connection.transport = nullptr;
+            connection.idle      = false;
+            ++connection.generation;
+        }
+    }
+
+    if (!response)
+    {  // a kept alive connection without request
+        if (event->kind() == YEK_ON_CLOSE)
+        {
+            channel->get_user_timer().cancel();
+            releaseConnection(channelIndex);
+            processPendingResponses();
+        }
+        else if (event->kind() == YEK_ON_PACKET)
+            _service->close(channelIndex);  // unexpected data, the connection can't be reused
+        return;
+    }
 
     bool responseFinished = response->isFinished();
     switch (event->kind())
@@ -264,143 +438,244 @@ void HttpClient::handleNetworkEvent(yasio::io_event* event)
         if (response->isFinished())
         {
             response->updateInternalCode(yasio::errc::eof);
-            _service->close(event->cindex());
+            if (_keepAliveEnabled && response->isKeepAlive())
+                keepConnectionAlive(response, channel);
+            else
+                _service->close(channelIndex);
         }
         break;
     case YEK_ON_OPEN:
         if (event->status() == 0)
         {
-            obstream obs;
-            bool usePostData = false;
-            auto request     = response->getHttpRequest();
-            switch (request->getRequestType())
             {
-            case HttpRequest::Type::GET:
-                obs.write_bytes("GET");
-                break;
-            case HttpRequest::Type::PATCH:
-                obs.write_bytes("PATCH");
-                usePostData = true;
-                break;
-            case HttpRequest::Type::POST:
-                obs.write_bytes("POST");
-                usePostData = true;
-                break;
-            case HttpRequest::Type::DELETE:
-                obs.write_bytes("DELETE");
-                break;
-            case HttpRequest::Type::PUT:
-                obs.write_bytes("PUT");
-                usePostData = true;
-                break;
-            default:
-                obs.write_bytes("GET");
-                break;
+                std::lock_guard<std::mutex> lock(_connectionMutex);
+                _connections[channelIndex].transport = event->transport();
             }
-            obs.write_bytes(" ");
+            writeRequest(response, channel, event->transport());
+        }
+        else
+        {
+            handleNetworkEOF(response, channel, event->status());
+        }
+        break;
+    case YEK_ON_CLOSE:
+        handleNetworkEOF(response, channel, event->status());
+        break;
+    }
+}
+
+void HttpClient::writeRequest(HttpResponse* response, yasio::io_channel* channel, yasio::transport_handle_t transport)
+{
+    obstream obs;
+    bool usePostData = false;
+    auto request     = response->getHttpRequest();
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET:
+        obs.write_bytes("GET");
+        break;
+    case HttpRequest::Type::PATCH:
+        obs.write_bytes("PATCH");
+        usePostData = true;
+        break;
+    case HttpRequest::Type::POST:
+        obs.write_bytes("POST");
+        usePostData = true;
+        break;
+    case HttpRequest::Type::DELETE:
+        obs.write_bytes("DELETE");
+        break;
+    case HttpRequest::Type::PUT:
+        obs.write_bytes("PUT");
+        usePostData = true;
+        break;
+    default:
+        obs.write_bytes("GET");
+        break;
+    }
+    obs.write_bytes(" ");
+
+    auto& uri = response->getRequestUri();
+    obs.write_bytes(uri.getPathEtc());
 
-            auto& uri = response->getRequestUri();
-            obs.write_bytes(uri.getPathEtc());
+    obs.write_bytes(" HTTP/1.1\r\n");
 
-            obs.write_bytes(" HTTP/1.1\r\n");
+    obs.write_bytes("Host: ");
+    obs.write_bytes(uri.getHost());
+    obs.write_bytes("\r\n");
 
-            obs.write_bytes("Host: ");
-            obs.write_bytes(uri.getHost());
+    // process custom headers
+    struct HeaderFlag
+    {
+        enum
+        {
+            UESR_AGENT      = 1,
+            CONTENT_TYPE    = 1 << 1,
+            ACCEPT          = 1 << 2,
+            ACCEPT_ENCODING = 1 << 3,
+            CONNECTION      = 1 << 4,
+        };
+    };
+    int headerFlags = 0;
+    auto& headers   = request->getHeaders();
+    if (!headers.empty())
+    {
+        using namespace cxx17;  // for string_view literal
+        for (auto&& header : headers)
+        {
+            obs.write_bytes(header);
             obs.write_bytes("\r\n");
 
-            // process custom headers
-            struct HeaderFlag
-            {
-                enum
-                {
-                    UESR_AGENT   = 1,
-                    CONTENT_TYPE = 1 << 1,
-                    ACCEPT       = 1 << 2,
-                };
-            };
-            int headerFlags = 0;
-            auto& headers   = request->getHeaders();
-            if (!headers.empty())
-            {
-                using namespace cxx17;  // for string_view literal
-                for (auto&& header : headers)
-                {
-                    obs.write_bytes(header);
-                    obs.write_bytes("\r\n");
-
-                    if (cxx20::ic::starts_with(cxx17::string_view{header}, "User-Agent:"_sv))
-                        headerFlags |= HeaderFlag::UESR_AGENT;
-                    else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Content-Type:"_sv))
-                        headerFlags |= HeaderFlag::CONTENT_TYPE;
-                    else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Accept:"_sv))
-                        headerFlags |= HeaderFlag::ACCEPT;
-                }
-            }
+            if (cxx20::ic::starts_with(cxx17::string_view{header}, "User-Agent:"_sv))
+                headerFlags |= HeaderFlag::UESR_AGENT;
+            else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Content-Type:"_sv))
+                headerFlags |= HeaderFlag::CONTENT_TYPE;
+            else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Accept:"_sv))
+                headerFlags |= HeaderFlag::ACCEPT;
+            else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Accept-Encoding:"_sv))
+                headerFlags |= HeaderFlag::ACCEPT_ENCODING;
+            else if (cxx20::ic::starts_with(cxx17::string_view{header}, "Connection:"_sv))
+                headerFlags |= HeaderFlag::CONNECTION;
+        }
+    }
 
-            if (_cookie)
-            {
-                auto cookies = _cookie->checkAndGetFormatedMatchCookies(uri);
-                if (!cookies.empty())
-                {
-                    obs.write_bytes("Cookie: ");
-                    obs.write_bytes(cookies);
-                }
-            }
+    if (_cookie)
+    {
+        auto cookies = _cookie->checkAndGetFormatedMatchCookies(uri);
+        if (!cookies.empty())
+        {
+            obs.write_bytes("Cookie: ");
+            obs.write_bytes(cookies);
+        }
+    }
 
-            if (!(headerFlags & HeaderFlag::UESR_AGENT))
-                obs.write_bytes("User-Agent: yasio-http\r\n");
+    if (!(headerFlags & HeaderFlag::UESR_AGENT))
+        obs.write_bytes("User-Agent: yasio-http\r\n");
 
-            if (!(headerFlags & HeaderFlag::ACCEPT))
-                obs.write_bytes("Accept: */*;q=0.8\r\n");
+    if (!(headerFlags & HeaderFlag::ACCEPT))
+        obs.write_bytes("Accept: */*;q=0.8\r\n");
 
-            if (usePostData)
-            {
-                if (!(headerFlags & HeaderFlag::CONTENT_TYPE))
-                    obs.write_bytes("Content-Type: application/x-www-form-urlencoded;charset=UTF-8\r\n");
-
-                char strContentLength[128] = {0};
-                auto requestData           = request->getRequestData();
-                auto requestDataSize       = request->getRequestDataSize();
-                snprintf(strContentLength, sizeof(strContentLength), "Content-Length: %d\r\n\r\n",
-                         static_cast<int>(requestDataSize));
-                obs.write_bytes(strContentLength);
-
-                if (requestData && requestDataSize > 0)
-                    obs.write_bytes(cxx17::string_view{requestData, static_cast<size_t>(requestDataSize)});
-            }
-            else
-            {
-                obs.write_bytes("\r\n");
-            }
+    if (!(headerFlags & HeaderFlag::ACCEPT_ENCODING) && _responseDecodingEnabled)
+        obs.write_bytes("Accept-Encoding: gzip, deflate\r\n");
 
-            _service->write(event->transport(), std::move(obs.buffer()));
+    if (!(headerFlags & HeaderFlag::CONNECTION) && !_keepAliveEnabled)
+        obs.write_bytes("Connection: close\r\n");
 
-            auto& timerForRead = channel->get_user_timer();
-            timerForRead.cancel();
-            timerForRead.expires_from_now(std::chrono::seconds(this->_timeoutForRead));
-            timerForRead.async_wait([=](io_service& s) {
-                response->updateInternalCode(yasio::errc::read_timeout);
-                s.close(channelIndex);  // timeout
-                return true;
-            });
-        }
-        else
+    if (usePostData)
+    {
+        if (!(headerFlags & HeaderFlag::CONTENT_TYPE))
+            obs.write_bytes("Content-Type: application/x-www-form-urlencoded;charset=UTF-8\r\n");
+
+        char strContentLength[128] = {0};
+        auto requestData           = request->getRequestData();
+        auto requestDataSize       = request->getRequestDataSize();
+        snprintf(strContentLength, sizeof(strContentLength), "Content-Length: %d\r\n\r\n",
+                 static_cast<int>(requestDataSize));
+        obs.write_bytes(strContentLength);
+
+        if (requestData && requestDataSize > 0)
+            obs.write_bytes(cxx17::string_view{requestData, static_cast<size_t>(requestDataSize)});
+    }
+    else
+    {
+        obs.write_bytes("\r\n");
+    }
+
+    _service->write(transport, std::move(obs.buffer()));
+
+    int channelIndex   = channel->index();
+    auto& timerForRead = channel->get_user_timer();
+    timerForRead.cancel();
+    timerForRead.expires_from_now(std::chrono::seconds(this->_timeoutForRead));
+    timerForRead.async_wait([=](io_service& s) {
+        response->updateInternalCode(yasio::errc::read_timeout);
+        s.close(channelIndex);  // timeout
+        return true;
+    });
+}
+
+void HttpClient::writeRequestOnIdleConnection(int channelIndex, unsigned int generation)
+{
+    auto channel = _service->channel_at(channelIndex);
+    HttpResponse* response;
+    yasio::transport_handle_t transport;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        auto& connection = _connections[channelIndex];
+        // the connection was closed meanwhile, YEK_ON_CLOSE sends the request again on a new connection
+        if (connection.generation != generation || !connection.transport)
+            return;
+        response  = (HttpResponse*)channel->ud_.ptr;
+        transport = connection.transport;
+    }
+
+    writeRequest(response, channel, transport);
+}
+
+void HttpClient::keepConnectionAlive(HttpResponse* response, yasio::io_channel* channel)
+{
+    int channelIndex = channel->index();
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        auto& connection = _connections[channelIndex];
+        channel->ud_.ptr = nullptr;
+        connection.idle  = true;
+        generation       = ++connection.generation;
+    }
+
+    auto& timer = channel->get_user_timer();
+    timer.cancel();
+
+    completeResponse(response);
+    processPendingResponses();
+
+    // close the connection unless another request claims it before the idle timeout
+    timer.expires_from_now(std::chrono::seconds(_keepAliveTimeout));
+    timer.async_wait([this, channelIndex, generation](io_service& s) {
         {
-            handleNetworkEOF(response, channel, event->status());
+            std::lock_guard<std::mutex> lock(_connectionMutex);
+            auto& connection = _connections[channelIndex];
+            if (!connection.idle || connection.generation != generation)
+                return true;
+            connection.idle = false;
+            ++connection.generation;
         }
-        break;
-    case YEK_ON_CLOSE:
-        handleNetworkEOF(response, channel, event->status());
-        break;
-    }
+        s.close(channelIndex);
+        return true;
+    });
 }
 
 void HttpClient::handleNetworkEOF(HttpResponse* response, yasio::io_channel* channel, int internalErrorCode)
 {
-    channel->ud_.ptr = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_connectionMutex);
+        channel->ud_.ptr = nullptr;
+    }
 
     channel->get_user_timer().cancel();
-    response->updateInternalCode(internalErrorCode);
+    releaseConnection(channel->index());
+
+    // a read timeout is recorded on the response before the channel is closed locally
+    if (response->_reusedConnection && !response->_receivedData && response->_internalCode == 0 &&
+        __isClosedByPeer(internalErrorCode) && __isIdempotent(response->getHttpRequest()))
+    {  // the server dropped the kept alive connection before the request reached it, retry on a new connection
+        response->_reusedConnection = false;
+        response->_internalCode     = 0;
+        processResponse(response, false);
+        response->release();
+    }
+    else
+    {
+        response->updateInternalCode(internalErrorCode);
+        completeResponse(response);
+    }
+
+    processPendingResponses();
+}
+
+void HttpClient::completeResponse(HttpResponse* response)
+{
     auto responseCode = response->getResponseCode();
     switch (responseCode)
     {
@@ -409,29 +684,40 @@ void HttpClient::handleNetworkEOF(HttpResponse* response, yasio::io_channel* cha
     case 307:
         if (response->tryRedirect())
         {
-            processResponse(response, channel->index());
+            processResponse(response);
             response->release();
             break;
         }
     default:
         finishResponse(response);
+    }
+}
 
-        // try process pending response
-        auto lck = _pendingResponseQueue.get_lock();
-        if (!_pendingResponseQueue.unsafe_empty())
-        {
-            auto pendingResponse = _pendingResponseQueue.unsafe_front();
-            _pendingResponseQueue.unsafe_pop_front();
-            lck.unlock();
+void HttpClient::decodeResponseData(HttpResponse* response)
+{
+    auto& responseData = response->_responseData;
+    if (responseData.empty())
+        return;
 
-            processResponse(pendingResponse, channel->index());
-            pendingResponse->release();
-        }
-        else
-        {  // recycle channel
-            _availChannelQueue.push_front(channel->index());
-        }
+    auto encoding = response->getResponseHeaders().find("content-encoding");
+    if (encoding == response->getResponseHeaders().end())
+        return;
+
+    using namespace cxx17;  // for string_view literal
+    cxx17::string_view encodingName{encoding->second};
+    if (!cxx20::ic::iequals(encodingName, "gzip"_sv) && !cxx20::ic::iequals(encodingName, "x-gzip"_sv) &&
+        !cxx20::ic::iequals(encodingName, "deflate"_sv))
+        return;
+
+    // zlib detects gzip and zlib wrapped deflate streams by itself
+    auto decoded = ZipUtils::decompressGZ(responseData.data(), responseData.size());
+    if (decoded.empty())
+    {
+        AXLOGW("HttpClient: decode {} response data of {} failed", encodingName, response->getHttpRequest()->getUrl());
+        return;
     }
+    auto decodedData = reinterpret_cast<const char*>(decoded.data());
+    responseData.assign(decodedData, decodedData + decoded.size());
 }
 
 void HttpClient::finishResponse(HttpResponse* response)
@@ -439,6 +725,9 @@ void HttpClient::finishResponse(HttpResponse* response)
     auto request   = response->getHttpRequest();
     auto syncState = request->getSyncState();
 
+    if (_responseDecodingEnabled)
+        decodeResponseData(response);
+
     if (_cookie)
     {
         auto cookieRange = response->getResponseHeaders().equal_range("set-cookie");
@@ -513,6 +802,21 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
 
+void HttpClient::setKeepAliveEnabled(bool enabled)
+{
+    _keepAliveEnabled = enabled;
+}
+
+void HttpClient::setKeepAliveTimeout(int seconds)
+{
+    _keepAliveTimeout = std::max(seconds, 0);
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    _maxConnectionsPerHost = std::clamp(value, 1, HttpClient::MAX_CHANNELS);
+}
+
 std::string_view HttpClient::getCookieFilename()
 {
     std::lock_guard<std::recursive_mutex> lock(_cookieFileMutex);
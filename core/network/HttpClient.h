@@ -32,6 +32,9 @@
 #include <thread>
 #include <condition_variable>
 #include <deque>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 #include "base/Scheduler.h"
 #include "network/HttpRequest.h"
@@ -150,6 +153,60 @@ public:
      */
     int getTimeoutForRead();
 
+    /**
+     * Enable or disable reusing connections for requests to the same host, enabled by default.
+     * When disabled every request is sent with "Connection: close" on a new connection.
+     * A GET, or a PUT or DELETE without body, whose reused connection the server closed before replying is sent
+     * again once on a new connection. Other requests, and requests that timed out, fail as usual.
+     *
+     * @param enabled whether to keep connections alive.
+     */
+    void setKeepAliveEnabled(bool enabled);
+
+    /**
+     * Get whether connections are kept alive between requests.
+     */
+    bool isKeepAliveEnabled() const { return _keepAliveEnabled; }
+
+    /**
+     * Set how long an idle connection is kept open waiting for the next request.
+     *
+     * @param seconds the idle timeout in seconds, 15 by default.
+     */
+    void setKeepAliveTimeout(int seconds);
+
+    /**
+     * Get the idle timeout of kept alive connections in seconds.
+     */
+    int getKeepAliveTimeout() const { return _keepAliveTimeout; }
+
+    /**
+     * Set the maximum number of connections opened to the same host at the same time,
+     * further requests to that host wait in the pending queue.
+     *
+     * @param value the connection limit per host, 6 by default, at most MAX_CHANNELS.
+     */
+    void setMaxConnectionsPerHost(int value);
+
+    /**
+     * Get the maximum number of connections opened to the same host.
+     */
+    int getMaxConnectionsPerHost() const { return _maxConnectionsPerHost; }
+
+    /**
+     * Enable transparent decoding of gzip/deflate compressed responses, disabled by default.
+     * When enabled "Accept-Encoding: gzip, deflate" is sent unless the request sets its own
+     * Accept-Encoding header, and the response data is inflated before the callback is invoked.
+     *
+     * @param enabled whether to decode compressed responses.
+     */
+    void setResponseDecodingEnabled(bool enabled) { _responseDecodingEnabled = enabled; }
+
+    /**
+     * Get whether compressed responses are decoded.
+     */
+    bool isResponseDecodingEnabled() const { return _responseDecodingEnabled; }
+
     HttpCookie* getCookie() const { return _cookie; }
 
     std::recursive_mutex& getCookieFileMutex() { return _cookieFileMutex; }
@@ -201,14 +258,32 @@ private:
     HttpClient();
     virtual ~HttpClient();
 
-    void processResponse(HttpResponse* response, int channelIndex);
+    void processResponse(HttpResponse* response, bool reuseConnection = true);
+
+    void processPendingResponses();
 
     int tryTakeAvailChannel();
 
+    int tryTakeIdleConnection(std::string_view host);
+
+    bool tryCloseIdleConnection();
+
+    void releaseConnection(int channelIndex);
+
     void handleNetworkEvent(yasio::io_event* event);
 
     void handleNetworkEOF(HttpResponse* response, yasio::io_channel* channel, int internalErrorCode);
 
+    void writeRequest(HttpResponse* response, yasio::io_channel* channel, yasio::transport_handle_t transport);
+
+    void writeRequestOnIdleConnection(int channelIndex, unsigned int generation);
+
+    void keepConnectionAlive(HttpResponse* response, yasio::io_channel* channel);
+
+    void completeResponse(HttpResponse* response);
+
+    void decodeResponseData(HttpResponse* response);
+
     void tickInput();
 
     void finishResponse(HttpResponse* response);
@@ -235,6 +310,23 @@ private:
 
     ConcurrentDeque<int> _availChannelQueue;
 
+    /** The state of the connection opened on a channel, guarded by _connectionMutex. */
+    struct Connection
+    {
+        std::string host;                               /// scheme://host:port the channel is connected to
+        yasio::transport_handle_t transport = nullptr;  /// valid while the connection is open
+        bool idle                           = false;    /// open and waiting for the next request to the host
+        unsigned int generation             = 0;        /// bumped whenever the connection changes hands
+    };
+    Connection _connections[MAX_CHANNELS];
+    std::unordered_map<std::string, int> _hostConnectionCounts;
+    std::mutex _connectionMutex;
+
+    std::atomic<bool> _keepAliveEnabled;
+    std::atomic<int> _keepAliveTimeout;
+    std::atomic<int> _maxConnectionsPerHost;
+    std::atomic<bool> _responseDecodingEnabled;
+
     std::string _cookieFilename;
     std::recursive_mutex _cookieFileMutex;
 
@@ -144,8 +144,15 @@ private:
      */
     bool isFinished() const { return _finished; }
 
+    /**
+     * To see if the server allows the connection to be reused after this response.
+     */
+    bool isKeepAlive() const { return _keepAlive; }
+
     void handleInput(const char* d, size_t n)
     {
+        _receivedData = true;
+
         enum llhttp_errno err = llhttp_execute(&_context, d, n);
         if (err != HPE_OK)
         {
@@ -193,6 +200,8 @@ private:
             /* Resets response status */
             _responseHeaders.clear();
             _finished = false;
+            _keepAlive = false;
+            _receivedData = false;
             _responseData.clear();
             _currentHeader.clear();
             _responseCode = -1;
@@ -260,6 +269,7 @@ private:
     {
         auto thiz           = (HttpResponse*)context->data;
         thiz->_responseCode = context->status_code;
+        thiz->_keepAlive    = llhttp_should_keep_alive(context) != 0;
         thiz->_finished     = true;
         return 0;
     }
@@ -271,6 +281,9 @@ protected:
 
     Uri _requestUri;
     bool _finished = false;             /// to indicate if the http request is successful simply
+    bool _keepAlive = false;            /// the server allows the connection to be reused
+    bool _receivedData = false;         /// any bytes were received for the current request
+    bool _reusedConnection = false;     /// the request was sent on a kept alive connection
     yasio::sbyte_buffer _responseData;  /// the returned raw data. You can also dump it as a string
     std::string _currentHeader;
     std::string _currentHeaderValue;
@@ -27,6 +27,7 @@
 #include "physics/PhysicsWorld.h"
 #if defined(AX_ENABLE_PHYSICS)
 #    include <algorithm>
+#    include <chrono>
 #    include <climits>
 
 #    include "chipmunk/chipmunk_private.h"
@@ -402,8 +403,7 @@ bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
     if (contact.isNotificationEnabled())
     {
         contact.setEventCode(PhysicsContact::EventCode::BEGIN);
-        contact.setWorld(this);
-        _eventDispatcher->dispatchEvent(&contact);
+        dispatchContactEvent(contact);
     }
 
     return ret ? contact.resetResult() : false;
@@ -417,8 +417,7 @@ bool PhysicsWorld::collisionPreSolveCallback(PhysicsContact& contact)
     }
 
     contact.setEventCode(PhysicsContact::EventCode::PRESOLVE);
-    contact.setWorld(this);
-    _eventDispatcher->dispatchEvent(&contact);
+    dispatchContactEvent(contact);
 
     return contact.resetResult();
 }
@@ -431,8 +430,7 @@ void PhysicsWorld::collisionPostSolveCallback(PhysicsContact& contact)
     }
 
     contact.setEventCode(PhysicsContact::EventCode::POSTSOLVE);
-    contact.setWorld(this);
-    _eventDispatcher->dispatchEvent(&contact);
+    dispatchContactEvent(contact);
 }
 
 void PhysicsWorld::collisionSeparateCallback(PhysicsContact& contact)
@@ -443,8 +441,17 @@ void PhysicsWorld::collisionSeparateCallback(PhysicsContact& contact)
     }
 
     contact.setEventCode(PhysicsContact::EventCode::SEPARATE);
+    dispatchContactEvent(contact);
+}
+
+void PhysicsWorld::dispatchContactEvent(PhysicsContact& contact)
+{
+    auto start = std::chrono::steady_clock::now();
+
     contact.setWorld(this);
     _eventDispatcher->dispatchEvent(&contact);
+
+    _contactCallbackTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
 }
 
 void PhysicsWorld::rayCast(PhysicsRayCastCallbackFunc func, const Vec2& point1, const Vec2& point2, void* data)
@@ -561,7 +568,8 @@ void PhysicsWorld::addBody(PhysicsBody* body)
 
     addBodyOrDelay(body);
     _bodies.pushBack(body);
-    body->_world = this;
+    body->_world    = this;
+    _syncNodesDirty = true;
     body->setFixedUpdate(_fixedRate > 0);
 }
 
@@ -652,7 +660,8 @@ void PhysicsWorld::removeBody(PhysicsBody* body)
 
     removeBodyOrDelay(body);
     _bodies.eraseObject(body);
-    body->_world = nullptr;
+    body->_world    = nullptr;
+    _syncNodesDirty = true;
 }
 
 void PhysicsWorld::removeBodyOrDelay(PhysicsBody* body)
@@ -853,6 +862,7 @@ void PhysicsWorld::removeAllBodies()
     }
 
     _bodies.clear();
+    _syncNodesDirty = true;
 }
 
 void PhysicsWorld::setDebugDrawMask(int mask)
@@ -931,6 +941,12 @@ void PhysicsWorld::step(float delta)
 
 void PhysicsWorld::update(float delta, bool userCall /* = false*/)
 {
+    using clock  = std::chrono::steady_clock;
+    auto elapsed = [](clock::time_point start) {
+        return std::chrono::duration<float>(clock::now() - start).count();
+    };
+    _contactCallbackTime = 0.0f;
+    _stepTimings         = PhysicsStepTimings{};
 
     if (_preUpdateCallback)
         _preUpdateCallback();  // fix #11154
@@ -944,8 +960,10 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
         updateBodies();
     }
 
-    auto sceneToWorldTransform = _scene->getNodeToParentTransform();
-    beforeSimulation(_scene, sceneToWorldTransform, 1.f, 1.f, 0.f);
+    auto syncInStart = clock::now();
+    beforeSimulation();
+    _stepTimings.syncIn      = elapsed(syncInStart);
+    _stepTimings.syncedNodes = static_cast<unsigned int>(_syncNodes.size());
 
     if (!_delayAddJoints.empty() || !_delayRemoveJoints.empty())
     {
@@ -954,9 +972,13 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
 
     if (delta < FLT_EPSILON)
     {
+        _stepTimings.contactCallbacks = _contactCallbackTime;
         return;
     }
 
+    auto stepStart         = clock::now();
+    auto stepCallbacksTime = _contactCallbackTime;
+
     if (userCall)
     {
 #    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
@@ -1007,14 +1029,17 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
         }
     }
 
+    _stepTimings.step = elapsed(stepStart) - (_contactCallbackTime - stepCallbacksTime);
+
     if (_debugDrawMask != DEBUGDRAW_NONE)
     {
         debugDraw();
     }
 
-    // Update physics position, should loop as the same sequence as node tree.
-    // PhysicsWorld::afterSimulation() will depend on the sequence.
-    afterSimulation(_scene, sceneToWorldTransform, 0.f);
+    auto syncOutStart = clock::now();
+    afterSimulation();
+    _stepTimings.syncOut          = elapsed(syncOutStart);
+    _stepTimings.contactCallbacks = _contactCallbackTime;
 
     if (_postUpdateCallback)
         _postUpdateCallback();  // fix #11154
@@ -1049,6 +1074,8 @@ PhysicsWorld::PhysicsWorld()
     , _debugDraw(nullptr)
     , _debugDrawMask(DEBUGDRAW_NONE)
     , _eventDispatcher(nullptr)
+    , _syncNodesDirty(true)
+    , _contactCallbackTime(0.0f)
 {}
 
 PhysicsWorld::~PhysicsWorld()
@@ -1066,41 +1093,124 @@ PhysicsWorld::~PhysicsWorld()
     AX_SAFE_RELEASE_NULL(_debugDraw);
 }
 
-void PhysicsWorld::beforeSimulation(Node* node,
-                                    const Mat4& parentToWorldTransform,
-                                    float nodeParentScaleX,
-                                    float nodeParentScaleY,
-                                    float parentRotation)
+void PhysicsWorld::rebuildSyncNodes()
 {
-    auto scaleX   = nodeParentScaleX * node->getScaleX();
-    auto scaleY   = nodeParentScaleY * node->getScaleY();
-    auto rotation = parentRotation + node->getRotation();
+    _syncNodes.clear();
+    _syncNodeIndices.clear();
+    _syncNodesDirty = false;
 
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
+    // the scene comes first, its parent transform is its own node to parent transform
+    _syncNodes.emplace_back(SyncNode{_scene, nullptr, -1});
+    _syncNodeIndices.emplace(_scene, 0);
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+    std::vector<Node*> path;
+    for (auto&& body : _bodies)
     {
-        physicsBody->beforeSimulation(parentToWorldTransform, nodeToWorldTransform, scaleX, scaleY, rotation);
+        auto owner = body->getOwner();
+        if (owner == nullptr)
+            continue;
+
+        // walk up to the first node already in the list, the bodies out of the scene aren't synchronized
+        path.clear();
+        auto node = owner;
+        auto it   = _syncNodeIndices.find(node);
+        for (; node && it == _syncNodeIndices.end(); it = _syncNodeIndices.find(node))
+        {
+            path.emplace_back(node);
+            node = node->getParent();
+        }
+        if (node == nullptr)
+            continue;
+
+        auto parent = it->second;
+        for (auto pathIt = path.rbegin(); pathIt != path.rend(); ++pathIt)
+        {
+            auto index = static_cast<int>(_syncNodes.size());
+            _syncNodes.emplace_back(SyncNode{*pathIt, nullptr, parent});
+            _syncNodeIndices.emplace(*pathIt, index);
+            parent = index;
+        }
+        _syncNodes[_syncNodeIndices[owner]].body = body;
     }
 
-    for (auto&& child : node->getChildren())
-        beforeSimulation(child, nodeToWorldTransform, scaleX, scaleY, rotation);
+    // force the computation of all the world transforms
+    for (auto&& syncNode : _syncNodes)
+        syncNode.transformVersion = syncNode.node->_transformVersion - 1;
 }
 
-void PhysicsWorld::afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsWorld::refreshSyncNodes()
 {
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
-    auto nodeRotation         = parentRotation + node->getRotation();
+    if (!_syncNodesDirty)
+    {
+        // a node moved to another parent without leaving the scene invalidates the list
+        for (auto&& syncNode : _syncNodes)
+        {
+            if (syncNode.parent >= 0 && syncNode.node->getParent() != _syncNodes[syncNode.parent].node)
+            {
+                _syncNodesDirty = true;
+                break;
+            }
+        }
+    }
+    if (_syncNodesDirty)
+        rebuildSyncNodes();
+
+    // the parents come first, so a node is computed again when its own transform or one of its ancestors changed
+    auto& sceneToWorldTransform = _scene->getNodeToParentTransform();
+    for (auto&& syncNode : _syncNodes)
+    {
+        auto node        = syncNode.node;
+        auto parent      = syncNode.parent >= 0 ? &_syncNodes[syncNode.parent] : nullptr;
+        syncNode.updated = (parent && parent->updated) || syncNode.transformVersion != node->_transformVersion;
+        if (!syncNode.updated)
+            continue;
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+        auto& parentToWorldTransform = parent ? parent->nodeToWorld : sceneToWorldTransform;
+        syncNode.transformVersion    = node->_transformVersion;
+        syncNode.nodeToWorld         = parentToWorldTransform * node->getNodeToParentTransform();
+        syncNode.scaleX              = (parent ? parent->scaleX : 1.f) * node->getScaleX();
+        syncNode.scaleY              = (parent ? parent->scaleY : 1.f) * node->getScaleY();
+        syncNode.rotation            = (parent ? parent->rotation : 0.f) + node->getRotation();
+    }
+}
+
+void PhysicsWorld::beforeSimulation()
+{
+    refreshSyncNodes();
+
+    auto& sceneToWorldTransform = _scene->getNodeToParentTransform();
+    for (auto&& syncNode : _syncNodes)
     {
-        physicsBody->afterSimulation(parentToWorldTransform, parentRotation);
+        if (syncNode.body == nullptr)
+            continue;
+
+        auto& parentToWorldTransform =
+            syncNode.parent >= 0 ? _syncNodes[syncNode.parent].nodeToWorld : sceneToWorldTransform;
+        syncNode.body->beforeSimulation(parentToWorldTransform, syncNode.nodeToWorld, syncNode.scaleX, syncNode.scaleY,
+                                        syncNode.rotation);
     }
+}
+
+void PhysicsWorld::afterSimulation()
+{
+    // All the world transforms are computed before any node moves, so a body is positioned relatively to the
+    // transform its parent had during the step, whatever the order of the list.
+    refreshSyncNodes();
+
+    auto sceneToWorldTransform = _scene->getNodeToParentTransform();
+    for (auto&& syncNode : _syncNodes)
+    {
+        if (syncNode.body == nullptr)
+            continue;
 
-    for (auto&& child : node->getChildren())
-        afterSimulation(child, nodeToWorldTransform, nodeRotation);
+        if (syncNode.parent >= 0)
+        {
+            auto& parent = _syncNodes[syncNode.parent];
+            syncNode.body->afterSimulation(parent.nodeToWorld, parent.rotation);
+        }
+        else
+            syncNode.body->afterSimulation(sceneToWorldTransform, 0.f);
+    }
 }
 
 void PhysicsWorld::setPostUpdateCallback(const std::function<void()>& callback)
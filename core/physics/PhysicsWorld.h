@@ -31,6 +31,8 @@
 #if defined(AX_ENABLE_PHYSICS)
 
 #    include <list>
+#    include <vector>
+#    include <unordered_map>
 #    include "base/Vector.h"
 #    include "math/Math.h"
 #    include "physics/PhysicsBody.h"
@@ -87,6 +89,18 @@ typedef std::function<bool(PhysicsWorld& world, const PhysicsRayCastInfo& info,
 typedef std::function<bool(PhysicsWorld&, PhysicsShape&, void*)> PhysicsQueryRectCallbackFunc;
 typedef PhysicsQueryRectCallbackFunc PhysicsQueryPointCallbackFunc;
 
+/**
+ * @brief Time spent by a PhysicsWorld in the phases of its last update, see PhysicsWorld::getStepTimings.
+ */
+struct AX_DLL PhysicsStepTimings
+{
+    float syncIn             = 0.0f;  // Seconds spent copying the node transforms into the bodies.
+    float step               = 0.0f;  // Seconds spent stepping the space, the contact callbacks excluded.
+    float syncOut            = 0.0f;  // Seconds spent copying the body positions back into the nodes.
+    float contactCallbacks   = 0.0f;  // Seconds spent dispatching the contact events.
+    unsigned int syncedNodes = 0;     // Number of nodes synchronized: the nodes with a body and their ancestors.
+};
+
 /**
  * @addtogroup physics
  * @{
@@ -402,6 +416,13 @@ public:
      */
     void step(float delta);
 
+    /**
+     * Get the time spent in the phases of the last update of this physics world.
+     *
+     * @return A PhysicsStepTimings object.
+     */
+    const PhysicsStepTimings& getStepTimings() const { return _stepTimings; }
+
 protected:
     static PhysicsWorld* construct(Scene* scene);
     bool init();
@@ -417,6 +438,7 @@ protected:
     virtual bool collisionPreSolveCallback(PhysicsContact& contact);
     virtual void collisionPostSolveCallback(PhysicsContact& contact);
     virtual void collisionSeparateCallback(PhysicsContact& contact);
+    void dispatchContactEvent(PhysicsContact& contact);
 
     virtual void doAddBody(PhysicsBody* body);
     virtual void doRemoveBody(PhysicsBody* body);
@@ -455,16 +477,37 @@ protected:
     std::function<void()> _preUpdateCallback;
     std::function<void()> _postUpdateCallback;
 
+    // A node synchronized with the bodies: the owner of a body of this world, or an ancestor of one
+    struct SyncNode
+    {
+        Node* node;
+        PhysicsBody* body;          // nullptr for an ancestor without a body
+        int parent;                 // index of the parent in _syncNodes, -1 for the scene
+        uint32_t transformVersion;  // Node::_transformVersion when nodeToWorld was computed
+        bool updated;               // whether nodeToWorld was computed again by the last refresh
+        float scaleX;
+        float scaleY;
+        float rotation;
+        Mat4 nodeToWorld;
+    };
+
+    // the scene and the nodes carrying the bodies of _bodies with their ancestors, the parents come first
+    std::vector<SyncNode> _syncNodes;
+    std::unordered_map<Node*, int> _syncNodeIndices;
+    bool _syncNodesDirty;
+
+    PhysicsStepTimings _stepTimings;
+    float _contactCallbackTime;
+
 protected:
     PhysicsWorld();
     virtual ~PhysicsWorld();
 
-    void beforeSimulation(Node* node,
-                          const Mat4& parentToWorldTransform,
-                          float nodeParentScaleX,
-                          float nodeParentScaleY,
-                          float parentRotation);
-    void afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation);
+    void beforeSimulation();
+    void afterSimulation();
+    /// Updates the cached world transforms of the sync list, rebuilt first if the bodies or the hierarchy changed
+    void refreshSyncNodes();
+    void rebuildSyncNodes();
 
     friend class Node;
     friend class Sprite;
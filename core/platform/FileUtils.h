@@ -898,11 +898,12 @@ protected:
         // move our arguments into our lambda, to potentially avoid copying.
         auto lambda = std::bind(
             [](const T& actionIn, const R& callbackIn, const ARGS&... argsIn) {
-            Director::getInstance()->getScheduler()->runOnAxmolThread(std::bind(callbackIn, actionIn(argsIn...)));
+            Director::getInstance()->getScheduler()->runOnAxmolThread(std::bind(callbackIn, actionIn(argsIn...)),
+                                                                      Scheduler::ActionPriority::Background);
             },
             std::forward<T>(action), std::forward<R>(callback), std::forward<ARGS>(args)...);
 
-        Director::getInstance()->getJobSystem()->enqueue(std::move(lambda));
+        Director::getInstance()->getJobSystem()->run(std::move(lambda), JobPriority::Low);
     }
 };
 
@@ -0,0 +1,59 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/GLViewNull.h"
+#include "renderer/backend/DriverBase.h"
+
+namespace ax
+{
+
+GLViewNull* GLViewNull::create(std::string_view viewName, const Size& frameSize)
+{
+    auto ret = new GLViewNull;
+    if (ret->init(viewName, frameSize))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    AX_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool GLViewNull::init(std::string_view viewName, const Size& frameSize)
+{
+    AXASSERT(backend::DriverBase::isNullDriverEnabled(), "GLViewNull has no graphics context, use the null driver");
+
+    setViewName(viewName);
+    setFrameSize(frameSize.width, frameSize.height);
+    setDesignResolutionSize(frameSize.width, frameSize.height, ResolutionPolicy::SHOW_ALL);
+    return true;
+}
+
+void GLViewNull::end()
+{
+    // Release self like the platform views do, the director gives up its reference this way.
+    release();
+}
+
+}  // namespace ax
@@ -27,8 +27,8 @@ THE SOFTWARE.
 #include <unistd.h>
 #include <sys/time.h>
 #include <string>
-#include <thread>
 #include "base/Director.h"
+#include "base/FramePacer.h"
 #include "base/Utils.h"
 #include "platform/FileUtils.h"
 
@@ -59,7 +59,8 @@ int Application::run()
         return 0;
     }
 
-    std::chrono::steady_clock::time_point lastTime{};
+    // paces against absolute deadlines, sleep_for alone overshoots by a millisecond or two
+    FramePacer framePacer(_animationInterval);
 
     auto director = Director::getInstance();
     auto glView   = director->getGLView();
@@ -69,21 +70,11 @@ int Application::run()
 
     while (!glView->windowShouldClose())
     {
-        lastTime = std::chrono::steady_clock::now();
-
         director->mainLoop();
         glView->pollEvents();
 
-        auto interval = std::chrono::steady_clock::now() - lastTime;
-        if (interval < _animationInterval)
-        {
-            auto waitDuration = _animationInterval - interval;
-            std::this_thread::sleep_for(waitDuration);
-        }
-        else
-        {
-            std::this_thread::yield();
-        }
+        framePacer.setInterval(_animationInterval);
+        framePacer.waitForNextFrame();
     }
     /* Only work on Desktop
      *  Director::mainLoop is really one frame logic
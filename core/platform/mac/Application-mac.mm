@@ -26,12 +26,12 @@ THE SOFTWARE.
 #import <Cocoa/Cocoa.h>
 #import <Metal/Metal.h>
 #include <algorithm>
-#include <thread>
 
 #include "platform/Application.h"
 #include "platform/FileUtils.h"
 #include "math/Math.h"
 #include "base/Director.h"
+#include "base/FramePacer.h"
 #include "base/Utils.h"
 #include "renderer/backend/metal/DriverMTL.h"
 
@@ -60,9 +60,8 @@ int Application::run()
         return 1;
     }
 
-    std::chrono::steady_clock::time_point lastTime{};
-
-    constexpr std::chrono::nanoseconds _1ms{1000000};
+    // paces against absolute deadlines, sleep_for alone overshoots by a millisecond or two
+    FramePacer framePacer(_animationInterval);
 
     auto director = Director::getInstance();
     auto glView   = director->getGLView();
@@ -72,17 +71,11 @@ int Application::run()
 
     while (!glView->windowShouldClose())
     {
-        lastTime = std::chrono::steady_clock::now();
-
         director->mainLoop();
         glView->pollEvents();
 
-        auto interval = std::chrono::steady_clock::now() - lastTime;
-        auto waitDuration = _animationInterval - interval - _1ms;
-        if (waitDuration.count() > 0)
-            std::this_thread::sleep_for(waitDuration);
-        else
-            std::this_thread::yield();
+        framePacer.setInterval(_animationInterval);
+        framePacer.waitForNextFrame();
     }
 
     /* Only work on Desktop
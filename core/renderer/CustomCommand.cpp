@@ -23,9 +23,11 @@
  THE SOFTWARE.
  ****************************************************************************/
 #include "renderer/CustomCommand.h"
+#include "renderer/Renderer.h"
 #include "renderer/TextureAtlas.h"
 #include "renderer/backend/Buffer.h"
 #include "renderer/backend/DriverBase.h"
+#include "base/Director.h"
 #include "base/Utils.h"
 #include <stddef.h>
 
@@ -160,13 +162,13 @@ void CustomCommand::createIndexBuffer(IndexFormat format, std::size_t capacity,
 void CustomCommand::updateVertexBuffer(const void* data, std::size_t offset, std::size_t length)
 {
     assert(_vertexBuffer);
-    _vertexBuffer->updateSubData(data, offset, length);
+    Director::getInstance()->getRenderer()->updateBufferSubData(_vertexBuffer, data, offset, length);
 }
 
 void CustomCommand::updateIndexBuffer(const void* data, std::size_t offset, std::size_t length)
 {
     assert(_indexBuffer);
-    _indexBuffer->updateSubData(data, offset, length);
+    Director::getInstance()->getRenderer()->updateBufferSubData(_indexBuffer, data, offset, length);
 }
 
 void CustomCommand::setVertexBuffer(backend::Buffer* vertexBuffer)
@@ -195,13 +197,13 @@ void CustomCommand::setIndexBuffer(backend::Buffer* indexBuffer, IndexFormat for
 void CustomCommand::updateVertexBuffer(const void* data, std::size_t length)
 {
     assert(_vertexBuffer);
-    _vertexBuffer->updateData(data, length);
+    Director::getInstance()->getRenderer()->updateBufferData(_vertexBuffer, data, length);
 }
 
 void CustomCommand::updateIndexBuffer(const void* data, std::size_t length)
 {
     assert(_indexBuffer);
-    _indexBuffer->updateData(data, length);
+    Director::getInstance()->getRenderer()->updateBufferData(_indexBuffer, data, length);
 }
 
 std::size_t CustomCommand::computeIndexSize() const
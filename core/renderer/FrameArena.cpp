@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "renderer/FrameArena.h"
+#include "base/Macros.h"
+
+#include <stdlib.h>
+
+namespace ax
+{
+
+static inline size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameArena::FrameArena(size_t blockSize) : _blockSize(blockSize)
+{
+    _blocks.reserve(8);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+    freeBlocks();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    AXASSERT(alignment && (alignment & (alignment - 1)) == 0, "alignment must be a power of 2");
+
+    while (true)
+    {
+        if (_currentBlock < _blocks.size())
+        {
+            auto& block = _blocks[_currentBlock];
+            auto base   = reinterpret_cast<uintptr_t>(block.data);
+            auto offset = alignUp(base + _offset, alignment) - base;
+            if (offset + size <= block.size)
+            {
+                _offset = offset + size;
+                _usedBytes += size;
+                return block.data + offset;
+            }
+
+            if (_currentBlock + 1 < _blocks.size())
+            {
+                ++_currentBlock;
+                _offset = 0;
+                continue;
+            }
+        }
+
+        addBlock(size + alignment);
+        _currentBlock = _blocks.size() - 1;
+        _offset       = 0;
+    }
+}
+
+void FrameArena::addFinalizer(void (*finalizer)(void*), void* object)
+{
+    auto node      = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+    node->finalize = finalizer;
+    node->object   = object;
+    node->next     = _finalizers;
+    _finalizers    = node;
+}
+
+void FrameArena::reset()
+{
+    // the list is LIFO, objects are destroyed in reverse order of construction
+    for (auto node = _finalizers; node; node = node->next)
+        node->finalize(node->object);
+    _finalizers = nullptr;
+
+    // merge the blocks, the next frame fits in one block
+    if (_blocks.size() > 1)
+    {
+        auto capacity = _capacity;
+        freeBlocks();
+        addBlock(capacity);
+    }
+
+    _currentBlock    = 0;
+    _offset          = 0;
+    _usedBytes       = 0;
+    _heapAllocations = 0;
+}
+
+void FrameArena::addBlock(size_t minSize)
+{
+    Block block;
+    block.size = (std::max)(minSize, _blockSize);
+    block.data = static_cast<uint8_t*>(malloc(block.size));
+    AXASSERT(block.data, "FrameArena: out of memory");
+    _blocks.emplace_back(block);
+    _capacity += block.size;
+    ++_heapAllocations;
+}
+
+void FrameArena::freeBlocks()
+{
+    for (auto&& block : _blocks)
+        free(block.data);
+    _blocks.clear();
+    _capacity = 0;
+}
+
+}
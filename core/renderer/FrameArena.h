@@ -0,0 +1,121 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform/PlatformMacros.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+namespace ax
+{
+
+/**
+ A linear (bump) allocator for the data which only lives for one frame of the renderer.
+ Allocating is a pointer increment, nothing is freed individually: `reset` runs the registered
+ finalizers and rewinds the whole arena at once. After a frame which needed more than one block,
+ the blocks are merged so that a steady-state frame never touches the heap.
+ */
+class AX_DLL FrameArena
+{
+public:
+    /**The default size of a block of the arena in bytes.*/
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /** Allocates uninitialized memory, valid until the next `reset`. */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /** Registers a function invoked with object on `reset`, in reverse order of registration. */
+    void addFinalizer(void (*finalizer)(void*), void* object);
+
+    /** Constructs an object in the arena, its destructor is invoked on `reset` if not trivial. */
+    template <typename T, typename... Args>
+    T* construct(Args&&... args)
+    {
+        auto object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            addFinalizer([](void* p) { static_cast<T*>(p)->~T(); }, object);
+        return object;
+    }
+
+    /** Runs the finalizers and rewinds the arena. */
+    void reset();
+
+    /** The number of bytes allocated since the last `reset`. */
+    size_t getUsedBytes() const { return _usedBytes; }
+
+    /** The total size of the blocks owned by the arena. */
+    size_t getCapacity() const { return _capacity; }
+
+    /** The number of heap allocations made by the arena since the last `reset`, 0 in a steady state. */
+    uint32_t getHeapAllocations() const { return _heapAllocations; }
+
+private:
+    struct Block
+    {
+        uint8_t* data = nullptr;
+        size_t size   = 0;
+    };
+
+    struct Finalizer
+    {
+        void (*finalize)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    void addBlock(size_t minSize);
+    void freeBlocks();
+
+    std::vector<Block> _blocks;
+    size_t _blockSize         = DEFAULT_BLOCK_SIZE;
+    size_t _currentBlock      = 0;
+    size_t _offset            = 0;
+    size_t _usedBytes         = 0;
+    size_t _capacity          = 0;
+    uint32_t _heapAllocations = 0;
+    Finalizer* _finalizers    = nullptr;
+};
+
+}
+
+/**
+ end of support group
+ @}
+ */
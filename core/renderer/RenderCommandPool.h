@@ -27,7 +27,7 @@
 #define __AX_RENDERCOMMANDPOOL_H__
 /// @cond DO_NOT_SHOW
 
-#include <list>
+#include <vector>
 
 #include "platform/PlatformMacros.h"
 
@@ -61,8 +61,8 @@ public:
         {
             AllocateCommands();
         }
-        result = _freePool.front();
-        _freePool.pop_front();
+        result = _freePool.back();
+        _freePool.pop_back();
         //_usedPool.insert(result);
         return result;
     }
@@ -91,8 +91,8 @@ private:
         }
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
+    std::vector<T*> _allocatedPoolBlocks;
+    std::vector<T*> _freePool;
     // std::set<T*> _usedPool;
 };
 
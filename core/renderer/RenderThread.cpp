@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/RenderThread.h"
+#include "renderer/backend/DeferredCommandBuffer.h"
+
+namespace ax
+{
+
+RenderThread::RenderThread(backend::DeferredCommandBuffer* commandBuffer) : _commandBuffer(commandBuffer)
+{
+    _thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _exit = true;
+    }
+    _submitted.notify_one();
+    _thread.join();
+}
+
+void RenderThread::submit(backend::DeferredFrame* frame, std::function<void()> present)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _executed.wait(lock, [this] { return _frame == nullptr; });
+        _frame   = frame;
+        _present = std::move(present);
+    }
+    _submitted.notify_one();
+}
+
+void RenderThread::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _executed.wait(lock, [this] { return _frame == nullptr; });
+}
+
+void RenderThread::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+    {
+        _submitted.wait(lock, [this] { return _frame != nullptr || _exit; });
+
+        // exit once the last submitted frame is executed
+        if (!_frame)
+            break;
+
+        auto frame   = _frame;
+        auto present = std::move(_present);
+        lock.unlock();
+        _commandBuffer->execute(frame, present);
+        lock.lock();
+
+        _frame = nullptr;
+        _executed.notify_all();
+    }
+}
+
+}  // namespace ax
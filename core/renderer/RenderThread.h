@@ -0,0 +1,84 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/PlatformMacros.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ax
+{
+
+namespace backend
+{
+class DeferredCommandBuffer;
+struct DeferredFrame;
+}  // namespace backend
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/**
+ * The thread executing the frames recorded by a DeferredCommandBuffer, see Renderer::setPipelined. One frame
+ * executes while the main thread records the next one, submit waits until the previous frame is executed.
+ */
+class AX_DLL RenderThread
+{
+public:
+    explicit RenderThread(backend::DeferredCommandBuffer* commandBuffer);
+
+    /** Executes the submitted frame, then joins the thread. */
+    ~RenderThread();
+
+    /**
+     * Hand a closed frame over, waits until the previous frame is executed.
+     * @param present Called on the render thread before the target command buffer ends the frame.
+     */
+    void submit(backend::DeferredFrame* frame, std::function<void()> present);
+
+    /** The sync point: wait until the submitted frame is executed. */
+    void wait();
+
+private:
+    void run();
+
+    backend::DeferredCommandBuffer* _commandBuffer = nullptr;
+    backend::DeferredFrame* _frame                 = nullptr;
+    std::function<void()> _present;
+    std::mutex _mutex;
+    std::condition_variable _submitted;
+    std::condition_variable _executed;
+    bool _exit = false;
+    std::thread _thread;
+};
+
+// end of renderer group
+/// @}
+}  // namespace ax
@@ -26,6 +26,7 @@
 #include "renderer/Renderer.h"
 
 #include <algorithm>
+#include <atomic>
 
 #include "renderer/TrianglesCommand.h"
 #include "renderer/CustomCommand.h"
@@ -36,6 +37,7 @@
 #include "renderer/Technique.h"
 #include "renderer/Pass.h"
 #include "renderer/Texture2D.h"
+#include "renderer/RenderThread.h"
 
 #include "base/Configuration.h"
 #include "base/Director.h"
@@ -43,39 +45,48 @@
 #include "base/EventListenerCustom.h"
 #include "base/EventType.h"
 #include "2d/Camera.h"
+#include "2d/Node.h"
 #include "2d/Scene.h"
 #include "xxhash.h"
 
 #include "renderer/backend/Backend.h"
 #include "renderer/backend/RenderTarget.h"
+#include "renderer/backend/DeferredCommandBuffer.h"
 
 namespace ax
 {
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Maps a float to an uint32 which keeps the float ordering when compared as unsigned integer
+static inline uint32_t toSortableBits(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
-{
-    return a->getDepth() > b->getDepth();
-}
+// sort key layout, from the most significant bit:
+//   DEFAULT:  | group: 3 | globalZ (or inverted depth for TRANSPARENT_3D): 32 | sequence: 29 |
+//   MATERIAL: | group: 3 | globalZ: 32 | barrier segment: 13 | material: 16 |
+static const int SORT_KEY_GROUP_SHIFT        = 61;
+static const int SORT_KEY_ORDER_SHIFT        = 29;
+static const int SORT_KEY_SEGMENT_SHIFT      = 16;
+static const uint32_t SORT_KEY_MAX_SEGMENT = (1u << 13) - 1;
 
 // queue
 RenderQueue::RenderQueue() {}
 
 void RenderQueue::emplace_back(RenderCommand* command)
 {
+    QUEUE_GROUP group;
     float z = command->getGlobalOrder();
     if (z < 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_NEG].emplace_back(command);
+        group = QUEUE_GROUP::GLOBALZ_NEG;
     }
     else if (z > 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_POS].emplace_back(command);
+        group = QUEUE_GROUP::GLOBALZ_POS;
     }
     else
     {
@@ -83,17 +94,100 @@ void RenderQueue::emplace_back(RenderCommand* command)
         {
             if (command->isTransparent())
             {
-                _commands[QUEUE_GROUP::TRANSPARENT_3D].emplace_back(command);
+                group = QUEUE_GROUP::TRANSPARENT_3D;
             }
             else
             {
-                _commands[QUEUE_GROUP::OPAQUE_3D].emplace_back(command);
+                group = QUEUE_GROUP::OPAQUE_3D;
             }
         }
         else
         {
-            _commands[QUEUE_GROUP::GLOBALZ_ZERO].emplace_back(command);
+            group = QUEUE_GROUP::GLOBALZ_ZERO;
+        }
+    }
+    _keys[group].emplace_back(makeSortKey(command, group, _commands[group].size()));
+    _commands[group].emplace_back(command);
+}
+
+uint64_t RenderQueue::makeSortKey(RenderCommand* command, QUEUE_GROUP group, size_t sequence)
+{
+    uint64_t key = static_cast<uint64_t>(group) << SORT_KEY_GROUP_SHIFT;
+    if (group == QUEUE_GROUP::TRANSPARENT_3D)
+    {
+        // far to near
+        key |= static_cast<uint64_t>(~toSortableBits(command->getDepth())) << SORT_KEY_ORDER_SHIFT;
+    }
+    else
+    {
+        key |= static_cast<uint64_t>(toSortableBits(command->getGlobalOrder())) << SORT_KEY_ORDER_SHIFT;
+    }
+
+    if (_sortKeyMode == SortKeyMode::MATERIAL && group != QUEUE_GROUP::TRANSPARENT_3D)
+    {
+        // Only consecutive TrianglesCommands may be reordered, any other command starts a new segment, so that
+        // e.g. the scissor callbacks of a ui::Layout still wrap their children
+        auto& segment    = _segments[group];
+        bool isTriangles = command->getType() == RenderCommand::Type::TRIANGLES_COMMAND;
+        if (!isTriangles && segment < SORT_KEY_MAX_SEGMENT)
+            ++segment;
+
+        // out of segments: the remaining commands share the same key, and keep the submission order
+        uint32_t material = 0xffff;
+        if (segment < SORT_KEY_MAX_SEGMENT)
+        {
+            auto materialID = isTriangles ? static_cast<TrianglesCommand*>(command)->getMaterialID() : 0u;
+            material        = (materialID ^ (materialID >> 16)) & 0xffff;
+        }
+        return key | (static_cast<uint64_t>(segment) << SORT_KEY_SEGMENT_SHIFT) | material;
+    }
+
+    // the radix sort is stable, the sequence keeps the submission order explicit in the key anyway
+    return key | (sequence & ((1u << SORT_KEY_ORDER_SHIFT) - 1));
+}
+
+void RenderQueue::getPositions(size_t positions[QUEUE_COUNT]) const
+{
+    for (int i = 0; i < QUEUE_GROUP::QUEUE_COUNT; ++i)
+        positions[i] = _commands[i].size();
+}
+
+void RenderQueue::merge(const MergeSource* sources, size_t count)
+{
+    for (int i = 0; i < QUEUE_GROUP::QUEUE_COUNT; ++i)
+    {
+        auto group     = static_cast<QUEUE_GROUP>(i);
+        auto& commands = _commands[group];
+
+        size_t mergedCount = 0;
+        for (size_t s = 0; s < count; ++s)
+            mergedCount += sources[s].queue->_commands[group].size();
+        if (mergedCount == 0)
+            continue;
+
+        _mergeScratch.clear();
+        _mergeScratch.reserve(commands.size() + mergedCount);
+        size_t position = 0;
+        for (size_t s = 0; s < count; ++s)
+        {
+            auto& source = sources[s];
+            AXASSERT(source.positions[group] >= position && source.positions[group] <= commands.size(),
+                     "The merge sources must be ordered by position");
+            _mergeScratch.insert(_mergeScratch.end(), commands.begin() + position,
+                                 commands.begin() + source.positions[group]);
+            position = source.positions[group];
+            auto& recorded = source.queue->_commands[group];
+            _mergeScratch.insert(_mergeScratch.end(), recorded.begin(), recorded.end());
         }
+        _mergeScratch.insert(_mergeScratch.end(), commands.begin() + position, commands.end());
+        commands.swap(_mergeScratch);
+
+        // the sequences and barrier segments depend on the final order
+        auto& keys       = _keys[group];
+        _segments[group] = 0;
+        keys.resize(commands.size());
+        for (size_t c = 0, size = commands.size(); c < size; ++c)
+            keys[c] = makeSortKey(commands[c], group, c);
     }
 }
 
@@ -111,12 +205,83 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]),
-                     std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]),
-                     compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]),
-                     compareRenderCommand);
+    sortSubQueue(QUEUE_GROUP::TRANSPARENT_3D);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_NEG);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_POS);
+    // the material keys reorder the commands with globalZ == 0 as well
+    if (_sortKeyMode == SortKeyMode::MATERIAL)
+        sortSubQueue(QUEUE_GROUP::GLOBALZ_ZERO);
+}
+
+void RenderQueue::sortSubQueue(QUEUE_GROUP group)
+{
+    auto& commands = _commands[group];
+    auto& keys     = _keys[group];
+    auto count     = commands.size();
+    if (count < 2)
+        return;
+
+    AXASSERT(keys.size() == count, "The commands must be pushed with emplace_back");
+
+    _sortItems.resize(count);
+    _sortScratch.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        _sortItems[i] = SortItem{keys[i], commands[i]};
+
+    radixSort(_sortItems.data(), _sortScratch.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i]     = _sortItems[i].key;
+        commands[i] = _sortItems[i].command;
+    }
+}
+
+void RenderQueue::radixSort(SortItem* items, SortItem* scratch, size_t count)
+{
+    constexpr int RADIX_BITS   = 8;
+    constexpr int RADIX_SIZE   = 1 << RADIX_BITS;
+    constexpr int RADIX_PASSES = 64 / RADIX_BITS;
+
+    if (count < 2)
+        return;
+
+    // build the histograms of all the digits in one pass
+    uint32_t histograms[RADIX_PASSES][RADIX_SIZE] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto key = items[i].key;
+        for (int pass = 0; pass < RADIX_PASSES; ++pass)
+            ++histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+    }
+
+    auto src = items;
+    auto dst = scratch;
+    for (int pass = 0; pass < RADIX_PASSES; ++pass)
+    {
+        auto shift      = pass * RADIX_BITS;
+        auto& histogram = histograms[pass];
+
+        // skip the digits shared by all keys, e.g. the queue group, or globalZ in the GLOBALZ_ZERO group
+        if (histogram[(src[0].key >> shift) & (RADIX_SIZE - 1)] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            auto bucketCount = bucket;
+            bucket           = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].key >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    if (src != items)
+        memcpy(items, src, count * sizeof(SortItem));
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -140,6 +305,8 @@ void RenderQueue::clear()
     for (int i = 0; i < QUEUE_GROUP::QUEUE_COUNT; ++i)
     {
         _commands[i].clear();
+        _keys[i].clear();
+        _segments[i] = 0;
     }
 }
 
@@ -149,6 +316,9 @@ void RenderQueue::realloc(size_t reserveSize)
     {
         _commands[i].clear();
         _commands[i].reserve(reserveSize);
+        _keys[i].clear();
+        _keys[i].reserve(reserveSize);
+        _segments[i] = 0;
     }
 }
 
@@ -157,6 +327,20 @@ void RenderQueue::realloc(size_t reserveSize)
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// the states of a deferred visit
+static const int PARALLEL_VISIT_QUEUED  = 0;
+static const int PARALLEL_VISIT_RUNNING = 1;
+
+// the most batch flushes retained in a frame, the following ones are filled in the shared buffers every frame
+static const size_t RETAINED_BATCH_MAX = 32;
+// the frames an unused retained batch is kept
+static const unsigned int RETAINED_BATCH_MAX_IDLE_FRAMES = 60;
+// the smallest vertex capacity of a retained batch
+static const unsigned int RETAINED_BATCH_MIN_VERTICES = 256;
+
+// the queue recording the commands of the deferred visit running on this thread
+static thread_local RenderQueue* s_parallelVisitQueue = nullptr;
+
 //
 // constructors, destructor, init
 //
@@ -168,6 +352,7 @@ Renderer::Renderer()
 
     _renderGroups.emplace_back();
     _queuedTriangleCommands.reserve(BATCH_TRIAGCOMMAND_RESERVED_SIZE);
+    _queuedFills.reserve(BATCH_TRIAGCOMMAND_RESERVED_SIZE);
 
     // for the batched TriangleCommand
     _triBatchesToDraw = (TriBatchToDraw*)malloc(sizeof(_triBatchesToDraw[0]) * _triBatchesToDrawCapacity);
@@ -175,20 +360,21 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
+    // execute the last submitted frame, the commands reference the resources released below
+    _renderThread.reset();
+    finishParallelVisits();
     _renderGroups.clear();
 
-    for (auto&& clearCommand : _callbackCommandsPool)
-        delete clearCommand;
-    _callbackCommandsPool.clear();
-
-    for (auto&& clearCommand : _groupCommandPool)
-        delete clearCommand;
-    _groupCommandPool.clear();
+    // destroy the callback/group commands of the frame
+    _frameArena.reset();
 
     _groupCommandManager->release();
 
     free(_triBatchesToDraw);
 
+    releaseRetainedBatches();
+
+    AX_SAFE_RELEASE(_multiTextureProgramState);
     AX_SAFE_RELEASE(_depthStencilState);
     AX_SAFE_RELEASE(_commandBuffer);
     AX_SAFE_RELEASE(_renderPipeline);
@@ -231,12 +417,20 @@ void Renderer::addCallbackCommand(std::function<void()> func, float globalZOrder
 
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (auto recording = s_parallelVisitQueue)
+    {
+        AXASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+        recording->emplace_back(command);
+        return;
+    }
+
     int renderQueueID = _commandGroupStack.top();
     addCommand(command, renderQueueID);
 }
 
 void Renderer::addCommand(RenderCommand* command, int renderQueueID)
 {
+    AXASSERT(!s_parallelVisitQueue, "A parallel visit can only add commands to the current render queue");
     AXASSERT(!_isRendering, "Cannot add command while rendering");
     AXASSERT(renderQueueID >= 0, "Invalid render queue");
     AXASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
@@ -246,37 +440,137 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
 
 GroupCommand* Renderer::getNextGroupCommand()
 {
-    if (_groupCommandPool.empty())
-    {
-        return new GroupCommand();
-    }
-
-    auto* command = _groupCommandPool.back();
-    _groupCommandPool.pop_back();
-    command->reset();
-
-    return command;
+    AXASSERT(!s_parallelVisitQueue, "A parallel visit can't use group commands");
+    return _frameArena.construct<GroupCommand>();
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
+    AXASSERT(!s_parallelVisitQueue, "A parallel visit can't change render queue");
     AXASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
+    AXASSERT(!s_parallelVisitQueue, "A parallel visit can't change render queue");
     AXASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.pop();
 }
 
+void Renderer::setParallelVisitEnabled(bool enabled)
+{
+    AXASSERT(!_isRendering, "Cannot change the parallel visit while rendering");
+    _parallelVisitEnabled = enabled;
+}
+
+bool Renderer::isParallelVisitThread()
+{
+    return s_parallelVisitQueue != nullptr;
+}
+
+bool Renderer::deferVisit(Node* node, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // the subtrees of a deferred visit are visited by the same job
+    if (!_parallelVisitEnabled || s_parallelVisitQueue || !node->isParallelVisitSafe())
+        return false;
+
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (!jobSystem)
+        return false;
+
+    if (_parallelVisitCount == _parallelVisits.size())
+        _parallelVisits.emplace_back();
+    auto& visit = _parallelVisits[_parallelVisitCount++];
+    if (!visit || visit.use_count() > 1)
+        visit = std::make_shared<ParallelVisit>();
+
+    node->retain();
+    visit->node            = node;
+    visit->parentTransform = parentTransform;
+    visit->parentFlags     = parentFlags;
+    visit->renderQueueID   = _commandGroupStack.top();
+
+    // the recorded commands go where the serial visit would have pushed them
+    auto& renderQueue = _renderGroups[visit->renderQueueID];
+    visit->recorded.clear();
+    visit->recorded.setSortKeyMode(renderQueue.getSortKeyMode());
+    visit->source.queue = &visit->recorded;
+    renderQueue.getPositions(visit->source.positions);
+    visit->state.store(PARALLEL_VISIT_QUEUED, std::memory_order_relaxed);
+
+    jobSystem->run([this, visit]() { runParallelVisit(visit.get()); }, JobPriority::High, &_parallelVisitGroup);
+    return true;
+}
+
+void Renderer::runParallelVisit(ParallelVisit* visit)
+{
+    // claimed already by the render thread, or by a worker
+    int expected = PARALLEL_VISIT_QUEUED;
+    if (!visit->state.compare_exchange_strong(expected, PARALLEL_VISIT_RUNNING, std::memory_order_acquire))
+        return;
+
+    s_parallelVisitQueue = &visit->recorded;
+    visit->node->visit(this, visit->parentTransform, visit->parentFlags);
+    s_parallelVisitQueue = nullptr;
+}
+
+void Renderer::finishParallelVisits()
+{
+    if (_parallelVisitCount == 0)
+        return;
+
+    // The render thread runs the visits no worker picked up yet, so a busy JobSystem never stalls the frame,
+    // then helps with the other jobs until the ones claimed by the workers finished
+    for (size_t i = 0; i < _parallelVisitCount; ++i)
+        runParallelVisit(_parallelVisits[i].get());
+    Director::getInstance()->getJobSystem()->wait(_parallelVisitGroup);
+
+    // merge the recorded commands, grouped by render queue, in the order of the visits
+    for (size_t i = 0; i < _parallelVisitCount; ++i)
+    {
+        auto renderQueueID = _parallelVisits[i]->renderQueueID;
+        if (renderQueueID < 0)
+            continue;
+
+        _mergeSources.clear();
+        for (size_t j = i; j < _parallelVisitCount; ++j)
+        {
+            auto& visit = _parallelVisits[j];
+            if (visit->renderQueueID == renderQueueID)
+            {
+                _mergeSources.emplace_back(visit->source);
+                visit->renderQueueID = -1;
+            }
+        }
+        _renderGroups[renderQueueID].merge(_mergeSources.data(), _mergeSources.size());
+    }
+
+    for (size_t i = 0; i < _parallelVisitCount; ++i)
+    {
+        auto& visit = _parallelVisits[i];
+        visit->node->release();
+        visit->node = nullptr;
+    }
+    _parallelVisitCount = 0;
+}
+
 int Renderer::createRenderQueue()
 {
     RenderQueue newRenderQueue;
+    newRenderQueue.setSortKeyMode(_sortKeyMode);
     _renderGroups.emplace_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::setRenderQueueSortKeyMode(RenderQueue::SortKeyMode mode)
+{
+    AXASSERT(!_isRendering, "Cannot change the sort key mode while rendering");
+    _sortKeyMode = mode;
+    for (auto&& renderQueue : _renderGroups)
+        renderQueue.setSortKeyMode(mode);
+}
+
 void Renderer::processGroupCommand(GroupCommand* command)
 {
     flush();
@@ -333,7 +627,6 @@ void Renderer::processRenderCommand(RenderCommand* command)
         break;
     case RenderCommand::Type::GROUP_COMMAND:
         processGroupCommand(static_cast<GroupCommand*>(command));
-        _groupCommandPool.emplace_back(static_cast<GroupCommand*>(command));
         break;
     case RenderCommand::Type::CUSTOM_COMMAND:
         flush();
@@ -342,7 +635,6 @@ void Renderer::processRenderCommand(RenderCommand* command)
     case RenderCommand::Type::CALLBACK_COMMAND:
         flush();
         static_cast<CallbackCommand*>(command)->execute();
-        _callbackCommandsPool.emplace_back(static_cast<CallbackCommand*>(command));
         break;
     default:
         assert(false);
@@ -405,6 +697,8 @@ void Renderer::doVisitRenderQueue(const std::vector<RenderCommand*>& renderComma
 void Renderer::render()
 {
     // TODO: setup camera or MVP
+    finishParallelVisits();
+
     _isRendering = true;
     //    if (_glViewAssigned)
     {
@@ -422,6 +716,11 @@ void Renderer::render()
 
 bool Renderer::beginFrame()
 {
+    if (_pipelinedRequested != isPipelined())
+        switchPipelined(_pipelinedRequested);
+    if (_deferredCommandBuffer)
+        _deferredCommandBuffer->dispatchReadbacks();
+
     return _commandBuffer->beginFrame();
 }
 
@@ -429,6 +728,17 @@ void Renderer::endFrame()
 {
     _commandBuffer->endFrame();
 
+    if (_deferredCommandBuffer)
+    {
+        // the render thread presents the frame once its commands are executed, instead of Director
+        auto glView = Director::getInstance()->getGLView();
+        _renderThread->submit(_deferredCommandBuffer->closeFrame(), [glView] {
+            if (glView)
+                glView->swapBuffers();
+        });
+        _deferredCommandBuffer->openFrame();
+    }
+
 #ifdef AX_USE_METAL
     _triangleCommandBufferManager.putbackAllBuffers();
     _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
@@ -436,6 +746,7 @@ void Renderer::endFrame()
 #endif
     _queuedTotalIndexCount  = 0;
     _queuedTotalVertexCount = 0;
+    trimRetainedBatches();
 }
 
 void Renderer::clean()
@@ -453,6 +764,10 @@ void Renderer::clean()
 
     // Clear batch commands
     _queuedTriangleCommands.clear();
+
+    // Release the callback/group commands and the frame data of the render queues
+    _frameHeapAllocations += _frameArena.getHeapAllocations();
+    _frameArena.reset();
 }
 
 void Renderer::setDepthTest(bool value)
@@ -588,22 +903,85 @@ void Renderer::setViewPort(int x, int y, unsigned int w, unsigned int h)
     _viewport.height = h;
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset)
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd,
+                                      unsigned int vertexBufferOffset,
+                                      unsigned int filledVertex,
+                                      unsigned int filledIndex,
+                                      unsigned int textureSlot)
 {
-    auto destVertices = &_verts[_filledVertex];
+    auto destVertices = &_verts[filledVertex];
     auto srcVertices = cmd->getVertices();
     auto vertexCount = cmd->getVertexCount();
     auto&& modelView = cmd->getModelView();
     MathUtil::transformVertices(destVertices, srcVertices, vertexCount, modelView);
 
-    auto destIndices = &_indices[_filledIndex];
+    // the multi-texture program decodes the slot as floor(u / 2)
+    if (textureSlot != 0)
+    {
+        const float slotOffset = 2.0f * textureSlot;
+        for (size_t i = 0; i < vertexCount; ++i)
+            destVertices[i].texCoords.u += slotOffset;
+    }
+
+    auto destIndices = &_indices[filledIndex];
     auto srcIndices = cmd->getIndices();
     auto indexCount = cmd->getIndexCount();
-    auto offset = vertexBufferOffset + _filledVertex;
+    auto offset = vertexBufferOffset + filledVertex;
     MathUtil::transformIndices(destIndices, srcIndices, indexCount, int(offset));
+}
+
+void Renderer::queueFillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int textureSlot)
+{
+    _queuedFills.emplace_back(QueuedFill{cmd, _filledVertex, _filledIndex, textureSlot});
+    _filledVertex += static_cast<unsigned int>(cmd->getVertexCount());
+    _filledIndex += static_cast<unsigned int>(cmd->getIndexCount());
+    _queuedFillVertexCount += static_cast<unsigned int>(cmd->getVertexCount());
+}
+
+void Renderer::flushQueuedFills(unsigned int vertexBufferOffset)
+{
+    auto fillRange = [this, vertexBufferOffset](size_t first, size_t last) {
+        for (; first < last; ++first)
+        {
+            auto& fill = _queuedFills[first];
+            fillVerticesAndIndices(fill.cmd, vertexBufferOffset, fill.filledVertex, fill.filledIndex,
+                                   fill.textureSlot);
+        }
+    };
+
+    auto jobSystem = _parallelFillEnabled ? Director::getInstance()->getJobSystem() : nullptr;
+    if (!jobSystem || _queuedFillVertexCount < PARALLEL_FILL_MIN_VERTICES)
+    {
+        fillRange(0, _queuedFills.size());
+    }
+    else
+    {
+        // Split the fills into chunks of about PARALLEL_FILL_CHUNK_VERTICES vertices, the destination offsets are
+        // already known, so every chunk writes its own slice of _verts/_indices without contention.
+        _queuedFillChunks.clear();
+        unsigned int chunkVertices = 0;
+        for (size_t i = 0, count = _queuedFills.size(); i < count; ++i)
+        {
+            chunkVertices += static_cast<unsigned int>(_queuedFills[i].cmd->getVertexCount());
+            if (chunkVertices >= PARALLEL_FILL_CHUNK_VERTICES || i + 1 == count)
+            {
+                _queuedFillChunks.emplace_back(i + 1);
+                chunkVertices = 0;
+            }
+        }
 
-    _filledVertex += vertexCount;
-    _filledIndex += indexCount;
+        // The render thread fills chunks as well, so a busy JobSystem never stalls the frame.
+        jobSystem->parallelFor(
+            0, _queuedFillChunks.size(), 1,
+            [this, &fillRange](size_t begin, size_t end) {
+                for (auto chunk = begin; chunk < end; ++chunk)
+                    fillRange(chunk > 0 ? _queuedFillChunks[chunk - 1] : 0, _queuedFillChunks[chunk]);
+            },
+            JobPriority::High, PARALLEL_FILL_MAX_HELPERS);
+    }
+
+    _queuedFills.clear();
+    _queuedFillVertexCount = 0;
 }
 
 void Renderer::drawBatchedTriangles()
@@ -623,6 +1001,7 @@ void Renderer::drawBatchedTriangles()
     _triBatchesToDraw[0].offset        = indexBufferFillOffset;
     _triBatchesToDraw[0].indicesToDraw = 0;
     _triBatchesToDraw[0].cmd           = nullptr;
+    _triBatchesToDraw[0].textureCount  = 0;
 
     int batchesTotal        = 0;
     uint32_t prevMaterialID = 0;
@@ -631,15 +1010,66 @@ void Renderer::drawBatchedTriangles()
     _filledVertex = 0;
     _filledIndex  = 0;
 
-    for (const auto& cmd : _queuedTriangleCommands)
+    auto vertexBuffer = _vertexBuffer;
+    auto indexBuffer  = _indexBuffer;
+
+    // retained mode: the dirty ranges of the batch buffers, merged when contiguous
+    struct DirtyRange
+    {
+        unsigned int vertexStart, vertexEnd;
+        unsigned int indexStart, indexEnd;
+    };
+    RetainedBatch* retainedBatch =
+        _retainedBatchingEnabled ? nextRetainedBatch(_queuedVertexCount, _queuedIndexCount) : nullptr;
+    std::vector<DirtyRange> dirtyRanges;
+    if (retainedBatch)
     {
+        vertexBuffer = retainedBatch->vertexBuffer;
+        indexBuffer  = retainedBatch->indexBuffer;
+    }
+
+    for (size_t cmdIndex = 0, cmdCount = _queuedTriangleCommands.size(); cmdIndex < cmdCount; ++cmdIndex)
+    {
+        auto cmd               = _queuedTriangleCommands[cmdIndex];
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable   = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd, vertexBufferFillOffset);
+        // in the same batch ? a multi-texture batch is broken as well when its texture slots are full
+        bool sameBatch           = batchable && (prevMaterialID == currentMaterialID || firstCommand);
+        unsigned int textureSlot = 0;
+        if (sameBatch && cmd->isTextureSlotBatchable())
+        {
+            auto slot = acquireTextureSlot(cmd, batchesTotal);
+            if (slot >= 0)
+                textureSlot = static_cast<unsigned int>(slot);
+            else
+                sameBatch = false;
+        }
+
+        if (!retainedBatch)
+            queueFillVerticesAndIndices(cmd, textureSlot);
+        else if (retainCommand(retainedBatch, cmdIndex, cmd, textureSlot))
+        {
+            _filledVertex += cmd->getVertexCount();
+            _filledIndex += cmd->getIndexCount();
+            ++_retainedBatchHits;
+        }
+        else
+        {
+            auto vertexStart = _filledVertex;
+            auto indexStart  = _filledIndex;
+            queueFillVerticesAndIndices(cmd, textureSlot);
+            if (!dirtyRanges.empty() && dirtyRanges.back().vertexEnd == vertexStart)
+            {
+                dirtyRanges.back().vertexEnd = _filledVertex;
+                dirtyRanges.back().indexEnd  = _filledIndex;
+            }
+            else
+                dirtyRanges.emplace_back(DirtyRange{vertexStart, _filledVertex, indexStart, _filledIndex});
+            ++_retainedBatchMisses;
+        }
 
-        // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        if (sameBatch)
         {
             AX_ASSERT((firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID()) &&
                       "argh... error in logic");
@@ -658,6 +1088,9 @@ void Renderer::drawBatchedTriangles()
 
             _triBatchesToDraw[batchesTotal].cmd           = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int)cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].textureCount  = 0;
+            if (cmd->isTextureSlotBatchable())
+                acquireTextureSlot(cmd, batchesTotal);
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
@@ -676,29 +1109,52 @@ void Renderer::drawBatchedTriangles()
         firstCommand   = false;
     }
     batchesTotal++;
+    flushQueuedFills(vertexBufferFillOffset);
+
+    if (retainedBatch)
+    {
+        retainedBatch->entries.resize(_queuedTriangleCommands.size());
+        for (auto&& range : dirtyRanges)
+        {
+            updateBufferSubData(vertexBuffer, &_verts[range.vertexStart], range.vertexStart * sizeof(_verts[0]),
+                                (range.vertexEnd - range.vertexStart) * sizeof(_verts[0]));
+            if (range.indexEnd != range.indexStart)
+                updateBufferSubData(indexBuffer, &_indices[range.indexStart], range.indexStart * sizeof(_indices[0]),
+                                    (range.indexEnd - range.indexStart) * sizeof(_indices[0]));
+        }
+    }
+    else
+    {
 #ifdef AX_USE_METAL
-    _vertexBuffer->updateSubData(_verts, vertexBufferFillOffset * sizeof(_verts[0]), _filledVertex * sizeof(_verts[0]));
-    _indexBuffer->updateSubData(_indices, indexBufferFillOffset * sizeof(_indices[0]),
-                                _filledIndex * sizeof(_indices[0]));
+        updateBufferSubData(_vertexBuffer, _verts, vertexBufferFillOffset * sizeof(_verts[0]),
+                            _filledVertex * sizeof(_verts[0]));
+        updateBufferSubData(_indexBuffer, _indices, indexBufferFillOffset * sizeof(_indices[0]),
+                            _filledIndex * sizeof(_indices[0]));
 #else
-    _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
-    _indexBuffer->updateData(_indices, _filledIndex * sizeof(_indices[0]));
+        updateBufferData(_vertexBuffer, _verts, _filledVertex * sizeof(_verts[0]));
+        updateBufferData(_indexBuffer, _indices, _filledIndex * sizeof(_indices[0]));
 #endif
+    }
 
     /************** 2: Draw *************/
     beginRenderPass();
 
-    _commandBuffer->setVertexBuffer(_vertexBuffer);
-    _commandBuffer->setIndexBuffer(_indexBuffer);
+    _commandBuffer->setVertexBuffer(vertexBuffer);
+    _commandBuffer->setIndexBuffer(indexBuffer);
 
     for (int i = 0; i < batchesTotal; ++i)
     {
         auto& drawInfo = _triBatchesToDraw[i];
-        _commandBuffer->updatePipelineState(_currentRT, drawInfo.cmd->getPipelineDescriptor());
-        auto& pipelineDescriptor = drawInfo.cmd->getPipelineDescriptor();
-        _commandBuffer->setProgramState(pipelineDescriptor.programState);
-        _commandBuffer->drawElements(backend::PrimitiveType::TRIANGLE, backend::IndexFormat::U_SHORT,
-                                     drawInfo.indicesToDraw, drawInfo.offset * sizeof(_indices[0]));
+        if (drawInfo.textureCount > 1)
+            drawMultiTextureBatch(i);
+        else
+        {
+            _commandBuffer->updatePipelineState(_currentRT, drawInfo.cmd->getPipelineDescriptor());
+            auto& pipelineDescriptor = drawInfo.cmd->getPipelineDescriptor();
+            _commandBuffer->setProgramState(pipelineDescriptor.programState);
+            _commandBuffer->drawElements(backend::PrimitiveType::TRIANGLE, backend::IndexFormat::U_SHORT,
+                                         drawInfo.indicesToDraw, drawInfo.offset * sizeof(_indices[0]));
+        }
 
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
@@ -715,6 +1171,205 @@ void Renderer::drawBatchedTriangles()
 #endif
 }
 
+int Renderer::acquireTextureSlot(TrianglesCommand* cmd, int batchIndex)
+{
+    auto& batch  = _triBatchesToDraw[batchIndex];
+    auto texture = cmd->getTexture();
+    for (unsigned int slot = 0; slot < batch.textureCount; ++slot)
+    {
+        if (batch.textures[slot] == texture)
+            return static_cast<int>(slot);
+    }
+
+    if (batch.textureCount == MULTI_TEXTURE_SLOTS)
+        return -1;
+
+    batch.textures[batch.textureCount] = texture;
+    return static_cast<int>(batch.textureCount++);
+}
+
+void Renderer::drawMultiTextureBatch(int batchIndex)
+{
+    auto& drawInfo = _triBatchesToDraw[batchIndex];
+    if (!_multiTextureProgramState)
+    {
+        auto program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR_MULTI);
+        _multiTextureProgramState = new backend::ProgramState(program);
+        _multiTextureMvpLocation  = _multiTextureProgramState->getUniformLocation(backend::Uniform::MVP_MATRIX);
+        for (int slot = 0; slot < MULTI_TEXTURE_SLOTS; ++slot)
+            _multiTextureLocations[slot] = _multiTextureProgramState->getUniformLocation(fmt::format("u_tex{}", slot));
+    }
+
+    // The vertex uniform buffer of the builtin POSITION_TEXTURE_COLOR program only holds the MVP matrix, the unused
+    // slots are bound to the first texture, the backends don't allow a sampler without a texture
+    auto& pipelineDescriptor = drawInfo.cmd->getPipelineDescriptor();
+    std::size_t uniformSize  = 0;
+    auto mvp                 = pipelineDescriptor.programState->getVertexUniformBuffer(uniformSize);
+    AXASSERT(uniformSize >= sizeof(Mat4), "The MVP matrix is missing");
+    _multiTextureProgramState->setUniform(_multiTextureMvpLocation, mvp, sizeof(Mat4));
+    for (unsigned int slot = 0; slot < MULTI_TEXTURE_SLOTS; ++slot)
+        _multiTextureProgramState->setTexture(_multiTextureLocations[slot], slot,
+                                              drawInfo.textures[slot < drawInfo.textureCount ? slot : 0]);
+
+    PipelineDescriptor multiTextureDescriptor;
+    multiTextureDescriptor.programState    = _multiTextureProgramState;
+    multiTextureDescriptor.blendDescriptor = pipelineDescriptor.blendDescriptor;
+
+    _commandBuffer->updatePipelineState(_currentRT, multiTextureDescriptor);
+    _commandBuffer->setProgramState(_multiTextureProgramState);
+    _commandBuffer->drawElements(backend::PrimitiveType::TRIANGLE, backend::IndexFormat::U_SHORT,
+                                 drawInfo.indicesToDraw, drawInfo.offset * sizeof(_indices[0]));
+}
+
+void Renderer::setMultiTextureBatchingEnabled(bool enabled)
+{
+    _multiTextureBatchingEnabled = enabled;
+}
+
+void Renderer::setParallelFillEnabled(bool enabled)
+{
+    _parallelFillEnabled = enabled;
+}
+
+void Renderer::setRetainedBatchingEnabled(bool enabled)
+{
+#ifdef AX_USE_METAL
+    // the triangle buffers are rotated between in-flight frames, can't keep their content across frames
+    enabled = false;
+#endif
+    if (_retainedBatchingEnabled == enabled)
+        return;
+
+    _retainedBatchingEnabled = enabled;
+    releaseRetainedBatches();
+}
+
+void Renderer::invalidateRetainedBatches()
+{
+    for (auto&& batch : _retainedBatches)
+    {
+        batch.entries.clear();
+        batch.allocated = false;
+    }
+}
+
+static unsigned int retainedBatchCapacity(unsigned int count, unsigned int minCapacity, unsigned int maxCapacity)
+{
+    auto capacity = minCapacity;
+    while (capacity < count && capacity < maxCapacity)
+        capacity *= 2;
+    return std::min(capacity, maxCapacity);
+}
+
+Renderer::RetainedBatch* Renderer::nextRetainedBatch(unsigned int vertexCount, unsigned int indexCount)
+{
+    if (_retainedBatchIndex >= RETAINED_BATCH_MAX)
+        return nullptr;
+
+    if (_retainedBatchIndex >= _retainedBatches.size())
+        _retainedBatches.emplace_back();
+
+    auto batch        = &_retainedBatches[_retainedBatchIndex++];
+    batch->idleFrames = 0;
+
+    // size the buffers to the content of the flush, recreate them when it outgrows them or shrinks a lot
+    auto vertexSize = retainedBatchCapacity(vertexCount, RETAINED_BATCH_MIN_VERTICES, VBO_SIZE) * sizeof(_verts[0]);
+    auto indexSize  = retainedBatchCapacity(indexCount, RETAINED_BATCH_MIN_VERTICES * 6 / 4, INDEX_VBO_SIZE) *
+                     sizeof(_indices[0]);
+    if (!batch->vertexBuffer || batch->vertexBuffer->getSize() < vertexCount * sizeof(_verts[0]) ||
+        batch->vertexBuffer->getSize() > vertexSize * 4 ||
+        batch->indexBuffer->getSize() < indexCount * sizeof(_indices[0]) ||
+        batch->indexBuffer->getSize() > indexSize * 4)
+    {
+        auto driver = backend::DriverBase::getInstance();
+
+        AX_SAFE_RELEASE(batch->vertexBuffer);
+        AX_SAFE_RELEASE(batch->indexBuffer);
+        batch->vertexBuffer = driver->newBuffer(vertexSize, backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
+        batch->indexBuffer  = driver->newBuffer(indexSize, backend::BufferType::INDEX, backend::BufferUsage::DYNAMIC);
+        batch->allocated    = false;
+    }
+
+    if (!batch->allocated)
+    {
+        // allocate the whole data store, the dirty ranges are uploaded with updateSubData
+        updateBufferData(batch->vertexBuffer, nullptr, batch->vertexBuffer->getSize());
+        updateBufferData(batch->indexBuffer, nullptr, batch->indexBuffer->getSize());
+        batch->entries.clear();
+        batch->allocated = true;
+    }
+    return batch;
+}
+
+bool Renderer::retainCommand(RetainedBatch* batch,
+                             size_t index,
+                             const TrianglesCommand* cmd,
+                             unsigned int textureSlot)
+{
+    auto vertexCount = static_cast<unsigned int>(cmd->getVertexCount());
+    auto indexCount  = static_cast<unsigned int>(cmd->getIndexCount());
+
+    // the vertex and index data may be modified in place by the owner, compare the data version it gives,
+    // or the content hash without one
+    auto dataVersion  = cmd->getDataVersion();
+    uint64_t dataHash = 0;
+    if (dataVersion == 0)
+    {
+        dataHash = XXH3_64bits(cmd->getVertices(), vertexCount * sizeof(V3F_C4B_T2F));
+        dataHash = XXH3_64bits_withSeed(cmd->getIndices(), indexCount * sizeof(unsigned short), dataHash);
+    }
+
+    if (index >= batch->entries.size())
+        batch->entries.resize(index + 1);
+
+    auto& entry = batch->entries[index];
+    if (entry.cmd == cmd && entry.verts == cmd->getVertices() && entry.vertexOffset == _filledVertex &&
+        entry.indexOffset == _filledIndex && entry.vertexCount == vertexCount && entry.indexCount == indexCount &&
+        entry.materialID == cmd->getMaterialID() && entry.textureSlot == textureSlot &&
+        entry.dataVersion == dataVersion && entry.dataHash == dataHash &&
+        memcmp(entry.modelView.m, cmd->getModelView().m, sizeof(entry.modelView.m)) == 0)
+        return true;
+
+    entry.cmd          = cmd;
+    entry.verts        = cmd->getVertices();
+    entry.dataHash     = dataHash;
+    entry.dataVersion  = dataVersion;
+    entry.materialID   = cmd->getMaterialID();
+    entry.vertexOffset = _filledVertex;
+    entry.indexOffset  = _filledIndex;
+    entry.vertexCount  = vertexCount;
+    entry.indexCount   = indexCount;
+    entry.textureSlot  = textureSlot;
+    entry.modelView    = cmd->getModelView();
+    return false;
+}
+
+void Renderer::trimRetainedBatches()
+{
+    // the batches are indexed by the flush order, the ones unused in this frame are the last ones
+    for (size_t i = _retainedBatchIndex, count = _retainedBatches.size(); i < count; ++i)
+        ++_retainedBatches[i].idleFrames;
+
+    while (!_retainedBatches.empty() && _retainedBatches.back().idleFrames > RETAINED_BATCH_MAX_IDLE_FRAMES)
+    {
+        AX_SAFE_RELEASE(_retainedBatches.back().vertexBuffer);
+        AX_SAFE_RELEASE(_retainedBatches.back().indexBuffer);
+        _retainedBatches.pop_back();
+    }
+    _retainedBatchIndex = 0;
+}
+
+void Renderer::releaseRetainedBatches()
+{
+    for (auto&& batch : _retainedBatches)
+    {
+        AX_SAFE_RELEASE(batch.vertexBuffer);
+        AX_SAFE_RELEASE(batch.indexBuffer);
+    }
+    _retainedBatches.clear();
+    _retainedBatchIndex = 0;
+}
+
 void Renderer::drawCustomCommand(RenderCommand* command)
 {
     auto cmd = static_cast<CustomCommand*>(command);
@@ -831,6 +1486,70 @@ void Renderer::readPixels(backend::RenderTarget* rt,
     _commandBuffer->readPixels(rt, std::move(callback));
 }
 
+void Renderer::setPipelined(bool pipelined)
+{
+#if AX_ENABLE_RENDER_THREAD
+    if (pipelined && !backend::DriverBase::getInstance()->supportsRenderThread())
+    {
+        AXLOGW("Renderer: the {} driver can't execute frames on a render thread, the renderer stays serial",
+               backend::DriverBase::getInstance()->getRenderer());
+        pipelined = false;
+    }
+#else
+    if (pipelined)
+    {
+        AXLOGW("Renderer: the pipelined mode requires AX_ENABLE_RENDER_THREAD, the renderer stays serial");
+        pipelined = false;
+    }
+#endif
+    _pipelinedRequested = pipelined;
+}
+
+void Renderer::switchPipelined(bool pipelined)
+{
+    if (pipelined)
+    {
+        _deferredCommandBuffer = new backend::DeferredCommandBuffer(_commandBuffer);
+        _commandBuffer->release();
+        _commandBuffer = _deferredCommandBuffer;
+        _renderThread  = std::make_unique<RenderThread>(_deferredCommandBuffer);
+    }
+    else
+    {
+        _renderThread.reset();
+        _deferredCommandBuffer->dispatchReadbacks();
+
+        _commandBuffer = _deferredCommandBuffer->getTarget();
+        _commandBuffer->retain();
+        AX_SAFE_RELEASE_NULL(_deferredCommandBuffer);
+    }
+}
+
+void Renderer::waitForRenderThread()
+{
+    if (!_deferredCommandBuffer)
+        return;
+
+    _renderThread->wait();
+    _deferredCommandBuffer->dispatchReadbacks();
+}
+
+void Renderer::updateBufferData(backend::Buffer* buffer, const void* data, std::size_t size)
+{
+    if (_deferredCommandBuffer)
+        _deferredCommandBuffer->updateBuffer(buffer, data, 0, size, true);
+    else
+        buffer->updateData(data, size);
+}
+
+void Renderer::updateBufferSubData(backend::Buffer* buffer, const void* data, std::size_t offset, std::size_t size)
+{
+    if (_deferredCommandBuffer)
+        _deferredCommandBuffer->updateBuffer(buffer, data, offset, size, false);
+    else
+        buffer->updateSubData(data, offset, size);
+}
+
 void Renderer::beginRenderPass()
 {
     _commandBuffer->beginRenderPass(_currentRT, _renderPassDesc);
@@ -893,15 +1612,10 @@ void Renderer::clear(ClearFlag flags, const Color4F& color, float depth, unsigne
 
 CallbackCommand* Renderer::nextCallbackCommand()
 {
-    CallbackCommand* cmd = nullptr;
-    if (!_callbackCommandsPool.empty())
-    {
-        cmd = _callbackCommandsPool.back();
-        cmd->reset();
-        _callbackCommandsPool.pop_back();
-    }
-    else
-        cmd = new CallbackCommand();
+    AXASSERT(!s_parallelVisitQueue, "A parallel visit can't use callback commands");
+    // CallbackCommand can only be constructed by the renderer
+    auto cmd = new (_frameArena.allocate(sizeof(CallbackCommand), alignof(CallbackCommand))) CallbackCommand();
+    _frameArena.addFinalizer([](void* p) { static_cast<CallbackCommand*>(p)->~CallbackCommand(); }, cmd);
     return cmd;
 }
 
@@ -30,11 +30,15 @@
 #include <array>
 #include <deque>
 #include <optional>
+#include <atomic>
+#include <memory>
 
 #include "platform/PlatformMacros.h"
 #include "renderer/RenderCommand.h"
+#include "renderer/FrameArena.h"
 #include "renderer/backend/Types.h"
 #include "renderer/backend/ProgramManager.h"
+#include "base/JobSystem.h"
 
 /**
  * @addtogroup renderer
@@ -51,6 +55,7 @@ namespace backend
 {
 class Buffer;
 class CommandBuffer;
+class DeferredCommandBuffer;
 class RenderPipeline;
 class RenderPass;
 class TextureBackend;
@@ -59,10 +64,12 @@ struct PixelBufferDescriptor;
 }  // namespace backend
 
 class EventListenerCustom;
+class Node;
 class TrianglesCommand;
 class MeshCommand;
 class GroupCommand;
 class CallbackCommand;
+class RenderThread;
 struct PipelineDescriptor;
 class Texture2D;
 
@@ -70,6 +77,9 @@ class Texture2D;
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+ Every command gets a packed 64-bit sort key when it's pushed, the queue is then
+ ordered with a stable LSD radix sort over (key, command) pairs, so the sort never
+ dereferences the commands.
 */
 class RenderQueue
 {
@@ -92,6 +102,33 @@ public:
         QUEUE_COUNT = 5,
     };
 
+    /**
+    How the sort keys of the 2D queue groups are built.
+    */
+    enum class SortKeyMode
+    {
+        /**Queue group, globalZ and insertion sequence: same order as submitted for equal globalZ.*/
+        DEFAULT,
+        /**Queue group, globalZ and material ID: the TrianglesCommands with equal globalZ are grouped by material
+         so that more of them batch, any other command type is kept in place and acts as a barrier.
+         Note: it can change the draw order of overlapping TrianglesCommands with equal globalZ.*/
+        MATERIAL,
+    };
+
+    /** The item sorted by the render queue. */
+    struct SortItem
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+
+    /** The commands recorded into another queue, and where they go in each sub queue of this one. */
+    struct MergeSource
+    {
+        const RenderQueue* queue = nullptr;
+        size_t positions[QUEUE_COUNT] = {};
+    };
+
 public:
     /**Constructor.*/
     RenderQueue();
@@ -111,10 +148,38 @@ public:
     std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
     ssize_t getSubQueueSize(QUEUE_GROUP group) const { return _commands[group].size(); }
+    /**Set the sort key mode, takes effect for the commands pushed afterwards.*/
+    void setSortKeyMode(SortKeyMode mode) { _sortKeyMode = mode; }
+    /**Get the sort key mode.*/
+    SortKeyMode getSortKeyMode() const { return _sortKeyMode; }
+
+    /**Get the current position of each sub queue, i.e. where the next pushed commands go.*/
+    void getPositions(size_t positions[QUEUE_COUNT]) const;
+    /**Insert the commands of the sources at their positions, the sources must be ordered by position.
+     The sort keys of the merged sub queues are rebuilt, so the result is the same as if the commands
+     had been pushed in that order.*/
+    void merge(const MergeSource* sources, size_t count);
+
+    /**Stable LSD radix sort of the items by key, scratch must hold count items.*/
+    static void radixSort(SortItem* items, SortItem* scratch, size_t count);
 
 protected:
+    uint64_t makeSortKey(RenderCommand* command, QUEUE_GROUP group, size_t sequence);
+    void sortSubQueue(QUEUE_GROUP group);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**The sort keys of the commands, built when they're pushed.*/
+    std::vector<uint64_t> _keys[QUEUE_COUNT];
+    /**The barrier segment of each queue group in MATERIAL sort key mode.*/
+    uint32_t _segments[QUEUE_COUNT] = {};
+    /**The scratch buffers of the radix sort.*/
+    std::vector<SortItem> _sortItems;
+    std::vector<SortItem> _sortScratch;
+    /**The scratch buffer of merge.*/
+    std::vector<RenderCommand*> _mergeScratch;
+
+    SortKeyMode _sortKeyMode = SortKeyMode::DEFAULT;
 
     /**Cull state.*/
     bool _isCullEnabled;
@@ -141,6 +206,14 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The min number of vertices of a batch to split its vertex fill across the JobSystem.*/
+    static const int PARALLEL_FILL_MIN_VERTICES = 8192;
+    /**The number of vertices filled by one job of the parallel vertex fill.*/
+    static const int PARALLEL_FILL_CHUNK_VERTICES = 2048;
+    /**The max number of JobSystem workers helping the render thread in the parallel vertex fill.*/
+    static const int PARALLEL_FILL_MAX_HELPERS = 7;
+    /**The number of textures bound at once by a multi-texture batch.*/
+    static const int MULTI_TEXTURE_SLOTS = 8;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -151,13 +224,32 @@ public:
 
     void addCallbackCommand(std::function<void()> func, float globalZOrder = 0.0f);
 
+    /** Adds a callback command, the closure is placed into the frame arena instead of the heap */
+    template <typename _Fty>
+    void addCallbackCommand(_Fty&& func, float globalZOrder = 0.0f)
+    {
+        auto closure = _frameArena.construct<std::decay_t<_Fty>>(std::forward<_Fty>(func));
+        // a lambda capturing one pointer fits in the small buffer of std::function
+        addCallbackCommand(std::function<void()>{[closure]() { (*closure)(); }}, globalZOrder);
+    }
+
+    /**
+     * Allocates memory which is valid until the end of the current render pass of the frame, e.g. for uniform blobs
+     * referenced by the queued commands. It's released all at once by `clean()`.
+     */
+    void* allocateFrameData(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        AXASSERT(!isParallelVisitThread(), "The frame arena can't be used by a parallel visit");
+        return _frameArena.allocate(size, alignment);
+    }
+
     /** Adds a `RenderComamnd` into the renderer */
     void addCommand(RenderCommand* command);
 
     /** Adds a `RenderComamnd` into the renderer specifying a particular render queue ID */
     void addCommand(RenderCommand* command, int renderQueueID);
 
-    /** Get a `GroupCommand` from a GroupCommand pool or creates a new command if the pool is empty */
+    /** Get a `GroupCommand` from the frame arena, it's released by `clean()` after rendering */
     GroupCommand* getNextGroupCommand();
 
     /** Pushes a group into the render queue */
@@ -169,6 +261,12 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Sets the sort key mode of all the render queues, @see RenderQueue::SortKeyMode */
+    void setRenderQueueSortKeyMode(RenderQueue::SortKeyMode mode);
+
+    /** Gets the sort key mode of the render queues */
+    RenderQueue::SortKeyMode getRenderQueueSortKeyMode() const { return _sortKeyMode; }
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -183,8 +281,78 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of TrianglesCommand reused from the retained batches in the last frame */
+    ssize_t getRetainedBatchHits() const { return _retainedBatchHits; }
+    /* returns the number of TrianglesCommand refilled into the retained batches in the last frame */
+    ssize_t getRetainedBatchMisses() const { return _retainedBatchMisses; }
+    /* returns the number of heap allocations made by the frame arena in the last frame, 0 in a steady state */
+    ssize_t getFrameHeapAllocations() const { return _frameHeapAllocations; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats()
+    {
+        _drawnBatches = _drawnVertices = _retainedBatchHits = _retainedBatchMisses = _frameHeapAllocations = 0;
+    }
+
+    /**
+     * Enable/disable the retained batch mode of TrianglesCommand.
+     * When enabled, every batch flush of a frame keeps its own vertex and index buffer across frames, the commands
+     * which didn't change since the previous frame (same material id, model-view and vertex/index data) are not
+     * transformed again, only the dirty ranges are refilled and uploaded with `updateSubData`.
+     * It's useful for scenes with lots of static sprites, e.g. UI.
+     * @note Not supported by the metal backend, which rotates the buffers between in-flight frames.
+     */
+    void setRetainedBatchingEnabled(bool enabled);
+
+    /** Whether the retained batch mode of TrianglesCommand is enabled. */
+    bool isRetainedBatchingEnabled() const { return _retainedBatchingEnabled; }
+
+    /** Drops the retained batches content, all the commands will be refilled in the next frame. */
+    void invalidateRetainedBatches();
+
+    /**
+     * Enable/disable the parallel vertex fill of TrianglesCommand.
+     * When enabled, the vertex transform and index fill of batches bigger than PARALLEL_FILL_MIN_VERTICES
+     * are split across the JobSystem workers, the render thread fills chunks as well.
+     */
+    void setParallelFillEnabled(bool enabled);
+
+    /** Whether the parallel vertex fill of TrianglesCommand is enabled. */
+    bool isParallelFillEnabled() const { return _parallelFillEnabled; }
+
+    /**
+     * Enable/disable the multi-texture batching of TrianglesCommand.
+     * When enabled, the commands using the builtin POSITION_TEXTURE_COLOR program don't break the batch on a texture
+     * change: up to MULTI_TEXTURE_SLOTS textures are bound at once, and a batch with several textures is drawn with
+     * the POSITION_TEXTURE_COLOR_MULTI program, which reads the texture slot of a vertex from its texture coordinates.
+     * It's useful for scenes mixing sprites of several atlases at the same z order.
+     * @note The textures with a repeat wrap mode are excluded, their texture coordinates may exceed [0, 1].
+     */
+    void setMultiTextureBatchingEnabled(bool enabled);
+
+    /** Whether the multi-texture batching of TrianglesCommand is enabled. */
+    bool isMultiTextureBatchingEnabled() const { return _multiTextureBatchingEnabled; }
+
+    /**
+     * Enable/disable the parallel visit of the scene graph.
+     * When enabled, the children flagged with `Node::setParallelVisitSafe` are visited by the JobSystem workers while
+     * the render thread goes on with their siblings. Every deferred subtree records its commands into its own render
+     * queue, which is merged back at the position of the subtree before sorting, so the draw order is the same as
+     * with a serial visit.
+     */
+    void setParallelVisitEnabled(bool enabled);
+
+    /** Whether the parallel visit of the scene graph is enabled. */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Called by the parents instead of `Node::visit` for the children flagged parallel visit safe: queues the visit
+     * of the child on the JobSystem.
+     * @return false if the visit wasn't deferred, the caller must visit the child itself then.
+     */
+    bool deferVisit(Node* node, const Mat4& parentTransform, uint32_t parentFlags);
+
+    /** Whether the calling thread is running a visit deferred by `deferVisit`. */
+    static bool isParallelVisitThread();
 
     /**
      Set render targets. If not set, will use default render targets. It will effect all commands.
@@ -415,6 +583,28 @@ public:
     /** read pixels from RenderTarget or screen framebuffer */
     void readPixels(backend::RenderTarget* rt, std::function<void(const backend::PixelBufferDescriptor&)> callback);
 
+    /**
+     * Enable or disable the pipelined mode, disabled by default, it takes effect at the next frame. The backend
+     * commands of a frame are recorded with snapshots of their uniforms and of the batched vertices, then the render
+     * thread executes them and presents the frame while the main thread updates and visits the next one.
+     * Requires AX_ENABLE_RENDER_THREAD and a driver which supports it, the renderer stays serial otherwise.
+     * While pipelined, nodes must update their buffers with updateBufferData/updateBufferSubData, the readPixels
+     * callbacks are invoked once the render thread executed the frame.
+     * @see backend::DriverBase::supportsRenderThread
+     */
+    void setPipelined(bool pipelined);
+    bool isPipelined() const { return _deferredCommandBuffer != nullptr; }
+
+    /**
+     * The sync point of the pipelined mode: wait until the render thread executed the last ended frame, then invoke
+     * the callbacks of its readPixels. Returns immediately when the renderer is serial.
+     */
+    void waitForRenderThread();
+
+    /** Update a buffer, recorded into the frame when the renderer is pipelined. */
+    void updateBufferData(backend::Buffer* buffer, const void* data, std::size_t size);
+    void updateBufferSubData(backend::Buffer* buffer, const void* data, std::size_t offset, std::size_t size);
+
     void beginRenderPass();  /// Begin a render pass.
     void endRenderPass();
 
@@ -470,6 +660,8 @@ protected:
 
     bool beginFrame();  /// Indicate the begining of a frame
     void endFrame();    /// Finish a frame.
+    /// Switch between the serial and the pipelined mode, between two frames
+    void switchPipelined(bool pipelined);
 
     /// Draw the previews queued triangles and flush previous context
     void flush();
@@ -485,7 +677,77 @@ protected:
     void visitRenderQueue(RenderQueue& queue);
     void doVisitRenderQueue(const std::vector<RenderCommand*>&);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset);
+    void fillVerticesAndIndices(const TrianglesCommand* cmd,
+                                unsigned int vertexBufferOffset,
+                                unsigned int filledVertex,
+                                unsigned int filledIndex,
+                                unsigned int textureSlot);
+
+    /// Reserve the destination of a command in _verts/_indices, the fill happens in flushQueuedFills
+    void queueFillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int textureSlot);
+    void flushQueuedFills(unsigned int vertexBufferOffset);
+
+    /// Gets the texture slot of a command in the current multi-texture batch, -1 when the slots are full
+    int acquireTextureSlot(TrianglesCommand* cmd, int batchIndex);
+    /// Draws a batch using several textures with the multi-texture program
+    void drawMultiTextureBatch(int batchIndex);
+
+    struct QueuedFill
+    {
+        const TrianglesCommand* cmd = nullptr;
+        unsigned int filledVertex   = 0;
+        unsigned int filledIndex    = 0;
+        unsigned int textureSlot    = 0;
+    };
+
+    // Retained batch entry, describes the content of a command filled in the retained buffers
+    struct RetainedBatchEntry
+    {
+        const TrianglesCommand* cmd = nullptr;
+        const V3F_C4B_T2F* verts    = nullptr;
+        uint64_t dataHash           = 0;
+        uint32_t dataVersion        = 0;
+        uint32_t materialID         = 0;
+        unsigned int vertexOffset   = 0;
+        unsigned int indexOffset    = 0;
+        unsigned int vertexCount    = 0;
+        unsigned int indexCount     = 0;
+        unsigned int textureSlot    = 0;
+        Mat4 modelView;
+    };
+
+    // The vertex/index buffers owned by one batch flush of a frame in retained mode
+    struct RetainedBatch
+    {
+        backend::Buffer* vertexBuffer = nullptr;
+        backend::Buffer* indexBuffer  = nullptr;
+        bool allocated                = false;
+        unsigned int idleFrames       = 0;
+        std::vector<RetainedBatchEntry> entries;
+    };
+
+    // A subtree visited by a JobSystem worker, and the queue it records its commands into
+    struct ParallelVisit
+    {
+        Node* node           = nullptr;
+        uint32_t parentFlags = 0;
+        int renderQueueID    = 0;
+        Mat4 parentTransform;
+        RenderQueue recorded;
+        RenderQueue::MergeSource source;
+        std::atomic<int> state{0};
+    };
+
+    void runParallelVisit(ParallelVisit* visit);
+    /// Wait for the deferred visits, and merge their commands into the render queues
+    void finishParallelVisits();
+
+    /// Returns the buffers of the next batch flush sized for its content, nullptr when the retained batches are full
+    RetainedBatch* nextRetainedBatch(unsigned int vertexCount, unsigned int indexCount);
+    bool retainCommand(RetainedBatch* batch, size_t index, const TrianglesCommand* cmd, unsigned int textureSlot);
+    /// Releases the retained batches unused for RETAINED_BATCH_MAX_IDLE_FRAMES frames
+    void trimRetainedBatches();
+    void releaseRetainedBatches();
 
     void pushStateBlock();
 
@@ -500,13 +762,12 @@ protected:
     std::stack<int> _commandGroupStack;
 
     std::vector<RenderQueue> _renderGroups;
+    RenderQueue::SortKeyMode _sortKeyMode = RenderQueue::SortKeyMode::DEFAULT;
 
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
-    // the pool for callback commands
-    std::vector<CallbackCommand*> _callbackCommandsPool;
-
-    std::vector<GroupCommand*> _groupCommandPool;
+    // the per-frame allocations: callback/group commands, callback closures and frame data
+    FrameArena _frameArena;
 
     // for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
@@ -518,6 +779,11 @@ protected:
     backend::CommandBuffer* _commandBuffer = nullptr;
     backend::RenderPassDescriptor _renderPassDesc;
 
+    // the pipelined mode, _commandBuffer is the deferred command buffer and the render thread executes its frames
+    backend::DeferredCommandBuffer* _deferredCommandBuffer = nullptr;
+    std::unique_ptr<RenderThread> _renderThread;
+    bool _pipelinedRequested = false;
+
     backend::DepthStencilState* _depthStencilState = nullptr;
     backend::DepthStencilDescriptor _dsDesc;
 
@@ -527,6 +793,8 @@ protected:
         TrianglesCommand* cmd      = nullptr;  // needed for the Material
         unsigned int indicesToDraw = 0;
         unsigned int offset        = 0;
+        unsigned int textureCount  = 0;        // the textures of a multi-texture batch, indexed by slot
+        backend::TextureBackend* textures[MULTI_TEXTURE_SLOTS];
     };
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity = 500;
@@ -540,9 +808,36 @@ protected:
     unsigned int _filledIndex            = 0;
     unsigned int _filledVertex           = 0;
 
+    // the pending fills of the current batch, and the end of each parallel fill chunk
+    std::vector<QueuedFill> _queuedFills;
+    std::vector<size_t> _queuedFillChunks;
+    unsigned int _queuedFillVertexCount = 0;
+    bool _parallelFillEnabled           = false;
+
+    // the deferred visits of the current render pass, a visit still referenced by a late job isn't reused
+    std::vector<std::shared_ptr<ParallelVisit>> _parallelVisits;
+    std::vector<RenderQueue::MergeSource> _mergeSources;
+    JobGroup _parallelVisitGroup;
+    size_t _parallelVisitCount = 0;
+    bool _parallelVisitEnabled = false;
+
+    // retained batches, indexed by the batch flush order of the frame
+    std::vector<RetainedBatch> _retainedBatches;
+    size_t _retainedBatchIndex    = 0;
+    bool _retainedBatchingEnabled = false;
+
+    // the program state drawing the batches with several textures, its uniforms are set before every draw
+    backend::ProgramState* _multiTextureProgramState = nullptr;
+    backend::UniformLocation _multiTextureMvpLocation;
+    backend::UniformLocation _multiTextureLocations[MULTI_TEXTURE_SLOTS];
+    bool _multiTextureBatchingEnabled = false;
+
     // stats
-    size_t _drawnBatches  = 0;
-    size_t _drawnVertices = 0;
+    size_t _drawnBatches        = 0;
+    size_t _drawnVertices       = 0;
+    size_t _retainedBatchHits   = 0;
+    size_t _retainedBatchMisses = 0;
+    size_t _frameHeapAllocations = 0;
     // the flag for checking whether renderer is rendering
     bool _isRendering      = false;
     bool _isDepthTestFor2D = false;
@@ -77,6 +77,9 @@ AX_DLL const std::string_view positionNormalTexture_vert           = "positionNo
 AX_DLL const std::string_view skinPositionNormalTexture_vert       = "skinPositionNormalTexture_vs"sv;
 AX_DLL const std::string_view positionTexture3D_vert               = "positionTexture3D_vs"sv;
 AX_DLL const std::string_view positionTextureInstance_vert         = "positionTextureInstance_vs"sv;
+AX_DLL const std::string_view positionTextureColorInstance_vert    = "positionTextureColorInstance_vs"sv;
+AX_DLL const std::string_view positionTextureColorMulti_vert       = "positionTextureColorMulti_vs"sv;
+AX_DLL const std::string_view positionTextureColorMulti_frag       = "positionTextureColorMulti_fs"sv;
 AX_DLL const std::string_view skinPositionTexture_vert             = "skinPositionTexture_vs"sv;
 AX_DLL const std::string_view skybox_frag                          = "skybox_fs"sv;
 AX_DLL const std::string_view skybox_vert                          = "skybox_vs"sv;
@@ -91,6 +91,9 @@ extern AX_DLL const std::string_view positionNormalTexture_vert;
 extern AX_DLL const std::string_view skinPositionNormalTexture_vert;
 extern AX_DLL const std::string_view positionTexture3D_vert;
 extern AX_DLL const std::string_view positionTextureInstance_vert;
+extern AX_DLL const std::string_view positionTextureColorInstance_vert;
+extern AX_DLL const std::string_view positionTextureColorMulti_vert;
+extern AX_DLL const std::string_view positionTextureColorMulti_frag;
 extern AX_DLL const std::string_view skinPositionTexture_vert;
 extern AX_DLL const std::string_view skybox_frag;
 extern AX_DLL const std::string_view skybox_vert;
@@ -732,6 +732,11 @@ void Texture2D::setTexParameters(const Texture2D::TexParams& desc)
     _texture->updateSamplerDescriptor(desc);
 }
 
+bool Texture2D::isRepeatWrapped() const
+{
+    return _texture && _texture->isRepeatWrapped();
+}
+
 void Texture2D::generateMipmap()
 {
     AXASSERT(_pixelsWide == utils::nextPOT(_pixelsWide) && _pixelsHigh == utils::nextPOT(_pixelsHigh),
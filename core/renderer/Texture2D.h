@@ -295,6 +295,9 @@ public:
 
     void setTexParameters(const TexParams& params);
 
+    /** Whether the sampler of the backend texture wraps with a repeat or mirrored repeat address mode. */
+    bool isRepeatWrapped() const;
+
     /** Generates mipmap images for the texture.
      It only works if the texture size is POT (power of 2).
      @since v0.99.0
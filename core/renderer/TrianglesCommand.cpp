@@ -27,11 +27,27 @@
 #include "xxhash.h"
 #include "renderer/Renderer.h"
 #include "renderer/Texture2D.h"
+#include "renderer/backend/ProgramState.h"
+#include "base/Director.h"
 #include "base//Utils.h"
 
+#include <atomic>
+
 namespace ax
 {
 
+// whether the texture coordinates can carry the texture slot, which is added to u at fill time
+static bool isUnitTexCoords(const V3F_C4B_T2F* verts, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const auto& texCoords = verts[i].texCoords;
+        if (!(texCoords.u >= 0.0f && texCoords.u <= 1.0f && texCoords.v >= 0.0f && texCoords.v <= 1.0f))
+            return false;
+    }
+    return true;
+}
+
 TrianglesCommand::TrianglesCommand()
 {
     _type = RenderCommand::Type::TRIANGLES_COMMAND;
@@ -53,14 +69,27 @@ void TrianglesCommand::init(float globalOrder,
         _triangles.indexCount = count / 3 * 3;
         AXLOGE("Resize indexCount from {} to {}, size must be multiple times of 3", count, _triangles.indexCount);
     }
-    _mv = mv;
-
-    auto batchId = _pipelineDescriptor.programState->getBatchId();
-    if (_batchId != batchId || _texture != texture->getBackendTexture() || _blendType != blendType)
+    _mv          = mv;
+    _dataVersion = 0;
+
+    auto programState = _pipelineDescriptor.programState;
+    auto batchId      = programState->getBatchId();
+
+    // Only the builtin sprite program with its default uniforms has a multi-texture variant, and the slot is
+    // encoded in the texture coordinates, which must stay in [0, 1] and not wrap
+    bool slotBatchable = false;
+    if (programState->getProgram()->getProgramType() == backend::ProgramType::POSITION_TEXTURE_COLOR &&
+        batchId == backend::ProgramType::POSITION_TEXTURE_COLOR && !texture->isRepeatWrapped() &&
+        Director::getInstance()->getRenderer()->isMultiTextureBatchingEnabled())
+        slotBatchable = isUnitTexCoords(_triangles.verts, _triangles.vertCount);
+
+    if (_batchId != batchId || _texture != texture->getBackendTexture() || _blendType != blendType ||
+        _textureSlotBatchable != slotBatchable)
     {
-        _batchId   = batchId;
-        _texture   = texture->getBackendTexture();
-        _blendType = blendType;
+        _batchId              = batchId;
+        _texture              = texture->getBackendTexture();
+        _blendType            = blendType;
+        _textureSlotBatchable = slotBatchable;
 
         // TODO: minggo set it in Node?
         auto& blendDescriptor                = _pipelineDescriptor.blendDescriptor;
@@ -84,12 +113,24 @@ void TrianglesCommand::updateMaterialID()
 
 TrianglesCommand::~TrianglesCommand() {}
 
+uint32_t TrianglesCommand::nextDataVersion()
+{
+    // sprites may be modified by the parallel visits
+    static std::atomic<uint32_t> lastVersion{0};
+    uint32_t version;
+    do
+        version = lastVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+    while (version == 0);
+    return version;
+}
+
 void TrianglesCommand::generateMaterialID()
 {
     struct
     {
         void* texture;
         uint64_t batchId;
+        bool textureSlotBatchable;
         backend::BlendFactor src;
         backend::BlendFactor dst;
     } hashMe;
@@ -99,11 +140,13 @@ void TrianglesCommand::generateMaterialID()
     // are set to random values by different compilers.
     memset(&hashMe, 0, sizeof(hashMe));
 
-    hashMe.texture = _texture;
-    hashMe.src     = _blendType.src;
-    hashMe.dst     = _blendType.dst;
-    hashMe.batchId = _batchId;
-    _materialID    = XXH32((const void*)&hashMe, sizeof(hashMe), 0);
+    // commands sharing a multi-texture batch differ by texture, the renderer assigns them a texture slot
+    hashMe.texture              = _textureSlotBatchable ? nullptr : _texture;
+    hashMe.src                  = _blendType.src;
+    hashMe.dst                  = _blendType.dst;
+    hashMe.batchId              = _batchId;
+    hashMe.textureSlotBatchable = _textureSlotBatchable;
+    _materialID                 = XXH32((const void*)&hashMe, sizeof(hashMe), 0);
 }
 
 }
@@ -103,6 +103,21 @@ public:
     const unsigned short* getIndices() const { return _triangles.indices; }
     /**Get the model view matrix.*/
     const Mat4& getModelView() const { return _mv; }
+    /**Get the backend texture used in rendering.*/
+    backend::TextureBackend* getTexture() const { return _texture; }
+    /**Whether the command can share a multi-texture batch, its material id doesn't depend on the texture then.*/
+    bool isTextureSlotBatchable() const { return _textureSlotBatchable; }
+
+    /**
+     * Sets the version of the vertex and index data, the retained batches of the Renderer compare it instead of
+     * hashing the data. Owners modifying the data in place take a new version from nextDataVersion on every change.
+     * init resets it to 0, unknown.
+     */
+    void setDataVersion(uint32_t version) { _dataVersion = version; }
+    uint32_t getDataVersion() const { return _dataVersion; }
+
+    /** Returns a data version never returned before, and never 0. */
+    static uint32_t nextDataVersion();
 
     /** update material ID */
     void updateMaterialID();
@@ -121,6 +136,8 @@ protected:
     BlendFunc _blendType              = BlendFunc::DISABLE;
     uint64_t _batchId                 = 0;
     backend::TextureBackend* _texture = nullptr;
+    bool _textureSlotBatchable        = false;
+    uint32_t _dataVersion             = 0;
 };
 
 }
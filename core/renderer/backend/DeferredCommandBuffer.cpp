@@ -0,0 +1,448 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DeferredCommandBuffer.h"
+#include "Buffer.h"
+#include "ProgramState.h"
+#include "RenderTarget.h"
+
+#include <string.h>
+
+NS_AX_BACKEND_BEGIN
+
+namespace
+{
+// a buffer update without data, which only allocates the buffer store
+constexpr std::size_t ALLOCATE_ONLY = static_cast<std::size_t>(-1);
+
+bool sameUniforms(const char* lhs, std::size_t lhsSize, const char* rhs, std::size_t rhsSize)
+{
+    return lhsSize == rhsSize && (lhsSize == 0 || memcmp(lhs, rhs, lhsSize) == 0);
+}
+
+bool sameTextures(const std::unordered_map<int, TextureInfo>& lhs, const std::unordered_map<int, TextureInfo>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (auto&& item : lhs)
+    {
+        auto it = rhs.find(item.first);
+        if (it == rhs.end() || it->second.slots != item.second.slots || it->second.textures != item.second.textures)
+            return false;
+    }
+    return true;
+}
+
+// whether the snapshot still holds the uniforms and textures of the program state
+bool sameState(ProgramState* programState, ProgramState* snapshot)
+{
+    if (programState->getProgram() != snapshot->getProgram())
+        return false;
+
+    std::size_t size = 0, snapshotSize = 0;
+    auto uniforms         = programState->getVertexUniformBuffer(size);
+    auto snapshotUniforms = snapshot->getVertexUniformBuffer(snapshotSize);
+    if (!sameUniforms(uniforms, size, snapshotUniforms, snapshotSize))
+        return false;
+    uniforms         = programState->getFragmentUniformBuffer(size);
+    snapshotUniforms = snapshot->getFragmentUniformBuffer(snapshotSize);
+    if (!sameUniforms(uniforms, size, snapshotUniforms, snapshotSize))
+        return false;
+
+    return sameTextures(programState->getVertexTextureInfos(), snapshot->getVertexTextureInfos()) &&
+           sameTextures(programState->getFragmentTextureInfos(), snapshot->getFragmentTextureInfos());
+}
+}  // namespace
+
+DeferredCommandBuffer::DeferredCommandBuffer(CommandBuffer* target) : _target(target)
+{
+    AX_SAFE_RETAIN(_target);
+}
+
+DeferredCommandBuffer::~DeferredCommandBuffer()
+{
+    resetFrame(_frames[0]);
+    resetFrame(_frames[1]);
+    AX_SAFE_RELEASE(_target);
+}
+
+void DeferredCommandBuffer::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    _target->setDepthStencilState(depthStencilState);
+}
+
+void DeferredCommandBuffer::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    _target->setRenderPipeline(renderPipeline);
+}
+
+bool DeferredCommandBuffer::beginFrame()
+{
+    record(DeferredCommandType::BEGIN_FRAME);
+    return true;
+}
+
+void DeferredCommandBuffer::beginRenderPass(const RenderTarget* rt, const RenderPassDescriptor& descriptor)
+{
+    auto& frame      = _frames[_recordingFrame];
+    auto& command    = record(DeferredCommandType::BEGIN_RENDER_PASS, const_cast<RenderTarget*>(rt));
+    command.sizes[0] = frame.renderPasses.size();
+    frame.renderPasses.emplace_back(descriptor);
+}
+
+void DeferredCommandBuffer::updateDepthStencilState(const DepthStencilDescriptor& descriptor)
+{
+    auto& frame      = _frames[_recordingFrame];
+    auto& command    = record(DeferredCommandType::UPDATE_DEPTH_STENCIL_STATE);
+    command.sizes[0] = frame.depthStencils.size();
+    frame.depthStencils.emplace_back(descriptor);
+}
+
+void DeferredCommandBuffer::updatePipelineState(const RenderTarget* rt, const PipelineDescriptor& descriptor)
+{
+    auto& frame      = _frames[_recordingFrame];
+    auto& command    = record(DeferredCommandType::UPDATE_PIPELINE_STATE, const_cast<RenderTarget*>(rt));
+    command.sizes[0] = frame.pipelines.size();
+
+    auto& pipeline        = frame.pipelines.emplace_back(descriptor);
+    pipeline.programState = snapshot(descriptor.programState);
+}
+
+void DeferredCommandBuffer::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    auto& command   = record(DeferredCommandType::SET_VIEWPORT);
+    command.ints[0] = x;
+    command.ints[1] = y;
+    command.ints[2] = static_cast<int>(w);
+    command.ints[3] = static_cast<int>(h);
+}
+
+void DeferredCommandBuffer::setCullMode(CullMode mode)
+{
+    record(DeferredCommandType::SET_CULL_MODE).mode = static_cast<uint8_t>(mode);
+}
+
+void DeferredCommandBuffer::setWinding(Winding winding)
+{
+    record(DeferredCommandType::SET_WINDING).mode = static_cast<uint8_t>(winding);
+}
+
+void DeferredCommandBuffer::setScissorRect(bool isEnabled, float x, float y, float width, float height)
+{
+    auto& command     = record(DeferredCommandType::SET_SCISSOR_RECT);
+    command.flag      = isEnabled;
+    command.floats[0] = x;
+    command.floats[1] = y;
+    command.floats[2] = width;
+    command.floats[3] = height;
+}
+
+void DeferredCommandBuffer::setVertexBuffer(Buffer* buffer)
+{
+    record(DeferredCommandType::SET_VERTEX_BUFFER, buffer);
+}
+
+void DeferredCommandBuffer::setProgramState(ProgramState* programState)
+{
+    record(DeferredCommandType::SET_PROGRAM_STATE, snapshot(programState));
+}
+
+void DeferredCommandBuffer::setIndexBuffer(Buffer* buffer)
+{
+    record(DeferredCommandType::SET_INDEX_BUFFER, buffer);
+}
+
+void DeferredCommandBuffer::setInstanceBuffer(Buffer* buffer)
+{
+    record(DeferredCommandType::SET_INSTANCE_BUFFER, buffer);
+}
+
+void DeferredCommandBuffer::drawArrays(PrimitiveType primitiveType,
+                                       std::size_t start,
+                                       std::size_t count,
+                                       bool wireframe)
+{
+    recordStencilReference();
+    auto& command    = record(DeferredCommandType::DRAW_ARRAYS);
+    command.mode     = static_cast<uint8_t>(primitiveType);
+    command.flag     = wireframe;
+    command.sizes[0] = start;
+    command.sizes[1] = count;
+}
+
+void DeferredCommandBuffer::drawElements(PrimitiveType primitiveType,
+                                         IndexFormat indexType,
+                                         std::size_t count,
+                                         std::size_t offset,
+                                         bool wireframe)
+{
+    recordStencilReference();
+    auto& command       = record(DeferredCommandType::DRAW_ELEMENTS);
+    command.mode        = static_cast<uint8_t>(primitiveType);
+    command.indexFormat = static_cast<uint8_t>(indexType);
+    command.flag        = wireframe;
+    command.sizes[0]    = count;
+    command.sizes[1]    = offset;
+}
+
+void DeferredCommandBuffer::drawElementsInstanced(PrimitiveType primitiveType,
+                                                  IndexFormat indexType,
+                                                  std::size_t count,
+                                                  std::size_t offset,
+                                                  int instanceCount,
+                                                  bool wireframe)
+{
+    recordStencilReference();
+    auto& command         = record(DeferredCommandType::DRAW_ELEMENTS_INSTANCED);
+    command.mode          = static_cast<uint8_t>(primitiveType);
+    command.indexFormat   = static_cast<uint8_t>(indexType);
+    command.flag          = wireframe;
+    command.instanceCount = instanceCount;
+    command.sizes[0]      = count;
+    command.sizes[1]      = offset;
+}
+
+void DeferredCommandBuffer::endRenderPass()
+{
+    record(DeferredCommandType::END_RENDER_PASS);
+}
+
+void DeferredCommandBuffer::endFrame()
+{
+    record(DeferredCommandType::END_FRAME);
+}
+
+void DeferredCommandBuffer::readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback)
+{
+    auto& frame      = _frames[_recordingFrame];
+    auto& command    = record(DeferredCommandType::READ_PIXELS, rt);
+    command.sizes[0] = frame.readbacks.size();
+    frame.readbacks.emplace_back(std::move(callback));
+}
+
+void DeferredCommandBuffer::updateBuffer(Buffer* buffer,
+                                         const void* data,
+                                         std::size_t offset,
+                                         std::size_t size,
+                                         bool whole)
+{
+    auto& frame      = _frames[_recordingFrame];
+    auto& command    = record(DeferredCommandType::UPDATE_BUFFER, buffer);
+    command.flag     = whole;
+    command.sizes[0] = data ? frame.data.size() : ALLOCATE_ONLY;
+    command.sizes[1] = size;
+    command.sizes[2] = offset;
+
+    if (data)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        frame.data.insert(frame.data.end(), bytes, bytes + size);
+    }
+}
+
+void DeferredCommandBuffer::openFrame()
+{
+    _recordingFrame ^= 1;
+    resetFrame(_frames[_recordingFrame]);
+}
+
+void DeferredCommandBuffer::execute(DeferredFrame* frame, const std::function<void()>& present)
+{
+    for (auto&& command : frame->commands)
+    {
+        switch (command.type)
+        {
+        case DeferredCommandType::BEGIN_FRAME:
+            _target->beginFrame();
+            break;
+        case DeferredCommandType::BEGIN_RENDER_PASS:
+            _target->beginRenderPass(static_cast<RenderTarget*>(command.object),
+                                     frame->renderPasses[command.sizes[0]]);
+            break;
+        case DeferredCommandType::END_RENDER_PASS:
+            _target->endRenderPass();
+            break;
+        case DeferredCommandType::END_FRAME:
+            if (present)
+                present();
+            _target->endFrame();
+            break;
+        case DeferredCommandType::UPDATE_PIPELINE_STATE:
+            _target->updatePipelineState(static_cast<RenderTarget*>(command.object),
+                                         frame->pipelines[command.sizes[0]]);
+            break;
+        case DeferredCommandType::UPDATE_DEPTH_STENCIL_STATE:
+            _target->updateDepthStencilState(frame->depthStencils[command.sizes[0]]);
+            break;
+        case DeferredCommandType::SET_STENCIL_REFERENCE:
+            _target->setStencilReferenceValue(static_cast<unsigned int>(command.sizes[0]),
+                                              static_cast<unsigned int>(command.sizes[1]));
+            break;
+        case DeferredCommandType::SET_VIEWPORT:
+            _target->setViewport(command.ints[0], command.ints[1], static_cast<unsigned int>(command.ints[2]),
+                                 static_cast<unsigned int>(command.ints[3]));
+            break;
+        case DeferredCommandType::SET_SCISSOR_RECT:
+            _target->setScissorRect(command.flag, command.floats[0], command.floats[1], command.floats[2],
+                                    command.floats[3]);
+            break;
+        case DeferredCommandType::SET_CULL_MODE:
+            _target->setCullMode(static_cast<CullMode>(command.mode));
+            break;
+        case DeferredCommandType::SET_WINDING:
+            _target->setWinding(static_cast<Winding>(command.mode));
+            break;
+        case DeferredCommandType::SET_VERTEX_BUFFER:
+            _target->setVertexBuffer(static_cast<Buffer*>(command.object));
+            break;
+        case DeferredCommandType::SET_INDEX_BUFFER:
+            _target->setIndexBuffer(static_cast<Buffer*>(command.object));
+            break;
+        case DeferredCommandType::SET_INSTANCE_BUFFER:
+            _target->setInstanceBuffer(static_cast<Buffer*>(command.object));
+            break;
+        case DeferredCommandType::SET_PROGRAM_STATE:
+            _target->setProgramState(static_cast<ProgramState*>(command.object));
+            break;
+        case DeferredCommandType::DRAW_ARRAYS:
+            _target->drawArrays(static_cast<PrimitiveType>(command.mode), command.sizes[0], command.sizes[1],
+                                command.flag);
+            break;
+        case DeferredCommandType::DRAW_ELEMENTS:
+            _target->drawElements(static_cast<PrimitiveType>(command.mode),
+                                  static_cast<IndexFormat>(command.indexFormat), command.sizes[0], command.sizes[1],
+                                  command.flag);
+            break;
+        case DeferredCommandType::DRAW_ELEMENTS_INSTANCED:
+            _target->drawElementsInstanced(static_cast<PrimitiveType>(command.mode),
+                                           static_cast<IndexFormat>(command.indexFormat), command.sizes[0],
+                                           command.sizes[1], command.instanceCount, command.flag);
+            break;
+        case DeferredCommandType::UPDATE_BUFFER:
+        {
+            auto buffer = static_cast<Buffer*>(command.object);
+            auto data   = command.sizes[0] != ALLOCATE_ONLY ? frame->data.data() + command.sizes[0] : nullptr;
+            if (command.flag)
+                buffer->updateData(data, command.sizes[1]);
+            else
+                buffer->updateSubData(data, command.sizes[2], command.sizes[1]);
+            break;
+        }
+        case DeferredCommandType::READ_PIXELS:
+        {
+            // a backend may read back once the frame completes, the callback doesn't reference the frame
+            _target->readPixels(static_cast<RenderTarget*>(command.object),
+                                [this, callback = std::move(frame->readbacks[command.sizes[0]])](
+                                    const PixelBufferDescriptor& pbd) {
+                std::lock_guard<std::mutex> lock(_readbackMutex);
+                _readbacks.emplace_back(callback, pbd);
+            });
+            break;
+        }
+        }
+    }
+}
+
+void DeferredCommandBuffer::dispatchReadbacks()
+{
+    decltype(_readbacks) readbacks;
+    {
+        std::lock_guard<std::mutex> lock(_readbackMutex);
+        if (_readbacks.empty())
+            return;
+        readbacks.swap(_readbacks);
+    }
+
+    for (auto&& readback : readbacks)
+        readback.first(readback.second);
+}
+
+DeferredCommand& DeferredCommandBuffer::record(DeferredCommandType type, Object* object)
+{
+    if (object)
+    {
+        object->retain();
+        _frames[_recordingFrame].references.emplace_back(object);
+    }
+
+    auto& command  = _frames[_recordingFrame].commands.emplace_back();
+    command.type   = type;
+    command.object = object;
+    return command;
+}
+
+ProgramState* DeferredCommandBuffer::snapshot(ProgramState* programState)
+{
+    if (!programState)
+        return nullptr;
+
+    // the callback uniforms are evaluated now, the snapshot doesn't copy them
+    auto& callbacks = programState->getCallbackUniforms();
+    if (programState == _snapshotSource && callbacks.empty() && sameState(programState, _snapshot))
+        return _snapshot;
+
+    auto snapshot = programState->clone();
+    for (auto&& cb : callbacks)
+        cb.second(snapshot, cb.first);
+
+    // the frame owns the snapshot, the commands using it add their reference
+    _frames[_recordingFrame].references.emplace_back(snapshot);
+    _snapshotSource = programState;
+    _snapshot       = snapshot;
+    return snapshot;
+}
+
+void DeferredCommandBuffer::recordStencilReference()
+{
+    if (_stencilRecorded && _recordedStencilFront == _stencilReferenceValueFront &&
+        _recordedStencilBack == _stencilReferenceValueBack)
+        return;
+
+    auto& command         = record(DeferredCommandType::SET_STENCIL_REFERENCE);
+    command.sizes[0]      = _stencilReferenceValueFront;
+    command.sizes[1]      = _stencilReferenceValueBack;
+    _recordedStencilFront = _stencilReferenceValueFront;
+    _recordedStencilBack  = _stencilReferenceValueBack;
+    _stencilRecorded      = true;
+}
+
+void DeferredCommandBuffer::resetFrame(DeferredFrame& frame)
+{
+    for (auto object : frame.references)
+        object->release();
+
+    frame.commands.clear();
+    frame.data.clear();
+    frame.renderPasses.clear();
+    frame.depthStencils.clear();
+    frame.pipelines.clear();
+    frame.readbacks.clear();
+    frame.references.clear();
+
+    _snapshotSource  = nullptr;
+    _snapshot        = nullptr;
+    _stencilRecorded = false;
+}
+
+NS_AX_BACKEND_END
@@ -0,0 +1,212 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "CommandBuffer.h"
+#include "DepthStencilState.h"
+#include "PixelBufferDescriptor.h"
+#include "RenderPassDescriptor.h"
+#include "renderer/PipelineDescriptor.h"
+
+#include <mutex>
+#include <vector>
+
+NS_AX_BACKEND_BEGIN
+
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+enum class DeferredCommandType : uint8_t
+{
+    BEGIN_FRAME,
+    BEGIN_RENDER_PASS,
+    END_RENDER_PASS,
+    END_FRAME,
+    UPDATE_PIPELINE_STATE,
+    UPDATE_DEPTH_STENCIL_STATE,
+    SET_STENCIL_REFERENCE,
+    SET_VIEWPORT,
+    SET_SCISSOR_RECT,
+    SET_CULL_MODE,
+    SET_WINDING,
+    SET_VERTEX_BUFFER,
+    SET_INDEX_BUFFER,
+    SET_INSTANCE_BUFFER,
+    SET_PROGRAM_STATE,
+    DRAW_ARRAYS,
+    DRAW_ELEMENTS,
+    DRAW_ELEMENTS_INSTANCED,
+    UPDATE_BUFFER,
+    READ_PIXELS,
+};
+
+/**
+ * A recorded command buffer call. The object is a buffer, a program state snapshot or a render target, the frame
+ * holds a reference to it. Descriptors, buffer data and readback callbacks are stored in the frame, the command
+ * keeps their index.
+ */
+struct DeferredCommand
+{
+    DeferredCommandType type;
+    uint8_t flag          = 0;  ///< wireframe, scissor test enabled or a whole buffer update
+    uint8_t mode          = 0;  ///< primitive type, cull mode or winding
+    uint8_t indexFormat   = 0;
+    int instanceCount     = 0;
+    Object* object        = nullptr;
+    union
+    {
+        std::size_t sizes[3];
+        float floats[4];
+        int ints[4];
+    };
+};
+
+/**
+ * The commands of a frame and everything they reference, a frame is recorded on the main thread and executed
+ * once, possibly on the render thread.
+ */
+struct DeferredFrame
+{
+    std::vector<DeferredCommand> commands;
+    std::vector<uint8_t> data;  ///< the snapshots of the buffer updates
+    std::vector<RenderPassDescriptor> renderPasses;
+    std::vector<DepthStencilDescriptor> depthStencils;
+    std::vector<PipelineDescriptor> pipelines;
+    std::vector<std::function<void(const PixelBufferDescriptor&)>> readbacks;
+    std::vector<Object*> references;
+};
+
+/**
+ * A command buffer which records the calls into double buffered frame storage instead of executing them, the
+ * recorded frame is then executed by the target command buffer. Program states are snapshotted when they're set,
+ * including their callback uniforms, so the main thread can update them for the next frame while the previous one
+ * executes. Buffer data must go through updateBuffer to be snapshotted as well.
+ *
+ * setDepthStencilState and setRenderPipeline are set once by the Renderer, they're forwarded to the target.
+ * The readPixels callbacks are delivered by dispatchReadbacks, on the thread which records.
+ * @see Renderer::setPipelined
+ */
+class DeferredCommandBuffer : public CommandBuffer
+{
+public:
+    explicit DeferredCommandBuffer(CommandBuffer* target);
+    ~DeferredCommandBuffer();
+
+    CommandBuffer* getTarget() const { return _target; }
+
+    void setDepthStencilState(DepthStencilState* depthStencilState) override;
+    void setRenderPipeline(RenderPipeline* renderPipeline) override;
+
+    /** Always succeeds, the target begins the frame when it's executed. */
+    bool beginFrame() override;
+    void beginRenderPass(const RenderTarget* rt, const RenderPassDescriptor& descriptor) override;
+
+    void updateDepthStencilState(const DepthStencilDescriptor& descriptor) override;
+    void updatePipelineState(const RenderTarget* rt, const PipelineDescriptor& descriptor) override;
+
+    void setViewport(int x, int y, unsigned int w, unsigned int h) override;
+    void setCullMode(CullMode mode) override;
+    void setWinding(Winding winding) override;
+    void setScissorRect(bool isEnabled, float x, float y, float width, float height) override;
+
+    void setVertexBuffer(Buffer* buffer) override;
+    void setProgramState(ProgramState* programState) override;
+    void setIndexBuffer(Buffer* buffer) override;
+    void setInstanceBuffer(Buffer* buffer) override;
+
+    void drawArrays(PrimitiveType primitiveType, std::size_t start, std::size_t count, bool wireframe = false) override;
+
+    void drawElements(PrimitiveType primitiveType,
+                      IndexFormat indexType,
+                      std::size_t count,
+                      std::size_t offset,
+                      bool wireframe = false) override;
+
+    void drawElementsInstanced(PrimitiveType primitiveType,
+                               IndexFormat indexType,
+                               std::size_t count,
+                               std::size_t offset,
+                               int instanceCount,
+                               bool wireframe = false) override;
+
+    void endRenderPass() override;
+    void endFrame() override;
+
+    void readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback) override;
+
+    /**
+     * Record a buffer update, the data is copied into the frame. A null data only allocates the buffer store.
+     * @param whole true to update with Buffer::updateData, offset is ignored, false to use Buffer::updateSubData.
+     */
+    void updateBuffer(Buffer* buffer, const void* data, std::size_t offset, std::size_t size, bool whole);
+
+    /**
+     * Stop recording into the current frame and return it, call openFrame once it's submitted.
+     */
+    DeferredFrame* closeFrame() { return &_frames[_recordingFrame]; }
+
+    /**
+     * Start recording into the other frame storage, the frame it held must be executed. Releases what it referenced.
+     */
+    void openFrame();
+
+    /**
+     * Execute a closed frame with the target command buffer, can be called from the render thread.
+     * @param present Called before the target ends the frame, where Director swaps the buffers in serial mode.
+     */
+    void execute(DeferredFrame* frame, const std::function<void()>& present = nullptr);
+
+    /**
+     * Invoke the readPixels callbacks of the executed frames, on the thread which records.
+     */
+    void dispatchReadbacks();
+
+protected:
+    DeferredCommand& record(DeferredCommandType type, Object* object = nullptr);
+    ProgramState* snapshot(ProgramState* programState);
+    void recordStencilReference();
+    void resetFrame(DeferredFrame& frame);
+
+    CommandBuffer* _target = nullptr;
+    DeferredFrame _frames[2];
+    int _recordingFrame = 0;
+
+    // the last snapshot, reused while the program state doesn't change
+    ProgramState* _snapshotSource = nullptr;
+    ProgramState* _snapshot       = nullptr;
+
+    unsigned int _recordedStencilFront = 0;
+    unsigned int _recordedStencilBack  = 0;
+    bool _stencilRecorded              = false;
+
+    std::mutex _readbackMutex;
+    std::vector<std::pair<std::function<void(const PixelBufferDescriptor&)>, PixelBufferDescriptor>> _readbacks;
+};
+
+// end of _backend group
+/// @}
+NS_AX_BACKEND_END
@@ -24,9 +24,21 @@
  ****************************************************************************/
 
 #include "DriverBase.h"
+#include "base/Macros.h"
+
+#if !defined(AX_USE_NULL_DRIVER)
+#    define AX_USE_NULL_DRIVER 0
+#endif
 
 NS_AX_BACKEND_BEGIN
 
 DriverBase* DriverBase::_instance = nullptr;
+bool DriverBase::_nullDriverEnabled = !!AX_USE_NULL_DRIVER;
+
+void DriverBase::setNullDriverEnabled(bool enabled)
+{
+    AXASSERT(!_instance, "The render driver was already created");
+    _nullDriverEnabled = enabled;
+}
 
 NS_AX_BACKEND_END
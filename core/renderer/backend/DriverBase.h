@@ -61,7 +61,8 @@ enum class FeatureType : uint32_t
     VAO,
     MAPBUFFER,
     DEPTH24,
-    ASTC
+    ASTC,
+    INSTANCING
 };
 
 /**
@@ -84,6 +85,14 @@ public:
     static DriverBase* getInstance();
     static void destroyInstance();
 
+    /**
+     * Create the null driver instead of the platform driver, it draws nothing and counts the submitted work.
+     * Must be called before the first getInstance, the default is the AX_USE_NULL_DRIVER build option.
+     * @see DriverNull
+     */
+    static void setNullDriverEnabled(bool enabled);
+    static bool isNullDriverEnabled() { return _nullDriverEnabled; }
+
     virtual ~DriverBase() = default;
 
     /**
@@ -185,6 +194,12 @@ public:
      */
     virtual bool checkForFeatureSupported(FeatureType feature) = 0;
 
+    /**
+     * Whether the command buffers of the driver can execute on a render thread while the main thread creates and
+     * updates resources, see Renderer::setPipelined. The GL driver can't, its context is current on the main thread.
+     */
+    virtual bool supportsRenderThread() const { return false; }
+
     /**
      * Get maximum texture size.
      * @return Maximum texture size.
@@ -225,6 +240,7 @@ protected:
 
 private:
     static DriverBase* _instance;
+    static bool _nullDriverEnabled;
 };
 
 // end of _backend group
@@ -384,6 +384,9 @@ struct ProgramType
         VIDEO_TEXTURE_I420, // For some android 11 and older devices
         VIDEO_TEXTURE_BGR32,
 
+        POSITION_TEXTURE_COLOR_INSTANCE,      // positionTextureColorInstance_vert, positionTextureColor_frag
+        POSITION_TEXTURE_COLOR_MULTI,         // positionTextureColorMulti_vert,  positionTextureColorMulti_frag
+
         BUILTIN_COUNT,
 
         VIDEO_TEXTURE_RGB32 = POSITION_TEXTURE_COLOR,
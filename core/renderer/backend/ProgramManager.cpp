@@ -154,6 +154,10 @@ bool ProgramManager::init()
                     VertexLayoutType::Sprite);
     registerProgram(ProgramType::VIDEO_TEXTURE_I420, positionTextureColor_vert, videoTextureI420_frag,
                     VertexLayoutType::Sprite);
+    registerProgram(ProgramType::POSITION_TEXTURE_COLOR_INSTANCE, positionTextureColorInstance_vert,
+                    positionTextureColor_frag, VertexLayoutType::Pos);
+    registerProgram(ProgramType::POSITION_TEXTURE_COLOR_MULTI, positionTextureColorMulti_vert,
+                    positionTextureColorMulti_frag, VertexLayoutType::Sprite);
 
     // The builtin dual sampler shader registry
     ProgramStateRegistry::getInstance()->registerProgram(ProgramType::POSITION_TEXTURE_COLOR,
@@ -45,4 +45,15 @@ void TextureBackend::updateTextureDescriptor(const ax::backend::TextureDescripto
     }
 }
 
+void TextureBackend::updateAddressModes(const SamplerDescriptor& sampler)
+{
+    // DONT_CARE keeps the current mode of the axis
+    auto apply = [](SamplerAddressMode mode, bool& repeatWrapped) {
+        if (mode != SamplerAddressMode::DONT_CARE)
+            repeatWrapped = mode == SamplerAddressMode::REPEAT || mode == SamplerAddressMode::MIRROR_REPEAT;
+    };
+    apply(sampler.sAddressMode, _repeatWrappedS);
+    apply(sampler.tAddressMode, _repeatWrappedT);
+}
+
 NS_AX_BACKEND_END
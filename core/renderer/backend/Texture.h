@@ -103,6 +103,9 @@ public:
     int getWidth() const { return _width; }
     int getHeight() const { return _height; }
 
+    /** Whether the sampler repeats or mirrors the texture on an axis, i.e. texture coordinates out of [0, 1] wrap. */
+    bool isRepeatWrapped() const { return _repeatWrappedS || _repeatWrappedT; }
+
 protected:
     /**
      * @param descriptor Specifies the texture descriptor.
@@ -110,6 +113,9 @@ protected:
     TextureBackend() {}
     virtual ~TextureBackend();
 
+    /// Tracks the address modes of the sampler, called by updateSamplerDescriptor of the backends.
+    void updateAddressModes(const SamplerDescriptor& sampler);
+
     /// The bytes of all components.
     uint8_t _bitsPerPixel = 0;
     bool _hasMipmaps      = false;
@@ -120,6 +126,9 @@ protected:
     TextureType _textureType   = TextureType::TEXTURE_2D;
     PixelFormat _textureFormat = PixelFormat::RGBA8;
     TextureUsage _textureUsage = TextureUsage::READ;
+
+    bool _repeatWrappedS = false;
+    bool _repeatWrappedT = false;
 };
 
 /**
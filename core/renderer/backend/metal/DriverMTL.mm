@@ -36,6 +36,7 @@
 #include "base/Macros.h"
 
 #include "renderer/backend/ProgramManager.h"
+#include "renderer/backend/null/DriverNull.h"
 
 NS_AX_BACKEND_BEGIN
 
@@ -392,7 +393,7 @@ id<CAMetalDrawable> DriverMTL::_currentDrawable = nil;
 DriverBase* DriverBase::getInstance()
 {
     if (!_instance)
-        _instance = new DriverMTL();
+        _instance = !_nullDriverEnabled ? static_cast<DriverBase*>(new DriverMTL()) : new DriverNull();
 
     return _instance;
 }
@@ -564,6 +565,9 @@ bool DriverMTL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::ASTC:
         featureSupported = supportASTC(_featureSet);
         break;
+    case FeatureType::INSTANCING:
+        featureSupported = true;
+        break;
     default:
         break;
     }
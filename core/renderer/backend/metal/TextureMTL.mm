@@ -214,6 +214,7 @@ TextureMTL::~TextureMTL() {}
 void TextureMTL::updateSamplerDescriptor(const SamplerDescriptor& sampler)
 {
     _textureInfo.recreateSampler(sampler);
+    updateAddressModes(sampler);
 }
 
 void TextureMTL::updateTextureDescriptor(const ax::backend::TextureDescriptor& descriptor, int index)
@@ -315,6 +316,7 @@ void TextureCubeMTL::updateTextureDescriptor(const ax::backend::TextureDescripto
 void TextureCubeMTL::updateSamplerDescriptor(const SamplerDescriptor& sampler)
 {
     _textureInfo.recreateSampler(sampler);
+    updateAddressModes(sampler);
 }
 
 void TextureCubeMTL::updateFaceData(TextureCubeFace side, void* data, int index)
@@ -0,0 +1,55 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "BufferNull.h"
+#include "DriverNull.h"
+
+#include <assert.h>
+
+NS_AX_BACKEND_BEGIN
+
+BufferNull::BufferNull(NullDriverCounters& counters, std::size_t size, BufferType type, BufferUsage usage)
+    : Buffer(size, type, usage), _counters(counters)
+{
+    ++_counters.buffersCreated;
+    _counters.bufferBytes += size;
+}
+
+void BufferNull::updateData(const void* /*data*/, std::size_t size)
+{
+    assert(size && size <= _size);
+
+    ++_counters.bufferUploads;
+    _counters.bufferUploadBytes += size;
+}
+
+void BufferNull::updateSubData(const void* /*data*/, std::size_t offset, std::size_t size)
+{
+    assert(offset + size <= _size);
+
+    ++_counters.bufferUploads;
+    _counters.bufferUploadBytes += size;
+}
+
+NS_AX_BACKEND_END
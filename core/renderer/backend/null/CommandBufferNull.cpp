@@ -0,0 +1,308 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CommandBufferNull.h"
+#include "DriverNull.h"
+#include "../Buffer.h"
+#include "../DepthStencilState.h"
+#include "../RenderPipeline.h"
+#include "../RenderTarget.h"
+#include "../ProgramState.h"
+#include "../Texture.h"
+
+#include <assert.h>
+
+NS_AX_BACKEND_BEGIN
+
+namespace
+{
+template <typename _Ty>
+bool retainBuffer(_Ty*& slot, Buffer* buffer)
+{
+    assert(buffer != nullptr);
+    if (buffer == nullptr || slot == buffer)
+        return false;
+
+    buffer->retain();
+    AX_SAFE_RELEASE(slot);
+    slot = buffer;
+    return true;
+}
+
+inline uint64_t indexBytes(IndexFormat indexType, std::size_t count)
+{
+    return static_cast<uint64_t>(count) * (indexType == IndexFormat::U_SHORT ? 2 : 4);
+}
+}  // namespace
+
+CommandBufferNull::CommandBufferNull(DriverNull* driver) : _driver(driver) {}
+
+CommandBufferNull::~CommandBufferNull()
+{
+    AX_SAFE_RELEASE_NULL(_indexBuffer);
+    AX_SAFE_RELEASE_NULL(_vertexBuffer);
+    AX_SAFE_RELEASE_NULL(_instanceBuffer);
+    cleanResources();
+}
+
+void CommandBufferNull::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    _depthStencilState = depthStencilState;
+}
+
+void CommandBufferNull::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    _renderPipeline = renderPipeline;
+}
+
+bool CommandBufferNull::beginFrame()
+{
+    ++_driver->getCounters().frames;
+    _driver->record(NullCommandType::BEGIN_FRAME);
+    return true;
+}
+
+void CommandBufferNull::beginRenderPass(const RenderTarget* rt, const RenderPassDescriptor& descriptor)
+{
+    ++_driver->getCounters().renderPasses;
+    _driver->record(NullCommandType::BEGIN_RENDER_PASS);
+}
+
+void CommandBufferNull::updateDepthStencilState(const DepthStencilDescriptor& descriptor)
+{
+    _depthStencilState->update(descriptor);
+
+    ++_driver->getCounters().depthStencilUpdates;
+    _driver->record(NullCommandType::UPDATE_DEPTH_STENCIL_STATE);
+}
+
+void CommandBufferNull::updatePipelineState(const RenderTarget* rt, const PipelineDescriptor& descriptor)
+{
+    // program and blend changes are counted by the pipeline
+    _renderPipeline->update(rt, descriptor);
+
+    ++_driver->getCounters().pipelineUpdates;
+    _driver->record(NullCommandType::UPDATE_PIPELINE_STATE);
+}
+
+void CommandBufferNull::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    Viewport viewport;
+    viewport.set(x, y, static_cast<int>(w), static_cast<int>(h));
+    if (viewport == _viewPort)
+        return;
+
+    _viewPort = viewport;
+    ++_driver->getCounters().viewportChanges;
+    _driver->record(NullCommandType::SET_VIEWPORT);
+}
+
+void CommandBufferNull::setCullMode(CullMode mode)
+{
+    if (_cullMode == mode)
+        return;
+
+    _cullMode = mode;
+    ++_driver->getCounters().cullModeChanges;
+    _driver->record(NullCommandType::SET_CULL_MODE);
+}
+
+void CommandBufferNull::setWinding(Winding winding)
+{
+    if (_winding == winding)
+        return;
+
+    _winding = winding;
+    _driver->record(NullCommandType::SET_WINDING);
+}
+
+void CommandBufferNull::setScissorRect(bool isEnabled, float x, float y, float width, float height)
+{
+    Rect rect{x, y, width, height};
+    if (_scissorEnabled == isEnabled && (!isEnabled || _scissorRect.equals(rect)))
+        return;
+
+    _scissorEnabled = isEnabled;
+    _scissorRect    = rect;
+    ++_driver->getCounters().scissorChanges;
+    _driver->record(NullCommandType::SET_SCISSOR_RECT);
+}
+
+void CommandBufferNull::setVertexBuffer(Buffer* buffer)
+{
+    if (!retainBuffer(_vertexBuffer, buffer))
+        return;
+
+    ++_driver->getCounters().vertexBufferBinds;
+    _driver->record(NullCommandType::SET_VERTEX_BUFFER, 0, buffer->getSize());
+}
+
+void CommandBufferNull::setIndexBuffer(Buffer* buffer)
+{
+    if (!retainBuffer(_indexBuffer, buffer))
+        return;
+
+    ++_driver->getCounters().indexBufferBinds;
+    _driver->record(NullCommandType::SET_INDEX_BUFFER, 0, buffer->getSize());
+}
+
+void CommandBufferNull::setInstanceBuffer(Buffer* buffer)
+{
+    if (!retainBuffer(_instanceBuffer, buffer))
+        return;
+
+    ++_driver->getCounters().instanceBufferBinds;
+    _driver->record(NullCommandType::SET_INSTANCE_BUFFER, 0, buffer->getSize());
+}
+
+void CommandBufferNull::setProgramState(ProgramState* programState)
+{
+    AX_SAFE_RETAIN(programState);
+    AX_SAFE_RELEASE(_programState);
+    _programState = programState;
+}
+
+void CommandBufferNull::drawArrays(PrimitiveType primitiveType, std::size_t start, std::size_t count, bool wireframe)
+{
+    auto uniformBytes = prepareDrawing();
+
+    auto& counters = _driver->getCounters();
+    ++counters.drawCalls;
+    counters.vertices += count;
+    _driver->record(NullCommandType::DRAW_ARRAYS, count, uniformBytes);
+
+    cleanResources();
+}
+
+void CommandBufferNull::drawElements(PrimitiveType primitiveType,
+                                     IndexFormat indexType,
+                                     std::size_t count,
+                                     std::size_t offset,
+                                     bool wireframe)
+{
+    assert(_indexBuffer != nullptr);
+    auto uniformBytes = prepareDrawing();
+
+    auto& counters = _driver->getCounters();
+    ++counters.drawCalls;
+    counters.indices += count;
+    _driver->record(NullCommandType::DRAW_ELEMENTS, count, indexBytes(indexType, count) + uniformBytes);
+
+    cleanResources();
+}
+
+void CommandBufferNull::drawElementsInstanced(PrimitiveType primitiveType,
+                                              IndexFormat indexType,
+                                              std::size_t count,
+                                              std::size_t offset,
+                                              int instanceCount,
+                                              bool wireframe)
+{
+    assert(_indexBuffer != nullptr);
+    auto uniformBytes = prepareDrawing();
+
+    auto& counters = _driver->getCounters();
+    ++counters.drawCalls;
+    ++counters.instancedDraws;
+    counters.indices += count;
+    counters.instances += instanceCount;
+    _driver->record(NullCommandType::DRAW_ELEMENTS_INSTANCED, count, indexBytes(indexType, count) + uniformBytes,
+                    static_cast<uint32_t>(instanceCount));
+
+    cleanResources();
+}
+
+void CommandBufferNull::endRenderPass()
+{
+    AX_SAFE_RELEASE_NULL(_indexBuffer);
+    AX_SAFE_RELEASE_NULL(_vertexBuffer);
+    AX_SAFE_RELEASE_NULL(_instanceBuffer);
+
+    _driver->record(NullCommandType::END_RENDER_PASS);
+}
+
+void CommandBufferNull::endFrame()
+{
+    _driver->record(NullCommandType::END_FRAME);
+}
+
+uint64_t CommandBufferNull::prepareDrawing()
+{
+    if (!_programState)
+        return 0;
+
+    // callback uniforms write into the uniform buffer, run them like a real backend
+    auto& callbacks = _programState->getCallbackUniforms();
+    for (auto&& cb : callbacks)
+        cb.second(_programState, cb.first);
+
+    std::size_t bufferSize = 0;
+    _programState->getVertexUniformBuffer(bufferSize);
+
+    auto& counters = _driver->getCounters();
+    counters.uniformUploadBytes += bufferSize;
+    for (auto&& textureInfo : _programState->getVertexTextureInfos())
+        counters.textureBinds += textureInfo.second.textures.size();
+
+    return bufferSize;
+}
+
+void CommandBufferNull::cleanResources()
+{
+    AX_SAFE_RELEASE_NULL(_programState);
+}
+
+void CommandBufferNull::readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback)
+{
+    uint32_t width = 0, height = 0;
+    if (rt->isDefaultRenderTarget())
+    {
+        width  = _viewPort.width;
+        height = _viewPort.height;
+    }
+    else if (auto colorAttachment = rt->_color[0].texture)
+    {
+        width  = colorAttachment->getWidth();
+        height = colorAttachment->getHeight();
+    }
+
+    PixelBufferDescriptor pbd;
+    auto bufferSize = static_cast<std::size_t>(width) * height * 4;
+    if (bufferSize)
+    {
+        if (auto wptr = pbd._data.resize(bufferSize))
+        {
+            memset(wptr, 0, bufferSize);
+            pbd._width  = width;
+            pbd._height = height;
+        }
+    }
+
+    ++_driver->getCounters().readPixels;
+    _driver->record(NullCommandType::READ_PIXELS, 0, bufferSize);
+
+    callback(pbd);
+}
+
+NS_AX_BACKEND_END
@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../CommandBuffer.h"
+#include "base/Types.h"
+
+NS_AX_BACKEND_BEGIN
+
+class DriverNull;
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A command buffer which executes nothing, each call updates the counters of the null driver and is appended to its
+ * command log when recording. Buffers and program states are retained and released exactly like CommandBufferGL
+ * does, so object lifetimes match the GL backend.
+ */
+class CommandBufferNull : public CommandBuffer
+{
+public:
+    explicit CommandBufferNull(DriverNull* driver);
+    ~CommandBufferNull();
+
+    void setDepthStencilState(DepthStencilState* depthStencilState) override;
+    void setRenderPipeline(RenderPipeline* renderPipeline) override;
+
+    bool beginFrame() override;
+    void beginRenderPass(const RenderTarget* rt, const RenderPassDescriptor& descriptor) override;
+
+    void updateDepthStencilState(const DepthStencilDescriptor& descriptor) override;
+    void updatePipelineState(const RenderTarget* rt, const PipelineDescriptor& descriptor) override;
+
+    void setViewport(int x, int y, unsigned int w, unsigned int h) override;
+    void setCullMode(CullMode mode) override;
+    void setWinding(Winding winding) override;
+    void setScissorRect(bool isEnabled, float x, float y, float width, float height) override;
+
+    void setVertexBuffer(Buffer* buffer) override;
+    void setProgramState(ProgramState* programState) override;
+    void setIndexBuffer(Buffer* buffer) override;
+    void setInstanceBuffer(Buffer* buffer) override;
+
+    void drawArrays(PrimitiveType primitiveType, std::size_t start, std::size_t count, bool wireframe = false) override;
+
+    void drawElements(PrimitiveType primitiveType,
+                      IndexFormat indexType,
+                      std::size_t count,
+                      std::size_t offset,
+                      bool wireframe = false) override;
+
+    void drawElementsInstanced(PrimitiveType primitiveType,
+                               IndexFormat indexType,
+                               std::size_t count,
+                               std::size_t offset,
+                               int instanceCount,
+                               bool wireframe = false) override;
+
+    void endRenderPass() override;
+    void endFrame() override;
+
+    /**
+     * Read back zeroed RGBA8 pixels with the size of the viewport or of the color attachment.
+     */
+    void readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback) override;
+
+protected:
+    /** Account for the uniforms and textures a draw would bind, returns the uniform bytes. */
+    uint64_t prepareDrawing();
+    void cleanResources();
+
+    DriverNull* _driver                   = nullptr;
+    Buffer* _vertexBuffer                 = nullptr;
+    Buffer* _indexBuffer                  = nullptr;
+    Buffer* _instanceBuffer               = nullptr;
+    ProgramState* _programState           = nullptr;
+    RenderPipeline* _renderPipeline       = nullptr;
+    DepthStencilState* _depthStencilState = nullptr;
+    CullMode _cullMode                    = CullMode::NONE;
+    Winding _winding                      = Winding::COUNTER_CLOCK_WISE;
+    Viewport _viewPort;
+    Rect _scissorRect;
+    bool _scissorEnabled = false;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
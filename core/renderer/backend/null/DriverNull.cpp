@@ -0,0 +1,200 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DriverNull.h"
+#include "BufferNull.h"
+#include "CommandBufferNull.h"
+#include "ProgramNull.h"
+#include "TextureNull.h"
+#include "../DepthStencilState.h"
+#include "../RenderPipeline.h"
+#include "../RenderTarget.h"
+#include "../ShaderModule.h"
+#include "../ProgramManager.h"
+#include "../ProgramState.h"
+
+NS_AX_BACKEND_BEGIN
+
+namespace
+{
+bool operator==(const BlendDescriptor& lhs, const BlendDescriptor& rhs)
+{
+    return lhs.writeMask == rhs.writeMask && lhs.blendEnabled == rhs.blendEnabled &&
+           lhs.rgbBlendOperation == rhs.rgbBlendOperation && lhs.alphaBlendOperation == rhs.alphaBlendOperation &&
+           lhs.sourceRGBBlendFactor == rhs.sourceRGBBlendFactor &&
+           lhs.destinationRGBBlendFactor == rhs.destinationRGBBlendFactor &&
+           lhs.sourceAlphaBlendFactor == rhs.sourceAlphaBlendFactor &&
+           lhs.destinationAlphaBlendFactor == rhs.destinationAlphaBlendFactor;
+}
+
+class DepthStencilStateNull : public DepthStencilState
+{};
+
+class ShaderModuleNull : public ShaderModule
+{
+public:
+    explicit ShaderModuleNull(ShaderStage stage) : ShaderModule(stage) {}
+};
+
+class RenderPipelineNull : public RenderPipeline
+{
+public:
+    explicit RenderPipelineNull(NullDriverCounters& counters) : _counters(counters) {}
+    ~RenderPipelineNull() { AX_SAFE_RELEASE(_program); }
+
+    void update(const RenderTarget*, const PipelineDescriptor& pipelineDescriptor) override
+    {
+        auto program = pipelineDescriptor.programState->getProgram();
+        if (_program != program)
+        {
+            AX_SAFE_RETAIN(program);
+            AX_SAFE_RELEASE(_program);
+            _program = program;
+            ++_counters.programChanges;
+        }
+
+        if (!(_blendDescriptor == pipelineDescriptor.blendDescriptor))
+        {
+            _blendDescriptor = pipelineDescriptor.blendDescriptor;
+            ++_counters.blendChanges;
+        }
+    }
+
+private:
+    NullDriverCounters& _counters;
+    Program* _program = nullptr;
+    BlendDescriptor _blendDescriptor;
+};
+}  // namespace
+
+DriverNull::DriverNull()
+{
+    _maxAttributes     = 16;
+    _maxTextureSize    = 16384;
+    _maxTextureUnits   = 16;
+    _maxSamplesAllowed = 4;
+}
+
+DriverNull::~DriverNull()
+{
+    ProgramManager::destroyInstance();
+}
+
+CommandBuffer* DriverNull::newCommandBuffer()
+{
+    return new CommandBufferNull(this);
+}
+
+Buffer* DriverNull::newBuffer(std::size_t size, BufferType type, BufferUsage usage)
+{
+    return new BufferNull(_counters, size, type, usage);
+}
+
+TextureBackend* DriverNull::newTexture(const TextureDescriptor& descriptor)
+{
+    switch (descriptor.textureType)
+    {
+    case TextureType::TEXTURE_2D:
+        return new Texture2DNull(_counters, descriptor);
+    case TextureType::TEXTURE_CUBE:
+        return new TextureCubeNull(_counters, descriptor);
+    default:
+        return nullptr;
+    }
+}
+
+RenderTarget* DriverNull::newDefaultRenderTarget()
+{
+    return new RenderTarget(true);
+}
+
+RenderTarget* DriverNull::newRenderTarget(TextureBackend* colorAttachment,
+                                          TextureBackend* depthAttachment,
+                                          TextureBackend* stencilAttachhment)
+{
+    auto rt = new RenderTarget(false);
+    RenderTarget::ColorAttachment colors{{colorAttachment, 0}};
+    rt->setColorAttachment(colors);
+    rt->setDepthAttachment(depthAttachment);
+    rt->setStencilAttachment(stencilAttachhment);
+    return rt;
+}
+
+ShaderModule* DriverNull::newShaderModule(ShaderStage stage, std::string_view /*source*/)
+{
+    return new ShaderModuleNull(stage);
+}
+
+DepthStencilState* DriverNull::newDepthStencilState()
+{
+    return new DepthStencilStateNull();
+}
+
+RenderPipeline* DriverNull::newRenderPipeline()
+{
+    return new RenderPipelineNull(_counters);
+}
+
+Program* DriverNull::newProgram(std::string_view vertexShader, std::string_view fragmentShader)
+{
+    ++_counters.programsCreated;
+    return new ProgramNull(vertexShader, fragmentShader);
+}
+
+const char* DriverNull::getVendor() const
+{
+    return "axmol";
+}
+
+const char* DriverNull::getRenderer() const
+{
+    return "null";
+}
+
+const char* DriverNull::getVersion() const
+{
+    return "1.0";
+}
+
+bool DriverNull::checkForFeatureSupported(FeatureType feature)
+{
+    switch (feature)
+    {
+    case FeatureType::VAO:
+    case FeatureType::INSTANCING:
+    case FeatureType::PACKED_DEPTH_STENCIL:
+    case FeatureType::DEPTH24:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void DriverNull::resetCounters()
+{
+    _counters = NullDriverCounters{};
+    _commands.clear();
+}
+
+NS_AX_BACKEND_END
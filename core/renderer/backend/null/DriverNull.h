@@ -0,0 +1,170 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../DriverBase.h"
+
+#include <vector>
+
+NS_AX_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * Deterministic counters collected by the null driver, everything is accumulated since the last
+ * DriverNull::resetCounters. Byte sizes are the sizes the engine asked the backend to upload, no GPU side
+ * padding or alignment is added.
+ */
+struct NullDriverCounters
+{
+    uint64_t frames         = 0;
+    uint64_t renderPasses   = 0;
+    uint64_t drawCalls      = 0;  ///< drawArrays + drawElements + drawElementsInstanced
+    uint64_t instancedDraws = 0;
+    uint64_t vertices       = 0;  ///< vertices submitted by drawArrays
+    uint64_t indices        = 0;  ///< indices submitted by drawElements and drawElementsInstanced
+    uint64_t instances      = 0;
+
+    uint64_t buffersCreated    = 0;
+    uint64_t bufferBytes       = 0;  ///< sizes of the created buffers
+    uint64_t bufferUploads     = 0;
+    uint64_t bufferUploadBytes = 0;
+
+    uint64_t texturesCreated    = 0;
+    uint64_t textureUploads     = 0;
+    uint64_t textureUploadBytes = 0;
+
+    uint64_t programsCreated     = 0;
+    uint64_t pipelineUpdates     = 0;
+    uint64_t programChanges      = 0;
+    uint64_t blendChanges        = 0;
+    uint64_t depthStencilUpdates = 0;
+    uint64_t viewportChanges     = 0;
+    uint64_t scissorChanges      = 0;
+    uint64_t cullModeChanges     = 0;
+    uint64_t vertexBufferBinds   = 0;
+    uint64_t indexBufferBinds    = 0;
+    uint64_t instanceBufferBinds = 0;
+    uint64_t textureBinds        = 0;
+    uint64_t uniformUploadBytes  = 0;
+    uint64_t readPixels          = 0;
+};
+
+enum class NullCommandType : uint8_t
+{
+    BEGIN_FRAME,
+    BEGIN_RENDER_PASS,
+    END_RENDER_PASS,
+    END_FRAME,
+    UPDATE_PIPELINE_STATE,
+    UPDATE_DEPTH_STENCIL_STATE,
+    SET_VIEWPORT,
+    SET_SCISSOR_RECT,
+    SET_CULL_MODE,
+    SET_WINDING,
+    SET_VERTEX_BUFFER,
+    SET_INDEX_BUFFER,
+    SET_INSTANCE_BUFFER,
+    DRAW_ARRAYS,
+    DRAW_ELEMENTS,
+    DRAW_ELEMENTS_INSTANCED,
+    READ_PIXELS,
+};
+
+/**
+ * A recorded command buffer call, only kept when recording is enabled.
+ * count: vertex or index count of draws, instances: instance count, bytes: index bytes of indexed draws plus the
+ * uniform bytes uploaded by the draw, or the size of the bound buffer for SET_*_BUFFER.
+ */
+struct NullCommand
+{
+    NullCommandType type;
+    uint32_t instances = 0;
+    uint64_t count     = 0;
+    uint64_t bytes     = 0;
+};
+
+/**
+ * A render driver which doesn't talk to any graphics API, it creates plain CPU side resources and counts what the
+ * renderer submits. Use it to run Director::drawScene offscreen in tests and benchmarks.
+ * @see DriverBase::setNullDriverEnabled
+ */
+class DriverNull : public DriverBase
+{
+public:
+    DriverNull();
+    ~DriverNull();
+
+    CommandBuffer* newCommandBuffer() override;
+    Buffer* newBuffer(std::size_t size, BufferType type, BufferUsage usage) override;
+    TextureBackend* newTexture(const TextureDescriptor& descriptor) override;
+    RenderTarget* newDefaultRenderTarget() override;
+    RenderTarget* newRenderTarget(TextureBackend* colorAttachment,
+                                  TextureBackend* depthAttachment,
+                                  TextureBackend* stencilAttachhment) override;
+    DepthStencilState* newDepthStencilState() override;
+    RenderPipeline* newRenderPipeline() override;
+    void setFrameBufferOnly(bool frameBufferOnly) override {}
+    Program* newProgram(std::string_view vertexShader, std::string_view fragmentShader) override;
+
+    const char* getVendor() const override;
+    const char* getRenderer() const override;
+    const char* getVersion() const override;
+    bool checkForFeatureSupported(FeatureType feature) override;
+    bool supportsRenderThread() const override { return true; }
+
+    /**
+     * Get the counters accumulated since the last reset.
+     */
+    const NullDriverCounters& getCounters() const { return _counters; }
+    NullDriverCounters& getCounters() { return _counters; }
+    void resetCounters();
+
+    /**
+     * Enable or disable the command log, disabled by default. The log is cleared by resetCounters.
+     */
+    void setRecordingEnabled(bool enabled) { _recording = enabled; }
+    bool isRecordingEnabled() const { return _recording; }
+    const std::vector<NullCommand>& getRecordedCommands() const { return _commands; }
+
+    void record(NullCommandType type, uint64_t count = 0, uint64_t bytes = 0, uint32_t instances = 0)
+    {
+        if (_recording)
+            _commands.emplace_back(NullCommand{type, instances, count, bytes});
+    }
+
+protected:
+    ShaderModule* newShaderModule(ShaderStage stage, std::string_view source) override;
+
+    NullDriverCounters _counters;
+    std::vector<NullCommand> _commands;
+    bool _recording = false;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
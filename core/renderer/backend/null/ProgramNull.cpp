@@ -0,0 +1,474 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ProgramNull.h"
+#include "base/Macros.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <vector>
+
+NS_AX_BACKEND_BEGIN
+
+namespace
+{
+using ShaderDefines = std::unordered_map<std::string_view, int>;
+
+struct TypeLayout
+{
+    unsigned int size;    // tight element size, the same as UtilsGL::getGLDataTypeSize
+    unsigned int extent;  // std140 footprint of one element
+    unsigned int align;   // std140 base alignment of one element
+    int slots;            // attribute locations used by one element
+};
+
+const TypeLayout* findTypeLayout(std::string_view type)
+{
+    static const std::pair<std::string_view, TypeLayout> layouts[] = {
+        {"float"sv, {4, 4, 4, 1}},    {"int"sv, {4, 4, 4, 1}},      {"uint"sv, {4, 4, 4, 1}},
+        {"bool"sv, {4, 4, 4, 1}},     {"vec2"sv, {8, 8, 8, 1}},     {"vec3"sv, {12, 12, 16, 1}},
+        {"vec4"sv, {16, 16, 16, 1}},  {"mat2"sv, {16, 32, 16, 2}},  {"mat3"sv, {36, 48, 16, 3}},
+        {"mat4"sv, {64, 64, 16, 4}},
+    };
+
+    // ivecN, uvecN and bvecN have the same layout as vecN
+    if (type.size() == 5 && type.substr(1, 3) == "vec"sv)
+        type.remove_prefix(1);
+
+    for (auto& layout : layouts)
+        if (layout.first == type)
+            return &layout.second;
+    return nullptr;
+}
+
+bool isSamplerType(std::string_view type)
+{
+    if (!type.empty() && (type[0] == 'i' || type[0] == 'u'))
+        type.remove_prefix(1);
+    return type.starts_with("sampler"sv);
+}
+
+bool isQualifier(std::string_view token)
+{
+    static constexpr std::string_view qualifiers[] = {"highp"sv,    "mediump"sv,       "lowp"sv,
+                                                      "flat"sv,     "smooth"sv,        "noperspective"sv,
+                                                      "centroid"sv, "invariant"sv,     "precise"sv,
+                                                      "const"sv,    "row_major"sv,     "column_major"sv};
+    return std::find(std::begin(qualifiers), std::end(qualifiers), token) != std::end(qualifiers);
+}
+
+inline bool isIdentifierChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+int toInt(std::string_view token, int defaultValue)
+{
+    int value = defaultValue;
+    std::from_chars(token.data(), token.data() + token.size(), value);
+    return value;
+}
+
+inline unsigned int alignTo(unsigned int value, unsigned int alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void tokenize(std::string_view text, std::vector<std::string_view>& tokens)
+{
+    tokens.clear();
+    for (size_t i = 0; i < text.size();)
+    {
+        if (isIdentifierChar(text[i]))
+        {
+            auto start = i;
+            while (i < text.size() && isIdentifierChar(text[i]))
+                ++i;
+            tokens.emplace_back(text.substr(start, i - start));
+        }
+        else
+        {
+            if (!isspace(static_cast<unsigned char>(text[i])))
+                tokens.emplace_back(text.substr(i, 1));
+            ++i;
+        }
+    }
+}
+
+void parseDefine(std::string_view directive, ShaderDefines& defines)
+{
+    std::vector<std::string_view> tokens;
+    tokenize(directive, tokens);
+    if (tokens.size() == 3 && tokens[0] == "define"sv && isdigit(static_cast<unsigned char>(tokens[2][0])))
+        defines.emplace(tokens[1], toInt(tokens[2], 0));
+}
+
+/**
+ * Evaluate an array size like 'SKINNING_JOINT_COUNT * 3', integer literals and macros joined by + - and *.
+ */
+int evalArraySize(const std::vector<std::string_view>& tokens, size_t first, size_t last, const ShaderDefines& defines)
+{
+    int sum = 0, product = 1, sign = 1;
+    for (auto index = first; index < last; ++index)
+    {
+        auto& token = tokens[index];
+        if (token == "+"sv || token == "-"sv)
+        {
+            sum += sign * product;
+            sign    = token == "+"sv ? 1 : -1;
+            product = 1;
+        }
+        else if (token != "*"sv)
+        {
+            auto it = defines.find(token);
+            product *= it != defines.end() ? it->second : toInt(token, 0);
+        }
+    }
+    return sum + sign * product;
+}
+
+/**
+ * Remove comments and preprocessor lines, what remains is a sequence of declarations and function bodies.
+ * Integer '#define's are collected since array sizes are often given by macros.
+ */
+std::string stripSource(std::string_view source, ShaderDefines& defines)
+{
+    std::string result;
+    result.reserve(source.size());
+
+    bool lineStart = true;
+    for (size_t i = 0; i < source.size();)
+    {
+        auto c = source[i];
+        if (c == '/' && i + 1 < source.size() && source[i + 1] == '/')
+        {
+            i = source.find('\n', i);
+        }
+        else if (c == '/' && i + 1 < source.size() && source[i + 1] == '*')
+        {
+            i = source.find("*/"sv, i + 2);
+            if (i != std::string_view::npos)
+                i += 2;
+            result.push_back(' ');
+        }
+        else if (c == '#' && lineStart)
+        {
+            auto end = source.find('\n', i);
+            parseDefine(source.substr(i + 1, end == std::string_view::npos ? end : end - i - 1), defines);
+            i = end;
+        }
+        else
+        {
+            if (c == '\n')
+                lineStart = true;
+            else if (c != ' ' && c != '\t' && c != '\r')
+                lineStart = false;
+            result.push_back(c);
+            ++i;
+        }
+
+        if (i == std::string_view::npos)
+            break;
+    }
+    return result;
+}
+
+/**
+ * Parse the layout qualifier and the qualifiers in front of the storage or type token.
+ * @return index of the first token after the qualifiers.
+ */
+size_t skipQualifiers(const std::vector<std::string_view>& tokens, size_t index, int* location = nullptr)
+{
+    while (index < tokens.size())
+    {
+        if (tokens[index] == "layout"sv)
+        {
+            for (++index; index < tokens.size() && tokens[index] != ")"sv; ++index)
+            {
+                if (location && tokens[index] == "location"sv && index + 2 < tokens.size())
+                    *location = toInt(tokens[index + 2], -1);
+            }
+            ++index;
+        }
+        else if (isQualifier(tokens[index]))
+            ++index;
+        else
+            break;
+    }
+    return index;
+}
+
+/**
+ * Visit the declarators of 'type name0[N], name1;' starting at the first name.
+ */
+template <typename _Fty>
+void forEachDeclarator(const std::vector<std::string_view>& tokens,
+                       size_t index,
+                       const ShaderDefines& defines,
+                       _Fty&& func)
+{
+    while (index < tokens.size())
+    {
+        auto name = tokens[index++];
+        int count = 1;
+        if (index < tokens.size() && tokens[index] == "["sv)
+        {
+            auto first = ++index;
+            while (index < tokens.size() && tokens[index] != "]"sv)
+                ++index;
+            count = (std::max)(evalArraySize(tokens, first, index, defines), 1);
+            ++index;
+        }
+        func(name, count);
+
+        // skip an initializer if any, up to the next declarator
+        while (index < tokens.size() && tokens[index] != ","sv)
+            ++index;
+        ++index;
+    }
+}
+}  // namespace
+
+ProgramNull::ProgramNull(std::string_view vertexShader, std::string_view fragmentShader)
+    : Program(vertexShader, fragmentShader)
+{
+    reflect(_vertexShader, ShaderStage::VERTEX);
+    reflect(_fragmentShader, ShaderStage::FRAGMENT);
+
+    setBuiltinLocations();
+}
+
+void ProgramNull::reflect(std::string_view source, ShaderStage stage)
+{
+    ShaderDefines defines;
+    auto text = stripSource(source, defines);
+
+    std::string_view code{text};
+    size_t start = 0;
+    for (size_t i = 0; i < code.size();)
+    {
+        auto c = code[i];
+        if (c == ';')
+        {
+            reflectDeclaration(code.substr(start, i - start), stage, defines);
+            start = ++i;
+        }
+        else if (c == '{')
+        {
+            // find the matching brace of a uniform block, struct or function body
+            auto head = code.substr(start, i - start);
+            auto end  = i + 1;
+            for (int depth = 1; end < code.size() && depth > 0; ++end)
+            {
+                if (code[end] == '{')
+                    ++depth;
+                else if (code[end] == '}')
+                    --depth;
+            }
+
+            std::vector<std::string_view> tokens;
+            tokenize(head, tokens);
+            if (std::find(tokens.begin(), tokens.end(), "uniform"sv) != tokens.end())
+            {
+                reflectUniformBlock(code.substr(i + 1, end - i - 2), defines);
+                // skip the instance name
+                end = (std::min)(code.find(';', end), code.size() - 1) + 1;
+            }
+            start = i = end;
+        }
+        else
+            ++i;
+    }
+}
+
+void ProgramNull::reflectDeclaration(std::string_view declaration, ShaderStage stage, const ShaderDefines& defines)
+{
+    std::vector<std::string_view> tokens;
+    tokenize(declaration, tokens);
+
+    int location = -1;
+    auto index   = skipQualifiers(tokens, 0, &location);
+    if (index + 2 >= tokens.size())
+        return;
+
+    auto storage = tokens[index];
+    index        = skipQualifiers(tokens, index + 1);
+    if (index + 1 >= tokens.size())
+        return;
+
+    auto type   = tokens[index++];
+    auto layout = findTypeLayout(type);
+
+    if (storage == "in"sv || storage == "attribute"sv)
+    {
+        if (stage != ShaderStage::VERTEX)
+            return;
+
+        forEachDeclarator(tokens, index, defines, [&](std::string_view name, int count) {
+            AttributeBindInfo info;
+            info.location = location >= 0 ? location : _nextAttribLocation;
+            info.size     = layout ? static_cast<int>(layout->size) * count : 0;
+            info.type     = 0;
+
+            auto slots           = (layout ? layout->slots : 1) * count;
+            _nextAttribLocation  = (std::max)(_nextAttribLocation, info.location + slots);
+            _activeAttribs[name] = info;
+            location             = -1;
+        });
+    }
+    else if (storage == "uniform"sv)
+    {
+        forEachDeclarator(tokens, index, defines, [&](std::string_view name, int count) {
+            UniformInfo info;
+            info.count = count;
+            if (isSamplerType(type))
+            {
+                info.location     = _nextUniformLocation;
+                info.bufferOffset = -1;
+                _nextUniformLocation += count;
+            }
+            else
+            {
+                // GLSL 100 style uniform: an absolute offset, the location is 0 so 'location + offset' of
+                // ProgramState::setVertexUniform resolves to the same address on all profiles
+                if (!layout)
+                    AXLOGW("ProgramNull: unknown uniform type {} of {}", type, name);
+                info.size         = layout ? layout->size : 16;
+                info.location     = 0;
+                info.bufferOffset = static_cast<unsigned int>(_totalBufferSize);
+                _totalBufferSize += info.size * count;
+            }
+            addUniform(name, info);
+        });
+    }
+}
+
+void ProgramNull::reflectUniformBlock(std::string_view body, const ShaderDefines& defines)
+{
+    auto blockLocation  = static_cast<int>(_totalBufferSize);
+    unsigned int offset = 0;
+
+    std::vector<std::string_view> tokens;
+    for (size_t start = 0, end; (end = body.find(';', start)) != std::string_view::npos; start = end + 1)
+    {
+        tokenize(body.substr(start, end - start), tokens);
+        auto index = skipQualifiers(tokens, 0);
+        if (index + 1 >= tokens.size())
+            continue;
+
+        auto type   = tokens[index++];
+        auto layout = findTypeLayout(type);
+        if (!layout)
+        {
+            AXLOGW("ProgramNull: unknown uniform block member type {}", type);
+            static const TypeLayout fallback{16, 16, 16, 1};
+            layout = &fallback;
+        }
+
+        forEachDeclarator(tokens, index, defines, [&](std::string_view name, int count) {
+            // std140: array elements are aligned and padded to vec4
+            auto align  = count > 1 ? alignTo(layout->align, 16) : layout->align;
+            auto extent = count > 1 ? alignTo(layout->extent, 16) * count : layout->extent;
+
+            offset = alignTo(offset, align);
+
+            UniformInfo info;
+            info.count        = count;
+            info.location     = blockLocation;
+            info.size         = layout->size;
+            info.bufferOffset = offset;
+            addUniform(name, info);
+
+            offset += extent;
+        });
+    }
+
+    _totalBufferSize += alignTo(offset, 16);
+}
+
+void ProgramNull::addUniform(std::string_view name, const UniformInfo& info)
+{
+    _activeUniformInfos[name] = info;
+
+    _maxLocation = _maxLocation <= info.location ? (info.location + 1) : _maxLocation;
+}
+
+void ProgramNull::setBuiltinLocations()
+{
+    std::fill(_builtinAttributeLocation, _builtinAttributeLocation + Attribute::ATTRIBUTE_MAX, -1);
+
+    _builtinAttributeLocation[Attribute::POSITION] = getAttributeLocation(ATTRIBUTE_NAME_POSITION);
+    _builtinAttributeLocation[Attribute::COLOR]    = getAttributeLocation(ATTRIBUTE_NAME_COLOR);
+    _builtinAttributeLocation[Attribute::TEXCOORD] = getAttributeLocation(ATTRIBUTE_NAME_TEXCOORD);
+    _builtinAttributeLocation[Attribute::NORMAL]   = getAttributeLocation(ATTRIBUTE_NAME_NORMAL);
+    _builtinAttributeLocation[Attribute::INSTANCE] = getAttributeLocation(ATTRIBUTE_NAME_INSTANCE);
+
+    _builtinUniformLocation[Uniform::MVP_MATRIX]   = getUniformLocation(UNIFORM_NAME_MVP_MATRIX);
+    _builtinUniformLocation[Uniform::TEXTURE]      = getUniformLocation(UNIFORM_NAME_TEXTURE);
+    _builtinUniformLocation[Uniform::TEXTURE1]     = getUniformLocation(UNIFORM_NAME_TEXTURE1);
+    _builtinUniformLocation[Uniform::TEXT_COLOR]   = getUniformLocation(UNIFORM_NAME_TEXT_COLOR);
+    _builtinUniformLocation[Uniform::EFFECT_COLOR] = getUniformLocation(UNIFORM_NAME_EFFECT_COLOR);
+    _builtinUniformLocation[Uniform::EFFECT_TYPE]  = getUniformLocation(UNIFORM_NAME_EFFECT_TYPE);
+}
+
+int ProgramNull::getAttributeLocation(Attribute name) const
+{
+    return _builtinAttributeLocation[name];
+}
+
+int ProgramNull::getAttributeLocation(std::string_view name) const
+{
+    auto iter = _activeAttribs.find(name);
+    return iter != _activeAttribs.end() ? iter->second.location : -1;
+}
+
+UniformLocation ProgramNull::getUniformLocation(backend::Uniform name) const
+{
+    return _builtinUniformLocation[name];
+}
+
+UniformLocation ProgramNull::getUniformLocation(std::string_view uniform) const
+{
+    UniformLocation uniformLocation;
+    auto iter = _activeUniformInfos.find(uniform);
+    if (iter != _activeUniformInfos.end())
+    {
+        uniformLocation.vertStage.location = iter->second.location;
+        uniformLocation.vertStage.offset   = iter->second.bufferOffset;
+    }
+    return uniformLocation;
+}
+
+#if AX_ENABLE_CACHE_TEXTURE_DATA
+const std::unordered_map<std::string, int> ProgramNull::getAllUniformsLocation() const
+{
+    std::unordered_map<std::string, int> locations;
+    for (auto& uniform : _activeUniformInfos)
+        locations.emplace(uniform.first, uniform.second.location);
+    return locations;
+}
+#endif
+
+NS_AX_BACKEND_END
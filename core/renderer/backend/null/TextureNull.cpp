@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TextureNull.h"
+#include "DriverNull.h"
+
+NS_AX_BACKEND_BEGIN
+
+namespace
+{
+uint64_t imageBytes(std::size_t width, std::size_t height, uint8_t bitsPerPixel)
+{
+    return static_cast<uint64_t>(width) * height * bitsPerPixel / 8;
+}
+}  // namespace
+
+Texture2DNull::Texture2DNull(NullDriverCounters& counters, const TextureDescriptor& descriptor) : _counters(counters)
+{
+    updateTextureDescriptor(descriptor);
+    ++_counters.texturesCreated;
+}
+
+void Texture2DNull::updateData(uint8_t* /*data*/,
+                               std::size_t width,
+                               std::size_t height,
+                               std::size_t /*level*/,
+                               int /*index*/)
+{
+    ++_counters.textureUploads;
+    _counters.textureUploadBytes += imageBytes(width, height, _bitsPerPixel);
+}
+
+void Texture2DNull::updateCompressedData(uint8_t* /*data*/,
+                                         std::size_t /*width*/,
+                                         std::size_t /*height*/,
+                                         std::size_t dataLen,
+                                         std::size_t /*level*/,
+                                         int /*index*/)
+{
+    ++_counters.textureUploads;
+    _counters.textureUploadBytes += dataLen;
+}
+
+void Texture2DNull::updateSubData(std::size_t /*xoffset*/,
+                                  std::size_t /*yoffset*/,
+                                  std::size_t width,
+                                  std::size_t height,
+                                  std::size_t /*level*/,
+                                  uint8_t* /*data*/,
+                                  int /*index*/)
+{
+    ++_counters.textureUploads;
+    _counters.textureUploadBytes += imageBytes(width, height, _bitsPerPixel);
+}
+
+void Texture2DNull::updateCompressedSubData(std::size_t /*xoffset*/,
+                                            std::size_t /*yoffset*/,
+                                            std::size_t /*width*/,
+                                            std::size_t /*height*/,
+                                            std::size_t dataLen,
+                                            std::size_t /*level*/,
+                                            uint8_t* /*data*/,
+                                            int /*index*/)
+{
+    ++_counters.textureUploads;
+    _counters.textureUploadBytes += dataLen;
+}
+
+TextureCubeNull::TextureCubeNull(NullDriverCounters& counters, const TextureDescriptor& descriptor)
+    : _counters(counters)
+{
+    updateTextureDescriptor(descriptor);
+    ++_counters.texturesCreated;
+}
+
+void TextureCubeNull::updateFaceData(TextureCubeFace /*side*/, void* /*data*/, int /*index*/)
+{
+    ++_counters.textureUploads;
+    _counters.textureUploadBytes += imageBytes(_width, _height, _bitsPerPixel);
+}
+
+NS_AX_BACKEND_END
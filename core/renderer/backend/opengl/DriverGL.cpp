@@ -35,6 +35,7 @@
 #include "RenderTargetGL.h"
 #include "MacrosGL.h"
 #include "renderer/backend/ProgramManager.h"
+#include "renderer/backend/null/DriverNull.h"
 #if !defined(__APPLE__) && AX_TARGET_PLATFORM != AX_PLATFORM_WINRT
 #    include "CommandBufferGLES2.h"
 #endif
@@ -84,7 +85,7 @@ static void GL_EnumAllExtensions(_Fty&& func)
 DriverBase* DriverBase::getInstance()
 {
     if (!_instance)
-        _instance = new DriverGL();
+        _instance = !_nullDriverEnabled ? static_cast<DriverBase*>(new DriverGL()) : new DriverNull();
 
     return _instance;
 }
@@ -539,6 +540,13 @@ bool DriverGL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::ASTC:
         featureSupported = checkASTCRenderability();
         break;
+    case FeatureType::INSTANCING:
+#if AX_GLES_PROFILE == 200
+        featureSupported = hasExtension("GL_EXT_instanced_arrays"sv) || hasExtension("GL_ANGLE_instanced_arrays"sv);
+#else
+        featureSupported = true;
+#endif
+        break;
     default:
         break;
     }
@@ -189,6 +189,7 @@ void Texture2DGL::updateSamplerDescriptor(const SamplerDescriptor& sampler)
 {
     bool isPow2 = ISPOW2(_width) && ISPOW2(_height);
     _textureInfo.applySampler(sampler, isPow2, _hasMipmaps, GL_TEXTURE_2D);
+    updateAddressModes(sampler);
 }
 
 void Texture2DGL::updateData(uint8_t* data, std::size_t width, std::size_t height, std::size_t level, int index)
@@ -355,6 +356,7 @@ TextureCubeGL::~TextureCubeGL()
 void TextureCubeGL::updateSamplerDescriptor(const SamplerDescriptor& sampler)
 {
     _textureInfo.applySampler(sampler, true, _hasMipmaps, GL_TEXTURE_CUBE_MAP);
+    updateAddressModes(sampler);
 }
 
 void TextureCubeGL::updateFaceData(TextureCubeFace side, void* data, int index)
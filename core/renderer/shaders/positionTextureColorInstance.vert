@@ -0,0 +1,34 @@
+#version 310 es
+
+layout (location = POSITION) in vec4 a_position;
+#if !defined(METAL)
+layout (location = TEXCOORD1) in mat4 a_instance;
+#endif
+layout (location = COLOR0) out vec4 v_color;
+layout (location = TEXCOORD0) out vec2 v_texCoord;
+
+layout(std140, binding = 0) uniform vs_ub {
+    mat4 u_MVPMatrix;
+};
+
+#if defined(METAL)
+layout(std140, binding = 1) buffer vs_inst {
+    mat4 u_instance[];
+};
+#endif
+
+// One quad per instance, a_position.xy is the corner of the unit quad:
+//   [0].xyz: origin, [1].xy: x edge, [1].zw: y edge, [2].xy: texture origin, [2].zw: texture size, [3]: color
+void main(void)
+{
+#if defined(METAL)
+    mat4 instance = u_instance[gl_InstanceIndex];
+#else
+    mat4 instance = a_instance;
+#endif
+    vec2 corner = a_position.xy;
+    vec3 position = instance[0].xyz + vec3(corner.x * instance[1].xy + corner.y * instance[1].zw, 0.0);
+    gl_Position = u_MVPMatrix * vec4(position, 1.0);
+    v_texCoord = instance[2].xy + corner * instance[2].zw;
+    v_color = instance[3];
+}
@@ -0,0 +1,42 @@
+#version 310 es
+precision highp float;
+precision highp int;
+
+layout(location = COLOR0) in vec4 v_color;
+layout(location = TEXCOORD0) in vec2 v_texCoord;
+layout(location = TEXCOORD1) in float v_texSlot;
+
+layout(binding = 0) uniform sampler2D u_tex0;
+layout(binding = 1) uniform sampler2D u_tex1;
+layout(binding = 2) uniform sampler2D u_tex2;
+layout(binding = 3) uniform sampler2D u_tex3;
+layout(binding = 4) uniform sampler2D u_tex4;
+layout(binding = 5) uniform sampler2D u_tex5;
+layout(binding = 6) uniform sampler2D u_tex6;
+layout(binding = 7) uniform sampler2D u_tex7;
+
+layout(location = SV_Target0) out vec4 FragColor;
+
+void main()
+{
+    // Sampler arrays can't be indexed dynamically on GLES2, select the slot with a branch chain
+    vec4 texColor;
+    if (v_texSlot < 0.5)
+        texColor = texture(u_tex0, v_texCoord);
+    else if (v_texSlot < 1.5)
+        texColor = texture(u_tex1, v_texCoord);
+    else if (v_texSlot < 2.5)
+        texColor = texture(u_tex2, v_texCoord);
+    else if (v_texSlot < 3.5)
+        texColor = texture(u_tex3, v_texCoord);
+    else if (v_texSlot < 4.5)
+        texColor = texture(u_tex4, v_texCoord);
+    else if (v_texSlot < 5.5)
+        texColor = texture(u_tex5, v_texCoord);
+    else if (v_texSlot < 6.5)
+        texColor = texture(u_tex6, v_texCoord);
+    else
+        texColor = texture(u_tex7, v_texCoord);
+
+    FragColor = v_color * texColor;
+}
@@ -0,0 +1,24 @@
+#version 310 es
+
+layout(location = POSITION) in vec4 a_position;
+layout(location = TEXCOORD0) in vec2 a_texCoord;
+layout(location = COLOR0) in vec4 a_color;
+
+layout(location = COLOR0) out vec4 v_color;
+layout(location = TEXCOORD0) out vec2 v_texCoord;
+layout(location = TEXCOORD1) out float v_texSlot;
+
+layout(std140) uniform vs_ub {
+    mat4 u_MVPMatrix;
+};
+
+void main()
+{
+    // The renderer stores the texture slot of a vertex as u + 2 * slot
+    float slot = floor(a_texCoord.x * 0.5);
+
+    gl_Position = u_MVPMatrix * a_position;
+    v_color = a_color;
+    v_texCoord = vec2(a_texCoord.x - slot * 2.0, a_texCoord.y);
+    v_texSlot = slot;
+}
@@ -445,7 +445,8 @@ void BoneNode::updateVertices()
         {
             _squareVertices[i] += _anchorPointInPoints;
         }
-        _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        _contentSizeDirty = true;
+        markTransformDirty();
     }
 }
 
@@ -455,7 +456,8 @@ void BoneNode::updateColor()
     {
         _vertexData[i].squareColor = _rackColor;
     }
-    _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+    _contentSizeDirty = true;
+    markTransformDirty();
 }
 
 void BoneNode::updateDisplayedColor(const ax::Color3B& /*parentColor*/)
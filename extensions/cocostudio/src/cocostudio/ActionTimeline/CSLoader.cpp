@@ -94,6 +94,8 @@
 
 #include "cocostudio/WidgetCallBackHandlerProtocol.h"
 
+#include <atomic>
+#include <chrono>
 #include <fstream>
 
 using namespace ax::ui;
@@ -252,6 +254,11 @@ CSLoader::CSLoader()
     CREATE_CLASS_NODE_READER_INFO(TextFieldExReader);
 }
 
+CSLoader::~CSLoader()
+{
+    cancelAllAsyncLoads();
+}
+
 void CSLoader::init()
 {
     using namespace std::placeholders;
@@ -1004,6 +1011,49 @@ inline void CSLoader::reconstructNestNode(ax::Node* node)
     }
 }
 
+bool CSLoader::isBuildIdSupported(const flatbuffers::String* csBuildId)
+{
+    int readerVersion = 0, writterVersion = 0;
+    // parse writter version
+    int revisionIndex = 0;
+    fast_split(csBuildId->c_str(), '.', [&](const char* start, const char* end) {
+        auto endv  = const_cast<char*>(end);
+        char charS = *endv;
+        switch (++revisionIndex)
+        {
+        case 3:
+            *endv          = '\0';
+            writterVersion = atoi(start);
+            *endv          = charS;
+            break;
+        }
+    });
+
+    // parse reader version
+    revisionIndex = 0;
+    fast_split(&_csBuildID.front(), '.', [&](char* start, char* end) {
+        auto endv  = const_cast<char*>(end);
+        char charS = *endv;
+        switch (++revisionIndex)
+        {
+        case 3:
+            *endv         = '\0';
+            readerVersion = atoi(start);
+            *endv         = charS;
+            break;
+        }
+    });
+#    if _AX_DEBUG > 0
+    auto prompt = fmt::format(
+            "{}{}{}{}{}{}{}{}{}{}", "The reader build id of your Cocos exported file(", csBuildId->c_str(),
+            ") and the reader build id in your axmol(", _csBuildID, ") are not match.\n",
+            "Please get the correct reader(build id ", csBuildId->c_str(), ")from ",
+            "https://github.com/axmolengine/axmol", " and replace it in your axmol");
+    AXASSERT(readerVersion >= writterVersion, prompt.c_str());
+#endif
+    return readerVersion >= writterVersion;
+}
+
 Node* CSLoader::nodeWithFlatBuffersFile(std::string_view fileName)
 {
     return nodeWithFlatBuffersFile(fileName, nullptr);
@@ -1027,67 +1077,17 @@ Node* CSLoader::nodeWithFlatBuffersFile(std::string_view fileName, const ccNodeL
     auto csparsebinary = GetCSParseBinary(buf.getBytes());
 
     auto csBuildId = csparsebinary->version();
-    if (csBuildId)
-    {
-        int readerVersion = 0, writterVersion = 0;
-        // parse writter version
-        int revisionIndex = 0;
-        fast_split(csBuildId->c_str(), '.', [&](const char* start, const char* end) {
-            auto endv  = const_cast<char*>(end);
-            char charS = *endv;
-            switch (++revisionIndex)
-            {
-            case 3:
-                *endv          = '\0';
-                writterVersion = atoi(start);
-                *endv          = charS;
-                break;
-            }
-        });
-
-        // parse reader version
-        revisionIndex = 0;
-        fast_split(&_csBuildID.front(), '.', [&](char* start, char* end) {
-            auto endv  = const_cast<char*>(end);
-            char charS = *endv;
-            switch (++revisionIndex)
-            {
-            case 3:
-                *endv         = '\0';
-                readerVersion = atoi(start);
-                *endv         = charS;
-                break;
-            }
-        });
-#    if _AX_DEBUG > 0
-        auto prompt = fmt::format(
-                "%s%s%s%s%s%s%s%s%s%s", "The reader build id of your Cocos exported file(", csBuildId->c_str(),
-                ") and the reader build id in your axmol(", _csBuildID, ") are not match.\n",
-                "Please get the correct reader(build id ", csBuildId->c_str(), ")from ",
-                "https://github.com/axmolengine/axmol", " and replace it in your axmol");
-        AXASSERT(readerVersion >= writterVersion, prompt.c_str());
-#endif
-        if (readerVersion < writterVersion)
-        {
-            auto exceptionMsg =
-                fmt::format("error: The csloader version not match, require version is:{}, but {} provided!",
-                                    csBuildId->c_str(), _csBuildID);
-            throw std::logic_error(exceptionMsg.c_str());
-            return nullptr;
-        }
+    if (csBuildId && !isBuildIdSupported(csBuildId))
+    {
+        auto exceptionMsg =
+            fmt::format("error: The csloader version not match, require version is:{}, but {} provided!",
+                        csBuildId->c_str(), _csBuildID);
+        throw std::logic_error(exceptionMsg.c_str());
+        return nullptr;
     }
 
     // decode plist
-    auto textures   = csparsebinary->textures();
-    int textureSize = textures->size();
-    for (int i = 0; i < textureSize; ++i)
-    {
-        std::string_view plist = textures->Get(i)->c_str();
-        if (!SpriteFrameCache::getInstance()->isSpriteFramesWithFileLoaded(plist))
-        {
-            SpriteFrameCache::getInstance()->addSpriteFramesWithFile(plist);
-        }
-    }
+    loadSpriteSheets(csparsebinary);
 
     Node* node = nodeWithFlatBuffers(csparsebinary->nodeTree(), callback);
 
@@ -1101,79 +1101,109 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree)
 
 Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const ccNodeLoadCallback& callback)
 {
-    if (nodetree == nullptr)
-        return nullptr;
+    Node* node = createSingleNodeWithFlatBuffers(nodetree, callback);
 
+    // If node is invalid, there is no necessity to process children of node.
+    if (!node)
     {
-        Node* node = nullptr;
-
-        std::string classname = nodetree->classname()->c_str();
-
-        auto options = nodetree->options();
+        return nullptr;
+    }
 
-        if (classname == "ProjectNode")
+    auto children = nodetree->children();
+    int size      = children->size();
+    for (int i = 0; i < size; ++i)
+    {
+        auto subNodeTree = children->Get(i);
+        Node* child      = nodeWithFlatBuffers(subNodeTree, callback);
+        if (child)
         {
-            auto reader             = ProjectNodeReader::getInstance();
-            auto projectNodeOptions = (ProjectNodeOptions*)options->data();
-            std::string filePath    = projectNodeOptions->fileName()->c_str();
+            addChildWithFlatBuffers(node, child);
 
-            cocostudio::timeline::ActionTimeline* action = nullptr;
-            if (!filePath.empty() && FileUtils::getInstance()->isFileExist(filePath))
-            {
-                Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
-                node     = createNode(buf, callback);
-                action   = createTimeline(buf, filePath);
-            }
-            else
-            {
-                node = Node::create();
-            }
-            reader->setPropsWithFlatBuffers(node, (const flatbuffers::Table*)options->data());
-            if (action)
+            if (callback)
             {
-                action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
-                node->runAction(action);
-                action->gotoFrameAndPause(0);
+                callback(child);
             }
         }
-        else if (classname == "SimpleAudio")
+    }
+
+    return node;
+}
+
+Node* CSLoader::createSingleNodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree,
+                                                const ccNodeLoadCallback& callback)
+{
+    if (nodetree == nullptr)
+        return nullptr;
+
+    Node* node = nullptr;
+
+    std::string classname = nodetree->classname()->c_str();
+
+    auto options = nodetree->options();
+
+    if (classname == "ProjectNode")
+    {
+        auto reader             = ProjectNodeReader::getInstance();
+        auto projectNodeOptions = (ProjectNodeOptions*)options->data();
+        std::string filePath    = projectNodeOptions->fileName()->c_str();
+
+        cocostudio::timeline::ActionTimeline* action = nullptr;
+        if (!filePath.empty() && FileUtils::getInstance()->isFileExist(filePath))
         {
-            node                 = Node::create();
-            auto reader          = ComAudioReader::getInstance();
-            Component* component = reader->createComAudioWithFlatBuffers((const flatbuffers::Table*)options->data());
-            if (component)
-            {
-                component->setName(PlayableFrame::PLAYABLE_EXTENTION);
-                node->addComponent(component);
-                reader->setPropsWithFlatBuffers(node, (const flatbuffers::Table*)options->data());
-            }
+            Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
+            node     = createNode(buf, callback);
+            action   = createTimeline(buf, filePath);
         }
         else
         {
-            std::string customClassName = nodetree->customClassName()->c_str();
-            if (customClassName != "")
-            {
-                classname = customClassName;
-            }
-            std::string readername{getGUIClassName(classname)};
-            readername.append("Reader");
-
-            NodeReaderProtocol* reader =
-                dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
-            if (reader == nullptr)
-                reader = dynamic_cast<NodeReaderProtocol*>(
-                    ObjectFactory::getInstance()->createObject("CustomRootNodeReader"));
-            if (reader != nullptr)
-            {
-                if (!customClassName.empty())
-                    reader->setCurrentCustomClassName(customClassName.c_str());
+            node = Node::create();
+        }
+        reader->setPropsWithFlatBuffers(node, (const flatbuffers::Table*)options->data());
+        if (action)
+        {
+            action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
+            node->runAction(action);
+            action->gotoFrameAndPause(0);
+        }
+    }
+    else if (classname == "SimpleAudio")
+    {
+        node                 = Node::create();
+        auto reader          = ComAudioReader::getInstance();
+        Component* component = reader->createComAudioWithFlatBuffers((const flatbuffers::Table*)options->data());
+        if (component)
+        {
+            component->setName(PlayableFrame::PLAYABLE_EXTENTION);
+            node->addComponent(component);
+            reader->setPropsWithFlatBuffers(node, (const flatbuffers::Table*)options->data());
+        }
+    }
+    else
+    {
+        std::string customClassName = nodetree->customClassName()->c_str();
+        if (customClassName != "")
+        {
+            classname = customClassName;
+        }
+        std::string readername{getGUIClassName(classname)};
+        readername.append("Reader");
 
-                node = reader->createNodeWithFlatBuffers((const flatbuffers::Table*)options->data());
-            }
-            else
-            {
-                auto exceptionMsg = fmt::format(
-                    R"(error: Missing custom reader class name:{}, please config at your project fiile xxx.xsxproj like follow:
+        NodeReaderProtocol* reader =
+            dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
+        if (reader == nullptr)
+            reader = dynamic_cast<NodeReaderProtocol*>(
+                ObjectFactory::getInstance()->createObject("CustomRootNodeReader"));
+        if (reader != nullptr)
+        {
+            if (!customClassName.empty())
+                reader->setCurrentCustomClassName(customClassName.c_str());
+
+            node = reader->createNodeWithFlatBuffers((const flatbuffers::Table*)options->data());
+        }
+        else
+        {
+            auto exceptionMsg = fmt::format(
+                R"(error: Missing custom reader class name:{}, please config at your project fiile xxx.xsxproj like follow:
     <Project>
       <publish-opts>
          <custom-readers>
@@ -1182,81 +1212,475 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const
       </publish-opts>
     </Project>
 )",
-                    readername, readername);
-                throw std::logic_error(exceptionMsg.c_str());
-            }
+                readername, readername);
+            throw std::logic_error(exceptionMsg.c_str());
+        }
 
-            Widget* widget = dynamic_cast<Widget*>(node);
-            if (widget)
-            {
-                auto callbackName = widget->getCallbackName();
-                auto callbackType = widget->getCallbackType();
+        Widget* widget = dynamic_cast<Widget*>(node);
+        if (widget)
+        {
+            auto callbackName = widget->getCallbackName();
+            auto callbackType = widget->getCallbackType();
 
-                bindCallback(callbackName, callbackType, widget, _rootNode);
-            }
+            bindCallback(callbackName, callbackType, widget, _rootNode);
+        }
 
-            /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
-            auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol*>(node);
-            if (callbackHandler)
-            {
-                _callbackHandlers.pushBack(node);
-                _rootNode = _callbackHandlers.back();
-            }
-            /**/
-            //        _loadingNodeParentHierarchy.emplace_back(node);
+        /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
+        auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol*>(node);
+        if (callbackHandler)
+        {
+            _callbackHandlers.pushBack(node);
+            _rootNode = _callbackHandlers.back();
         }
+        /**/
+        //        _loadingNodeParentHierarchy.emplace_back(node);
+    }
 
-        // If node is invalid, there is no necessity to process children of node.
-        if (!node)
+    return node;
+}
+
+void CSLoader::addChildWithFlatBuffers(Node* node, Node* child)
+{
+    if (auto pageView = dynamic_cast<PageView*>(node))
+    {
+        Layout* layout = dynamic_cast<Layout*>(child);
+        if (layout)
+        {
+            pageView->addPage(layout);
+        }
+    }
+    else if (auto listView = dynamic_cast<ListView*>(node))
+    {
+        Widget* widget = dynamic_cast<Widget*>(child);
+        if (widget)
         {
-            return nullptr;
+            listView->pushBackCustomItem(widget);
         }
+    }
+    else if (auto radioButtonGroup = dynamic_cast<RadioButtonGroup*>(node))
+    {
+        radioButtonGroup->addRadioButton(dynamic_cast<RadioButton*>(child));
+        radioButtonGroup->addChild(child);
+    }
+    else
+    {
+        node->addChild(child);
+    }
+}
 
-        auto children = nodetree->children();
-        int size      = children->size();
-        for (int i = 0; i < size; ++i)
+struct CSLoader::AsyncLoad
+{
+    enum class State
+    {
+        READING,
+        PRELOADING,
+        BUILDING,
+        DONE,
+    };
+
+    // A node being built, it's added to its parent once all its children are
+    struct BuildFrame
+    {
+        const flatbuffers::NodeTree* tree;
+        Node* node;
+        int nextChild;
+    };
+
+    unsigned int id;
+    std::string filename;
+    std::string fullPath;
+    ccNodeAsyncLoadCallback callback;
+    State state = State::READING;
+    std::atomic<bool> cancelled{false};
+
+    Data data;
+    const CSParseBinary* csparsebinary = nullptr;
+    std::vector<std::string> plists;    // sprite sheets to load before building
+    std::vector<std::string> textures;  // textures of plists, decoded by TextureCache::addImageAsync
+    int pendingTextures = 0;
+
+    std::vector<BuildFrame> stack;
+    Node* result = nullptr;
+    // CSLoader::_rootNode and _callbackHandlers of this load while another one is building
+    Node* rootNode = nullptr;
+    Vector<Node*> callbackHandlers;
+};
+
+static const CSParseBinary* verifyCSParseBinary(const Data& data)
+{
+    if (data.isNull())
+        return nullptr;
+
+    flatbuffers::Verifier verifier(data.getBytes(), data.getSize());
+    return VerifyCSParseBinaryBuffer(verifier) ? GetCSParseBinary(data.getBytes()) : nullptr;
+}
+
+void CSLoader::loadSpriteSheets(const CSParseBinary* csparsebinary)
+{
+    auto textures   = csparsebinary->textures();
+    int textureSize = textures->size();
+    for (int i = 0; i < textureSize; ++i)
+    {
+        std::string_view plist = textures->Get(i)->c_str();
+        if (!SpriteFrameCache::getInstance()->isSpriteFramesWithFileLoaded(plist))
         {
-            auto subNodeTree = children->Get(i);
-            Node* child      = nodeWithFlatBuffers(subNodeTree, callback);
-            if (child)
+            SpriteFrameCache::getInstance()->addSpriteFramesWithFile(plist);
+        }
+    }
+}
+
+unsigned int CSLoader::createNodeAsync(std::string_view filename, const ccNodeAsyncLoadCallback& callback)
+{
+    CSLoader* loader = CSLoader::getInstance();
+
+    auto load = std::make_shared<AsyncLoad>();
+    if (++loader->_nextAsyncLoadId == 0)
+        ++loader->_nextAsyncLoadId;
+    load->id       = loader->_nextAsyncLoadId;
+    load->filename = filename;
+    load->callback = callback;
+
+    if (loader->_asyncLoads.empty())
+    {
+        Director::getInstance()->getScheduler()->schedule(AX_CALLBACK_1(CSLoader::buildAsyncLoads, loader), loader,
+                                                          0, false, "CSLoader::buildAsyncLoads");
+    }
+    loader->_asyncLoads.emplace_back(load);
+
+    if (auto prototype = loader->getPrototype(filename))
+    {
+        // Already read and verified
+        load->data          = *prototype;
+        load->csparsebinary = GetCSParseBinary(load->data.getBytes());
+        loader->preloadAsyncLoad(load);
+    }
+    else
+    {
+        loader->readAsyncLoad(load);
+    }
+
+    return load->id;
+}
+
+void CSLoader::readAsyncLoad(std::shared_ptr<AsyncLoad> load)
+{
+    // FileUtils path lookups aren't thread safe, workers only get full paths
+    load->fullPath = FileUtils::getInstance()->fullPathForFilename(load->filename);
+    if (load->fullPath.empty())
+    {
+        AXLOGE("CSLoader::createNodeAsync - file not found: {}", load->filename);
+        load->state = AsyncLoad::State::DONE;
+        return;
+    }
+
+    Director::getInstance()->getJobSystem()->enqueue(
+        [load]() {
+            if (load->cancelled)
+                return;
+            load->data          = FileUtils::getInstance()->getDataFromFile(load->fullPath);
+            load->csparsebinary = verifyCSParseBinary(load->data);
+        },
+        [load]() {
+            // A live load implies a live loader, cancelAllAsyncLoads runs before it's destroyed
+            if (!load->cancelled)
+                _sharedCSLoader->preloadAsyncLoad(load);
+        });
+}
+
+void CSLoader::preloadAsyncLoad(std::shared_ptr<AsyncLoad> load)
+{
+    if (load->cancelled)
+        return;
+
+    auto csparsebinary = load->csparsebinary;
+    if (!csparsebinary)
+    {
+        AXLOGE("CSLoader::createNodeAsync - invalid csb file: {}", load->filename);
+        load->state = AsyncLoad::State::DONE;
+        return;
+    }
+    auto csBuildId = csparsebinary->version();
+    if (csBuildId && !isBuildIdSupported(csBuildId))
+    {
+        AXLOGE("CSLoader::createNodeAsync - {} requires reader version {}, but {} provided", load->filename,
+               csBuildId->c_str(), _csBuildID);
+        load->state = AsyncLoad::State::DONE;
+        return;
+    }
+
+    load->state     = AsyncLoad::State::PRELOADING;
+    auto textures   = csparsebinary->textures();
+    int textureSize = textures->size();
+    std::vector<std::string> plistPaths;
+    for (int i = 0; i < textureSize; ++i)
+    {
+        std::string_view plist = textures->Get(i)->c_str();
+        if (!SpriteFrameCache::getInstance()->isSpriteFramesWithFileLoaded(plist))
+        {
+            load->plists.emplace_back(plist);
+            plistPaths.emplace_back(FileUtils::getInstance()->fullPathForFilename(plist));
+        }
+    }
+    if (load->plists.empty())
+    {
+        startAsyncBuild(load);
+        return;
+    }
+
+    // Parse the sprite sheets on a worker to find their textures, the same way PlistSpriteSheetLoader does
+    Director::getInstance()->getJobSystem()->enqueue(
+        [load, plistPaths = std::move(plistPaths)]() {
+            for (size_t i = 0; i < plistPaths.size(); ++i)
             {
-                if (auto pageView = dynamic_cast<PageView*>(node))
-                {
-                    Layout* layout = dynamic_cast<Layout*>(child);
-                    if (layout)
-                    {
-                        pageView->addPage(layout);
-                    }
-                }
-                else if (auto listView = dynamic_cast<ListView*>(node))
+                auto& plist = load->plists[i];
+                if (load->cancelled || plistPaths[i].empty())
+                    continue;
+
+                auto dict = FileUtils::getInstance()->getValueMapFromFile(plistPaths[i]);
+                std::string texturePath;
+                auto metadata = dict.find("metadata");
+                if (metadata != dict.end() && metadata->second.getType() == Value::Type::MAP)
                 {
-                    Widget* widget = dynamic_cast<Widget*>(child);
-                    if (widget)
-                    {
-                        listView->pushBackCustomItem(widget);
-                    }
+                    auto& metadataDict = metadata->second.asValueMap();
+                    auto textureName   = metadataDict.find("textureFileName");
+                    if (textureName != metadataDict.end())
+                        texturePath = textureName->second.asString();
                 }
-                else if (auto radioButtonGroup = dynamic_cast<RadioButtonGroup*>(node))
+                if (!texturePath.empty())
                 {
-                    radioButtonGroup->addRadioButton(dynamic_cast<RadioButton*>(child));
-                    radioButtonGroup->addChild(child);
+                    texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
                 }
                 else
                 {
-                    node->addChild(child);
+                    texturePath = plist;
+                    auto pos    = texturePath.find_last_of('.');
+                    texturePath = texturePath.erase(pos) + ".png";
                 }
+                load->textures.emplace_back(std::move(texturePath));
+            }
+        },
+        [load]() {
+            if (load->cancelled)
+                return;
 
-                if (callback)
-                {
-                    callback(child);
-                }
+            load->pendingTextures = static_cast<int>(load->textures.size()) + 1;
+            for (auto& texture : load->textures)
+            {
+                Director::getInstance()->getTextureCache()->addImageAsync(texture, [load](Texture2D*) {
+                    if (--load->pendingTextures == 0 && !load->cancelled)
+                        _sharedCSLoader->startAsyncBuild(load);
+                });
             }
+            if (--load->pendingTextures == 0)
+                _sharedCSLoader->startAsyncBuild(load);
+        });
+}
+
+void CSLoader::startAsyncBuild(std::shared_ptr<AsyncLoad> load)
+{
+    if (load->cancelled)
+        return;
+
+    // The textures are cached by now, only the frame data is read here
+    for (auto& plist : load->plists)
+    {
+        if (!SpriteFrameCache::getInstance()->isSpriteFramesWithFileLoaded(plist))
+            SpriteFrameCache::getInstance()->addSpriteFramesWithFile(plist);
+    }
+    load->state = AsyncLoad::State::BUILDING;
+}
+
+void CSLoader::buildAsyncLoads(float /*dt*/)
+{
+    using clock   = std::chrono::steady_clock;
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(
+                                       std::chrono::duration<float>(std::max(_asyncBuildBudget, 0.0f)));
+
+    for (size_t i = 0; i < _asyncLoads.size();)
+    {
+        auto load = _asyncLoads[i];
+        if (load->state == AsyncLoad::State::BUILDING && clock::now() < deadline)
+        {
+            std::swap(_rootNode, load->rootNode);
+            std::swap(_callbackHandlers, load->callbackHandlers);
+            try
+            {
+                // At least one node per frame, so a tiny budget still makes progress
+                while (!buildAsyncLoadStep(*load) && clock::now() < deadline)
+                    ;
+            }
+            catch (const std::exception& e)
+            {
+                AXLOGE("CSLoader::createNodeAsync - failed to build {}: {}", load->filename, e.what());
+                releaseAsyncLoad(*load);
+                load->state = AsyncLoad::State::DONE;
+            }
+            std::swap(_rootNode, load->rootNode);
+            std::swap(_callbackHandlers, load->callbackHandlers);
+        }
+
+        if (load->state != AsyncLoad::State::DONE)
+        {
+            ++i;
+            continue;
+        }
+
+        // Removed before the callback, which may start or cancel loads
+        _asyncLoads.erase(_asyncLoads.begin() + i);
+        load->data.clear();
+        if (load->callback)
+            load->callback(load->result);
+    }
+
+    if (_asyncLoads.empty())
+        Director::getInstance()->getScheduler()->unschedule("CSLoader::buildAsyncLoads", this);
+}
+
+bool CSLoader::buildAsyncLoadStep(AsyncLoad& load)
+{
+    // The nodes being built aren't in the scene yet, they are retained to outlive the autorelease pool
+    if (load.stack.empty())
+    {
+        auto nodetree = load.csparsebinary->nodeTree();
+        auto node     = createSingleNodeWithFlatBuffers(nodetree, nullptr);
+        if (!node)
+        {
+            load.state = AsyncLoad::State::DONE;
+            return true;
+        }
+        node->retain();
+        load.stack.push_back({nodetree, node, 0});
+        return false;
+    }
+
+    auto& frame   = load.stack.back();
+    auto children = frame.tree->children();
+    if (frame.nextChild < static_cast<int>(children->size()))
+    {
+        auto subNodeTree = children->Get(frame.nextChild++);
+        auto child       = createSingleNodeWithFlatBuffers(subNodeTree, nullptr);
+        if (child)
+        {
+            child->retain();
+            load.stack.push_back({subNodeTree, child, 0});
         }
+        return false;
+    }
+
+    auto node = frame.node;
+    load.stack.pop_back();
+    if (load.stack.empty())
+    {
+        reconstructNestNode(node);
+        node->autorelease();
+        load.result = node;
+        load.state  = AsyncLoad::State::DONE;
+        return true;
+    }
+
+    addChildWithFlatBuffers(load.stack.back().node, node);
+    node->release();
+    return false;
+}
+
+void CSLoader::releaseAsyncLoad(AsyncLoad& load)
+{
+    for (auto& frame : load.stack)
+        frame.node->release();
+    load.stack.clear();
+    load.callbackHandlers.clear();
+    load.rootNode = nullptr;
+    load.data.clear();
+}
 
-        //    _loadingNodeParentHierarchy.pop_back();
+void CSLoader::cancelAsyncLoad(unsigned int loadId)
+{
+    if (!_sharedCSLoader)
+        return;
+
+    auto& loads = _sharedCSLoader->_asyncLoads;
+    auto it     = std::find_if(loads.begin(), loads.end(), [loadId](auto& load) { return load->id == loadId; });
+    if (it == loads.end())
+        return;
+
+    // Work still running on other threads sees the flag and drops its result
+    (*it)->cancelled = true;
+    _sharedCSLoader->releaseAsyncLoad(**it);
+    loads.erase(it);
+}
+
+void CSLoader::cancelAllAsyncLoads()
+{
+    if (!_sharedCSLoader || _sharedCSLoader->_asyncLoads.empty())
+        return;
+
+    auto loads = std::move(_sharedCSLoader->_asyncLoads);
+    _sharedCSLoader->_asyncLoads.clear();
+    for (auto& load : loads)
+    {
+        load->cancelled = true;
+        _sharedCSLoader->releaseAsyncLoad(*load);
+    }
+    Director::getInstance()->getScheduler()->unschedule("CSLoader::buildAsyncLoads", _sharedCSLoader);
+}
+
+const Data* CSLoader::getPrototype(std::string_view filename)
+{
+    auto it = _prototypes.find(filename);
+    return it != _prototypes.end() ? &it->second : nullptr;
+}
+
+bool CSLoader::addPrototype(std::string_view filename)
+{
+    CSLoader* loader = CSLoader::getInstance();
+    if (loader->getPrototype(filename))
+        return true;
 
-        return node;
+    auto data          = FileUtils::getInstance()->getDataFromFile(filename);
+    auto csparsebinary = verifyCSParseBinary(data);
+    if (!csparsebinary)
+    {
+        AXLOGE("CSLoader::addPrototype - can't read csb file: {}", filename);
+        return false;
     }
+    auto csBuildId = csparsebinary->version();
+    if (csBuildId && !loader->isBuildIdSupported(csBuildId))
+    {
+        AXLOGE("CSLoader::addPrototype - {} requires reader version {}, but {} provided", filename, csBuildId->c_str(),
+               loader->_csBuildID);
+        return false;
+    }
+
+    loader->loadSpriteSheets(csparsebinary);
+    loader->_prototypes.emplace(filename, std::move(data));
+    return true;
+}
+
+Node* CSLoader::createNodeFromPrototype(std::string_view filename)
+{
+    CSLoader* loader = CSLoader::getInstance();
+    if (!addPrototype(filename))
+        return nullptr;
+
+    auto csparsebinary = GetCSParseBinary(loader->getPrototype(filename)->getBytes());
+    // The sprite sheets may have been purged since the prototype was added
+    loader->loadSpriteSheets(csparsebinary);
+
+    Node* node = loader->nodeWithFlatBuffers(csparsebinary->nodeTree(), nullptr);
+    loader->reconstructNestNode(node);
+    return node;
+}
+
+void CSLoader::removePrototype(std::string_view filename)
+{
+    if (_sharedCSLoader)
+        _sharedCSLoader->_prototypes.erase(filename);
+}
+
+void CSLoader::removeAllPrototypes()
+{
+    if (_sharedCSLoader)
+        _sharedCSLoader->_prototypes.clear();
 }
 
 bool CSLoader::bindCallback(std::string_view callbackName,
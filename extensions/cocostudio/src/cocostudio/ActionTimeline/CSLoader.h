@@ -30,12 +30,16 @@
 
 #include "base/ObjectFactory.h"
 #include "base/Data.h"
+#include "base/hlookup.h"
 #include "ui/UIWidget.h"
 
 #include "flatbuffers/flatbuffers.h"
 
+#include <memory>
+
 namespace flatbuffers
 {
+struct CSParseBinary;
 struct NodeTree;
 
 struct WidgetOptions;
@@ -67,6 +71,7 @@ namespace ax
 {
 
 typedef std::function<void(Object*)> ccNodeLoadCallback;
+typedef std::function<void(Node*)> ccNodeAsyncLoadCallback;
 
 class CCS_DLL CSLoader
 {
@@ -75,6 +80,7 @@ public:
     static void destroyInstance();
 
     CSLoader();
+    ~CSLoader();
 
     void init();
 
@@ -118,11 +124,61 @@ public:
     ax::Node* createNodeWithFlatBuffersForSimulator(std::string_view filename);
     ax::Node* nodeWithFlatBuffersForSimulator(const flatbuffers::NodeTree* nodetree);
 
+    /**
+     * Loads a csb file without blocking the axmol thread. Reading and verifying the file, and decoding the textures
+     * of its sprite sheets run on worker threads. The nodes are built on the axmol thread, at most
+     * getAsyncBuildBudget() seconds per frame, so a big layout is spread over a few frames instead of a hitch.
+     * Nested project nodes are built synchronously within the slice that reaches them.
+     *
+     * @param filename The csb file.
+     * @param callback Called on the axmol thread with the autoreleased root node, or nullptr when loading failed.
+     * It isn't called for a cancelled load.
+     * @return The id to cancel the load with, never 0.
+     */
+    static unsigned int createNodeAsync(std::string_view filename, const ccNodeAsyncLoadCallback& callback);
+
+    /** Cancels a load started by createNodeAsync, the nodes built so far are released. */
+    static void cancelAsyncLoad(unsigned int loadId);
+    static void cancelAllAsyncLoads();
+
+    /** Max time in seconds the async loads spend building nodes each frame, 0.004 by default. */
+    void setAsyncBuildBudget(float seconds) { _asyncBuildBudget = seconds; }
+    float getAsyncBuildBudget() const { return _asyncBuildBudget; }
+
+    /**
+     * Keeps a csb file read, verified and its sprite sheets loaded, so createNodeFromPrototype only builds the nodes.
+     * Meant for layouts instantiated over and over, like list cells and popups.
+     *
+     * @return false if the file can't be read or isn't a valid csb file.
+     */
+    static bool addPrototype(std::string_view filename);
+    /** Instantiates a prototype, the prototype is added first if needed. */
+    static ax::Node* createNodeFromPrototype(std::string_view filename);
+    static void removePrototype(std::string_view filename);
+    static void removeAllPrototypes();
+
 protected:
+    struct AsyncLoad;
     ax::Node* createNodeWithFlatBuffersFile(std::string_view filename, const ccNodeLoadCallback& callback);
     ax::Node* nodeWithFlatBuffersFile(std::string_view fileName, const ccNodeLoadCallback& callback);
     ax::Node* nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const ccNodeLoadCallback& callback);
 
+    // Creates the node of a tree entry without its children
+    ax::Node* createSingleNodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree,
+                                              const ccNodeLoadCallback& callback);
+    void addChildWithFlatBuffers(ax::Node* node, ax::Node* child);
+    bool isBuildIdSupported(const flatbuffers::String* csBuildId);
+    void loadSpriteSheets(const flatbuffers::CSParseBinary* csparsebinary);
+
+    const Data* getPrototype(std::string_view filename);
+
+    void readAsyncLoad(std::shared_ptr<AsyncLoad> load);
+    void preloadAsyncLoad(std::shared_ptr<AsyncLoad> load);
+    void startAsyncBuild(std::shared_ptr<AsyncLoad> load);
+    void buildAsyncLoads(float dt);
+    bool buildAsyncLoadStep(AsyncLoad& load);
+    void releaseAsyncLoad(AsyncLoad& load);
+
     ax::Node* loadNode(const rapidjson::Value& json);
 
     void locateNodeWithMulresPosition(ax::Node* node, const rapidjson::Value& json);
@@ -172,6 +228,12 @@ protected:
     ax::Vector<ax::Node*> _callbackHandlers;
 
     std::string _csBuildID;
+
+    hlookup::string_map<Data> _prototypes;
+
+    std::vector<std::shared_ptr<AsyncLoad>> _asyncLoads;
+    unsigned int _nextAsyncLoadId = 0;
+    float _asyncBuildBudget       = 0.004f;
 };
 
 }
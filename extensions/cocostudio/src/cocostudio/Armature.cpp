@@ -327,7 +327,7 @@ void Armature::setAnchorPoint(const Vec2& point)
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x - _offsetPoint.x,
                                  _contentSize.height * _anchorPoint.y - _offsetPoint.y);
         _realAnchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
-        _transformDirty = _inverseDirty = true;
+        markTransformDirty();
     }
 }
 
@@ -79,7 +79,11 @@ Skin* Skin::create(std::string_view pszFileName)
     return nullptr;
 }
 
-Skin::Skin() : _bone(nullptr), _armature(nullptr), _displayName(), _skinTransform(Mat4::IDENTITY) {}
+Skin::Skin() : _bone(nullptr), _armature(nullptr), _displayName(), _skinTransform(Mat4::IDENTITY)
+{
+    // updateArmatureTransform follows the bone, which doesn't mark the node dirty
+    setVolatileTransform(true);
+}
 
 bool Skin::initWithSpriteFrameName(std::string_view spriteFrameName)
 {
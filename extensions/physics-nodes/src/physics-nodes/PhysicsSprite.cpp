@@ -460,8 +460,8 @@ void PhysicsSprite::afterUpdate(EventCustom* /*event*/)
 {
     syncPhysicsTransform();
 
-    _transformDirty   = false;
-    _transformUpdated = true;
+    // report the synced transform, e.g. to the transform system of the scene
+    setNodeToParentTransform(_transform);
     setDirtyRecursively(true);
 }
 
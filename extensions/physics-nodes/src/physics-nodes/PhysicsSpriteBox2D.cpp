@@ -344,8 +344,8 @@ void PhysicsSpriteBox2D::afterUpdate(EventCustom* /*event*/)
 {
     syncPhysicsTransform();
 
-    _transformDirty   = false;
-    _transformUpdated = true;
+    // report the synced transform, e.g. to the transform system of the scene
+    setNodeToParentTransform(_transform);
     setDirtyRecursively(true);
 }
 
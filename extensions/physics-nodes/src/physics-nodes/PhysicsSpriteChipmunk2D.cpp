@@ -321,8 +321,8 @@ void PhysicsSpriteChipmunk2D::afterUpdate(EventCustom* /*event*/)
 {
     syncPhysicsTransform();
 
-    _transformDirty   = false;
-    _transformUpdated = true;
+    // report the synced transform, e.g. to the transform system of the scene
+    setNodeToParentTransform(_transform);
     setDirtyRecursively(true);
 }
 
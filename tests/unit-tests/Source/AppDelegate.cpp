@@ -28,6 +28,8 @@
 #include <string>
 #include "doctest.h"
 #include "AppDelegate.h"
+#include "Benchmark.h"
+#include "platform/GLViewNull.h"
 
 using namespace ax;
 
@@ -95,7 +97,14 @@ void AppDelegate::applicationWillEnterForeground()
 
 
 int AppDelegate::run(int argc, char** argv) {
-    AXLOGI("Running unit tests...\n");
+    // Tests and benchmarks run without a GL context, the null driver has to be selected before anything creates
+    // the driver
+    backend::DriverBase::setNullDriverEnabled(true);
+    bool benchmarks = std::any_of(argv + 1, argv + argc, [](const char* arg) {
+        return std::string_view{arg}.substr(0, 11) == "--benchmark";
+    });
+
+    AXLOGI("Running {}...\n", benchmarks ? "benchmarks" : "unit tests");
     fflush(stdout);
     AXLOGI("Default resource path: {}\n", FileUtils::getInstance()->getDefaultResourceRootPath());
     AXLOGI("Writable path: {}\n", FileUtils::getInstance()->getWritablePath());
@@ -107,6 +116,12 @@ int AppDelegate::run(int argc, char** argv) {
 
     ax::Director::getInstance()->init();
 
+    if (benchmarks) {
+        auto director = Director::getInstance();
+        director->setGLView(GLViewNull::create("unit-benchmarks", Size(gWindowSize.x, gWindowSize.y)));
+        return runBenchmarks(argc, argv);
+    }
+
     doctest::Context context;
 
     //context.addFilter("test-case-exclude", "*math*"); // exclude test cases with "math" in their name
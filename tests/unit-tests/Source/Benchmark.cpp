@@ -0,0 +1,342 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+
+#include "axmol.h"
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+using namespace std::chrono;
+
+
+namespace {
+    struct BenchmarkInfo {
+        const char* name;
+        BenchmarkFunc func;
+    };
+
+    std::vector<BenchmarkInfo>& registry() {
+        static std::vector<BenchmarkInfo> benchmarks;
+        return benchmarks;
+    }
+
+    constexpr nanoseconds WARMUP_TIME = milliseconds(50);
+}
+
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* name, BenchmarkFunc func) {
+    registry().push_back({name, func});
+}
+
+
+BenchmarkState::BenchmarkState(int sampleCount, nanoseconds sampleTime)
+    : _sampleCount(std::max(sampleCount, 1)), _sampleTime(sampleTime) {
+    _samples.reserve(_sampleCount);
+}
+
+
+bool BenchmarkState::nextBatch() {
+    // Only look at the clock at batch boundaries so the loop overhead stays a counter compare
+    auto now = clock::now();
+    auto elapsed = now - _batchStart - _paused;
+
+    switch (_phase) {
+    case Phase::START:
+        _phase     = Phase::WARMUP;
+        _batchSize = 1;
+        break;
+    case Phase::WARMUP:
+        if (elapsed < WARMUP_TIME) {
+            _batchSize *= 2;
+        } else {
+            // Size the batches so one sample takes about _sampleTime
+            auto perIteration = std::max<int64_t>(duration_cast<nanoseconds>(elapsed).count() / _batchSize, 1);
+            _batchSize        = std::max<int64_t>(_sampleTime.count() / perIteration, 1);
+            _phase            = Phase::MEASURE;
+        }
+        break;
+    case Phase::MEASURE:
+        _samples.push_back(double(duration_cast<nanoseconds>(elapsed).count()) / _batchSize);
+        _totalIterations += _batchSize;
+        if (int(_samples.size()) >= _sampleCount)
+            _phase = Phase::DONE;
+        break;
+    case Phase::DONE:
+        break;
+    }
+
+    if (_phase == Phase::DONE || !_skipReason.empty()) {
+        _phase = Phase::DONE;
+        return false;
+    }
+
+    _iteration  = 0;
+    _paused     = {};
+    _batchStart = clock::now();
+    return true;
+}
+
+
+void BenchmarkState::pauseTiming() {
+    _pauseStart = clock::now();
+}
+
+
+void BenchmarkState::resumeTiming() {
+    _paused += clock::now() - _pauseStart;
+}
+
+
+void BenchmarkState::setCounter(std::string_view name, double value) {
+    auto it = std::find_if(_counters.begin(), _counters.end(), [&](auto& c) { return c.first == name; });
+    if (it != _counters.end())
+        it->second = value;
+    else
+        _counters.emplace_back(name, value);
+}
+
+
+void BenchmarkState::skip(std::string_view reason) {
+    _skipReason = reason;
+}
+
+
+BenchmarkState::Result BenchmarkState::finish(std::string_view name) const {
+    Result result;
+    result.name              = name;
+    result.skipReason        = _skipReason;
+    result.iterations        = _totalIterations;
+    result.itemsPerIteration = _itemsPerIteration;
+    result.counters          = _counters;
+    if (!_skipReason.empty() || _samples.empty())
+        return result;
+
+    auto sorted = _samples;
+    std::sort(sorted.begin(), sorted.end());
+    auto n          = sorted.size();
+    result.medianNs = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    result.minNs    = sorted.front();
+    result.meanNs   = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+    double variance = 0;
+    for (auto s : sorted)
+        variance += (s - result.meanNs) * (s - result.meanNs);
+    result.stddevNs = n > 1 ? std::sqrt(variance / (n - 1)) : 0.0;
+    return result;
+}
+
+
+namespace {
+    struct Options {
+        bool enabled = false;
+        std::string filter;
+        std::string outPath;
+        std::string baselinePath;
+        double tolerance = 0.1;
+        int samples = 10;
+    };
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        auto value = [](std::string_view arg, std::string_view option, std::string_view& out) {
+            if (arg.substr(0, option.size()) != option)
+                return false;
+            out = arg.substr(option.size());
+            return true;
+        };
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i], v;
+            if (arg == "--benchmark") {
+                options.enabled = true;
+            } else if (value(arg, "--benchmark=", v)) {
+                options.enabled = true;
+                options.filter  = v;
+            } else if (value(arg, "--benchmark-out=", v)) {
+                options.outPath = v;
+            } else if (value(arg, "--benchmark-baseline=", v)) {
+                options.baselinePath = v;
+            } else if (value(arg, "--benchmark-tolerance=", v)) {
+                options.tolerance = std::atof(std::string{v}.c_str()) / 100.0;
+            } else if (value(arg, "--benchmark-samples=", v)) {
+                options.samples = std::atoi(std::string{v}.c_str());
+            }
+        }
+        return options;
+    }
+
+    std::string toJson(const std::vector<BenchmarkState::Result>& results, const Options& options) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("context");
+        writer.StartObject();
+        writer.Key("engine");
+        writer.String(ax::axmolVersion());
+        writer.Key("samples");
+        writer.Int(options.samples);
+        writer.Key("filter");
+        writer.String(options.filter.c_str());
+        writer.EndObject();
+
+        writer.Key("benchmarks");
+        writer.StartArray();
+        for (auto& r : results) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(r.name.c_str());
+            if (!r.skipReason.empty()) {
+                writer.Key("skipped");
+                writer.String(r.skipReason.c_str());
+                writer.EndObject();
+                continue;
+            }
+            writer.Key("iterations");
+            writer.Int64(r.iterations);
+            writer.Key("ns_per_iter");
+            writer.Double(r.medianNs);
+            writer.Key("min_ns");
+            writer.Double(r.minNs);
+            writer.Key("mean_ns");
+            writer.Double(r.meanNs);
+            writer.Key("stddev_ns");
+            writer.Double(r.stddevNs);
+            if (r.itemsPerIteration > 0 && r.medianNs > 0) {
+                writer.Key("items_per_second");
+                writer.Double(r.itemsPerIteration * 1e9 / r.medianNs);
+            }
+            writer.Key("counters");
+            writer.StartObject();
+            for (auto& [name, value] : r.counters) {
+                writer.Key(name.c_str());
+                writer.Double(value);
+            }
+            writer.EndObject();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        return buffer.GetString();
+    }
+
+    /// Returns the number of regressions against the baseline.
+    int compareWithBaseline(const std::vector<BenchmarkState::Result>& results, const Options& options) {
+        auto content = ax::FileUtils::getInstance()->getStringFromFile(options.baselinePath);
+        rapidjson::Document doc;
+        doc.Parse(content.c_str(), content.size());
+        if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("benchmarks") || !doc["benchmarks"].IsArray()) {
+            AXLOGE("Can't read benchmark baseline: {}", options.baselinePath);
+            return 1;
+        }
+
+        std::map<std::string, const rapidjson::Value*, std::less<>> baseline;
+        for (auto& b : doc["benchmarks"].GetArray()) {
+            if (b.IsObject() && b.HasMember("name") && b.HasMember("ns_per_iter"))
+                baseline.emplace(b["name"].GetString(), &b);
+        }
+
+        int regressions = 0;
+        for (auto& r : results) {
+            auto it = baseline.find(r.name);
+            if (!r.skipReason.empty() || it == baseline.end())
+                continue;
+
+            auto& b     = *it->second;
+            auto before = b["ns_per_iter"].GetDouble();
+            auto change = before > 0 ? r.medianNs / before - 1.0 : 0.0;
+            if (change > options.tolerance) {
+                ++regressions;
+                AXLOGE("REGRESSION {}: {:.0f} ns -> {:.0f} ns ({:+.1f}%)", r.name, before, r.medianNs, change * 100);
+            } else if (change < -options.tolerance) {
+                AXLOGI("improved {}: {:.0f} ns -> {:.0f} ns ({:+.1f}%)", r.name, before, r.medianNs, change * 100);
+            }
+
+            // Counters are deterministic, so any increase is a change in behavior rather than noise
+            if (!b.HasMember("counters") || !b["counters"].IsObject())
+                continue;
+            auto& counters = b["counters"];
+            for (auto& [name, value] : r.counters) {
+                auto c = counters.FindMember(name.c_str());
+                if (c == counters.MemberEnd() || !c->value.IsNumber())
+                    continue;
+                auto prev = c->value.GetDouble();
+                if (value > prev) {
+                    ++regressions;
+                    AXLOGE("REGRESSION {} counter {}: {} -> {}", r.name, name, prev, value);
+                } else if (value < prev) {
+                    AXLOGI("improved {} counter {}: {} -> {}", r.name, name, prev, value);
+                }
+            }
+        }
+        return regressions;
+    }
+}
+
+
+int runBenchmarks(int argc, char** argv) {
+    auto options = parseOptions(argc, argv);
+    if (!options.enabled)
+        return -1;
+
+    auto& benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](auto& a, auto& b) { return std::string_view{a.name} < std::string_view{b.name}; });
+
+    std::vector<BenchmarkState::Result> results;
+    for (auto& info : benchmarks) {
+        if (!options.filter.empty() && std::string_view{info.name}.find(options.filter) == std::string_view::npos)
+            continue;
+
+        BenchmarkState state(options.samples, milliseconds(20));
+        info.func(state);
+        auto& r = results.emplace_back(state.finish(info.name));
+        if (!r.skipReason.empty()) {
+            AXLOGI("{:<48} skipped: {}", r.name, r.skipReason);
+            continue;
+        }
+        AXLOGI("{:<48} {:>14.1f} ns/iter  (min {:.1f}, stddev {:.1f}, {} iterations)", r.name, r.medianNs,
+               r.minNs, r.stddevNs, r.iterations);
+        for (auto& [name, value] : r.counters)
+            AXLOGI("    {} = {}", name, value);
+        fflush(stdout);
+    }
+
+    if (!options.outPath.empty()) {
+        auto json = toJson(results, options);
+        if (!ax::FileUtils::getInstance()->writeStringToFile(json, options.outPath))
+            AXLOGE("Can't write benchmark results: {}", options.outPath);
+    }
+
+    int regressions = 0;
+    if (!options.baselinePath.empty()) {
+        regressions = compareWithBaseline(results, options);
+        AXLOGI("{} regression(s) against {}", regressions, options.baselinePath);
+    }
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/// Micro-benchmark support for the unit-tests app, run with `unit-tests --benchmark`.
+///
+/// @code
+///    AX_BENCHMARK("2d/Node/visit_deep_hierarchy") {
+///        auto root = buildHierarchy();       // setup isn't measured
+///        while (state.keepRunning()) {
+///            root->setRotation(angle += 1);  // measured loop body
+///            root->visit(renderer, Mat4::IDENTITY, 0);
+///        }
+///        state.setItemsPerIteration(nodeCount);
+///    }
+/// @endcode
+///
+/// Every benchmark runs a warm up, then collects a number of samples which each time a batch of iterations.
+/// Results are printed, and optionally written as JSON and compared against a baseline JSON file.
+class BenchmarkState {
+public:
+    explicit BenchmarkState(int sampleCount, std::chrono::nanoseconds sampleTime);
+
+    /// Returns true while the measured loop body should run again.
+    bool keepRunning() {
+        if (++_iteration < _batchSize)
+            return true;
+        return nextBatch();
+    }
+
+    /// Exclude setup done inside the measured loop from timing.
+    void pauseTiming();
+    void resumeTiming();
+
+    /// Number of processed items per iteration, used to report the throughput.
+    void setItemsPerIteration(int64_t items) { _itemsPerIteration = items; }
+
+    /// Attach a value to the results, e.g. draw calls per frame. Counters are compared exactly against the
+    /// baseline, an increase is reported as a regression.
+    void setCounter(std::string_view name, double value);
+
+    /// Mark the benchmark as not runnable in this environment, e.g. a missing asset.
+    void skip(std::string_view reason);
+
+    struct Result {
+        std::string name;
+        std::string skipReason;
+        int64_t iterations = 0;
+        int64_t itemsPerIteration = 0;
+        double medianNs = 0;
+        double minNs = 0;
+        double meanNs = 0;
+        double stddevNs = 0;
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    Result finish(std::string_view name) const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    bool nextBatch();
+
+    enum class Phase { START, WARMUP, MEASURE, DONE };
+
+    Phase _phase = Phase::START;
+    int64_t _iteration = 0;
+    int64_t _batchSize = 0;
+    int64_t _totalIterations = 0;
+    int64_t _itemsPerIteration = 0;
+    int _sampleCount;
+    std::chrono::nanoseconds _sampleTime;
+    clock::time_point _batchStart;
+    clock::time_point _pauseStart;
+    clock::duration _paused{};
+    std::vector<double> _samples;  // ns per iteration of each measured batch
+    std::vector<std::pair<std::string, double>> _counters;
+    std::string _skipReason;
+};
+
+
+using BenchmarkFunc = void (*)(BenchmarkState& state);
+
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, BenchmarkFunc func);
+};
+
+
+/// Runs the benchmarks when the command line has `--benchmark`, returns -1 otherwise.
+/// Options:
+///   --benchmark[=filter]          run the benchmarks whose name contains filter
+///   --benchmark-out=file          write the results as JSON
+///   --benchmark-baseline=file     compare with the results of a previous run
+///   --benchmark-tolerance=percent slowdown of the median accepted against the baseline, default 10
+///   --benchmark-samples=count     samples per benchmark, default 10
+/// The exit code is non zero when a benchmark regressed against the baseline.
+int runBenchmarks(int argc, char** argv);
+
+
+#define AX_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define AX_BENCHMARK_CONCAT(a, b) AX_BENCHMARK_CONCAT_IMPL(a, b)
+#define AX_BENCHMARK_IMPL(name, func)                                            \
+    static void func(BenchmarkState& state);                                     \
+    static BenchmarkRegistrar AX_BENCHMARK_CONCAT(func, _registrar)(name, func); \
+    static void func(BenchmarkState& state)
+
+/// Define and register a benchmark, the body gets a `BenchmarkState& state`.
+#define AX_BENCHMARK(name) AX_BENCHMARK_IMPL(name, AX_BENCHMARK_CONCAT(axBenchmark, __COUNTER__))
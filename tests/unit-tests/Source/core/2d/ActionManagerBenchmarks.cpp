@@ -0,0 +1,83 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+static void updateActions(BenchmarkState& state, int nodeCount, int actionsPerNode) {
+    ActionManager actionManager;
+    Vector<Node*> nodes;
+    nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        auto node = Node::create();
+        nodes.pushBack(node);
+        for (int a = 0; a < actionsPerNode; ++a) {
+            Action* action = a % 2 ? static_cast<Action*>(RepeatForever::create(RotateBy::create(1.0f, 360.0f)))
+                                   : RepeatForever::create(MoveBy::create(1.0f, Vec2(10, 0)));
+            actionManager.addAction(action, node, false);
+        }
+    }
+
+    while (state.keepRunning())
+        actionManager.update(1 / 60.0f);
+
+    state.setItemsPerIteration(int64_t(nodeCount) * actionsPerNode);
+    actionManager.removeAllActions();
+}
+
+
+AX_BENCHMARK("2d/ActionManager/update_10000_actions") {
+    updateActions(state, 10000, 1);
+}
+
+
+AX_BENCHMARK("2d/ActionManager/update_1000_nodes_10_actions") {
+    updateActions(state, 1000, 10);
+}
+
+
+AX_BENCHMARK("2d/TweenSystem/update_10000_tweens") {
+    // the same workload as update_10000_actions, the tweens are long enough not to finish
+    TweenSystem tweens;
+    Vector<Node*> nodes;
+    nodes.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        auto node = Node::create();
+        nodes.pushBack(node);
+        if (i % 2)
+            tweens.rotateBy(node, 1e6f, 360e6f);
+        else
+            tweens.moveBy(node, 1e6f, Vec2(10e6f, 0));
+        tweens.resumeTarget(node);
+    }
+
+    while (state.keepRunning())
+        tweens.update(1 / 60.0f);
+
+    state.setItemsPerIteration(10000);
+    tweens.stopAll();
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/AutoPolygon.h"
+#include "platform/FileUtils.h"
+
+using namespace ax;
+
+
+static std::string writeDiscImage(std::string_view name, int size) {
+    std::vector<uint8_t> pixels(size * size * 4, 0);
+    auto radius = size / 2.0f - 2;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            auto dx = x - size / 2.0f, dy = y - size / 2.0f;
+            if (dx * dx + dy * dy < radius * radius)
+                std::fill_n(&pixels[(y * size + x) * 4], 4, 0xff);
+        }
+    }
+
+    auto path  = FileUtils::getInstance()->getWritablePath() + std::string{name};
+    auto image = new Image();
+    image->initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+    image->saveToFile(path, false);
+    image->release();
+    return path;
+}
+
+
+TEST_SUITE("2d/AutoPolygon") {
+    TEST_CASE("cache") {
+        auto fu        = FileUtils::getInstance();
+        auto imagePath = writeDiscImage("autopolygon-disc.png", 64);
+        AutoPolygon::setCacheDirectory("autopolygon-cache-test");
+        auto cacheDir = std::string{AutoPolygon::getCacheDirectory()};
+        CHECK(fu->isDirectoryExist(cacheDir));
+
+        auto generated = AutoPolygon::generatePolygon(imagePath);
+        REQUIRE(generated.getTrianglesCount() > 0);
+        CHECK_EQ(fu->listFiles(cacheDir).size(), 1);
+
+        auto cached = AutoPolygon::generatePolygon(imagePath);
+        REQUIRE_EQ(cached.getVertCount(), generated.getVertCount());
+        REQUIRE_EQ(cached.getTrianglesCount(), generated.getTrianglesCount());
+        CHECK(cached.getRect().equals(generated.getRect()));
+        for (unsigned int i = 0; i < cached.getVertCount(); ++i) {
+            CHECK_EQ(cached.triangles.verts[i].vertices, generated.triangles.verts[i].vertices);
+            CHECK_EQ(cached.triangles.verts[i].texCoords.u, generated.triangles.verts[i].texCoords.u);
+            CHECK_EQ(cached.triangles.verts[i].texCoords.v, generated.triangles.verts[i].texCoords.v);
+        }
+        for (unsigned int i = 0; i < cached.triangles.indexCount; ++i)
+            CHECK_EQ(cached.triangles.indices[i], generated.triangles.indices[i]);
+
+        // Other parameters are another entry
+        AutoPolygon::generatePolygon(imagePath, Rect::ZERO, 4.0f);
+        CHECK_EQ(fu->listFiles(cacheDir).size(), 2);
+
+        AutoPolygon::setCacheDirectory("");
+        fu->removeDirectory(cacheDir);
+        fu->removeFile(imagePath);
+    }
+}
@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+// Set by CMake to a font shipped with the engine templates
+#ifndef AX_BENCHMARK_FONT
+#    define AX_BENCHMARK_FONT "fonts/arial.ttf"
+#endif
+
+
+static std::string makeText(int length, char variant) {
+    static const std::string_view words[] = {"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+                                             "elit", "sed", "do", "eiusmod", "tempor"};
+    std::string text;
+    text.reserve(length + 16);
+    for (int i = 0; text.size() < size_t(length); ++i) {
+        text += words[i % std::size(words)];
+        text += i % 17 == 16 ? '\n' : ' ';
+    }
+    text.resize(length);
+    text.back() = variant;
+    return text;
+}
+
+
+static void layoutText(BenchmarkState& state, int length, float width) {
+    auto fontPath = AX_BENCHMARK_FONT;
+    if (!FileUtils::getInstance()->isFileExist(fontPath)) {
+        state.skip(fmt::format("font not found: {}", fontPath));
+        return;
+    }
+
+    // Two strings so setString never short circuits on equal text
+    std::string texts[] = {makeText(length, 'a'), makeText(length, 'b')};
+    auto label          = Label::createWithTTF(texts[0], fontPath, 18, Vec2(width, 0));
+    label->updateContent();
+
+    int i = 0;
+    while (state.keepRunning()) {
+        label->setString(texts[++i % 2]);
+        label->updateContent();
+    }
+    state.setItemsPerIteration(length);
+    state.setCounter("lines", double(label->getStringNumLines()));
+}
+
+
+AX_BENCHMARK("2d/Label/layout_ttf_1000_chars") {
+    layoutText(state, 1000, 0);
+}
+
+
+AX_BENCHMARK("2d/Label/layout_ttf_10000_chars_wrapped") {
+    layoutText(state, 10000, 800);
+}
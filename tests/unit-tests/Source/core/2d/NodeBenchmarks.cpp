@@ -0,0 +1,79 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+static int addChildren(Node* parent, int depth, int branching) {
+    if (depth == 0)
+        return 0;
+    int count = 0;
+    for (int i = 0; i < branching; ++i) {
+        auto child = Node::create();
+        child->setPosition(float(i * 10), 5.0f);
+        child->setRotation(float(i * 15));
+        parent->addChild(child);
+        count += 1 + addChildren(child, depth - 1, branching);
+    }
+    return count;
+}
+
+
+static void visitHierarchy(BenchmarkState& state, int depth, int branching) {
+    auto renderer = Director::getInstance()->getRenderer();
+    auto root     = Node::create();
+    auto count    = addChildren(root, depth, branching);
+
+    float angle = 0;
+    while (state.keepRunning()) {
+        // Moving the root dirties every transform below it
+        root->setRotation(angle += 1.0f);
+        root->visit(renderer, Mat4::IDENTITY, 0);
+    }
+    state.setItemsPerIteration(count);
+}
+
+
+AX_BENCHMARK("2d/Node/visit_tree_depth7_branching4") {
+    visitHierarchy(state, 7, 4);
+}
+
+
+AX_BENCHMARK("2d/Node/visit_chain_depth1000") {
+    visitHierarchy(state, 1000, 1);
+}
+
+
+AX_BENCHMARK("2d/Node/visit_tree_clean_transforms") {
+    auto renderer = Director::getInstance()->getRenderer();
+    auto root     = Node::create();
+    auto count    = addChildren(root, 7, 4);
+
+    while (state.keepRunning())
+        root->visit(renderer, Mat4::IDENTITY, 0);
+    state.setItemsPerIteration(count);
+}
@@ -0,0 +1,54 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+static void updateParticles(BenchmarkState& state, int count) {
+    auto emitter = ParticleFire::createWithTotalParticles(count);
+    emitter->setEmissionRate(float(count));
+
+    // Fill the pool before measuring
+    for (int i = 0; i < 240; ++i)
+        emitter->update(1 / 60.0f);
+
+    while (state.keepRunning())
+        emitter->update(1 / 60.0f);
+
+    state.setItemsPerIteration(count);
+    state.setCounter("particles", double(emitter->getParticleCount()));
+}
+
+
+AX_BENCHMARK("2d/ParticleSystemQuad/update_1000") {
+    updateParticles(state, 1000);
+}
+
+
+AX_BENCHMARK("2d/ParticleSystemQuad/update_10000") {
+    updateParticles(state, 10000);
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <vector>
+#include "2d/SkylinePacker.h"
+
+using namespace ax;
+
+namespace
+{
+struct Placed
+{
+    int x, y, width, height;
+};
+
+bool overlaps(const Placed& a, const Placed& b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+}  // namespace
+
+TEST_SUITE("2d/SkylinePacker") {
+    TEST_CASE("no_overlap") {
+        SkylinePacker packer(128, 128);
+        std::vector<Placed> placed;
+        for (int i = 0; i < 200; ++i)
+        {
+            int width  = 5 + (i * 7) % 13;
+            int height = 6 + (i * 5) % 11;
+            int x, y;
+            if (!packer.insert(width, height, x, y))
+                break;
+
+            Placed rect{x, y, width, height};
+            CHECK(x + width <= 128);
+            CHECK(y + height <= 128);
+            for (auto&& other : placed)
+                CHECK_FALSE(overlaps(rect, other));
+            placed.push_back(rect);
+        }
+        CHECK(placed.size() > 50);
+    }
+
+    TEST_CASE("fills_gaps") {
+        SkylinePacker packer(64, 64);
+        int x, y;
+        REQUIRE(packer.insert(32, 40, x, y));
+        REQUIRE(packer.insert(32, 8, x, y));
+        // a row cursor would start below the 40 pixel tall rectangle
+        REQUIRE(packer.insert(32, 8, x, y));
+        CHECK_EQ(32, x);
+        CHECK_EQ(8, y);
+    }
+
+    TEST_CASE("release_reuses_room") {
+        SkylinePacker packer(32, 32);
+        int x, y;
+        REQUIRE(packer.insert(32, 32, x, y));
+        CHECK_FALSE(packer.insert(8, 8, x, y));
+
+        packer.release(0, 0, 16, 16);
+        REQUIRE(packer.insert(8, 8, x, y));
+        CHECK_EQ(0, x);
+        CHECK_EQ(0, y);
+        REQUIRE(packer.insert(8, 16, x, y));
+        CHECK_FALSE(packer.insert(16, 16, x, y));
+    }
+
+    TEST_CASE("release_coalesces") {
+        SkylinePacker packer(32, 32);
+        int x, y;
+        REQUIRE(packer.insert(32, 32, x, y));
+
+        // four quarters released in an order where no two consecutive ones touch
+        packer.release(0, 0, 16, 16);
+        packer.release(16, 16, 16, 16);
+        packer.release(16, 0, 16, 16);
+        packer.release(0, 16, 16, 16);
+        CHECK_EQ(0, packer.getUsedArea());
+
+        REQUIRE(packer.insert(32, 32, x, y));
+        CHECK_EQ(0, x);
+        CHECK_EQ(0, y);
+    }
+
+    TEST_CASE("reserve") {
+        SkylinePacker packer(64, 64);
+        packer.reserve(64, 20);
+        packer.reserve(16, 30);
+        CHECK_EQ(30, packer.getUsedHeight());
+
+        int x, y;
+        REQUIRE(packer.insert(16, 4, x, y));
+        CHECK_EQ(16, x);
+        CHECK_EQ(20, y);
+    }
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+#include "renderer/backend/null/DriverNull.h"
+
+using namespace ax;
+
+
+static Texture2D* createTexture(int size) {
+    std::vector<uint8_t> pixels(size * size * 4, 0xff);
+    auto texture = new Texture2D();
+    texture->initWithData(pixels.data(), pixels.size(), backend::PixelFormat::RGBA8, size, size);
+    texture->autorelease();
+    return texture;
+}
+
+
+static void present(Scene* scene) {
+    auto director = Director::getInstance();
+    if (director->getRunningScene())
+        director->replaceScene(scene);
+    else
+        director->runWithScene(scene);
+    director->drawScene();
+}
+
+
+static void reportFrameCounters(BenchmarkState& state) {
+    auto director = Director::getInstance();
+    auto renderer = director->getRenderer();
+    auto driver   = dynamic_cast<backend::DriverNull*>(backend::DriverBase::getInstance());
+
+    if (driver)
+        driver->resetCounters();
+    director->drawScene();
+
+    state.setCounter("drawn_batches", double(renderer->getDrawnBatches()));
+    state.setCounter("drawn_vertices", double(renderer->getDrawnVertices()));
+    if (driver) {
+        auto& counters = driver->getCounters();
+        state.setCounter("draw_calls", double(counters.drawCalls));
+        state.setCounter("buffer_upload_bytes", double(counters.bufferUploadBytes));
+        state.setCounter("pipeline_updates", double(counters.pipelineUpdates));
+    }
+}
+
+
+static void visitAndRenderSprites(BenchmarkState& state, int count, bool sharedTexture) {
+    auto scene   = Scene::create();
+    auto texture = createTexture(32);
+    for (int i = 0; i < count; ++i) {
+        auto sprite = Sprite::createWithTexture(sharedTexture || i % 2 ? texture : createTexture(32));
+        sprite->setPosition(float(i * 37 % 1024), float(i * 53 % 768));
+        sprite->setRotation(float(i % 360));
+        scene->addChild(sprite);
+    }
+    present(scene);
+
+    while (state.keepRunning())
+        Director::getInstance()->drawScene();
+
+    state.setItemsPerIteration(count);
+    reportFrameCounters(state);
+}
+
+
+AX_BENCHMARK("2d/Sprite/visit_render_1000") {
+    visitAndRenderSprites(state, 1000, true);
+}
+
+
+AX_BENCHMARK("2d/Sprite/visit_render_10000") {
+    visitAndRenderSprites(state, 10000, true);
+}
+
+
+// Alternating textures break every batch, this is the worst case for the renderer
+AX_BENCHMARK("2d/Sprite/visit_render_1000_unbatched") {
+    visitAndRenderSprites(state, 1000, false);
+}
@@ -0,0 +1,169 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/Node.h"
+#include "2d/TransformSystem.h"
+
+#if defined(AX_ENABLE_3D)
+#    include "3d/AttachNode.h"
+#    include "3d/Bundle3DData.h"
+#    include "3d/Skeleton3D.h"
+#endif
+
+using namespace ax;
+
+namespace
+{
+Vec3 worldPosition(Node* node)
+{
+    Vec3 position;
+    node->getNodeToWorldTransform().getTranslation(&position);
+    return position;
+}
+
+// records the translation of the model-view transform it's drawn with
+class DrawnNode : public Node
+{
+public:
+    static DrawnNode* create()
+    {
+        auto node = new DrawnNode();
+        node->init();
+        node->autorelease();
+        return node;
+    }
+
+    void draw(Renderer* /*renderer*/, const Mat4& transform, uint32_t /*flags*/) override
+    {
+        transform.getTranslation(&drawnPosition);
+    }
+
+    Vec3 drawnPosition;
+};
+}  // namespace
+
+TEST_SUITE("2d/TransformSystem") {
+    TEST_CASE("reparent") {
+        auto root = Node::create();
+        auto a    = Node::create();
+        auto b    = Node::create();
+        auto c    = Node::create();
+        root->addChild(a);
+        root->addChild(b);
+        a->addChild(c);
+        a->setPosition(10.0f, 0.0f);
+        b->setPosition(0.0f, 20.0f);
+        c->setPosition(1.0f, 2.0f);
+
+        TransformSystem system(root);
+        system.update();
+        REQUIRE(system.isClean());
+        CHECK_EQ(system.getNodeCount(), 4u);
+        CHECK_EQ(worldPosition(c), Vec3(11.0f, 2.0f, 0.0f));
+
+        // the subtree is moved without registering the whole scene graph again
+        c->retain();
+        c->removeFromParent();
+        b->addChild(c);
+        c->release();
+        CHECK_EQ(system.getNodeCount(), 4u);
+        CHECK_FALSE(system.isClean());
+
+        system.update();
+        REQUIRE(system.isClean());
+        CHECK_EQ(worldPosition(c), Vec3(1.0f, 22.0f, 0.0f));
+
+        b->setPosition(0.0f, 30.0f);
+        system.update();
+        CHECK_EQ(worldPosition(c), Vec3(1.0f, 32.0f, 0.0f));
+    }
+
+    TEST_CASE("visit_transform") {
+        auto root = Node::create();
+        auto a    = Node::create();
+        auto c    = DrawnNode::create();
+        root->addChild(a);
+        a->addChild(c);
+        a->setPosition(10.0f, 0.0f);
+        c->setPosition(1.0f, 2.0f);
+
+        TransformSystem system(root);
+        system.update();
+        system.setVisiting(true);
+
+        // visited from the root, the model-view transforms are the world transforms
+        root->visit(nullptr, Mat4::IDENTITY, 0);
+        CHECK_EQ(c->drawnPosition, Vec3(11.0f, 2.0f, 0.0f));
+
+        // visited with another parent transform, e.g. by a render texture, the world transforms don't apply
+        Mat4 offset;
+        Mat4::createTranslation(100.0f, 0.0f, 0.0f, &offset);
+        a->visit(nullptr, offset, Node::FLAGS_TRANSFORM_DIRTY);
+        CHECK_EQ(c->drawnPosition, Vec3(111.0f, 2.0f, 0.0f));
+
+        root->visit(nullptr, Mat4::IDENTITY, Node::FLAGS_TRANSFORM_DIRTY);
+        CHECK_EQ(c->drawnPosition, Vec3(11.0f, 2.0f, 0.0f));
+        system.setVisiting(false);
+    }
+
+#if defined(AX_ENABLE_3D)
+    TEST_CASE("attach_node") {
+        NodeData data;
+        data.id = "hand";
+        data.transform.translate(10.0f, 0.0f, 0.0f);
+        auto skeleton = Skeleton3D::create({&data});
+        auto bone     = skeleton->getBoneByIndex(0);
+        skeleton->updateBoneMatrix();
+
+        auto root   = Node::create();
+        auto attach = AttachNode::create(bone);
+        auto weapon = Node::create();
+        weapon->setPosition3D(Vec3(1.0f, 0.0f, 0.0f));
+        root->addChild(attach);
+        attach->addChild(weapon);
+
+        TransformSystem system(root);
+        system.update();
+        system.setVisiting(true);
+        CHECK_EQ(worldPosition(weapon), Vec3(11.0f, 0.0f, 0.0f));
+        system.setVisiting(false);
+
+        // the bone moves without marking the attach node dirty
+        float translation[] = {20.0f, 0.0f, 0.0f};
+        float rotation[]    = {0.0f, 0.0f, 0.0f, 1.0f};
+        float scale[]       = {1.0f, 1.0f, 1.0f};
+        bone->setAnimationValue(translation, rotation, scale);
+        skeleton->updateBoneMatrix();
+
+        // between two visits the world transforms below the attach node aren't served from the arrays
+        CHECK_FALSE(system.isClean());
+        CHECK_EQ(worldPosition(weapon), Vec3(21.0f, 0.0f, 0.0f));
+
+        system.update();
+        REQUIRE(system.isClean());
+        CHECK_EQ(worldPosition(weapon), Vec3(21.0f, 0.0f, 0.0f));
+    }
+#endif
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/TweenSystem.h"
+#include "2d/Node.h"
+
+using namespace ax;
+
+
+TEST_SUITE("2d/TweenSystem") {
+    TEST_CASE("tweens") {
+        TweenSystem tweens;
+        auto node = Node::create();
+        node->setPosition(10, 0);
+
+        auto move = tweens.moveBy(node, 1.0f, Vec2(10, 20));
+        tweens.fadeOut(node, 0.5f, tweenfunc::Quad_EaseIn);
+        bool completed = false;
+        tweens.setCompletionCallback(move, [&] { completed = true; });
+
+        // the node isn't running, so its tweens start paused
+        tweens.update(0.5f);
+        CHECK_EQ(node->getPosition(), Vec2(10, 0));
+        tweens.resumeTarget(node);
+
+        tweens.update(0.25f);
+        CHECK_EQ(node->getPosition(), Vec2(12.5f, 5));
+        CHECK_EQ(node->getOpacity(), 191);
+        CHECK_EQ(tweens.getTweenCountForTarget(node), 2);
+
+        tweens.update(0.25f);
+        CHECK_EQ(node->getOpacity(), 0);
+        CHECK_EQ(tweens.getTweenCount(), 1);
+
+        tweens.update(0.5f);
+        CHECK_EQ(node->getPosition(), Vec2(20, 20));
+        CHECK(completed);
+        CHECK_FALSE(tweens.isRunning(move));
+
+        // stopped tweens don't complete
+        completed = false;
+        move      = tweens.rotateTo(node, 1.0f, 270.0f);
+        tweens.setCompletionCallback(move, [&] { completed = true; });
+        tweens.resumeTarget(node);
+        tweens.update(0.5f);
+        CHECK_EQ(node->getRotation(), doctest::Approx(-45.0f));
+        tweens.stopAllForTarget(node);
+        tweens.update(1.0f);
+        CHECK_FALSE(completed);
+        CHECK_EQ(tweens.getTweenCount(), 0);
+    }
+
+    TEST_CASE("targets") {
+        TweenSystem tweens;
+        auto a = Node::create();
+        auto b = Node::create();
+        tweens.moveTo(a, 1.0f, Vec2(10, 0));
+        tweens.fadeOut(a, 1.0f);
+        tweens.moveTo(b, 1.0f, Vec2(0, 10));
+        tweens.resumeTarget(a);
+        tweens.resumeTarget(b);
+
+        // only the tweens of the paused target stop advancing
+        tweens.pauseTarget(a);
+        tweens.update(0.5f);
+        CHECK_EQ(a->getPosition(), Vec2(0, 0));
+        CHECK_EQ(b->getPosition(), Vec2(0, 5));
+
+        tweens.resumeTarget(a);
+        tweens.stopAllForTarget(b);
+        tweens.update(0.5f);
+        CHECK_EQ(a->getPosition(), Vec2(5, 0));
+        CHECK_EQ(b->getPosition(), Vec2(0, 5));
+        CHECK_EQ(tweens.getTweenCountForTarget(a), 2);
+        CHECK_EQ(tweens.getTweenCountForTarget(b), 0);
+    }
+}
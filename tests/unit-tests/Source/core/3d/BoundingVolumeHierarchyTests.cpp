@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#if defined(AX_ENABLE_3D)
+#    include "3d/BoundingVolumeHierarchy.h"
+
+using namespace ax;
+
+namespace
+{
+AABB randomBox(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    Vec3 min(position(rng), position(rng), position(rng));
+    return AABB(min, min + Vec3(size(rng), size(rng), size(rng)));
+}
+
+std::vector<intptr_t> queryAll(const BoundingVolumeHierarchy& bvh, const AABB& aabb)
+{
+    std::vector<intptr_t> result;
+    bvh.query(aabb, [&](void* userData) { result.push_back(reinterpret_cast<intptr_t>(userData)); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+}  // namespace
+
+TEST_SUITE("3d/BoundingVolumeHierarchy") {
+    TEST_CASE("query_matches_brute_force") {
+        std::mt19937 rng(1234);
+        BoundingVolumeHierarchy bvh;
+
+        std::vector<AABB> boxes;
+        std::vector<int> proxies;
+        for (intptr_t i = 0; i < 500; ++i)
+        {
+            boxes.push_back(randomBox(rng));
+            proxies.push_back(bvh.createProxy(boxes.back(), reinterpret_cast<void*>(i)));
+        }
+        REQUIRE(bvh.validate());
+        CHECK_EQ(500, bvh.getProxyCount());
+        // balanced by the rotations, a degenerate tree would be hundreds deep
+        CHECK_LT(bvh.getHeight(), 24);
+
+        // small moves stay in the fat aabb, large ones reinsert the leaf
+        for (size_t i = 0; i < boxes.size(); i += 2)
+        {
+            Vec3 offset = (i % 4 == 0) ? Vec3(0.02f, 0.0f, 0.0f) : Vec3(50.0f, -30.0f, 10.0f);
+            boxes[i]    = AABB(boxes[i]._min + offset, boxes[i]._max + offset);
+            CHECK_EQ(i % 4 != 0, bvh.moveProxy(proxies[i], boxes[i]));
+        }
+        for (size_t i = 1; i < boxes.size(); i += 5)
+        {
+            bvh.destroyProxy(proxies[i]);
+            proxies[i] = BoundingVolumeHierarchy::NULL_NODE;
+        }
+        REQUIRE(bvh.validate());
+
+        for (int q = 0; q < 50; ++q)
+        {
+            AABB query = randomBox(rng);
+            query._max += Vec3(20.0f, 20.0f, 20.0f);
+
+            std::vector<intptr_t> expected;
+            for (size_t i = 0; i < boxes.size(); ++i)
+            {
+                if (proxies[i] != BoundingVolumeHierarchy::NULL_NODE && boxes[i].intersects(query))
+                    expected.push_back(static_cast<intptr_t>(i));
+            }
+            CHECK_EQ(expected, queryAll(bvh, query));
+        }
+
+        bvh.clear();
+        CHECK_EQ(0, bvh.getProxyCount());
+        CHECK(queryAll(bvh, AABB(Vec3(-1000, -1000, -1000), Vec3(1000, 1000, 1000))).empty());
+    }
+}
+#endif
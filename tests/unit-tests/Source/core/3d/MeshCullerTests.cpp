@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+
+#if defined(AX_ENABLE_3D)
+#    include "2d/Camera.h"
+#    include "3d/AttachNode.h"
+#    include "3d/Bundle3DData.h"
+#    include "3d/Mesh.h"
+#    include "3d/MeshCuller.h"
+#    include "3d/MeshRenderer.h"
+#    include "3d/Skeleton3D.h"
+
+using namespace ax;
+
+namespace
+{
+MeshRenderer* createTriangle()
+{
+    auto renderer = MeshRenderer::create();
+    renderer->addMesh(Mesh::create({-1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f}, {}, {},
+                                   IndexArray{uint16_t(0), uint16_t(1), uint16_t(2)}));
+    return renderer;
+}
+
+Camera* createCamera()
+{
+    auto camera = Camera::createPerspective(60.0f, 1.0f, 1.0f, 100.0f);
+    camera->setPosition3D(Vec3(0.0f, 0.0f, 10.0f));
+    camera->lookAt(Vec3::ZERO);
+    return camera;
+}
+}  // namespace
+
+TEST_SUITE("3d/MeshCuller") {
+    TEST_CASE("frustum_query") {
+        auto camera  = createCamera();
+        auto inside  = createTriangle();
+        auto outside = createTriangle();
+        outside->setPosition3D(Vec3(500.0f, 0.0f, 0.0f));
+
+        MeshCuller culler;
+        culler.addMeshRenderer(inside);
+        culler.addMeshRenderer(outside);
+        culler.update();
+        culler.cull(camera);
+        CHECK(culler.isVisible(inside));
+        CHECK_FALSE(culler.isVisible(outside));
+        CHECK_EQ(culler.getVisibleMeshRenderers().size(), 1u);
+
+        outside->setPosition3D(Vec3(0.0f, 2.0f, 0.0f));
+        culler.update();
+        culler.cull(camera);
+        CHECK(culler.isVisible(outside));
+        CHECK_EQ(culler.getVisibleMeshRenderers().size(), 2u);
+    }
+
+    TEST_CASE("attached_renderer") {
+        NodeData data;
+        data.id       = "hand";
+        auto skeleton = Skeleton3D::create({&data});
+        auto bone     = skeleton->getBoneByIndex(0);
+        skeleton->updateBoneMatrix();
+
+        auto camera   = createCamera();
+        auto attach   = AttachNode::create(bone);
+        auto renderer = createTriangle();
+        attach->addChild(renderer);
+
+        MeshCuller culler;
+        culler.addMeshRenderer(renderer);
+        culler.update();
+        culler.cull(camera);
+        CHECK(culler.isVisible(renderer));
+
+        // the bone moves the renderer out of the frustum without marking any node dirty
+        float translation[] = {500.0f, 0.0f, 0.0f};
+        float rotation[]    = {0.0f, 0.0f, 0.0f, 1.0f};
+        float scale[]       = {1.0f, 1.0f, 1.0f};
+        bone->setAnimationValue(translation, rotation, scale);
+        skeleton->updateBoneMatrix();
+
+        culler.update();
+        culler.cull(camera);
+        CHECK_FALSE(culler.isVisible(renderer));
+    }
+}
+#endif
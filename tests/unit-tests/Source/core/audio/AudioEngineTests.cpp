@@ -0,0 +1,201 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "audio/AudioEngine.h"
+#include "base/Director.h"
+#include "base/Scheduler.h"
+#include "platform/FileUtils.h"
+
+using namespace ax;
+using namespace std::chrono_literals;
+
+namespace
+{
+bool initAudio()
+{
+    // OpenAL Soft mixes into its null device when there is no sound card, unless the environment says otherwise
+#if defined(_WIN32)
+    if (!std::getenv("ALSOFT_DRIVERS"))
+        _putenv_s("ALSOFT_DRIVERS", "null");
+#else
+    setenv("ALSOFT_DRIVERS", "null", 0);
+#endif
+    return AudioEngine::lazyInit();
+}
+
+// writes dataSize bytes of silence as a PCM wave file
+std::string writeWave(std::string_view name, uint16_t channels, uint16_t bitsPerSample, uint32_t dataSize)
+{
+    const uint32_t sampleRate = 22050;
+    const uint16_t blockAlign = channels * bitsPerSample / 8;
+
+    std::vector<uint8_t> wave;
+    wave.reserve(44 + dataSize);
+    auto tag = [&](const char* id) { wave.insert(wave.end(), id, id + 4); };
+    auto put = [&](uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            wave.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    };
+    tag("RIFF");
+    put(36 + dataSize, 4);
+    tag("WAVE");
+    tag("fmt ");
+    put(16, 4);
+    put(1, 2);
+    put(channels, 2);
+    put(sampleRate, 4);
+    put(sampleRate * blockAlign, 4);
+    put(blockAlign, 2);
+    put(bitsPerSample, 2);
+    tag("data");
+    put(dataSize, 4);
+    wave.resize(wave.size() + dataSize, bitsPerSample == 8 ? 0x80 : 0);
+
+    auto path = FileUtils::getInstance()->getWritablePath() + std::string{name};
+    FileUtils::writeBinaryToFile(wave.data(), wave.size(), path);
+    return path;
+}
+
+// the audio engine reports back through the scheduler of the director, which no main loop updates here
+template <typename Pred>
+bool updateUntil(Pred&& pred, std::chrono::milliseconds timeout = 5s)
+{
+    auto scheduler      = Director::getInstance()->getScheduler();
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(10ms);
+        scheduler->update(0.01f);
+    }
+    return true;
+}
+
+// runs func on another thread, so a deadlock fails the test instead of hanging it
+template <typename Func>
+bool finishesWithin(Func&& func, std::chrono::milliseconds timeout)
+{
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    std::thread([func = std::forward<Func>(func), done]() mutable {
+        func();
+        done->store(true);
+    }).detach();
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done->load())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+}  // namespace
+
+TEST_SUITE("audio/AudioEngine") {
+    TEST_CASE("cache_budget") {
+        if (!initAudio())
+        {
+            MESSAGE("no audio device, skipped");
+            return;
+        }
+
+        // one format per file, so bytesPerFormat tells which caches are left
+        const uint32_t fileSize = 64 * 1024;
+        auto pinned = writeWave("__audio_stereo16.wav", 2, 16, fileSize);
+        auto oldest = writeWave("__audio_mono16.wav", 1, 16, fileSize);
+        auto recent = writeWave("__audio_mono8.wav", 1, 8, fileSize);
+        auto added  = writeWave("__audio_stereo8.wav", 2, 8, fileSize);
+
+        AudioEngine::setPcmCacheBudget(fileSize * 5 / 2);
+        const auto evictions = AudioEngine::getCacheStats().evictions;
+
+        // the pinned cache is the least recently used one
+        AudioEngine::setCachePinned(pinned, true);
+        AudioEngine::preload(oldest);
+        AudioEngine::preload(recent);
+        REQUIRE(updateUntil([] { return AudioEngine::getCacheStats().bytesPerFormat.size() == 3; }));
+        CHECK_EQ(AudioEngine::getCacheStats().evictions, evictions);
+        CHECK_EQ(AudioEngine::getCacheStats().pinnedBytes, fileSize);
+
+        // three caches are over the budget, a new one evicts the oldest unpinned cache, which is enough
+        AudioEngine::preload(added);
+        REQUIRE(updateUntil([] { return AudioEngine::getCacheStats().bytesPerFormat.count("stereo8") == 1; }));
+        auto stats = AudioEngine::getCacheStats();
+        CHECK_EQ(stats.evictions, evictions + 1);
+        CHECK_EQ(stats.cacheCount, 3);
+        CHECK_EQ(stats.bytesPerFormat.count("mono16"), 0);
+        CHECK_EQ(stats.bytesPerFormat.count("mono8"), 1);
+        CHECK_EQ(stats.bytesPerFormat.count("stereo16"), 1);
+        CHECK_EQ(stats.pinnedBytes, fileSize);
+
+        AudioEngine::setPcmCacheBudget(0);
+        AudioEngine::end();
+        for (auto&& path : {pinned, oldest, recent, added})
+            FileUtils::getInstance()->removeFile(path);
+    }
+
+    TEST_CASE("stream_refills") {
+        if (!initAudio())
+        {
+            MESSAGE("no audio device, skipped");
+            return;
+        }
+
+        // over a megabyte of PCM is streamed instead of decoded at once
+        auto path = writeWave("__audio_stream.wav", 2, 16, 2 * 1024 * 1024);
+
+        auto audioID = AudioEngine::play2d(path);
+        REQUIRE_NE(audioID, AudioEngine::INVALID_AUDIO_ID);
+        AudioStreamStats stats;
+        REQUIRE(updateUntil([&] { return AudioEngine::getStreamStats(audioID, stats) && stats.refills > 0; }));
+
+        // the file is cached now, so play2d queues the player on the worker right away and the first refill,
+        // which opens the decoder, is likely still running when the player gets destroyed
+        for (int i = 0; i < 8; ++i)
+        {
+            auto id = AudioEngine::play2d(path);
+            REQUIRE_NE(id, AudioEngine::INVALID_AUDIO_ID);
+            REQUIRE(finishesWithin([id] { AudioEngine::stop(id); }, 2s));
+        }
+
+        // the worker keeps refilling the player which is still playing
+        const auto refills = stats.refills;
+        REQUIRE(updateUntil([&] { return AudioEngine::getStreamStats(audioID, stats) && stats.refills > refills; }));
+
+        REQUIRE(finishesWithin([audioID] { AudioEngine::stop(audioID); }, 2s));
+        CHECK_FALSE(AudioEngine::getStreamStats(audioID, stats));
+
+        AudioEngine::end();
+        FileUtils::getInstance()->removeFile(path);
+    }
+}
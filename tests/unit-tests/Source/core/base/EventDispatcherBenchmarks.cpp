@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+static void dispatchTouches(BenchmarkState& state, int listenerCount) {
+    auto dispatcher = new EventDispatcher();
+    dispatcher->setEnabled(true);
+
+    int handled = 0;
+    for (int i = 0; i < listenerCount; ++i) {
+        auto listener = EventListenerTouchOneByOne::create();
+        // Not claiming the touch makes the dispatcher walk every listener
+        listener->onTouchBegan = [&handled](Touch*, Event*) {
+            ++handled;
+            return false;
+        };
+        dispatcher->addEventListenerWithFixedPriority(listener, i + 1);
+    }
+
+    auto touch = new Touch();
+    touch->setTouchInfo(0, 100, 100);
+    EventTouch event;
+    event.setEventCode(EventTouch::EventCode::BEGAN);
+    event.setTouches({touch});
+
+    while (state.keepRunning())
+        dispatcher->dispatchEvent(&event);
+
+    state.setItemsPerIteration(listenerCount);
+    dispatcher->removeAllEventListeners();
+    dispatcher->release();
+    touch->release();
+}
+
+
+AX_BENCHMARK("base/EventDispatcher/dispatch_touch_100_listeners") {
+    dispatchTouches(state, 100);
+}
+
+
+AX_BENCHMARK("base/EventDispatcher/dispatch_touch_1000_listeners") {
+    dispatchTouches(state, 1000);
+}
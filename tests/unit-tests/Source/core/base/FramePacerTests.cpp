@@ -0,0 +1,61 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <thread>
+#include "base/FramePacer.h"
+
+using namespace ax;
+using namespace std::chrono_literals;
+
+
+TEST_SUITE("base/FramePacer") {
+    TEST_CASE("deadlines") {
+        FramePacer pacer(5ms);
+        auto begin = FramePacer::clock::now();
+
+        // the first call only starts pacing
+        pacer.waitForNextFrame();
+        CHECK(FramePacer::clock::now() - begin < 5ms);
+
+        // never wakes before the deadline, and the wake up error doesn't accumulate
+        for (int frame = 1; frame <= 10; ++frame)
+        {
+            pacer.waitForNextFrame();
+            CHECK(FramePacer::clock::now() - begin >= frame * 5ms);
+        }
+    }
+
+    TEST_CASE("late frame") {
+        FramePacer pacer(5ms);
+        pacer.waitForNextFrame();
+
+        // a frame late by more than one interval restarts the deadlines instead of catching up
+        std::this_thread::sleep_for(20ms);
+        pacer.waitForNextFrame();
+        auto late = FramePacer::clock::now();
+        pacer.waitForNextFrame();
+        CHECK(FramePacer::clock::now() - late >= 4ms);
+    }
+}
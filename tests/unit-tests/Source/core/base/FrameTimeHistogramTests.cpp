@@ -0,0 +1,71 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <memory>
+#include "base/FrameTimeHistogram.h"
+
+using namespace ax;
+using namespace std::chrono_literals;
+using Phase = FrameTimeHistogram::Phase;
+
+
+TEST_SUITE("base/FrameTimeHistogram") {
+    TEST_CASE("percentiles") {
+        auto histogram = std::make_unique<FrameTimeHistogram>();
+        CHECK_EQ(histogram->getPercentiles(Phase::UPDATE).samples, 0);
+
+        // 90 frames of 1 ms, 9 of 5 ms and a 100 ms spike
+        for (int i = 0; i < 90; ++i)
+            histogram->record(Phase::UPDATE, 1ms);
+        for (int i = 0; i < 9; ++i)
+            histogram->record(Phase::UPDATE, 5ms);
+        histogram->record(Phase::UPDATE, 100ms);
+
+        auto update = histogram->getPercentiles(Phase::UPDATE);
+        CHECK_EQ(update.samples, 100);
+        CHECK(update.p50 == doctest::Approx(1.05f));
+        CHECK(update.p95 == doctest::Approx(5.05f));
+        CHECK(update.p99 == doctest::Approx(5.05f));
+        CHECK(update.max == doctest::Approx(100.0f));
+
+        // the phases are independent
+        CHECK_EQ(histogram->getPercentiles(Phase::RENDER).samples, 0);
+
+        histogram->reset();
+        CHECK_EQ(histogram->getPercentiles(Phase::UPDATE).samples, 0);
+        CHECK_EQ(histogram->getPercentiles(Phase::UPDATE).max, 0);
+    }
+
+    TEST_CASE("overflow") {
+        auto histogram = std::make_unique<FrameTimeHistogram>();
+        histogram->record(Phase::SWAP, 250ms);
+        histogram->record(Phase::SWAP, -1ms);
+
+        auto swap = histogram->getPercentiles(Phase::SWAP);
+        CHECK_EQ(swap.samples, 2);
+        CHECK(swap.p99 == doctest::Approx(250.0f));
+        CHECK(swap.p50 == doctest::Approx(0.05f));
+    }
+}
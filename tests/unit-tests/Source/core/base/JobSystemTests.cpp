@@ -0,0 +1,78 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <array>
+#include <numeric>
+#include "base/JobSystem.h"
+
+using namespace ax;
+
+
+TEST_SUITE("base/JobSystem") {
+    TEST_CASE("JobFunction") {
+        int calls = 0;
+        JobFunction small([&calls] { ++calls; });
+        JobFunction moved(std::move(small));
+        CHECK_FALSE(small);
+        moved(nullptr);
+
+        std::array<char, JobFunction::INLINE_SIZE * 2> big{};
+        JobFunction heap([&calls, big](JobThreadData*) { calls += static_cast<int>(big.size()) > 0; });
+        heap(nullptr);
+        CHECK_EQ(calls, 2);
+    }
+
+    TEST_CASE("groups") {
+        JobSystem jobs(4);
+        std::atomic<int> done{0};
+        JobGroup first, second;
+        for (int i = 0; i < 64; ++i)
+            jobs.run([&done] { ++done; }, JobPriority::Normal, &first);
+
+        int seenByContinuation = -1;
+        jobs.runAfter(first, [&] { seenByContinuation = done.load(); }, JobPriority::High, &second);
+        jobs.wait(second);
+        CHECK(first.isDone());
+        CHECK_EQ(seenByContinuation, 64);
+
+        // a finished dependency queues the job at once
+        jobs.runAfter(first, [&done] { ++done; }, JobPriority::Low, &second);
+        jobs.wait(second);
+        CHECK_EQ(done.load(), 65);
+    }
+
+    TEST_CASE("parallelFor") {
+        for (int threads : {1, 3}) {
+            JobSystem jobs(threads);
+            std::vector<int> values(1000, 1);
+            std::atomic<int> sum{0};
+            jobs.parallelFor(0, values.size(), 64, [&](size_t begin, size_t end) {
+                sum += std::accumulate(values.begin() + begin, values.begin() + end, 0);
+            });
+            CHECK_EQ(sum.load(), 1000);
+        }
+    }
+}
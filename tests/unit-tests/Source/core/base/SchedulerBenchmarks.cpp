@@ -0,0 +1,79 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+namespace {
+    struct Target {
+        float elapsed = 0;
+        void update(float dt) { elapsed += dt; }
+    };
+}
+
+
+static void updateScheduler(BenchmarkState& state, Scheduler* scheduler, int64_t items) {
+    while (state.keepRunning())
+        scheduler->update(1 / 60.0f);
+    state.setItemsPerIteration(items);
+    scheduler->unscheduleAll();
+    scheduler->release();
+}
+
+
+AX_BENCHMARK("base/Scheduler/update_10000_timers") {
+    auto scheduler = new Scheduler();
+    std::vector<Target> targets(10000);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        auto target = &targets[i];
+        // A mix of every frame timers and timers firing at their own interval
+        scheduler->schedule([target](float dt) { target->update(dt); }, target, i % 4 ? 0.0f : 0.1f, false,
+                            "benchmark");
+    }
+    updateScheduler(state, scheduler, targets.size());
+}
+
+
+AX_BENCHMARK("base/Scheduler/update_10000_slow_timers") {
+    auto scheduler = new Scheduler();
+    std::vector<Target> targets(10000);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        auto target = &targets[i];
+        // Cooldowns and countdowns, only the few due timers should cost anything
+        scheduler->schedule([target](float dt) { target->update(dt); }, target, 5.0f + i % 56, false, "benchmark");
+    }
+    updateScheduler(state, scheduler, targets.size());
+}
+
+
+AX_BENCHMARK("base/Scheduler/update_10000_per_frame_targets") {
+    auto scheduler = new Scheduler();
+    std::vector<Target> targets(10000);
+    for (size_t i = 0; i < targets.size(); ++i)
+        scheduler->scheduleUpdate(&targets[i], int(i % 3) - 1, false);
+    updateScheduler(state, scheduler, targets.size());
+}
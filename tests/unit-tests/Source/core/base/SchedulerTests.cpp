@@ -0,0 +1,108 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <thread>
+#include "base/Scheduler.h"
+
+using namespace ax;
+
+
+TEST_SUITE("base/Scheduler") {
+    TEST_CASE("interval timers") {
+        auto scheduler = new Scheduler();
+        int target;
+        int fired = 0, once = 0;
+        scheduler->schedule([&](float) { ++fired; }, &target, 1.0f, false, "interval");
+        scheduler->schedule([&](float) { ++once; }, &target, 0.0f, 0, 0.5f, false, "once");
+
+        // the first frame only starts the timers
+        for (int frame = 0; frame <= 60; ++frame)
+            scheduler->update(0.05f);
+        CHECK_EQ(fired, 3);
+        CHECK_EQ(once, 1);
+        CHECK_FALSE(scheduler->isScheduled("once", &target));
+
+        // paused time doesn't count
+        scheduler->pauseTarget(&target);
+        for (int frame = 0; frame < 100; ++frame)
+            scheduler->update(0.05f);
+        CHECK_EQ(fired, 3);
+        scheduler->resumeTarget(&target);
+        scheduler->update(0.5f);
+        CHECK_EQ(fired, 3);
+        scheduler->update(0.5f);
+        CHECK_EQ(fired, 4);
+
+        scheduler->unschedule("interval", &target);
+        scheduler->update(10.0f);
+        CHECK_EQ(fired, 4);
+        scheduler->release();
+    }
+
+    TEST_CASE("unschedule while firing") {
+        auto scheduler = new Scheduler();
+        int first, second;
+        int fired = 0;
+        scheduler->schedule([&](float) { ++fired; scheduler->unscheduleAllForTarget(&second); }, &first, 1.0f, false,
+                            "first");
+        scheduler->schedule([&](float) { ++fired; scheduler->unscheduleAllForTarget(&first); }, &second, 1.0f, false,
+                            "second");
+        // timers due at the same time fire in scheduling order
+        scheduler->update(0);
+        scheduler->update(1.0f);
+        CHECK_EQ(fired, 1);
+        CHECK_FALSE(scheduler->isScheduled("second", &second));
+        scheduler->update(1.0f);
+        CHECK_EQ(fired, 2);
+        scheduler->release();
+    }
+
+    TEST_CASE("runOnAxmolThread") {
+        auto scheduler = new Scheduler();
+        int frame = 0, background = 0;
+        scheduler->setActionBudget(0.0001f);
+        for (int i = 0; i < 100; ++i) {
+            scheduler->runOnAxmolThread([&] { ++frame; });
+            scheduler->runOnAxmolThread([&] {
+                ++background;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }, Scheduler::ActionPriority::Background);
+        }
+
+        // the frame actions always run, background actions past the budget carry over
+        scheduler->update(0);
+        CHECK_EQ(frame, 100);
+        CHECK_EQ(background, 1);
+        CHECK_EQ(scheduler->getActionQueueStats().performedActions, 101);
+        CHECK_EQ(scheduler->getActionQueueStats().pendingActions, 99);
+
+        scheduler->setActionBudget(0);
+        scheduler->update(0);
+        CHECK_EQ(background, 100);
+        CHECK_GT(scheduler->getActionQueueStats().maxLatency, 0.0f);
+        scheduler->release();
+    }
+}
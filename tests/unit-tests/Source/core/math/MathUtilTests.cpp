@@ -27,6 +27,7 @@
 #include "base/Config.h"
 #include "base/Types.h"
 #include "math/MathBase.h"
+#include "math/Quaternion.h"
 #include "TestUtils.h"
 
 #define INCLUDE_SSE
@@ -157,6 +158,58 @@ TEST_SUITE("math/MathUtil")
             for (int i = 0; i < count; ++i)
                 CHECK_EQ(expected[i], dst[i]);
         }
+#endif
+    }
+
+    TEST_CASE("slerpQuaternions")
+    {
+        const int count = 7;
+        std::vector<float> from(count * 4), to(count * 4), t(count), expected(count * 4), dst(count * 4);
+        for (int i = 0; i < count; ++i)
+        {
+            ax::Quaternion q1(ax::Vec3(1.0f, float(i), 2.0f), 0.3f * i);
+            ax::Quaternion q2(ax::Vec3(float(i), -1.0f, 0.5f), 2.0f - 0.5f * i);
+            t[i] = i / float(count - 1);
+            memcpy(&from[i * 4], &q1.x, sizeof(q1));
+            memcpy(&to[i * 4], &q2.x, sizeof(q2));
+
+            ax::Quaternion q;
+            ax::Quaternion::slerp(q1, q2, t[i], &q);
+            memcpy(&expected[i * 4], &q.x, sizeof(q));
+        }
+
+        // Quaternion::slerp returns the from quaternion as it is for t = 0, the batched versions may flip its sign
+        auto checkQuaternions = [&]() {
+            for (int i = 0; i < count * 4; i += 4)
+            {
+                float dot = expected[i] * dst[i] + expected[i + 1] * dst[i + 1] + expected[i + 2] * dst[i + 2] +
+                            expected[i + 3] * dst[i + 3];
+                float sign = dot < 0 ? -1.0f : 1.0f;
+                for (int c = 0; c < 4; ++c)
+                    CHECK(fabs(expected[i + c] - sign * dst[i + c]) < 0.00001f);
+            }
+        };
+
+        SUBCASE("MathUtilC")
+        {
+            MathUtilC::slerpQuaternions(from.data(), to.data(), t.data(), dst.data(), count);
+            checkQuaternions();
+        }
+
+#ifdef AX_NEON_INTRINSICS
+        SUBCASE("MathUtilNeon")
+        {
+            MathUtilNeon::slerpQuaternions(from.data(), to.data(), t.data(), dst.data(), 4);
+            MathUtilC::slerpQuaternions(&from[16], &to[16], &t[4], &dst[16], count - 4);
+            checkQuaternions();
+        }
+#elif defined(AX_SSE_INTRINSICS)
+        SUBCASE("MathUtilSSE")
+        {
+            MathUtilSSE::slerpQuaternions(from.data(), to.data(), t.data(), dst.data(), 4);
+            MathUtilC::slerpQuaternions(&from[16], &to[16], &t[4], &dst[16], count - 4);
+            checkQuaternions();
+        }
 #endif
     }
 }
@@ -0,0 +1,217 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "network/HttpClient.h"
+#include "base/ZipUtils.h"
+#include "yasio/xxsocket.hpp"
+#include "TestUtils.h"
+
+using namespace ax;
+using namespace ax::network;
+
+
+namespace {
+    /// Minimal HTTP/1.1 server on a loopback port which answers every request on a
+    /// connection with "hello from <path>" and counts the accepted connections.
+    /// "/drop" closes the connection without reply, "/slow" never replies.
+    class LocalHttpServer {
+    public:
+        LocalHttpServer() {
+            _listener.pserve("127.0.0.1", 0);
+            _port = _listener.local_endpoint().port();
+            _acceptThread = std::thread([this] { serve(); });
+        }
+
+        ~LocalHttpServer() {
+            _stopped = true;
+            yasio::xxsocket wakeup;
+            wakeup.pconnect("127.0.0.1", _port);
+            _acceptThread.join();
+
+            for (auto& connection : _connections)
+                connection->shutdown();
+            for (auto& thread : _connectionThreads)
+                thread.join();
+        }
+
+        std::string url(std::string_view path) const { return fmt::format("http://127.0.0.1:{}{}", _port, path); }
+
+        int getConnectionCount() const { return _connectionCount; }
+
+        int getRequestCount(const std::string& path) {
+            std::lock_guard<std::mutex> lock(_requestMutex);
+            return _requestCounts[path];
+        }
+
+    private:
+        void serve() {
+            while (true) {
+                auto connection = _listener.accept();
+                if (_stopped)
+                    break;
+                if (!connection.is_open())
+                    continue;
+
+                ++_connectionCount;
+                _connections.emplace_back(std::make_unique<yasio::xxsocket>(std::move(connection)));
+                auto socket = _connections.back().get();
+                _connectionThreads.emplace_back([this, socket] { handleConnection(socket); });
+            }
+        }
+
+        void handleConnection(yasio::xxsocket* socket) {
+            std::string buffer;
+            char chunk[1024];
+            while (true) {
+                auto headerEnd = buffer.find("\r\n\r\n");
+                if (headerEnd == std::string::npos) {
+                    int n = socket->recv(chunk, sizeof(chunk));
+                    if (n <= 0)
+                        return;
+                    buffer.append(chunk, n);
+                    continue;
+                }
+
+                auto requestLine = buffer.substr(0, buffer.find("\r\n"));
+                buffer.erase(0, headerEnd + 4);
+
+                auto pathStart = requestLine.find(' ') + 1;
+                auto path = requestLine.substr(pathStart, requestLine.find(' ', pathStart) - pathStart);
+                {
+                    std::lock_guard<std::mutex> lock(_requestMutex);
+                    ++_requestCounts[path];
+                }
+                if (path == "/drop") {
+                    socket->shutdown();
+                    return;
+                }
+                if (path == "/slow")
+                    continue;
+
+                auto body = "hello from " + path;
+                std::string extraHeaders;
+                if (path == "/gzip") {
+                    auto compressed = ZipUtils::compressGZ(body.data(), body.size());
+                    body.assign(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+                    extraHeaders = "Content-Encoding: gzip\r\n";
+                }
+
+                auto response = fmt::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\n{}\r\n{}", body.size(),
+                                            extraHeaders, body);
+                socket->send(response.data(), static_cast<int>(response.size()));
+            }
+        }
+
+        yasio::xxsocket _listener;
+        unsigned short _port = 0;
+        std::atomic<bool> _stopped{false};
+        std::atomic<int> _connectionCount{0};
+        std::mutex _requestMutex;
+        std::unordered_map<std::string, int> _requestCounts;
+        std::thread _acceptThread;
+        std::vector<std::unique_ptr<yasio::xxsocket>> _connections;
+        std::vector<std::thread> _connectionThreads;
+    };
+
+    std::string send(std::string_view url, HttpRequest::Type type) {
+        auto run = AsyncRunner<std::string>();
+        auto request = new HttpRequest();
+        request->setUrl(url);
+        request->setRequestType(type);
+        if (type == HttpRequest::Type::POST)
+            request->setRequestData("x=1", 3);
+        request->setResponseCallback([&run](HttpClient*, HttpResponse* response) {
+            auto data = response->getResponseData();
+            run.finish(response->getResponseCode() == 200 ? std::string(data->data(), data->size()) : std::string{});
+        });
+        HttpClient::getInstance()->send(request);
+        request->release();
+        return run();
+    }
+
+    std::string get(std::string_view url) {
+        return send(url, HttpRequest::Type::GET);
+    }
+}
+
+
+TEST_SUITE("network/HttpClient") {
+    TEST_CASE("keep_alive") {
+        LocalHttpServer server;
+        HttpClient::getInstance()->setResponseDecodingEnabled(true);
+
+        CHECK_EQ(get(server.url("/first")), "hello from /first");
+        CHECK_EQ(get(server.url("/second")), "hello from /second");
+        CHECK_EQ(get(server.url("/gzip")), "hello from /gzip");
+        CHECK_EQ(server.getConnectionCount(), 1);
+
+        HttpClient::getInstance()->setResponseDecodingEnabled(false);
+    }
+
+    TEST_CASE("keep_alive_disabled") {
+        LocalHttpServer server;
+        HttpClient::getInstance()->setKeepAliveEnabled(false);
+
+        CHECK_EQ(get(server.url("/first")), "hello from /first");
+        CHECK_EQ(get(server.url("/second")), "hello from /second");
+        CHECK_EQ(server.getConnectionCount(), 2);
+
+        HttpClient::getInstance()->setKeepAliveEnabled(true);
+    }
+
+    TEST_CASE("retry_get_on_dropped_connection") {
+        LocalHttpServer server;
+
+        CHECK_EQ(get(server.url("/first")), "hello from /first");
+        // sent again once on a new connection, which the server drops as well
+        CHECK_EQ(get(server.url("/drop")), "");
+        CHECK_EQ(server.getRequestCount("/drop"), 2);
+    }
+
+    TEST_CASE("no_retry_post") {
+        LocalHttpServer server;
+
+        CHECK_EQ(get(server.url("/first")), "hello from /first");
+        CHECK_EQ(send(server.url("/drop"), HttpRequest::Type::POST), "");
+        CHECK_EQ(server.getRequestCount("/drop"), 1);
+    }
+
+    TEST_CASE("no_retry_after_timeout") {
+        LocalHttpServer server;
+        auto client = HttpClient::getInstance();
+        auto timeoutForRead = client->getTimeoutForRead();
+        client->setTimeoutForRead(1);
+
+        CHECK_EQ(get(server.url("/first")), "hello from /first");
+        CHECK_EQ(get(server.url("/slow")), "");
+        CHECK_EQ(server.getRequestCount("/slow"), 1);
+
+        client->setTimeoutForRead(timeoutForRead);
+    }
+}
@@ -0,0 +1,219 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "renderer/RenderThread.h"
+#include "renderer/backend/DeferredCommandBuffer.h"
+#include "renderer/backend/null/CommandBufferNull.h"
+#include "renderer/backend/null/DriverNull.h"
+#include "renderer/backend/Buffer.h"
+#include "renderer/backend/ProgramState.h"
+#include "renderer/backend/RenderTarget.h"
+
+#include <atomic>
+
+using namespace ax;
+using namespace ax::backend;
+
+namespace
+{
+const char* VERTEX_SHADER = R"(#version 310 es
+layout(location = 0) in vec4 a_position;
+layout(std140) uniform vs_ub { float u_alpha; };
+void main() { gl_Position = a_position * u_alpha; }
+)";
+
+const char* FRAGMENT_SHADER = R"(#version 310 es
+precision highp float;
+void main() {}
+)";
+
+/// Keeps the first uniform of every program state the deferred command buffer executes with
+class UniformSpy : public CommandBufferNull
+{
+public:
+    using CommandBufferNull::CommandBufferNull;
+
+    void setProgramState(ProgramState* programState) override
+    {
+        std::size_t size = 0;
+        auto buffer      = programState->getVertexUniformBuffer(size);
+        values.emplace_back(*reinterpret_cast<const float*>(buffer));
+        programStates.emplace_back(programState);
+        CommandBufferNull::setProgramState(programState);
+    }
+
+    std::vector<float> values;
+    std::vector<ProgramState*> programStates;
+};
+}  // namespace
+
+TEST_SUITE("renderer/DeferredCommandBuffer") {
+    TEST_CASE("replay") {
+        DriverNull driver;
+        driver.setRecordingEnabled(true);
+
+        auto vertexBuffer = driver.newBuffer(1024, BufferType::VERTEX, BufferUsage::DYNAMIC);
+        auto indexBuffer  = driver.newBuffer(256, BufferType::INDEX, BufferUsage::DYNAMIC);
+        auto deferred     = new DeferredCommandBuffer(driver.newCommandBuffer());
+        deferred->getTarget()->release();
+
+        uint8_t vertices[64]{};
+        deferred->beginFrame();
+        deferred->setViewport(0, 0, 960, 640);
+        deferred->updateBuffer(vertexBuffer, vertices, 0, sizeof(vertices), true);
+        deferred->updateBuffer(indexBuffer, nullptr, 0, indexBuffer->getSize(), true);
+        deferred->setVertexBuffer(vertexBuffer);
+        deferred->setIndexBuffer(indexBuffer);
+        deferred->drawElements(PrimitiveType::TRIANGLE, IndexFormat::U_SHORT, 6, 0);
+        deferred->drawArrays(PrimitiveType::TRIANGLE, 0, 3);
+        deferred->endRenderPass();
+        deferred->endFrame();
+
+        // nothing executes until the frame is
+        auto& counters = driver.getCounters();
+        CHECK_EQ(0, counters.frames);
+        CHECK_EQ(0, counters.bufferUploads);
+
+        int presents = 0;
+        auto frame   = deferred->closeFrame();
+        deferred->execute(frame, [&] { ++presents; });
+        deferred->openFrame();
+
+        CHECK_EQ(1, presents);
+        CHECK_EQ(1, counters.frames);
+        CHECK_EQ(2, counters.drawCalls);
+        CHECK_EQ(6, counters.indices);
+        CHECK_EQ(3, counters.vertices);
+        CHECK_EQ(2, counters.bufferUploads);
+        CHECK_EQ(64 + 256, counters.bufferUploadBytes);
+
+        auto& commands = driver.getRecordedCommands();
+        REQUIRE_EQ(8, commands.size());
+        CHECK(commands[0].type == NullCommandType::BEGIN_FRAME);
+        CHECK(commands[4].type == NullCommandType::DRAW_ELEMENTS);
+        CHECK(commands[7].type == NullCommandType::END_FRAME);
+
+        // the frame references the buffer until it's recycled
+        CHECK_EQ(3, vertexBuffer->getReferenceCount());
+        deferred->closeFrame();
+        deferred->openFrame();
+        CHECK_EQ(1, vertexBuffer->getReferenceCount());
+
+        deferred->release();
+        indexBuffer->release();
+        vertexBuffer->release();
+    }
+
+    TEST_CASE("program_state_snapshot") {
+        DriverNull driver;
+        auto program      = driver.newProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+        auto programState = new ProgramState(program);
+        auto alpha        = programState->getUniformLocation("u_alpha");
+        auto spy          = new UniformSpy(&driver);
+        auto deferred     = new DeferredCommandBuffer(spy);
+        spy->release();
+
+        float value = 1.0f;
+        programState->setUniform(alpha, &value, sizeof(value));
+        deferred->setProgramState(programState);
+        value = 2.0f;
+        programState->setUniform(alpha, &value, sizeof(value));
+        deferred->setProgramState(programState);
+        deferred->setProgramState(programState);
+
+        // a callback uniform is evaluated when the program state is set
+        programState->setCallbackUniform(alpha, [&value](ProgramState* target, const UniformLocation& location) {
+            target->setUniform(location, &value, sizeof(value));
+        });
+        value = 3.0f;
+        deferred->setProgramState(programState);
+        value = 4.0f;
+
+        deferred->execute(deferred->closeFrame());
+        deferred->openFrame();
+
+        REQUIRE_EQ(4, spy->values.size());
+        CHECK_EQ(1.0f, spy->values[0]);
+        CHECK_EQ(2.0f, spy->values[1]);
+        CHECK_EQ(2.0f, spy->values[2]);
+        CHECK_EQ(3.0f, spy->values[3]);
+        CHECK_NE(programState, spy->programStates[0]);
+        CHECK_NE(spy->programStates[0], spy->programStates[1]);
+        CHECK_EQ(spy->programStates[1], spy->programStates[2]);
+
+        deferred->release();
+        programState->release();
+        program->release();
+    }
+
+    TEST_CASE("render_thread") {
+        DriverNull driver;
+        auto vertexBuffer  = driver.newBuffer(1024, BufferType::VERTEX, BufferUsage::DYNAMIC);
+        auto renderTarget  = driver.newDefaultRenderTarget();
+        auto deferred      = new DeferredCommandBuffer(driver.newCommandBuffer());
+        deferred->getTarget()->release();
+
+        // bind the buffer first, the frames never end a render pass so the render thread doesn't retain it again,
+        // Object needs AX_ENABLE_RENDER_THREAD for that
+        deferred->setVertexBuffer(vertexBuffer);
+        deferred->execute(deferred->closeFrame());
+        deferred->openFrame();
+
+        std::atomic<int> presents{0};
+        int readbacks = 0;
+        {
+            RenderThread renderThread(deferred);
+            for (int i = 0; i < 8; ++i)
+            {
+                deferred->beginFrame();
+                deferred->setViewport(0, 0, 16, 16);
+                deferred->setVertexBuffer(vertexBuffer);
+                deferred->drawArrays(PrimitiveType::TRIANGLE, 0, 3);
+                deferred->readPixels(renderTarget, [&readbacks](const PixelBufferDescriptor& pbd) {
+                    CHECK_EQ(16, pbd._width);
+                    ++readbacks;
+                });
+                deferred->endFrame();
+
+                renderThread.submit(deferred->closeFrame(), [&presents] { ++presents; });
+                deferred->openFrame();
+            }
+
+            renderThread.wait();
+            CHECK_EQ(8, presents.load());
+            CHECK_EQ(8, driver.getCounters().frames);
+
+            // the readbacks are delivered on the recording thread
+            CHECK_EQ(0, readbacks);
+            deferred->dispatchReadbacks();
+            CHECK_EQ(8, readbacks);
+        }
+
+        deferred->release();
+        renderTarget->release();
+        vertexBuffer->release();
+    }
+}
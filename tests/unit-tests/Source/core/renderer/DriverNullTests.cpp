@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "renderer/backend/null/DriverNull.h"
+#include "renderer/backend/Buffer.h"
+#include "renderer/backend/CommandBuffer.h"
+#include "renderer/backend/Program.h"
+
+using namespace ax;
+using namespace ax::backend;
+
+TEST_SUITE("renderer/DriverNull") {
+    TEST_CASE("program_reflection") {
+        DriverNull driver;
+        auto program = driver.newProgram(R"(#version 310 es
+#define COLOR_COUNT 2
+layout(location = 0) in vec4 a_position;
+layout(location = TEXCOORD0) in vec2 a_texCoord; // unresolved macro, assigned sequentially
+in vec4 a_color;
+layout(location = COLOR0) out vec4 v_color;
+
+layout(std140) uniform vs_ub {
+    mat4 u_MVPMatrix;
+    vec3 u_direction;
+    float u_strength;
+    highp vec4 u_colors[COLOR_COUNT];
+};
+
+void main() { gl_Position = u_MVPMatrix * a_position; }
+)",
+                                         R"(#version 310 es
+precision highp float;
+layout(binding = 0) uniform sampler2D u_tex0;
+/* layout(std140) uniform commented_ub { vec4 u_unused; }; */
+layout(std140) uniform fs_ub { vec4 u_textColor; };
+void main() {}
+)");
+
+        CHECK_EQ(0, program->getAttributeLocation(Attribute::POSITION));
+        CHECK_EQ(1, program->getAttributeLocation(Attribute::TEXCOORD));
+        CHECK_EQ(2, program->getAttributeLocation(Attribute::COLOR));
+        CHECK_EQ(3, program->getActiveAttributes().size());
+
+        auto mvp = program->getUniformLocation(Uniform::MVP_MATRIX);
+        CHECK_EQ(0, mvp.vertStage.location);
+        CHECK_EQ(0, mvp.vertStage.offset);
+        CHECK_EQ(64, program->getUniformLocation("u_direction").vertStage.offset);
+        CHECK_EQ(76, program->getUniformLocation("u_strength").vertStage.offset);
+        CHECK_EQ(80, program->getUniformLocation("u_colors").vertStage.offset);
+
+        // the fragment block follows the 112 bytes of the vertex block
+        auto textColor = program->getUniformLocation(Uniform::TEXT_COLOR);
+        CHECK_EQ(112, textColor.vertStage.location);
+        CHECK_EQ(0, textColor.vertStage.offset);
+        CHECK_EQ(128, program->getUniformBufferSize(ShaderStage::VERTEX));
+
+        CHECK(program->getUniformLocation(Uniform::TEXTURE));
+        CHECK_FALSE(program->getUniformLocation("u_unused"));
+
+        program->release();
+    }
+
+    TEST_CASE("counters") {
+        DriverNull driver;
+        driver.setRecordingEnabled(true);
+
+        auto vertexBuffer = driver.newBuffer(1024, BufferType::VERTEX, BufferUsage::DYNAMIC);
+        auto indexBuffer  = driver.newBuffer(256, BufferType::INDEX, BufferUsage::STATIC);
+        vertexBuffer->updateData(nullptr, 512);
+        vertexBuffer->updateSubData(nullptr, 512, 128);
+
+        auto commandBuffer = driver.newCommandBuffer();
+        commandBuffer->beginFrame();
+        commandBuffer->setViewport(0, 0, 960, 640);
+        commandBuffer->setViewport(0, 0, 960, 640);
+        commandBuffer->setVertexBuffer(vertexBuffer);
+        commandBuffer->setIndexBuffer(indexBuffer);
+        commandBuffer->setIndexBuffer(indexBuffer);
+        commandBuffer->drawElements(PrimitiveType::TRIANGLE, IndexFormat::U_SHORT, 6, 0);
+        commandBuffer->drawArrays(PrimitiveType::TRIANGLE, 0, 3);
+        commandBuffer->endRenderPass();
+        commandBuffer->endFrame();
+
+        auto& counters = driver.getCounters();
+        CHECK_EQ(1, counters.frames);
+        CHECK_EQ(2, counters.drawCalls);
+        CHECK_EQ(6, counters.indices);
+        CHECK_EQ(3, counters.vertices);
+        CHECK_EQ(1, counters.viewportChanges);
+        CHECK_EQ(1, counters.indexBufferBinds);
+        CHECK_EQ(2, counters.buffersCreated);
+        CHECK_EQ(1280, counters.bufferBytes);
+        CHECK_EQ(2, counters.bufferUploads);
+        CHECK_EQ(640, counters.bufferUploadBytes);
+
+        auto& commands = driver.getRecordedCommands();
+        REQUIRE_EQ(8, commands.size());
+        CHECK(commands[4].type == NullCommandType::DRAW_ELEMENTS);
+        CHECK_EQ(12, commands[4].bytes);
+        CHECK(commands[7].type == NullCommandType::END_FRAME);
+
+        driver.resetCounters();
+        CHECK_EQ(0, driver.getCounters().drawCalls);
+        CHECK(driver.getRecordedCommands().empty());
+
+        commandBuffer->release();
+        indexBuffer->release();
+        vertexBuffer->release();
+    }
+}
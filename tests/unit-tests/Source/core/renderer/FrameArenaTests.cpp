@@ -0,0 +1,72 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include <string>
+#include "renderer/FrameArena.h"
+
+using namespace ax;
+
+TEST_SUITE("renderer/FrameArena") {
+    TEST_CASE("alignment") {
+        FrameArena arena(256);
+        for (size_t alignment = 1; alignment <= 64; alignment *= 2)
+        {
+            auto p = arena.allocate(3, alignment);
+            CHECK_EQ(0, reinterpret_cast<uintptr_t>(p) % alignment);
+        }
+    }
+
+    TEST_CASE("finalizers") {
+        FrameArena arena;
+        std::string order;
+        struct Tracker
+        {
+            std::string* order;
+            char id;
+            ~Tracker() { order->push_back(id); }
+        };
+        arena.construct<Tracker>(&order, 'a');
+        arena.construct<Tracker>(&order, 'b');
+        arena.construct<std::string>("not trivially destructible, and long enough to use the heap");
+        arena.construct<Tracker>(&order, 'c');
+        arena.reset();
+        CHECK_EQ(std::string("cba"), order);
+    }
+
+    TEST_CASE("steady_state") {
+        FrameArena arena(1024);
+        for (int i = 0; i < 100; ++i)
+            arena.allocate(100);
+        CHECK_GT(arena.getHeapAllocations(), 1);
+        CHECK_GE(arena.getUsedBytes(), 100 * 100);
+
+        // the blocks are merged, the same frame fits now
+        arena.reset();
+        CHECK_EQ(0, arena.getUsedBytes());
+        for (int i = 0; i < 100; ++i)
+            arena.allocate(100);
+        CHECK_EQ(0, arena.getHeapAllocations());
+    }
+}
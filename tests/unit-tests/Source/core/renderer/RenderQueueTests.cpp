@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "renderer/Renderer.h"
+
+using namespace ax;
+
+namespace
+{
+class TestCommand : public RenderCommand
+{
+public:
+    TestCommand(float globalZOrder, int id) : id(id)
+    {
+        _type = RenderCommand::Type::CUSTOM_COMMAND;
+        init(globalZOrder, Mat4::IDENTITY, 0);
+    }
+
+    int id;
+};
+}  // namespace
+
+TEST_SUITE("renderer/RenderQueue") {
+    TEST_CASE("radix_sort") {
+        std::vector<RenderQueue::SortItem> items;
+        for (uint64_t i = 0; i < 1000; ++i)
+            items.push_back({(i * 7919) % 251 + (i % 3 == 0 ? (1ull << 62) : 0), reinterpret_cast<RenderCommand*>(i + 1)});
+
+        auto expected = items;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const auto& a, const auto& b) { return a.key < b.key; });
+
+        std::vector<RenderQueue::SortItem> scratch(items.size());
+        RenderQueue::radixSort(items.data(), scratch.data(), items.size());
+
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            CHECK_EQ(expected[i].key, items[i].key);
+            CHECK_EQ(expected[i].command, items[i].command);
+        }
+    }
+
+    TEST_CASE("global_order") {
+        std::vector<TestCommand> commands;
+        float orders[] = {3.0f, -1.0f, 0.0f, 2.5f, -7.0f, 3.0f, 1.0f, -1.0f, 0.0f, 2.5f};
+        for (int i = 0; i < 10; ++i)
+            commands.emplace_back(orders[i], i);
+
+        RenderQueue queue;
+        for (auto&& command : commands)
+            queue.emplace_back(&command);
+        queue.sort();
+
+        auto& negative = queue.getSubQueue(RenderQueue::GLOBALZ_NEG);
+        REQUIRE_EQ(3, negative.size());
+        CHECK_EQ(4, static_cast<TestCommand*>(negative[0])->id);
+        CHECK_EQ(1, static_cast<TestCommand*>(negative[1])->id);
+        CHECK_EQ(7, static_cast<TestCommand*>(negative[2])->id);
+
+        auto& zero = queue.getSubQueue(RenderQueue::GLOBALZ_ZERO);
+        REQUIRE_EQ(2, zero.size());
+        CHECK_EQ(2, static_cast<TestCommand*>(zero[0])->id);
+        CHECK_EQ(8, static_cast<TestCommand*>(zero[1])->id);
+
+        auto& positive = queue.getSubQueue(RenderQueue::GLOBALZ_POS);
+        REQUIRE_EQ(5, positive.size());
+        CHECK_EQ(6, static_cast<TestCommand*>(positive[0])->id);
+        CHECK_EQ(3, static_cast<TestCommand*>(positive[1])->id);
+        CHECK_EQ(9, static_cast<TestCommand*>(positive[2])->id);
+        CHECK_EQ(0, static_cast<TestCommand*>(positive[3])->id);
+        CHECK_EQ(5, static_cast<TestCommand*>(positive[4])->id);
+    }
+
+    TEST_CASE("merge") {
+        std::vector<TestCommand> commands;
+        float orders[] = {1.0f, 0.0f, 1.0f, -2.0f, 1.0f, 0.0f, 1.0f, 0.0f, -2.0f, 1.0f};
+        for (int i = 0; i < 10; ++i)
+            commands.emplace_back(orders[i], i);
+
+        // commands 2-4 and 7-8 are recorded by two other queues, as by two deferred visits
+        RenderQueue queue, first, second;
+        RenderQueue::MergeSource sources[2];
+        sources[0].queue  = &first;
+        sources[1].queue  = &second;
+        for (int i = 0; i < 10; ++i)
+        {
+            if (i == 2)
+                queue.getPositions(sources[0].positions);
+            if (i == 7)
+                queue.getPositions(sources[1].positions);
+            auto& target = (i >= 2 && i <= 4) ? first : (i >= 7 && i <= 8) ? second : queue;
+            target.emplace_back(&commands[i]);
+        }
+        queue.merge(sources, 2);
+        queue.sort();
+
+        RenderQueue serial;
+        for (auto&& command : commands)
+            serial.emplace_back(&command);
+        serial.sort();
+
+        REQUIRE_EQ(serial.size(), queue.size());
+        for (ssize_t i = 0; i < serial.size(); ++i)
+            CHECK_EQ(serial[i], queue[i]);
+    }
+}
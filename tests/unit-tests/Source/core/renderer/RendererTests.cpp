@@ -0,0 +1,185 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/Sprite.h"
+#include "base/Director.h"
+#include "renderer/Renderer.h"
+#include "renderer/Texture2D.h"
+#include "renderer/backend/null/DriverNull.h"
+
+using namespace ax;
+
+namespace
+{
+// the frames are begun and ended by the Director
+class FrameRenderer : public Renderer
+{
+public:
+    using Renderer::beginFrame;
+    using Renderer::endFrame;
+};
+
+Texture2D* createTexture(int size)
+{
+    std::vector<uint8_t> pixels(size * size * 4, 0xff);
+    auto texture = new Texture2D();
+    texture->initWithData(pixels.data(), pixels.size(), backend::PixelFormat::RGBA8, size, size);
+    texture->autorelease();
+    return texture;
+}
+
+void renderFrame(FrameRenderer& renderer, Node* root)
+{
+    renderer.clearDrawStats();
+    renderer.beginFrame();
+    root->visit(&renderer, Mat4::IDENTITY, 0);
+    renderer.render();
+    renderer.endFrame();
+}
+}  // namespace
+
+TEST_SUITE("renderer/Renderer") {
+    TEST_CASE("retained_batches") {
+        auto driver = dynamic_cast<backend::DriverNull*>(backend::DriverBase::getInstance());
+        REQUIRE(driver);
+
+        FrameRenderer renderer;
+        renderer.init();
+        renderer.setRetainedBatchingEnabled(true);
+
+        auto texture = createTexture(16);
+        auto root    = Node::create();
+        Sprite* sprites[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            sprites[i] = Sprite::createWithTexture(texture);
+            sprites[i]->setPosition(Vec2(32.0f * i, 0.0f));
+            root->addChild(sprites[i]);
+        }
+
+        // the first frame fills the batch buffers, sized for their content
+        driver->resetCounters();
+        renderFrame(renderer, root);
+        CHECK_EQ(renderer.getRetainedBatchHits(), 0);
+        CHECK_EQ(renderer.getRetainedBatchMisses(), 3);
+        CHECK_EQ(driver->getCounters().buffersCreated, 2);
+        CHECK_LT(driver->getCounters().bufferBytes, Renderer::VBO_SIZE * sizeof(V3F_C4B_T2F));
+
+        // nothing changed, nothing uploaded
+        driver->resetCounters();
+        renderFrame(renderer, root);
+        CHECK_EQ(renderer.getRetainedBatchHits(), 3);
+        CHECK_EQ(renderer.getRetainedBatchMisses(), 0);
+        CHECK_EQ(driver->getCounters().buffersCreated, 0);
+        CHECK_EQ(driver->getCounters().bufferUploads, 0);
+        CHECK_EQ(driver->getCounters().bufferUploadBytes, 0);
+        CHECK_EQ(driver->getCounters().drawCalls, 1);
+
+        // only the vertices and indices of the moved sprite are uploaded
+        sprites[1]->setPosition(Vec2(32.0f, 8.0f));
+        driver->resetCounters();
+        renderFrame(renderer, root);
+        CHECK_EQ(renderer.getRetainedBatchHits(), 2);
+        CHECK_EQ(renderer.getRetainedBatchMisses(), 1);
+        CHECK_EQ(driver->getCounters().bufferUploads, 2);
+        CHECK_EQ(driver->getCounters().bufferUploadBytes, 4 * sizeof(V3F_C4B_T2F) + 6 * sizeof(unsigned short));
+
+        // a sprite modified in place is refilled as well
+        sprites[2]->setColor(Color3B::RED);
+        renderFrame(renderer, root);
+        CHECK_EQ(renderer.getRetainedBatchHits(), 2);
+        CHECK_EQ(renderer.getRetainedBatchMisses(), 1);
+    }
+
+    TEST_CASE("multi_texture_batches") {
+        auto driver = dynamic_cast<backend::DriverNull*>(backend::DriverBase::getInstance());
+        REQUIRE(driver);
+
+        // the commands read the mode from the renderer of the director
+        auto directorRenderer = Director::getInstance()->getRenderer();
+        directorRenderer->setMultiTextureBatchingEnabled(true);
+
+        FrameRenderer renderer;
+        renderer.init();
+
+        auto atlas1 = createTexture(16);
+        auto atlas2 = createTexture(16);
+        auto root   = Node::create();
+        root->addChild(Sprite::createWithTexture(atlas1));
+        root->addChild(Sprite::createWithTexture(atlas2));
+
+        // the two atlases share one draw
+        driver->resetCounters();
+        renderFrame(renderer, root);
+        CHECK_EQ(driver->getCounters().drawCalls, 1);
+
+        // a repeated texture can't carry its slot in the texture coordinates
+        atlas2->setTexParameters(Texture2D::TexParams{backend::SamplerFilter::LINEAR, backend::SamplerFilter::LINEAR,
+                                                      backend::SamplerAddressMode::REPEAT,
+                                                      backend::SamplerAddressMode::REPEAT});
+        CHECK(atlas2->isRepeatWrapped());
+        driver->resetCounters();
+        renderFrame(renderer, root);
+        CHECK_EQ(driver->getCounters().drawCalls, 2);
+
+        directorRenderer->setMultiTextureBatchingEnabled(false);
+    }
+
+#if AX_ENABLE_RENDER_THREAD
+    TEST_CASE("pipelined") {
+        auto driver = dynamic_cast<backend::DriverNull*>(backend::DriverBase::getInstance());
+        REQUIRE(driver);
+
+        FrameRenderer renderer;
+        renderer.init();
+        renderer.setRetainedBatchingEnabled(true);
+        renderer.setPipelined(true);
+
+        auto texture = createTexture(16);
+        auto root    = Node::create();
+        auto sprite  = Sprite::createWithTexture(texture);
+        root->addChild(sprite);
+        root->addChild(Sprite::createWithTexture(texture));
+
+        // the mode switches at the next frame, the frames are executed by the render thread
+        driver->resetCounters();
+        for (int i = 0; i < 4; ++i)
+        {
+            sprite->setPosition(Vec2(8.0f * i, 0.0f));
+            renderFrame(renderer, root);
+            CHECK(renderer.isPipelined());
+        }
+        renderer.waitForRenderThread();
+        CHECK_EQ(driver->getCounters().frames, 4);
+        CHECK_EQ(driver->getCounters().drawCalls, 4);
+
+        // back to serial frames, nothing left pending
+        renderer.setPipelined(false);
+        renderFrame(renderer, root);
+        CHECK_FALSE(renderer.isPipelined());
+        CHECK_EQ(driver->getCounters().frames, 5);
+    }
+#endif
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+#include "axmol.h"
+
+using namespace ax;
+
+
+/// Writes a 512x512 PNG with some structure in it, so the encoder can't collapse it, and returns its path.
+static std::string writeTestImage(std::string_view name) {
+    constexpr int size = 512;
+    std::vector<uint8_t> pixels(size * size * 4);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            auto p = &pixels[(y * size + x) * 4];
+            p[0]   = uint8_t(x);
+            p[1]   = uint8_t(y);
+            p[2]   = uint8_t((x * y) >> 4);
+            p[3]   = 0xff;
+        }
+    }
+
+    auto path  = FileUtils::getInstance()->getWritablePath() + std::string{name};
+    auto image = new Image();
+    image->initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+    bool saved = image->saveToFile(path, false);
+    image->release();
+    return saved ? path : std::string{};
+}
+
+
+AX_BENCHMARK("renderer/Image/decode_png_512") {
+    auto path = writeTestImage("benchmark-decode.png");
+    auto data = FileUtils::getInstance()->getDataFromFile(path);
+    if (data.isNull()) {
+        state.skip("can't write the test image");
+        return;
+    }
+
+    while (state.keepRunning()) {
+        Image image;
+        image.initWithImageData(data.getBytes(), data.getSize());
+    }
+    state.setCounter("bytes", double(data.getSize()));
+    FileUtils::getInstance()->removeFile(path);
+}
+
+
+AX_BENCHMARK("renderer/TextureCache/add_remove_png_512") {
+    auto path = writeTestImage("benchmark-texture.png");
+    if (path.empty()) {
+        state.skip("can't write the test image");
+        return;
+    }
+
+    // Load, upload and evict, so every iteration misses the cache
+    auto cache = Director::getInstance()->getTextureCache();
+    while (state.keepRunning()) {
+        cache->addImage(path);
+        cache->removeTextureForKey(path);
+    }
+    FileUtils::getInstance()->removeFile(path);
+}